@@ -0,0 +1,102 @@
+package bsp
+
+import (
+	"math"
+	"testing"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// countSplitNodes counts general and axis-aligned split nodes
+func countSplitNodes(nodes []*pb.BSPNode) (general, axis int) {
+	for _, node := range nodes {
+		switch node.Type.(type) {
+		case *pb.BSPNode_Split:
+			general++
+		case *pb.BSPNode_AxisSplit:
+			axis++
+		}
+	}
+	return general, axis
+}
+
+func TestAxisSplit(t *testing.T) {
+	t.Run("Rectilinear geometry only uses axis-aligned splits", func(t *testing.T) {
+		box := Polygon{
+			Vertices: []Point{{X: -5, Y: -5}, {X: 5, Y: -5}, {X: 5, Y: 5}, {X: -5, Y: 5}},
+			IsSolid:  true,
+		}
+		levelData := NewBSPBuilder([]Polygon{box}).Build()
+
+		general, axis := countSplitNodes(levelData.Nodes)
+		if general != 0 || axis == 0 {
+			t.Errorf("Expected only axis-aligned splits, got %d general and %d axis-aligned", general, axis)
+		}
+
+		runTestCases(t, levelData, []TestCase{
+			{Name: "Center", Point: Point{X: 0, Y: 0}, ExpectSolid: true},
+			{Name: "On the right edge", Point: Point{X: 5, Y: 0}, ExpectSolid: true},
+			{Name: "On the bottom edge", Point: Point{X: 0, Y: -5}, ExpectSolid: true},
+			{Name: "Left of the box", Point: Point{X: -5.01, Y: 0}, ExpectSolid: false},
+			{Name: "Above the box", Point: Point{X: 0, Y: 5.01}, ExpectSolid: false},
+		})
+
+		result := LineTraceBSP(levelData, 0, 10, 0, 0)
+		if !result.Hit || math.Abs(float64(result.HitY-5)) > 0.001 {
+			t.Errorf("Expected a hit at y=5, got hit=%v y=%.4f", result.Hit, result.HitY)
+		}
+	})
+
+	t.Run("Axis-aligned edges are tested first", func(t *testing.T) {
+		// Right triangle with one diagonal edge, listed first
+		triangle := Polygon{
+			Vertices: []Point{{X: 4, Y: 0}, {X: 0, Y: 4}, {X: 0, Y: 0}},
+			IsSolid:  true,
+		}
+		levelData := NewBSPBuilder([]Polygon{triangle}).Build()
+
+		general, axis := countSplitNodes(levelData.Nodes)
+		if general != 1 || axis != 2 {
+			t.Fatalf("Expected 1 general and 2 axis-aligned splits, got %d and %d", general, axis)
+		}
+		if _, ok := levelData.Nodes[levelData.RootIndex].Type.(*pb.BSPNode_AxisSplit); !ok {
+			t.Errorf("Expected the root to be an axis-aligned split, got %T", levelData.Nodes[levelData.RootIndex].Type)
+		}
+
+		runTestCases(t, levelData, []TestCase{
+			{Name: "Inside", Point: Point{X: 1, Y: 1}, ExpectSolid: true},
+			{Name: "Beyond the diagonal", Point: Point{X: 3, Y: 3}, ExpectSolid: false},
+			{Name: "Below", Point: Point{X: 1, Y: -1}, ExpectSolid: false},
+		})
+	})
+
+	t.Run("Trace grazing a wall within epsilon stays outside", func(t *testing.T) {
+		box := Polygon{
+			Vertices: []Point{{X: 0, Y: 0}, {X: 4, Y: 0}, {X: 4, Y: 1}, {X: 0, Y: 1}},
+			IsSolid:  true,
+		}
+		levelData := NewBSPBuilder([]Polygon{box}).Build()
+
+		// Starts just above the top edge, closer than the trace epsilon, and moves away
+		result := LineTraceBSP(levelData, 2, 1.00005, 3, 5)
+		if result.Hit {
+			t.Errorf("Expected no hit, got a hit at (%.4f, %.4f)", result.HitX, result.HitY)
+		}
+	})
+
+	t.Run("Merged trees keep axis-aligned splits", func(t *testing.T) {
+		levelData := NewBSPBuilder([]Polygon{
+			{Vertices: []Point{{X: 0, Y: 0}, {X: 2, Y: 0}, {X: 2, Y: 2}, {X: 0, Y: 2}}, IsSolid: true},
+			{Vertices: []Point{{X: 5, Y: 0}, {X: 7, Y: 0}, {X: 7, Y: 2}, {X: 5, Y: 2}}, IsSolid: true},
+		}).Build()
+
+		if general, _ := countSplitNodes(levelData.Nodes); general != 0 {
+			t.Errorf("Expected no general splits, got %d", general)
+		}
+		runTestCases(t, levelData, []TestCase{
+			{Name: "First box", Point: Point{X: 1, Y: 1}, ExpectSolid: true},
+			{Name: "Second box", Point: Point{X: 6, Y: 1}, ExpectSolid: true},
+			{Name: "Between", Point: Point{X: 3.5, Y: 1}, ExpectSolid: false},
+		})
+	})
+}
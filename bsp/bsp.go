@@ -49,21 +49,57 @@ func (l Line) PointSide(p Point) float32 {
 }
 
 // ClassifyPoint returns 1 for front, -1 for back, 0 for on the line
+// The side is exact for the float32 plane, see lineSide
 func (l Line) ClassifyPoint(p Point) int {
-	side := l.PointSide(p)
-	epsilon := float32(0.0001)
-	if side > epsilon {
-		return 1 // Front
-	} else if side < -epsilon {
-		return -1 // Back
+	return lineSide(l, p)
+}
+
+// Axes of an AxisSplit
+const (
+	axisX = 0 // Vertical line, x = threshold
+	axisY = 1 // Horizontal line, y = threshold
+)
+
+// axisSplitSide is Line.PointSide for an axis-aligned split: one subtraction, no multiplies
+func axisSplitSide(split *pb.AxisSplit, p Point) float32 {
+	c := p.X
+	if split.Axis == axisY {
+		c = p.Y
+	}
+	if split.FrontBelow {
+		return split.Threshold - c
 	}
-	return 0 // On line
+	return c - split.Threshold
+}
+
+// sign returns 1 for positive values and -1 otherwise
+func sign(v float32) float32 {
+	if v > 0 {
+		return 1
+	}
+	return -1
+}
+
+// axisSplitLine returns the general plane of an axis-aligned split
+func axisSplitLine(split *pb.AxisSplit) Line {
+	sign := float32(1)
+	if split.FrontBelow {
+		sign = -1
+	}
+	if split.Axis == axisY {
+		return Line{Normal: Vector2{X: 0, Y: sign}, Distance: sign * split.Threshold}
+	}
+	return Line{Normal: Vector2{X: sign, Y: 0}, Distance: sign * split.Threshold}
 }
 
 // BSPBuilder holds the state for building a BSP tree
 type BSPBuilder struct {
-	Polygons []Polygon
-	nodes    []*pb.BSPNode // Flat array of all nodes
+	Polygons   []Polygon
+	Prefabs    map[string][]Polygon // Prefab collision polygons in local space, keyed by name
+	Instances  []Instance           // Placements of prefabs in the world
+	Partitions *PartitionCache      // Convex partitions shared across builds (optional)
+	ChunkSize  float32              // If > 0, BuildWithinBudget lays the exact tree out in chunks of this size (see BuildChunked)
+	nodes      []*pb.BSPNode        // Flat array of all nodes
 }
 
 // NewBSPBuilder creates a new BSP builder with the given polygons
@@ -76,25 +112,11 @@ func NewBSPBuilder(polygons []Polygon) *BSPBuilder {
 
 // Build constructs the BSP tree and returns the level data with flat structure
 func (b *BSPBuilder) Build() *pb.LevelData {
-	// Step 1: Partition all polygons into convex sub-polygons
-	convexPolygons := make([]Polygon, 0)
-	for _, poly := range b.Polygons {
-		partitioned, err := PartitionPolygonConvex(poly)
-		if err != nil {
-			continue
-		}
-		convexPolygons = append(convexPolygons, partitioned...)
-	}
+	// Step 1 and 2: Partition the world polygons and build one tree per convex piece
+	polyTreeIndices := b.buildPolygonTrees(b.Polygons)
 
-	// Step 2: Build individual BSP trees for each polygon
-	// Then combine them with OR logic
-	var polyTreeIndices []int32
-	for _, poly := range convexPolygons {
-		if poly.IsSolid && len(poly.Vertices) >= 3 {
-			idx := b.buildConvexPolygonTree(poly)
-			polyTreeIndices = append(polyTreeIndices, idx)
-		}
-	}
+	// Step 3: Build every referenced prefab once and place it with instance nodes
+	polyTreeIndices = append(polyTreeIndices, b.buildInstanceTrees()...)
 
 	var rootIndex int32
 	if len(polyTreeIndices) == 0 {
@@ -112,6 +134,33 @@ func (b *BSPBuilder) Build() *pb.LevelData {
 	}
 }
 
+// buildPolygonTrees partitions polygons into convex pieces and builds one tree per solid piece
+// Outlines that approximate a circle become a single circle primitive instead
+// The returned trees still have to be combined with mergeTrees
+func (b *BSPBuilder) buildPolygonTrees(polygons []Polygon) []int32 {
+	circleTrees, polygons := b.buildCircleTrees(polygons)
+
+	// Partition all polygons into convex sub-polygons
+	convexPolygons := make([]Polygon, 0)
+	for _, poly := range polygons {
+		partitioned, err := b.partition(poly)
+		if err != nil {
+			continue
+		}
+		convexPolygons = append(convexPolygons, partitioned...)
+	}
+
+	// Build individual BSP trees for each polygon
+	polyTreeIndices := circleTrees
+	for _, poly := range convexPolygons {
+		if poly.IsSolid && len(poly.Vertices) >= 3 {
+			idx := b.buildConvexPolygonTree(poly)
+			polyTreeIndices = append(polyTreeIndices, idx)
+		}
+	}
+	return polyTreeIndices
+}
+
 // mergeTrees combines multiple BSP trees with OR logic
 // A point is solid if it's solid in ANY of the trees
 func (b *BSPBuilder) mergeTrees(treeIndices []int32) int32 {
@@ -146,21 +195,43 @@ func (b *BSPBuilder) mergeTreePair(tree1Idx, tree2Idx int32) int32 {
 		return tree2Idx
 	}
 
-	// tree1 is a split node
-	split1 := tree1.Type.(*pb.BSPNode_Split).Split
-	line := Line{
-		Normal:   Vector2{X: split1.NormalX, Y: split1.NormalY},
-		Distance: split1.Distance,
+	// If tree1 is an instance, tree2 takes over wherever the instance is empty
+	// The prefab subtree itself lives in local space and is never merged
+	if inst1, ok := tree1.Type.(*pb.BSPNode_Instance); ok {
+		inst := inst1.Instance
+		nextMerged := b.mergeTreePair(inst.NextIndex, tree2Idx)
+		return b.addInstanceNode(inst.SubtreeIndex, instanceTransform(inst), nextMerged)
+	}
+
+	// If tree1 is a circle, tree2 takes over outside of it
+	if circle1, ok := tree1.Type.(*pb.BSPNode_Circle); ok {
+		outsideMerged := b.mergeTreePair(circle1.Circle.OutsideIndex, tree2Idx)
+		return b.addCircleNode(circleFromNode(circle1.Circle), outsideMerged)
+	}
+
+	// tree1 is a split node, either general or axis-aligned
+	var line Line
+	var frontIdx, backIdx int32
+	if axis1, ok := tree1.Type.(*pb.BSPNode_AxisSplit); ok {
+		line = axisSplitLine(axis1.AxisSplit)
+		frontIdx, backIdx = axis1.AxisSplit.FrontIndex, axis1.AxisSplit.BackIndex
+	} else {
+		split1 := tree1.Type.(*pb.BSPNode_Split).Split
+		line = Line{
+			Normal:   Vector2{X: split1.NormalX, Y: split1.NormalY},
+			Distance: split1.Distance,
+		}
+		frontIdx, backIdx = split1.FrontIndex, split1.BackIndex
 	}
 
 	// Split tree2 along tree1's plane
 	tree2FrontIdx, tree2BackIdx := b.splitTree(tree2Idx, line)
 
 	// Recursively merge
-	frontMerged := b.mergeTreePair(split1.FrontIndex, tree2FrontIdx)
-	backMerged := b.mergeTreePair(split1.BackIndex, tree2BackIdx)
+	frontMerged := b.mergeTreePair(frontIdx, tree2FrontIdx)
+	backMerged := b.mergeTreePair(backIdx, tree2BackIdx)
 
-	return b.addSplitNode(split1.NormalX, split1.NormalY, split1.Distance, frontMerged, backMerged)
+	return b.addSplitNode(line.Normal.X, line.Normal.Y, line.Distance, frontMerged, backMerged)
 }
 
 // splitTree splits a BSP tree along a plane
@@ -192,7 +263,18 @@ func (b *BSPBuilder) buildConvexPolygonTree(poly Polygon) int32 {
 	normalizedPoly := ensureCCW(poly)
 
 	// Build nested tests: must be on inside of ALL edges
-	return b.buildEdgeTest(normalizedPoly, 0)
+	// Axis-aligned edges are tested first, their nodes are the cheapest to evaluate
+	edges := make([]int, 0, len(normalizedPoly.Vertices))
+	for pass := 0; pass < 2; pass++ {
+		for i, v1 := range normalizedPoly.Vertices {
+			v2 := normalizedPoly.Vertices[(i+1)%len(normalizedPoly.Vertices)]
+			axisAligned := v1.X == v2.X || v1.Y == v2.Y
+			if axisAligned == (pass == 0) {
+				edges = append(edges, i)
+			}
+		}
+	}
+	return b.buildEdgeTest(normalizedPoly, edges)
 }
 
 // signedArea computes the signed area of a polygon
@@ -213,8 +295,9 @@ func signedArea(poly Polygon) float32 {
 }
 
 // isCCW returns true if the polygon has counter-clockwise winding
+// The winding is decided by an exact orientation test, so slivers are not flipped by rounding
 func isCCW(poly Polygon) bool {
-	return signedArea(poly) > 0
+	return polygonOrientation(poly.Vertices) > 0
 }
 
 // ensureCCW returns a copy of the polygon with CCW winding order
@@ -240,13 +323,15 @@ func ensureCCW(poly Polygon) Polygon {
 
 // buildEdgeTest recursively builds edge tests for a convex polygon
 // A point must be on the "inside" of all edges to be considered inside the polygon
-func (b *BSPBuilder) buildEdgeTest(poly Polygon, edgeIdx int) int32 {
-	if edgeIdx >= len(poly.Vertices) {
+// edges lists the start vertices of the edges still to test, in test order
+func (b *BSPBuilder) buildEdgeTest(poly Polygon, edges []int) int32 {
+	if len(edges) == 0 {
 		// Passed all edge tests - point is inside!
 		return b.addLeafNode(0, []int32{}, true)
 	}
 
 	// Get edge vertices
+	edgeIdx := edges[0]
 	v1 := poly.Vertices[edgeIdx]
 	v2 := poly.Vertices[(edgeIdx+1)%len(poly.Vertices)]
 
@@ -254,7 +339,13 @@ func (b *BSPBuilder) buildEdgeTest(poly Polygon, edgeIdx int) int32 {
 	edge := Vector2{X: v2.X - v1.X, Y: v2.Y - v1.Y}
 
 	// Inward normal (for CCW polygon, rotate 90° clockwise)
+	// Axis-aligned edges get an exact unit normal, so they become axis-aligned split nodes
 	inwardNormal := Vector2{X: edge.Y, Y: -edge.X}.Normalize()
+	if edge.X == 0 && edge.Y != 0 {
+		inwardNormal = Vector2{X: sign(edge.Y), Y: 0}
+	} else if edge.Y == 0 && edge.X != 0 {
+		inwardNormal = Vector2{X: 0, Y: -sign(edge.X)}
+	}
 
 	distance := inwardNormal.X*v1.X + inwardNormal.Y*v1.Y
 
@@ -279,7 +370,7 @@ func (b *BSPBuilder) buildEdgeTest(poly Polygon, edgeIdx int) int32 {
 	// So: back side = inside, front side = outside
 
 	frontNodeIdx := b.addLeafNode(0, []int32{}, false) // Front = outside
-	backNodeIdx := b.buildEdgeTest(poly, edgeIdx+1)    // Back = might be inside, check next edge
+	backNodeIdx := b.buildEdgeTest(poly, edges[1:])    // Back = might be inside, check next edge
 
 	return b.addSplitNode(line.Normal.X, line.Normal.Y, line.Distance, frontNodeIdx, backNodeIdx)
 }
@@ -322,21 +413,43 @@ const (
 	PolygonCoplanar
 )
 
-// classifyPolygon determines which side of the line a polygon is on
-func classifyPolygon(poly Polygon, line Line) PolygonClassification {
+// splitEdge is a split line through two points of the geometry, its front is left of a -> b
+// Sides are decided by exact orientation tests against the two points, not against the rounded
+// plane of the node, so vertices on the line are coplanar instead of randomly front or back
+type splitEdge struct {
+	a, b Point
+}
+
+// side returns 1 for front, -1 for back and 0 for points exactly on the line
+func (e splitEdge) side(p Point) int {
+	return orient2d(e.a, e.b, p)
+}
+
+// line returns the float32 plane stored in split nodes for the edge
+func (e splitEdge) line() Line {
+	edge := Vector2{X: e.b.X - e.a.X, Y: e.b.Y - e.a.Y}
+
+	// Normal is perpendicular to edge (rotate 90 degrees counter-clockwise)
+	normal := Vector2{X: -edge.Y, Y: edge.X}.Normalize()
+
+	// Distance is the dot product of normal with any point on the line
+	return Line{Normal: normal, Distance: normal.X*e.a.X + normal.Y*e.a.Y}
+}
+
+// classifyPolygon determines which side of the split edge a polygon is on
+func classifyPolygon(poly Polygon, split splitEdge) PolygonClassification {
 	if len(poly.Vertices) == 0 {
 		return PolygonCoplanar
 	}
 
 	frontCount := 0
 	backCount := 0
-	epsilon := float32(0.0001)
 
 	for _, v := range poly.Vertices {
-		side := line.PointSide(v)
-		if side > epsilon {
+		switch split.side(v) {
+		case 1:
 			frontCount++
-		} else if side < -epsilon {
+		case -1:
 			backCount++
 		}
 	}
@@ -354,64 +467,58 @@ func classifyPolygon(poly Polygon, line Line) PolygonClassification {
 // selectSplitLine chooses a splitting line from the polygon edges
 // This uses a simple heuristic: pick the first edge of the first polygon
 // A more sophisticated approach would evaluate multiple candidates
-func selectSplitLine(polygons []Polygon) Line {
+func selectSplitLine(polygons []Polygon) splitEdge {
 	if len(polygons) == 0 || len(polygons[0].Vertices) < 2 {
 		// Fallback: horizontal line at origin
-		return Line{Normal: Vector2{X: 0, Y: 1}, Distance: 0}
+		return splitEdge{a: Point{X: 0, Y: 0}, b: Point{X: 1, Y: 0}}
 	}
 
 	// Use the first edge of the first polygon
 	poly := polygons[0]
-	v1 := poly.Vertices[0]
-	v2 := poly.Vertices[1]
-
-	// Edge vector
-	edge := Vector2{X: v2.X - v1.X, Y: v2.Y - v1.Y}
-
-	// Normal is perpendicular to edge (rotate 90 degrees counter-clockwise)
-	normal := Vector2{X: -edge.Y, Y: edge.X}.Normalize()
-
-	// Distance is the dot product of normal with any point on the line
-	distance := normal.X*v1.X + normal.Y*v1.Y
-
-	return Line{Normal: normal, Distance: distance}
+	return splitEdge{a: poly.Vertices[0], b: poly.Vertices[1]}
 }
 
-// splitPolygon splits a polygon by a line into front and back parts
+// splitPolygon splits a polygon by a split edge into front and back parts
 // For convex polygons, this creates two convex sub-polygons
-func splitPolygon(poly Polygon, line Line) (*Polygon, *Polygon) {
+// Only edges whose endpoints lie strictly on opposite sides are cut, the crossing is computed in
+// float64 and rounded to float32 once
+func splitPolygon(poly Polygon, split splitEdge) (*Polygon, *Polygon) {
 	if len(poly.Vertices) < 3 {
 		return nil, nil
 	}
 
-	epsilon := float32(0.0001)
+	sides := make([]int, len(poly.Vertices))
+	distances := make([]float64, len(poly.Vertices))
+	for i, v := range poly.Vertices {
+		sides[i], distances[i] = orientDistance(split.a, split.b, v)
+	}
+
 	var frontVerts, backVerts []Point
 
 	for i := 0; i < len(poly.Vertices); i++ {
+		j := (i + 1) % len(poly.Vertices)
 		v1 := poly.Vertices[i]
-		v2 := poly.Vertices[(i+1)%len(poly.Vertices)]
-
-		side1 := line.PointSide(v1)
-		side2 := line.PointSide(v2)
+		v2 := poly.Vertices[j]
 
 		// Add v1 to appropriate list(s)
-		if side1 > epsilon {
+		switch sides[i] {
+		case 1:
 			frontVerts = append(frontVerts, v1)
-		} else if side1 < -epsilon {
+		case -1:
 			backVerts = append(backVerts, v1)
-		} else {
+		default:
 			// On the line - add to both
 			frontVerts = append(frontVerts, v1)
 			backVerts = append(backVerts, v1)
 		}
 
 		// Check if edge crosses the line
-		if (side1 > epsilon && side2 < -epsilon) || (side1 < -epsilon && side2 > epsilon) {
+		if sides[i]*sides[j] < 0 {
 			// Edge crosses - compute intersection point
-			t := side1 / (side1 - side2)
+			t := min(max(distances[i]/(distances[i]-distances[j]), 0), 1)
 			intersection := Point{
-				X: v1.X + t*(v2.X-v1.X),
-				Y: v1.Y + t*(v2.Y-v1.Y),
+				X: float32(float64(v1.X) + t*(float64(v2.X)-float64(v1.X))),
+				Y: float32(float64(v1.Y) + t*(float64(v2.Y)-float64(v1.Y))),
 			}
 			frontVerts = append(frontVerts, intersection)
 			backVerts = append(backVerts, intersection)
@@ -464,6 +571,28 @@ func PointInBSP(nodes []*pb.BSPNode, nodeIndex int32, point Point) bool {
 			return PointInBSP(nodes, split.BackIndex, point)
 		}
 
+	case *pb.BSPNode_AxisSplit:
+		// Axis-aligned split node: same sides as a split, one coordinate compare
+		if axisSplitSide(n.AxisSplit, point) > 0 {
+			return PointInBSP(nodes, n.AxisSplit.FrontIndex, point)
+		}
+		return PointInBSP(nodes, n.AxisSplit.BackIndex, point)
+
+	case *pb.BSPNode_Instance:
+		// Instance node: test the prefab in local space, then continue in world space
+		inst := n.Instance
+		if PointInBSP(nodes, inst.SubtreeIndex, instanceTransform(inst).Apply(point)) {
+			return true
+		}
+		return PointInBSP(nodes, inst.NextIndex, point)
+
+	case *pb.BSPNode_Circle:
+		// Circle node: solid inside, continue with the rest of the tree outside
+		if circleFromNode(n.Circle).Contains(point) {
+			return true
+		}
+		return PointInBSP(nodes, n.Circle.OutsideIndex, point)
+
 	default:
 		return false
 	}
@@ -473,32 +602,33 @@ func PointInBSP(nodes []*pb.BSPNode, nodeIndex int32, point Point) bool {
 // Returns true and hit point if the line hits solid geometry
 // The segment is defined by the parametric range [t0, t1] on the line from `from` to `to`
 func LineTraceBSPNode(nodes []*pb.BSPNode, nodeIndex int32, from, to Point, t0, t1 float32) (hit bool, hitX, hitY float32) {
-	if nodeIndex < 0 || int(nodeIndex) >= len(nodes) {
+	hit, t := lineTraceNode(nodes, nodeIndex, from, to, t0, t1)
+	if !hit {
 		return false, 0, 0
 	}
+	return true, from.X + t*(to.X-from.X), from.Y + t*(to.Y-from.Y)
+}
 
-	node := nodes[nodeIndex]
-	if node == nil {
-		return false, 0, 0
+// lineTraceNode is the recursive part of LineTraceBSPNode
+// It returns the parametric value of the first solid entry instead of a point,
+// because that value is the same in world space and in an instance's local space
+func lineTraceNode(nodes []*pb.BSPNode, nodeIndex int32, from, to Point, t0, t1 float32) (bool, float32) {
+	if nodeIndex < 0 || int(nodeIndex) >= len(nodes) {
+		return false, 0
 	}
 
-	// Compute the actual segment endpoints for this recursion level
-	p0 := Point{
-		X: from.X + t0*(to.X-from.X),
-		Y: from.Y + t0*(to.Y-from.Y),
-	}
-	p1 := Point{
-		X: from.X + t1*(to.X-from.X),
-		Y: from.Y + t1*(to.Y-from.Y),
+	node := nodes[nodeIndex]
+	if node == nil {
+		return false, 0
 	}
 
 	switch n := node.Type.(type) {
 	case *pb.BSPNode_Leaf:
 		if n.Leaf.IsSolid {
 			// Hit! Return the entry point of the line segment
-			return true, p0.X, p0.Y
+			return true, t0
 		}
-		return false, 0, 0
+		return false, 0
 
 	case *pb.BSPNode_Split:
 		split := n.Split
@@ -506,53 +636,121 @@ func LineTraceBSPNode(nodes []*pb.BSPNode, nodeIndex int32, from, to Point, t0,
 		normalY := split.NormalY
 		dist := split.Distance
 
+		// Compute the actual segment endpoints for this recursion level
+		p0 := Point{
+			X: from.X + t0*(to.X-from.X),
+			Y: from.Y + t0*(to.Y-from.Y),
+		}
+		p1 := Point{
+			X: from.X + t1*(to.X-from.X),
+			Y: from.Y + t1*(to.Y-from.Y),
+		}
+
 		// Calculate signed distance for the CURRENT segment endpoints
 		d0 := normalX*p0.X + normalY*p0.Y - dist
 		d1 := normalX*p1.X + normalY*p1.Y - dist
 
-		epsilon := float32(0.0001)
+		return lineTraceSplit(nodes, split.FrontIndex, split.BackIndex, d0, d1, from, to, t0, t1)
 
-		// Both points on front side
-		if d0 > epsilon && d1 > epsilon {
-			return LineTraceBSPNode(nodes, split.FrontIndex, from, to, t0, t1)
+	case *pb.BSPNode_AxisSplit:
+		// Only the split coordinate of the segment endpoints is needed
+		split := n.AxisSplit
+		c0 := from.X + t0*(to.X-from.X)
+		c1 := from.X + t1*(to.X-from.X)
+		if split.Axis == axisY {
+			c0 = from.Y + t0*(to.Y-from.Y)
+			c1 = from.Y + t1*(to.Y-from.Y)
 		}
-
-		// Both points on back side
-		if d0 <= epsilon && d1 <= epsilon {
-			return LineTraceBSPNode(nodes, split.BackIndex, from, to, t0, t1)
+		d0, d1 := c0-split.Threshold, c1-split.Threshold
+		if split.FrontBelow {
+			d0, d1 = -d0, -d1
 		}
 
-		// Line segment spans the plane - compute intersection
-		// t is the parametric value where the segment [p0, p1] crosses the plane
-		// At intersection: d0 + t*(d1-d0) = 0, so t = -d0 / (d1-d0)
-		t := -d0 / (d1 - d0)
+		return lineTraceSplit(nodes, split.FrontIndex, split.BackIndex, d0, d1, from, to, t0, t1)
 
-		// Map t from [0,1] on segment to the global parametric range
-		tMid := t0 + t*(t1-t0)
+	case *pb.BSPNode_Instance:
+		inst := n.Instance
 
-		// Determine traversal order (near to far based on segment start)
-		var nearIndex, farIndex int32
-		if d0 > 0 {
-			// Segment starts in front
-			nearIndex = split.FrontIndex
-			farIndex = split.BackIndex
-		} else {
-			// Segment starts in back
-			nearIndex = split.BackIndex
-			farIndex = split.FrontIndex
+		// Affine maps preserve the segment parameter, so the prefab can be traced in local space
+		worldToLocal := instanceTransform(inst)
+		localHit, localT := lineTraceNode(nodes, inst.SubtreeIndex, worldToLocal.Apply(from), worldToLocal.Apply(to), t0, t1)
+
+		// The rest of the world only matters if it is hit before the prefab
+		nextEnd := t1
+		if localHit {
+			nextEnd = localT
+		}
+		nextHit, nextT := lineTraceNode(nodes, inst.NextIndex, from, to, t0, nextEnd)
+		if nextHit && (!localHit || nextT < localT) {
+			return true, nextT
 		}
+		return localHit, localT
 
-		// Check near side first (from t0 to tMid)
-		hit, hitX, hitY = LineTraceBSPNode(nodes, nearIndex, from, to, t0, tMid)
-		if hit {
-			return true, hitX, hitY
+	case *pb.BSPNode_Circle:
+		// Exact segment-circle intersection, no planes involved
+		circleHit, circleT := traceCircle(circleFromNode(n.Circle), from, to, t0, t1)
+
+		// The rest of the world only matters if it is hit before the circle
+		outsideEnd := t1
+		if circleHit {
+			outsideEnd = circleT
+		}
+		if outsideHit, outsideT := lineTraceNode(nodes, n.Circle.OutsideIndex, from, to, t0, outsideEnd); outsideHit && (!circleHit || outsideT < circleT) {
+			return true, outsideT
 		}
+		return circleHit, circleT
+	}
+
+	return false, 0
+}
+
+// lineTraceSplit continues a line trace at a split node, given the signed distances
+// d0 and d1 of the segment endpoints at t0 and t1 to the split plane
+func lineTraceSplit(nodes []*pb.BSPNode, frontIdx, backIdx int32, d0, d1 float32, from, to Point, t0, t1 float32) (bool, float32) {
+	epsilon := float32(0.0001)
+
+	// Both points on front side
+	if d0 > epsilon && d1 > epsilon {
+		return lineTraceNode(nodes, frontIdx, from, to, t0, t1)
+	}
 
-		// Check far side (from tMid to t1)
-		return LineTraceBSPNode(nodes, farIndex, from, to, tMid, t1)
+	// Both points on back side
+	if d0 <= epsilon && d1 <= epsilon {
+		return lineTraceNode(nodes, backIdx, from, to, t0, t1)
 	}
 
-	return false, 0, 0
+	// One endpoint lies in front, but within epsilon: the segment never crosses the plane
+	if d0 > 0 && d1 > 0 {
+		return lineTraceNode(nodes, frontIdx, from, to, t0, t1)
+	}
+
+	// Line segment spans the plane - compute intersection
+	// t is the parametric value where the segment [p0, p1] crosses the plane
+	// At intersection: d0 + t*(d1-d0) = 0, so t = -d0 / (d1-d0)
+	t := -d0 / (d1 - d0)
+
+	// Map t from [0,1] on segment to the global parametric range
+	tMid := t0 + t*(t1-t0)
+
+	// Determine traversal order (near to far based on segment start)
+	var nearIndex, farIndex int32
+	if d0 > 0 {
+		// Segment starts in front
+		nearIndex = frontIdx
+		farIndex = backIdx
+	} else {
+		// Segment starts in back
+		nearIndex = backIdx
+		farIndex = frontIdx
+	}
+
+	// Check near side first (from t0 to tMid)
+	if hit, tHit := lineTraceNode(nodes, nearIndex, from, to, t0, tMid); hit {
+		return true, tHit
+	}
+
+	// Check far side (from tMid to t1)
+	return lineTraceNode(nodes, farIndex, from, to, tMid, t1)
 }
 
 // Helper functions for creating protobuf nodes in flat array
@@ -574,8 +772,14 @@ func (b *BSPBuilder) addLeafNode(sectorID int32, polygonIndices []int32, isSolid
 }
 
 // addSplitNode creates a new split node and adds it to the flat array
+// Planes with an exact axis normal are stored as axis-aligned split nodes
 func (b *BSPBuilder) addSplitNode(normalX, normalY, distance float32, frontIdx, backIdx int32) int32 {
 	idx := int32(len(b.nodes))
+	if split, ok := axisSplit(normalX, normalY, distance); ok {
+		split.FrontIndex, split.BackIndex = frontIdx, backIdx
+		b.nodes = append(b.nodes, &pb.BSPNode{Type: &pb.BSPNode_AxisSplit{AxisSplit: split}})
+		return idx
+	}
 	node := &pb.BSPNode{
 		Type: &pb.BSPNode_Split{
 			Split: &pb.Split{
@@ -591,6 +795,58 @@ func (b *BSPBuilder) addSplitNode(normalX, normalY, distance float32, frontIdx,
 	return idx
 }
 
+// axisSplit converts a plane with a normal of (±1, 0) or (0, ±1) into an axis-aligned split
+// Returns false for any other plane
+func axisSplit(normalX, normalY, distance float32) (*pb.AxisSplit, bool) {
+	switch {
+	case normalY == 0 && (normalX == 1 || normalX == -1):
+		return &pb.AxisSplit{Axis: axisX, Threshold: normalX * distance, FrontBelow: normalX < 0}, true
+	case normalX == 0 && (normalY == 1 || normalY == -1):
+		return &pb.AxisSplit{Axis: axisY, Threshold: normalY * distance, FrontBelow: normalY < 0}, true
+	}
+	return nil, false
+}
+
+// addInstanceNode creates a new instance node and adds it to the flat array
+// worldToLocal maps world space into the local space of the subtree
+func (b *BSPBuilder) addInstanceNode(subtreeIdx int32, worldToLocal Transform2D, nextIdx int32) int32 {
+	idx := int32(len(b.nodes))
+	node := &pb.BSPNode{
+		Type: &pb.BSPNode_Instance{
+			Instance: &pb.Instance{
+				SubtreeIndex: subtreeIdx,
+				M00:          worldToLocal.M00,
+				M01:          worldToLocal.M01,
+				M10:          worldToLocal.M10,
+				M11:          worldToLocal.M11,
+				Tx:           worldToLocal.TX,
+				Ty:           worldToLocal.TY,
+				NextIndex:    nextIdx,
+			},
+		},
+	}
+	b.nodes = append(b.nodes, node)
+	return idx
+}
+
+// addBoundsGuard wraps a subtree in four outward-facing planes of an axis-aligned box
+// Queries outside the box end in non-solid leaves after at most four plane tests
+func (b *BSPBuilder) addBoundsGuard(boundsMin, boundsMax Point, innerIdx int32) int32 {
+	// Front = outside the box
+	guards := []Line{
+		{Normal: Vector2{X: 1, Y: 0}, Distance: boundsMax.X},
+		{Normal: Vector2{X: -1, Y: 0}, Distance: -boundsMin.X},
+		{Normal: Vector2{X: 0, Y: 1}, Distance: boundsMax.Y},
+		{Normal: Vector2{X: 0, Y: -1}, Distance: -boundsMin.Y},
+	}
+	nodeIdx := innerIdx
+	for i := len(guards) - 1; i >= 0; i-- {
+		outsideIdx := b.addLeafNode(0, []int32{}, false)
+		nodeIdx = b.addSplitNode(guards[i].Normal.X, guards[i].Normal.Y, guards[i].Distance, outsideIdx, nodeIdx)
+	}
+	return nodeIdx
+}
+
 // NewLeafNode creates a new leaf node (deprecated - for backward compatibility)
 func NewLeafNode(sectorID int32, polygonIndices []int32, isSolid bool) *pb.BSPNode {
 	return &pb.BSPNode{
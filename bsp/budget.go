@@ -0,0 +1,454 @@
+package bsp
+
+import (
+	"fmt"
+	"math"
+	"slices"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// Budget limits the size of a built BSP tree
+// Zero means no limit
+type Budget struct {
+	MaxNodes int // Maximum number of nodes in the emitted node array
+	MaxDepth int // Maximum number of nodes visited by a single point query
+}
+
+// BudgetReport describes how a tree was fitted into its budget
+type BudgetReport struct {
+	Nodes      int  // Number of nodes in the emitted node array
+	Depth      int  // Longest point query path
+	Simplified bool // true if the geometry had to be simplified
+	// GeometricError is the largest distance (in world units) by which solid space grew
+	// It is estimated on a grid inside every simplified shape
+	GeometricError float32
+}
+
+// fits returns true if a tree of the given size is within the budget
+func (b Budget) fits(nodes, depth int) bool {
+	return (b.MaxNodes <= 0 || nodes <= b.MaxNodes) && (b.MaxDepth <= 0 || depth <= b.MaxDepth)
+}
+
+// budgetErrorSamples is the number of grid samples per axis used to estimate the geometric error
+const budgetErrorSamples = 9
+
+// budgetPiece is one convex solid shape in world space
+type budgetPiece struct {
+	polygon  []Point // CCW convex outline, nil if the piece is not a polygon
+	min, max Point
+	distance func(p Point) float32 // Distance from p to the piece, 0 inside
+
+	// Disc pieces (polygon == nil) are a local-space circle
+	circle       Circle
+	worldToLocal Transform2D
+}
+
+// budgetCluster is a group of pieces that is simplified as a whole
+type budgetCluster struct {
+	pieces   []budgetPiece
+	min, max Point
+}
+
+// BuildWithinBudget builds the BSP tree like Build, but makes sure it fits the budget
+// If the exact tree is too large, solid shapes are replaced by their bounding boxes and
+// neighboring boxes are merged until the tree fits. These simplifications only ever grow
+// solid space, they never turn solid space empty.
+// Returns an error if the tree does not fit even when all geometry is merged into a single box.
+// With a chunk size, the exact tree is chunk-stable (see BuildChunked), a simplified one is not.
+func (b *BSPBuilder) BuildWithinBudget(budget Budget) (*pb.LevelData, BudgetReport, error) {
+	exact := &BSPBuilder{Polygons: b.Polygons, Prefabs: b.Prefabs, Instances: b.Instances, Partitions: b.Partitions}
+	var levelData *pb.LevelData
+	if b.ChunkSize > 0 {
+		levelData = exact.BuildChunked(b.ChunkSize)
+	} else {
+		levelData = compactLevelData(exact.Build())
+	}
+	report := BudgetReport{
+		Nodes: len(levelData.Nodes),
+		Depth: TreeDepth(levelData.Nodes, levelData.RootIndex),
+	}
+	if budget.fits(report.Nodes, report.Depth) {
+		return levelData, report, nil
+	}
+
+	clusters := b.budgetClusters()
+	for {
+		simplified := &BSPBuilder{}
+		rootIndex, geometricError := simplified.buildClusterTrees(clusters)
+		levelData = compactLevelData(&pb.LevelData{Nodes: simplified.nodes, RootIndex: rootIndex})
+		report = BudgetReport{
+			Nodes:          len(levelData.Nodes),
+			Depth:          TreeDepth(levelData.Nodes, levelData.RootIndex),
+			Simplified:     true,
+			GeometricError: geometricError,
+		}
+		if budget.fits(report.Nodes, report.Depth) {
+			return levelData, report, nil
+		}
+
+		if len(clusters) <= 1 {
+			return nil, report, fmt.Errorf("BSP tree needs %d nodes and depth %d even when simplified to a single box, budget allows %d nodes and depth %d",
+				report.Nodes, report.Depth, budget.MaxNodes, budget.MaxDepth)
+		}
+		clusters = mergeClusters(clusters)
+	}
+}
+
+// budgetClusters collects all solid geometry as world-space convex pieces
+// World polygons start as one cluster per piece, every instance is one cluster
+func (b *BSPBuilder) budgetClusters() []budgetCluster {
+	var clusters []budgetCluster
+
+	for _, poly := range b.Polygons {
+		if !poly.IsSolid {
+			continue
+		}
+		for _, piece := range b.shapePieces(poly, Transform2D{M00: 1, M11: 1}) {
+			clusters = append(clusters, newBudgetCluster([]budgetPiece{piece}))
+		}
+	}
+
+	prefabPieces := make(map[string][]Polygon)
+	for _, inst := range b.Instances {
+		if inst.Transform.Determinant() == 0 {
+			continue
+		}
+		polygons, ok := prefabPieces[inst.Prefab]
+		if !ok {
+			polygons = b.Prefabs[inst.Prefab]
+			prefabPieces[inst.Prefab] = polygons
+		}
+
+		var pieces []budgetPiece
+		for _, poly := range polygons {
+			if poly.IsSolid {
+				pieces = append(pieces, b.shapePieces(poly, inst.Transform)...)
+			}
+		}
+		if len(pieces) > 0 {
+			clusters = append(clusters, newBudgetCluster(pieces))
+		}
+	}
+
+	return clusters
+}
+
+// shapePieces splits a solid polygon into world-space convex pieces, the same way the
+// exact build does (circle detection, then convex partitioning)
+func (b *BSPBuilder) shapePieces(poly Polygon, localToWorld Transform2D) []budgetPiece {
+	if circle, ok := DetectCircle(poly, CircleTolerance, CircleMinVertices); ok {
+		return []budgetPiece{ellipsePiece(circle, localToWorld)}
+	}
+
+	parts := b.convexParts(poly, localToWorld)
+	pieces := make([]budgetPiece, 0, len(parts))
+	for _, part := range parts {
+		pieces = append(pieces, polygonPiece(part))
+	}
+	return pieces
+}
+
+// convexParts partitions a polygon into convex parts and moves them into world space (CCW)
+func (b *BSPBuilder) convexParts(poly Polygon, localToWorld Transform2D) [][]Point {
+	partitioned, err := b.partition(poly)
+	if err != nil {
+		return nil
+	}
+
+	parts := make([][]Point, 0, len(partitioned))
+	for _, part := range partitioned {
+		if len(part.Vertices) < 3 {
+			continue
+		}
+		vertices := make([]Point, len(part.Vertices))
+		for i, v := range part.Vertices {
+			vertices[i] = localToWorld.Apply(v)
+		}
+		parts = append(parts, ensureCCW(Polygon{Vertices: vertices}).Vertices)
+	}
+	return parts
+}
+
+// polygonPiece creates a piece from a CCW convex polygon
+func polygonPiece(vertices []Point) budgetPiece {
+	piece := budgetPiece{
+		polygon: vertices,
+		min:     vertices[0],
+		max:     vertices[0],
+		distance: func(p Point) float32 {
+			return convexPolygonDistance(vertices, p)
+		},
+	}
+	for _, v := range vertices[1:] {
+		piece.min.X = min(piece.min.X, v.X)
+		piece.min.Y = min(piece.min.Y, v.Y)
+		piece.max.X = max(piece.max.X, v.X)
+		piece.max.Y = max(piece.max.Y, v.Y)
+	}
+	return piece
+}
+
+// ellipsePiece creates a piece from a local-space circle
+// The distance is measured in local space and scaled by the largest stretch of the transform,
+// which overestimates it for non-uniform scales
+func ellipsePiece(circle Circle, localToWorld Transform2D) budgetPiece {
+	center := localToWorld.Apply(circle.Center)
+	halfX := circle.Radius * float32(math.Hypot(float64(localToWorld.M00), float64(localToWorld.M01)))
+	halfY := circle.Radius * float32(math.Hypot(float64(localToWorld.M10), float64(localToWorld.M11)))
+
+	// Largest singular value of the linear part
+	m := localToWorld
+	sum := float64(m.M00*m.M00 + m.M01*m.M01 + m.M10*m.M10 + m.M11*m.M11)
+	det := float64(m.Determinant())
+	stretch := float32(math.Sqrt((sum + math.Sqrt(max(0, sum*sum-4*det*det))) / 2))
+
+	worldToLocal := localToWorld.Inverse()
+	return budgetPiece{
+		min:          Point{X: center.X - halfX, Y: center.Y - halfY},
+		max:          Point{X: center.X + halfX, Y: center.Y + halfY},
+		circle:       circle,
+		worldToLocal: worldToLocal,
+		distance: func(p Point) float32 {
+			local := worldToLocal.Apply(p)
+			d := float32(math.Hypot(float64(local.X-circle.Center.X), float64(local.Y-circle.Center.Y))) - circle.Radius
+			return max(0, d) * stretch
+		},
+	}
+}
+
+// newBudgetCluster creates a cluster and computes its bounds
+func newBudgetCluster(pieces []budgetPiece) budgetCluster {
+	cluster := budgetCluster{pieces: pieces, min: pieces[0].min, max: pieces[0].max}
+	for _, piece := range pieces[1:] {
+		cluster.min.X = min(cluster.min.X, piece.min.X)
+		cluster.min.Y = min(cluster.min.Y, piece.min.Y)
+		cluster.max.X = max(cluster.max.X, piece.max.X)
+		cluster.max.Y = max(cluster.max.Y, piece.max.Y)
+	}
+	return cluster
+}
+
+// buildClusterTrees builds one tree per cluster and merges them
+// Single triangles and quads are cheaper exact than as a box, so they stay exact
+// Returns the root and the estimated geometric error
+func (b *BSPBuilder) buildClusterTrees(clusters []budgetCluster) (int32, float32) {
+	var geometricError float32
+	var trees []int32
+	for _, cluster := range clusters {
+		if len(cluster.pieces) == 1 && cluster.pieces[0].polygon != nil && len(cluster.pieces[0].polygon) <= 4 {
+			trees = append(trees, b.buildConvexPolygonTree(Polygon{Vertices: cluster.pieces[0].polygon, IsSolid: true}))
+			continue
+		}
+
+		box := Polygon{
+			Vertices: []Point{
+				{X: cluster.min.X, Y: cluster.min.Y},
+				{X: cluster.max.X, Y: cluster.min.Y},
+				{X: cluster.max.X, Y: cluster.max.Y},
+				{X: cluster.min.X, Y: cluster.max.Y},
+			},
+			IsSolid: true,
+		}
+		trees = append(trees, b.buildConvexPolygonTree(box))
+		geometricError = max(geometricError, clusterError(cluster))
+	}
+	return b.mergeTrees(trees), geometricError
+}
+
+// clusterError estimates how far the bounding box of a cluster reaches beyond its pieces
+func clusterError(cluster budgetCluster) float32 {
+	var worst float32
+	for i := 0; i < budgetErrorSamples; i++ {
+		for j := 0; j < budgetErrorSamples; j++ {
+			p := Point{
+				X: cluster.min.X + (cluster.max.X-cluster.min.X)*float32(i)/(budgetErrorSamples-1),
+				Y: cluster.min.Y + (cluster.max.Y-cluster.min.Y)*float32(j)/(budgetErrorSamples-1),
+			}
+			nearest := float32(math.Inf(1))
+			for _, piece := range cluster.pieces {
+				nearest = min(nearest, piece.distance(p))
+			}
+			worst = max(worst, nearest)
+		}
+	}
+	return worst
+}
+
+// mergeClusters halves the number of clusters by merging spatial neighbors
+// Clusters are ordered along a Z-order curve, then consecutive pairs are merged
+func mergeClusters(clusters []budgetCluster) []budgetCluster {
+	worldMin := clusters[0].min
+	worldMax := clusters[0].max
+	for _, c := range clusters[1:] {
+		worldMin.X = min(worldMin.X, c.min.X)
+		worldMin.Y = min(worldMin.Y, c.min.Y)
+		worldMax.X = max(worldMax.X, c.max.X)
+		worldMax.Y = max(worldMax.Y, c.max.Y)
+	}
+
+	type keyed struct {
+		cluster budgetCluster
+		key     uint32
+	}
+	ordered := make([]keyed, len(clusters))
+	for i, c := range clusters {
+		center := Point{X: (c.min.X + c.max.X) / 2, Y: (c.min.Y + c.max.Y) / 2}
+		ordered[i] = keyed{cluster: c, key: mortonCode(center, worldMin, worldMax)}
+	}
+	slices.SortStableFunc(ordered, func(a, b keyed) int {
+		if a.key < b.key {
+			return -1
+		} else if a.key > b.key {
+			return 1
+		}
+		return 0
+	})
+
+	merged := make([]budgetCluster, 0, (len(ordered)+1)/2)
+	for i := 0; i < len(ordered); i += 2 {
+		if i+1 == len(ordered) {
+			merged = append(merged, ordered[i].cluster)
+			break
+		}
+		pieces := append(slices.Clip(ordered[i].cluster.pieces), ordered[i+1].cluster.pieces...)
+		merged = append(merged, newBudgetCluster(pieces))
+	}
+	return merged
+}
+
+// mortonCode interleaves the bits of a point quantized to 16 bits per axis within the bounds
+func mortonCode(p, boundsMin, boundsMax Point) uint32 {
+	quantize := func(v, lo, hi float32) uint32 {
+		if hi <= lo {
+			return 0
+		}
+		return uint32(min(max((v-lo)/(hi-lo), 0), 1) * 0xFFFF)
+	}
+	spread := func(v uint32) uint32 {
+		v = (v | (v << 8)) & 0x00FF00FF
+		v = (v | (v << 4)) & 0x0F0F0F0F
+		v = (v | (v << 2)) & 0x33333333
+		v = (v | (v << 1)) & 0x55555555
+		return v
+	}
+	return spread(quantize(p.X, boundsMin.X, boundsMax.X)) | spread(quantize(p.Y, boundsMin.Y, boundsMax.Y))<<1
+}
+
+// convexPolygonDistance returns the distance from p to a CCW convex polygon, 0 inside
+func convexPolygonDistance(vertices []Point, p Point) float32 {
+	inside := true
+	nearest := float32(math.Inf(1))
+	n := len(vertices)
+	for i := 0; i < n; i++ {
+		a := vertices[i]
+		b := vertices[(i+1)%n]
+		if (b.X-a.X)*(p.Y-a.Y)-(b.Y-a.Y)*(p.X-a.X) < 0 {
+			inside = false
+		}
+		nearest = min(nearest, pointSegmentDistance(p, a, b))
+	}
+	if inside {
+		return 0
+	}
+	return nearest
+}
+
+// pointSegmentDistance returns the distance from p to the segment a-b
+func pointSegmentDistance(p, a, b Point) float32 {
+	abX, abY := b.X-a.X, b.Y-a.Y
+	lengthSq := abX*abX + abY*abY
+	t := float32(0)
+	if lengthSq > 0 {
+		t = min(max(((p.X-a.X)*abX+(p.Y-a.Y)*abY)/lengthSq, 0), 1)
+	}
+	dx := p.X - (a.X + t*abX)
+	dy := p.Y - (a.Y + t*abY)
+	return float32(math.Sqrt(float64(dx*dx + dy*dy)))
+}
+
+// compactLevelData drops nodes that are not reachable from the root
+// Merging trees leaves the replaced copies behind in the node array
+func compactLevelData(levelData *pb.LevelData) *pb.LevelData {
+	remap := make(map[int32]int32)
+	var nodes []*pb.BSPNode
+
+	var visit func(idx int32) int32
+	visit = func(idx int32) int32 {
+		if newIdx, ok := remap[idx]; ok {
+			return newIdx
+		}
+		if idx < 0 || int(idx) >= len(levelData.Nodes) {
+			return idx
+		}
+
+		var node *pb.BSPNode
+		switch n := levelData.Nodes[idx].Type.(type) {
+		case *pb.BSPNode_Split:
+			split := *n.Split
+			split.FrontIndex = visit(n.Split.FrontIndex)
+			split.BackIndex = visit(n.Split.BackIndex)
+			node = &pb.BSPNode{Type: &pb.BSPNode_Split{Split: &split}}
+		case *pb.BSPNode_AxisSplit:
+			split := *n.AxisSplit
+			split.FrontIndex = visit(n.AxisSplit.FrontIndex)
+			split.BackIndex = visit(n.AxisSplit.BackIndex)
+			node = &pb.BSPNode{Type: &pb.BSPNode_AxisSplit{AxisSplit: &split}}
+		case *pb.BSPNode_Instance:
+			inst := *n.Instance
+			inst.SubtreeIndex = visit(n.Instance.SubtreeIndex)
+			inst.NextIndex = visit(n.Instance.NextIndex)
+			node = &pb.BSPNode{Type: &pb.BSPNode_Instance{Instance: &inst}}
+		case *pb.BSPNode_Circle:
+			circle := *n.Circle
+			circle.OutsideIndex = visit(n.Circle.OutsideIndex)
+			node = &pb.BSPNode{Type: &pb.BSPNode_Circle{Circle: &circle}}
+		default:
+			node = levelData.Nodes[idx]
+		}
+
+		// Children first, so every node points backwards in the array
+		newIdx := int32(len(nodes))
+		nodes = append(nodes, node)
+		remap[idx] = newIdx
+		return newIdx
+	}
+
+	rootIndex := visit(levelData.RootIndex)
+	return &pb.LevelData{
+		Nodes:     nodes,
+		RootIndex: rootIndex,
+	}
+}
+
+// TreeDepth returns the number of nodes on the longest point query path
+// Instances and circles continue the query after their shape, so those paths add up
+func TreeDepth(nodes []*pb.BSPNode, rootIndex int32) int {
+	memo := make(map[int32]int)
+
+	var depth func(idx int32) int
+	depth = func(idx int32) int {
+		if idx < 0 || int(idx) >= len(nodes) {
+			return 0
+		}
+		if d, ok := memo[idx]; ok {
+			return d
+		}
+
+		d := 1
+		switch n := nodes[idx].Type.(type) {
+		case *pb.BSPNode_Split:
+			d += max(depth(n.Split.FrontIndex), depth(n.Split.BackIndex))
+		case *pb.BSPNode_AxisSplit:
+			d += max(depth(n.AxisSplit.FrontIndex), depth(n.AxisSplit.BackIndex))
+		case *pb.BSPNode_Instance:
+			d += depth(n.Instance.SubtreeIndex) + depth(n.Instance.NextIndex)
+		case *pb.BSPNode_Circle:
+			d += depth(n.Circle.OutsideIndex)
+		}
+		memo[idx] = d
+		return d
+	}
+
+	return depth(rootIndex)
+}
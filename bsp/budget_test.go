@@ -0,0 +1,80 @@
+package bsp
+
+import (
+	"testing"
+)
+
+// budgetTestPolygons returns a row of L-shaped walls and round pillars
+func budgetTestPolygons() []Polygon {
+	var polygons []Polygon
+	for i := 0; i < 10; i++ {
+		x := float32(i * 5)
+		polygons = append(polygons, Polygon{
+			Vertices: []Point{
+				{X: x, Y: 0}, {X: x + 3, Y: 0}, {X: x + 3, Y: 1},
+				{X: x + 1, Y: 1}, {X: x + 1, Y: 3}, {X: x, Y: 3},
+			},
+			IsSolid: true,
+		})
+		polygons = append(polygons, regularPolygon(Point{X: x + 2.5, Y: 6}, 1, 32))
+	}
+	return polygons
+}
+
+func TestBuildWithinBudget(t *testing.T) {
+	polygons := budgetTestPolygons()
+
+	t.Run("Unlimited budget is exact", func(t *testing.T) {
+		levelData, report, err := NewBSPBuilder(polygons).BuildWithinBudget(Budget{})
+		if err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+		if report.Simplified || report.GeometricError != 0 {
+			t.Errorf("Expected an exact tree, got %+v", report)
+		}
+		if report.Nodes != len(levelData.Nodes) {
+			t.Errorf("Report says %d nodes, level data has %d", report.Nodes, len(levelData.Nodes))
+		}
+	})
+
+	t.Run("Tight budget simplifies conservatively", func(t *testing.T) {
+		_, exact, err := NewBSPBuilder(polygons).BuildWithinBudget(Budget{})
+		if err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+
+		budget := Budget{MaxNodes: exact.Nodes / 4, MaxDepth: exact.Depth / 4}
+		levelData, report, err := NewBSPBuilder(polygons).BuildWithinBudget(budget)
+		if err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+		if !report.Simplified {
+			t.Fatal("Expected the tree to be simplified")
+		}
+		if report.Nodes > budget.MaxNodes || report.Depth > budget.MaxDepth {
+			t.Errorf("Tree with %d nodes and depth %d exceeds budget %+v", report.Nodes, report.Depth, budget)
+		}
+		if got := TreeDepth(levelData.Nodes, levelData.RootIndex); got != report.Depth {
+			t.Errorf("Report says depth %d, tree has %d", report.Depth, got)
+		}
+		if report.GeometricError <= 0 {
+			t.Error("Expected a positive geometric error")
+		}
+
+		// Solid space must never become empty
+		for i := 0; i < 10; i++ {
+			x := float32(i * 5)
+			for _, p := range []Point{{X: x + 0.5, Y: 2.5}, {X: x + 2.5, Y: 0.5}, {X: x + 2.5, Y: 6}, {X: x + 3.2, Y: 6.3}} {
+				if !PointInBSP(levelData.Nodes, levelData.RootIndex, p) {
+					t.Errorf("Point %v became empty", p)
+				}
+			}
+		}
+	})
+
+	t.Run("Impossible budget fails", func(t *testing.T) {
+		if _, _, err := NewBSPBuilder(polygons).BuildWithinBudget(Budget{MaxNodes: 3}); err == nil {
+			t.Error("Expected an error for a budget no tree can fit")
+		}
+	})
+}
@@ -0,0 +1,403 @@
+package bsp
+
+import (
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+const (
+	// bvhBins is the number of SAH buckets per axis
+	bvhBins = 16
+	// bvhMaxLeafPieces forces a split of larger leaves, even if SAH prefers a leaf
+	bvhMaxLeafPieces = 8
+	// bvhTraversalCost is the cost of visiting a node, relative to testing one piece
+	bvhTraversalCost = 0.5
+)
+
+// bvhBin is a SAH bucket of pieces
+type bvhBin struct {
+	count    int
+	min, max Point
+}
+
+// bvhItem is a piece while the hierarchy is built
+type bvhItem struct {
+	piece    budgetPiece
+	centroid Point
+}
+
+// BuildBVH builds a bounding volume hierarchy over the same convex pieces the BSP tree is built from
+// The hierarchy is split with a binned surface area heuristic (perimeter in 2D)
+// Returns nil if there is no solid geometry
+func (b *BSPBuilder) BuildBVH() *pb.CollisionBVH {
+	var items []bvhItem
+	for _, cluster := range b.budgetClusters() {
+		for _, piece := range cluster.pieces {
+			items = append(items, bvhItem{
+				piece:    piece,
+				centroid: Point{X: (piece.min.X + piece.max.X) / 2, Y: (piece.min.Y + piece.max.Y) / 2},
+			})
+		}
+	}
+	if len(items) == 0 {
+		return nil
+	}
+
+	bvh := &pb.CollisionBVH{}
+	buildBVHNode(bvh, items)
+	return bvh
+}
+
+// buildBVHNode appends the subtree over items depth-first and returns its index
+func buildBVHNode(bvh *pb.CollisionBVH, items []bvhItem) int32 {
+	idx := int32(len(bvh.Nodes))
+	node := &pb.BVHNode{}
+	bvh.Nodes = append(bvh.Nodes, node)
+
+	boundsMin, boundsMax := items[0].piece.min, items[0].piece.max
+	centroidMin, centroidMax := items[0].centroid, items[0].centroid
+	for _, item := range items[1:] {
+		boundsMin = Point{X: min(boundsMin.X, item.piece.min.X), Y: min(boundsMin.Y, item.piece.min.Y)}
+		boundsMax = Point{X: max(boundsMax.X, item.piece.max.X), Y: max(boundsMax.Y, item.piece.max.Y)}
+		centroidMin = Point{X: min(centroidMin.X, item.centroid.X), Y: min(centroidMin.Y, item.centroid.Y)}
+		centroidMax = Point{X: max(centroidMax.X, item.centroid.X), Y: max(centroidMax.Y, item.centroid.Y)}
+	}
+	node.MinX, node.MinY = boundsMin.X, boundsMin.Y
+	node.MaxX, node.MaxY = boundsMax.X, boundsMax.Y
+
+	left, right := splitBVHItems(items, boundsMin, boundsMax, centroidMin, centroidMax)
+	if left == nil {
+		node.FirstPiece = int32(len(bvh.Pieces))
+		node.PieceCount = int32(len(items))
+		for _, item := range items {
+			appendBVHPiece(bvh, item.piece)
+		}
+		return idx
+	}
+
+	buildBVHNode(bvh, left)
+	node.RightIndex = buildBVHNode(bvh, right)
+	return idx
+}
+
+// splitBVHItems finds the cheapest binned SAH split of the items
+// Returns nil, nil if a leaf is cheaper
+func splitBVHItems(items []bvhItem, boundsMin, boundsMax, centroidMin, centroidMax Point) ([]bvhItem, []bvhItem) {
+	if len(items) == 1 {
+		return nil, nil
+	}
+
+	axisOf := func(p Point, axis int) float32 {
+		if axis == 0 {
+			return p.X
+		}
+		return p.Y
+	}
+
+	bestCost := float32(len(items)) * halfPerimeter(boundsMin, boundsMax)
+	bestAxis, bestSplit := -1, 0
+	for axis := 0; axis < 2; axis++ {
+		lo, hi := axisOf(centroidMin, axis), axisOf(centroidMax, axis)
+		if hi <= lo {
+			continue
+		}
+
+		var bins [bvhBins]bvhBin
+		for _, item := range items {
+			i := binIndex(axisOf(item.centroid, axis), lo, hi)
+			if bins[i].count == 0 {
+				bins[i].min, bins[i].max = item.piece.min, item.piece.max
+			} else {
+				bins[i].min = Point{X: min(bins[i].min.X, item.piece.min.X), Y: min(bins[i].min.Y, item.piece.min.Y)}
+				bins[i].max = Point{X: max(bins[i].max.X, item.piece.max.X), Y: max(bins[i].max.Y, item.piece.max.Y)}
+			}
+			bins[i].count++
+		}
+
+		// Sweep from the right to get the cost of every right side, then from the left
+		var rightCost [bvhBins]float32
+		var acc bvhBin
+		for i := bvhBins - 1; i > 0; i-- {
+			acc = mergeBin(acc, bins[i])
+			rightCost[i] = float32(acc.count) * halfPerimeter(acc.min, acc.max)
+		}
+		acc = bvhBin{}
+		for split := 1; split < bvhBins; split++ {
+			acc = mergeBin(acc, bins[split-1])
+			if acc.count == 0 || acc.count == len(items) {
+				continue
+			}
+			cost := bvhTraversalCost*halfPerimeter(boundsMin, boundsMax) + float32(acc.count)*halfPerimeter(acc.min, acc.max) + rightCost[split]
+			if cost < bestCost {
+				bestCost, bestAxis, bestSplit = cost, axis, split
+			}
+		}
+	}
+
+	if bestAxis < 0 {
+		if len(items) <= bvhMaxLeafPieces {
+			return nil, nil
+		}
+		// Identical centroids, split by count to keep leaves small
+		mid := len(items) / 2
+		return items[:mid:mid], items[mid:]
+	}
+
+	lo, hi := axisOf(centroidMin, bestAxis), axisOf(centroidMax, bestAxis)
+	var left, right []bvhItem
+	for _, item := range items {
+		if binIndex(axisOf(item.centroid, bestAxis), lo, hi) < bestSplit {
+			left = append(left, item)
+		} else {
+			right = append(right, item)
+		}
+	}
+	return left, right
+}
+
+// mergeBin combines the counts and bounds of two SAH bins
+func mergeBin(a, b bvhBin) bvhBin {
+	if a.count == 0 {
+		return b
+	}
+	if b.count == 0 {
+		return a
+	}
+	return bvhBin{
+		count: a.count + b.count,
+		min:   Point{X: min(a.min.X, b.min.X), Y: min(a.min.Y, b.min.Y)},
+		max:   Point{X: max(a.max.X, b.max.X), Y: max(a.max.Y, b.max.Y)},
+	}
+}
+
+// binIndex maps a centroid coordinate to its SAH bin
+func binIndex(v, lo, hi float32) int {
+	i := int(float32(bvhBins) * (v - lo) / (hi - lo))
+	return min(max(i, 0), bvhBins-1)
+}
+
+// halfPerimeter is the 2D surface area heuristic measure of a box
+func halfPerimeter(boundsMin, boundsMax Point) float32 {
+	return (boundsMax.X - boundsMin.X) + (boundsMax.Y - boundsMin.Y)
+}
+
+// appendBVHPiece stores a piece and its vertices
+func appendBVHPiece(bvh *pb.CollisionBVH, piece budgetPiece) {
+	if piece.polygon != nil {
+		bvh.Pieces = append(bvh.Pieces, &pb.ConvexPiece{
+			FirstVertex: int32(len(bvh.Vertices) / 2),
+			VertexCount: int32(len(piece.polygon)),
+		})
+		for _, v := range piece.polygon {
+			bvh.Vertices = append(bvh.Vertices, v.X, v.Y)
+		}
+		return
+	}
+
+	t := piece.worldToLocal
+	bvh.Pieces = append(bvh.Pieces, &pb.ConvexPiece{
+		CenterX: piece.circle.Center.X,
+		CenterY: piece.circle.Center.Y,
+		Radius:  piece.circle.Radius,
+		M00:     t.M00,
+		M01:     t.M01,
+		M10:     t.M10,
+		M11:     t.M11,
+		Tx:      t.TX,
+		Ty:      t.TY,
+	})
+}
+
+// bvhStackSize is the initial traversal stack capacity, enough for typical hierarchies
+const bvhStackSize = 64
+
+// PointInBVH tests if a point is inside solid geometry using the BVH
+// Points on the boundary of a piece are inside, like in the BSP tree
+func PointInBVH(bvh *pb.CollisionBVH, point Point) bool {
+	if bvh == nil || len(bvh.Nodes) == 0 {
+		return false
+	}
+
+	stack := make([]int32, 1, bvhStackSize)
+	for len(stack) > 0 {
+		idx := stack[len(stack)-1]
+		stack = stack[:len(stack)-1]
+		node := bvh.Nodes[idx]
+		if point.X < node.MinX || point.X > node.MaxX || point.Y < node.MinY || point.Y > node.MaxY {
+			continue
+		}
+
+		if node.PieceCount > 0 {
+			for _, piece := range bvh.Pieces[node.FirstPiece : node.FirstPiece+node.PieceCount] {
+				if pieceContains(bvh, piece, point) {
+					return true
+				}
+			}
+			continue
+		}
+
+		stack = append(stack, idx+1, node.RightIndex)
+	}
+	return false
+}
+
+// LineTraceBVH traces a line segment through the BVH
+// Returns true and the first solid point if the segment hits solid geometry
+// The segment is defined by the parametric range [t0, t1] on the line from `from` to `to`
+func LineTraceBVH(bvh *pb.CollisionBVH, from, to Point, t0, t1 float32) (hit bool, hitX, hitY float32) {
+	if bvh == nil || len(bvh.Nodes) == 0 {
+		return false, 0, 0
+	}
+
+	d := Point{X: to.X - from.X, Y: to.Y - from.Y}
+	best := t1
+
+	stack := make([]int32, 1, bvhStackSize)
+	for len(stack) > 0 {
+		idx := stack[len(stack)-1]
+		stack = stack[:len(stack)-1]
+		node := bvh.Nodes[idx]
+
+		// Nodes entered after the closest hit so far cannot contain a closer one
+		if _, ok := segmentBoxEntry(node, from, d, t0, best); !ok {
+			continue
+		}
+
+		if node.PieceCount > 0 {
+			for _, piece := range bvh.Pieces[node.FirstPiece : node.FirstPiece+node.PieceCount] {
+				if pieceHit, t := tracePiece(bvh, piece, from, to, t0, best); pieceHit && (!hit || t < best) {
+					hit, best = true, t
+				}
+			}
+			continue
+		}
+
+		// Visit the nearer child first, so the farther one can be pruned by its hit
+		near, far := idx+1, node.RightIndex
+		nearEntry, nearOK := segmentBoxEntry(bvh.Nodes[near], from, d, t0, best)
+		farEntry, farOK := segmentBoxEntry(bvh.Nodes[far], from, d, t0, best)
+		if farOK && (!nearOK || farEntry < nearEntry) {
+			near, far = far, near
+			nearOK, farOK = farOK, nearOK
+		}
+		if farOK {
+			stack = append(stack, far)
+		}
+		if nearOK {
+			stack = append(stack, near)
+		}
+	}
+
+	if !hit {
+		return false, 0, 0
+	}
+	return true, from.X + best*d.X, from.Y + best*d.Y
+}
+
+// segmentBoxEntry clips the segment range [t0, t1] against the box of a node (slab test)
+// Returns the entry parameter and true if the segment touches the box
+func segmentBoxEntry(node *pb.BVHNode, from, d Point, t0, t1 float32) (float32, bool) {
+	return segmentRangeInBox(Point{X: node.MinX, Y: node.MinY}, Point{X: node.MaxX, Y: node.MaxY}, from, d, t0, t1)
+}
+
+// segmentRangeInBox clips the segment range [t0, t1] against a box (slab test)
+// Returns the entry parameter and true if the segment touches the box
+func segmentRangeInBox(boxMin, boxMax, from, d Point, t0, t1 float32) (float32, bool) {
+	enter, exit := t0, t1
+	for axis := 0; axis < 2; axis++ {
+		origin, dir, lo, hi := from.X, d.X, boxMin.X, boxMax.X
+		if axis == 1 {
+			origin, dir, lo, hi = from.Y, d.Y, boxMin.Y, boxMax.Y
+		}
+		if dir == 0 {
+			if origin < lo || origin > hi {
+				return 0, false
+			}
+			continue
+		}
+		ta := (lo - origin) / dir
+		tb := (hi - origin) / dir
+		if ta > tb {
+			ta, tb = tb, ta
+		}
+		enter = max(enter, ta)
+		exit = min(exit, tb)
+		if enter > exit {
+			return 0, false
+		}
+	}
+	return enter, true
+}
+
+// pieceContains tests if a point is inside or on a piece
+func pieceContains(bvh *pb.CollisionBVH, piece *pb.ConvexPiece, p Point) bool {
+	if piece.VertexCount == 0 {
+		return pieceCircle(piece).Contains(pieceTransform(piece).Apply(p))
+	}
+
+	vertices := bvh.Vertices[2*piece.FirstVertex : 2*(piece.FirstVertex+piece.VertexCount)]
+	n := int(piece.VertexCount)
+	for i := 0; i < n; i++ {
+		j := (i + 1) % n
+		a := Point{X: vertices[2*i], Y: vertices[2*i+1]}
+		b := Point{X: vertices[2*j], Y: vertices[2*j+1]}
+		if orient2d(a, b, p) < 0 {
+			return false
+		}
+	}
+	return true
+}
+
+// tracePiece returns the parameter where the segment range [t0, t1] first touches a piece
+func tracePiece(bvh *pb.CollisionBVH, piece *pb.ConvexPiece, from, to Point, t0, t1 float32) (bool, float32) {
+	if piece.VertexCount == 0 {
+		// Affine maps preserve the segment parameter, so the disc is traced in local space
+		worldToLocal := pieceTransform(piece)
+		return traceCircle(pieceCircle(piece), worldToLocal.Apply(from), worldToLocal.Apply(to), t0, t1)
+	}
+
+	// Cyrus-Beck clipping against the edges of the CCW outline
+	d := Point{X: to.X - from.X, Y: to.Y - from.Y}
+	enter, exit := t0, t1
+	vertices := bvh.Vertices[2*piece.FirstVertex : 2*(piece.FirstVertex+piece.VertexCount)]
+	n := int(piece.VertexCount)
+	for i := 0; i < n; i++ {
+		j := (i + 1) % n
+		a := Point{X: vertices[2*i], Y: vertices[2*i+1]}
+		b := Point{X: vertices[2*j], Y: vertices[2*j+1]}
+
+		// Outward normal of a CCW edge, inside where normal . (p - a) <= 0
+		normal := Point{X: b.Y - a.Y, Y: a.X - b.X}
+		num := normal.X*(from.X-a.X) + normal.Y*(from.Y-a.Y)
+		denom := normal.X*d.X + normal.Y*d.Y
+		if denom == 0 {
+			if num > 0 {
+				return false, 0
+			}
+			continue
+		}
+		t := -num / denom
+		if denom < 0 {
+			enter = max(enter, t)
+		} else {
+			exit = min(exit, t)
+		}
+		if enter > exit {
+			return false, 0
+		}
+	}
+	return true, enter
+}
+
+// pieceCircle reads the local-space disc of a piece
+func pieceCircle(piece *pb.ConvexPiece) Circle {
+	return Circle{Center: Point{X: piece.CenterX, Y: piece.CenterY}, Radius: piece.Radius}
+}
+
+// pieceTransform reads the world-to-local transform of a disc piece
+func pieceTransform(piece *pb.ConvexPiece) Transform2D {
+	return Transform2D{
+		M00: piece.M00, M01: piece.M01,
+		M10: piece.M10, M11: piece.M11,
+		TX: piece.Tx, TY: piece.Ty,
+	}
+}
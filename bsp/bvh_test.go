@@ -0,0 +1,151 @@
+package bsp
+
+import (
+	"math"
+	"math/rand"
+	"testing"
+)
+
+// bvhTestBuilder returns a builder with world geometry, circles and rotated prefab instances
+func bvhTestBuilder() *BSPBuilder {
+	builder := NewBSPBuilder(budgetTestPolygons())
+	builder.Prefabs = map[string][]Polygon{
+		"crate":  unitBoxPrefab,
+		"barrel": {regularPolygon(Point{X: 0, Y: 0}, 0.5, 32)},
+	}
+	builder.Instances = []Instance{
+		{Prefab: "crate", Transform: NewTransform2D(Point{X: 10, Y: -5}, 30, Vector2{X: 2, Y: 1})},
+		{Prefab: "crate", Transform: NewTransform2D(Point{X: 30, Y: -5}, 90, Vector2{X: 4, Y: 1})},
+		{Prefab: "barrel", Transform: NewTransform2D(Point{X: 20, Y: -5}, 45, Vector2{X: 3, Y: 1})},
+	}
+	return builder
+}
+
+func TestBVHMatchesBSP(t *testing.T) {
+	levelData := bvhTestBuilder().Build()
+	bvh := bvhTestBuilder().BuildBVH()
+	if len(bvh.Nodes) == 0 || len(bvh.Pieces) == 0 {
+		t.Fatalf("Expected a BVH, got %d nodes and %d pieces", len(bvh.Nodes), len(bvh.Pieces))
+	}
+
+	// Grid offsets keep the samples off the axis-aligned edges
+	for y := float32(-8.13); y < 9; y += 0.31 {
+		for x := float32(-2.07); x < 52; x += 0.29 {
+			p := Point{X: x, Y: y}
+			want := PointInBSP(levelData.Nodes, levelData.RootIndex, p)
+			if got := PointInBVH(bvh, p); got != want {
+				t.Errorf("Point (%.2f, %.2f): BVH says solid=%v, BSP says %v", x, y, got, want)
+			}
+		}
+	}
+
+	rng := rand.New(rand.NewSource(7))
+	for i := 0; i < 500; i++ {
+		from := Point{X: rng.Float32()*56 - 3, Y: rng.Float32()*18 - 9}
+		to := Point{X: rng.Float32()*56 - 3, Y: rng.Float32()*18 - 9}
+		wantHit, wantX, wantY := LineTraceBSPNode(levelData.Nodes, levelData.RootIndex, from, to, 0, 1)
+		gotHit, gotX, gotY := LineTraceBVH(bvh, from, to, 0, 1)
+		if gotHit != wantHit {
+			t.Errorf("Trace (%.2f, %.2f) -> (%.2f, %.2f): BVH hit=%v, BSP hit=%v", from.X, from.Y, to.X, to.Y, gotHit, wantHit)
+			continue
+		}
+		if gotHit && math.Hypot(float64(gotX-wantX), float64(gotY-wantY)) > 0.01 {
+			t.Errorf("Trace (%.2f, %.2f) -> (%.2f, %.2f): BVH hit (%.3f, %.3f), BSP hit (%.3f, %.3f)",
+				from.X, from.Y, to.X, to.Y, gotX, gotY, wantX, wantY)
+		}
+	}
+}
+
+func TestBVHLeavesAndDepth(t *testing.T) {
+	bvh := bvhTestBuilder().BuildBVH()
+
+	pieces := 0
+	for _, node := range bvh.Nodes {
+		if node.PieceCount > 0 {
+			if node.PieceCount > bvhMaxLeafPieces {
+				t.Errorf("Leaf holds %d pieces, limit is %d", node.PieceCount, bvhMaxLeafPieces)
+			}
+			pieces += int(node.PieceCount)
+		}
+	}
+	if pieces != len(bvh.Pieces) {
+		t.Errorf("Leaves reference %d pieces, BVH has %d", pieces, len(bvh.Pieces))
+	}
+	if depth := BVHDepth(bvh); depth < 2 || depth > len(bvh.Nodes) {
+		t.Errorf("Unexpected BVH depth %d for %d nodes", depth, len(bvh.Nodes))
+	}
+}
+
+func TestSelectEngine(t *testing.T) {
+	t.Run("Shipped engine answers like the BSP tree", func(t *testing.T) {
+		reference := bvhTestBuilder().Build()
+		builder := bvhTestBuilder()
+		levelData := builder.Build()
+		report := SelectEngine(levelData, builder.BuildBVH(), Budget{})
+
+		switch report.Engine {
+		case EngineBVH:
+			if levelData.CollisionBvh == nil {
+				t.Error("BVH selected, but level data has no BVH")
+			}
+		case EngineBSP:
+			if levelData.CollisionBvh != nil {
+				t.Error("BSP selected, but level data has a BVH")
+			}
+		default:
+			t.Fatalf("Unknown engine %q", report.Engine)
+		}
+		if len(levelData.Nodes) != len(reference.Nodes) || levelData.RootIndex != reference.RootIndex {
+			t.Errorf("Expected the BSP tree to stay, got %d nodes and root %d", len(levelData.Nodes), levelData.RootIndex)
+		}
+		if report.BSPCost <= 0 || report.BVHCost <= 0 {
+			t.Errorf("Expected both engines to be counted, got %+v", report)
+		}
+
+		for _, p := range []Point{{X: 0.5, Y: 2}, {X: 2.5, Y: 6}, {X: 10, Y: -5}, {X: 4, Y: 4}, {X: -1, Y: -1}} {
+			want := PointInBSP(reference.Nodes, reference.RootIndex, p)
+			if got := PointInLevel(levelData, p); got != want {
+				t.Errorf("Point (%v, %v): level says solid=%v, expected %v", p.X, p.Y, got, want)
+			}
+		}
+		hit, hitX, _ := LineTraceLevel(levelData, Point{X: -2, Y: 0.5}, Point{X: 5, Y: 0.5})
+		if !hit || math.Abs(float64(hitX)) > 0.01 {
+			t.Errorf("Expected the trace to hit the first wall at x=0, got hit=%v x=%.3f", hit, hitX)
+		}
+	})
+
+	t.Run("Selection is deterministic", func(t *testing.T) {
+		selectEngine := func() EngineReport {
+			builder := bvhTestBuilder()
+			levelData := builder.Build()
+			return SelectEngine(levelData, builder.BuildBVH(), Budget{})
+		}
+		first := selectEngine()
+		for i := 0; i < 3; i++ {
+			if again := selectEngine(); again != first {
+				t.Fatalf("Expected the same selection every time, got %+v and %+v", first, again)
+			}
+		}
+	})
+
+	t.Run("Carving drops the BVH", func(t *testing.T) {
+		builder := bvhTestBuilder()
+		levelData := builder.Build()
+		levelData.CollisionBvh = builder.BuildBVH()
+		if _, err := CarveBSP(levelData, Polygon{Vertices: []Point{{X: -1, Y: 0}, {X: 2, Y: 0}, {X: 2, Y: 1}, {X: -1, Y: 1}}}, 0); err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+		if levelData.CollisionBvh != nil {
+			t.Error("Expected the BVH to be dropped after carving")
+		}
+	})
+
+	t.Run("BVH over budget keeps the BSP tree", func(t *testing.T) {
+		builder := bvhTestBuilder()
+		levelData := builder.Build()
+		report := SelectEngine(levelData, builder.BuildBVH(), Budget{MaxNodes: 1})
+		if report.Engine != EngineBSP || levelData.CollisionBvh != nil || len(levelData.Nodes) == 0 {
+			t.Errorf("Expected the BSP tree to be kept, got %+v", report)
+		}
+	})
+}
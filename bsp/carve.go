@@ -0,0 +1,414 @@
+package bsp
+
+import (
+	"fmt"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// DefaultCarveVisits is the node visit budget of a carve if none is given
+const DefaultCarveVisits = 1024
+
+// carveSectorProbe is how far outside the polygon's edges the sector of carved space is looked up
+const carveSectorProbe = 0.01
+
+// CarveReport describes a carve into a level's BSP tree
+type CarveReport struct {
+	Visited int  // Nodes visited while carving locally
+	Added   int  // Nodes appended to the node array
+	Local   bool // false if the visit budget ran out and the subtrees not reached got the polygon's edges above them instead
+}
+
+// carveVertex is a vertex of the carved polygon, clipped to the cell of a node
+// Edge is the edge of the original polygon that starts at this vertex, -1 for an edge
+// that lies on a plane of the cell
+type carveVertex struct {
+	Point Point
+	Edge  int
+}
+
+// carveSpace is the world or the local space of a prefab instance
+type carveSpace struct {
+	polygon []carveVertex // The whole polygon in this space
+	lines   []Line        // Planes of the polygon's edges in this space
+}
+
+// carveKey identifies a node reached in a space
+type carveKey struct {
+	space int
+	idx   int32
+}
+
+// carver subtracts one convex polygon from a BSP tree
+// Nodes are shared between trees (merged trees, prefab subtrees), so the carved copy of a node
+// depends on the path it was reached on. A node reached a second time is carved once more with
+// the whole polygon, which is right on every path, and that copy is reused from then on.
+type carver struct {
+	b         *BSPBuilder
+	polygon   []Point // CCW world-space polygon
+	empty     int32   // Shared empty leaf, -1 until a wrap needs it
+	root      int32   // Root of the tree before the carve
+	sectors   bool    // The level has sectors, carved space gets the sector next to it
+	spaces    []carveSpace
+	seen      map[carveKey]bool
+	shared    map[carveKey]int32 // Copies carved with the whole polygon
+	visited   int
+	limit     int
+	exhausted bool // The visit budget ran out, the remaining subtrees are wrapped instead of carved
+}
+
+// CarveBSP subtracts a convex polygon from the solid space of a level's BSP tree at runtime,
+// e.g. to destroy part of a wall
+// Only the subtrees whose cells overlap the polygon are rewritten: every solid leaf inside it
+// gets the polygon's edges that cross its cell, the rest of the tree is shared with the old
+// version. Shared subtrees are copied, never modified, so prefab subtrees used by other
+// instances stay intact.
+// maxVisits bounds the cost of a carve (0 = DefaultCarveVisits). Subtrees the carve does not
+// reach within the budget get the polygon's edges that cross their cell tested before them
+// instead, so only queries in cells that overlap the polygon get deeper, by at most one node
+// per edge, and carves that run over budget don't pile up above the root.
+// Replaced nodes stay in the node array until CompactBSP is called. On levels with sectors,
+// carved space belongs to the sector next to the polygon.
+// The level's BVH, if it ships one, is dropped, so queries answer with the carved tree
+func CarveBSP(levelData *pb.LevelData, polygon Polygon, maxVisits int) (CarveReport, error) {
+	var report CarveReport
+	if levelData.RootIndex < 0 || int(levelData.RootIndex) >= len(levelData.Nodes) {
+		return report, fmt.Errorf("level has no BSP tree to carve")
+	}
+	if len(polygon.Vertices) < 3 || !isConvex(polygon.Vertices) {
+		return report, fmt.Errorf("carve polygon must be convex with at least 3 vertices")
+	}
+	if maxVisits <= 0 {
+		maxVisits = DefaultCarveVisits
+	}
+
+	before := len(levelData.Nodes)
+	c := &carver{
+		b:       &BSPBuilder{nodes: levelData.Nodes},
+		polygon: ensureCCW(polygon).Vertices,
+		seen:    make(map[carveKey]bool),
+		shared:  make(map[carveKey]int32),
+		limit:   maxVisits,
+		empty:   -1,
+		root:    levelData.RootIndex,
+		sectors: len(levelData.Sectors) > 0,
+	}
+
+	world := c.addSpace(Transform2D{M00: 1, M11: 1})
+	rootIndex := c.carve(levelData.RootIndex, c.spaces[world].polygon, world)
+	report.Visited = c.visited
+	report.Local = !c.exhausted
+
+	levelData.Nodes = c.b.nodes
+	levelData.RootIndex = rootIndex
+	// A shipped BVH still has the old solids, queries fall back to the carved tree
+	levelData.CollisionBvh = nil
+	report.Added = len(levelData.Nodes) - before
+	return report, nil
+}
+
+// CompactBSP drops the nodes of a level's BSP tree that are no longer reachable, e.g. after carving
+// It touches every reachable node, so call it outside of time-critical frames
+func CompactBSP(levelData *pb.LevelData) {
+	if levelData.RootIndex < 0 {
+		return
+	}
+	compacted := compactLevelData(levelData)
+	levelData.Nodes = compacted.Nodes
+	levelData.RootIndex = compacted.RootIndex
+}
+
+// addSpace adds the space of the given world-to-local transform and returns its index
+func (c *carver) addSpace(worldToLocal Transform2D) int {
+	polygon := make([]carveVertex, len(c.polygon))
+	for i, v := range c.polygon {
+		polygon[i] = carveVertex{Point: worldToLocal.Apply(v), Edge: i}
+	}
+	c.spaces = append(c.spaces, carveSpace{polygon: polygon, lines: carveLines(c.polygon, worldToLocal)})
+	return len(c.spaces) - 1
+}
+
+// carve returns the index of a copy of the subtree with the polygon removed, or the subtree
+// itself if it does not change
+// clipped is the polygon clipped to the cell of the node, in the node's space
+// Once the visit budget has run out, the subtree is wrapped in the clipped polygon's edges instead
+func (c *carver) carve(idx int32, clipped []carveVertex, space int) int32 {
+	if idx < 0 || int(idx) >= len(c.b.nodes) {
+		return idx
+	}
+	if c.visited >= c.limit {
+		if leaf, ok := c.b.nodes[idx].Type.(*pb.BSPNode_Leaf); ok && !leaf.Leaf.IsSolid {
+			return idx
+		}
+		c.exhausted = true
+		return c.wrap(idx, clipped, c.spaces[space].lines)
+	}
+	c.visited++
+
+	key := carveKey{space: space, idx: idx}
+	if copied, ok := c.shared[key]; ok {
+		return copied
+	}
+	if c.seen[key] {
+		copied := c.carveNode(idx, c.spaces[space].polygon, space)
+		c.shared[key] = copied
+		return copied
+	}
+	c.seen[key] = true
+	return c.carveNode(idx, clipped, space)
+}
+
+// carveNode carves a node with the polygon clipped to its cell
+func (c *carver) carveNode(idx int32, clipped []carveVertex, space int) int32 {
+	lines := c.spaces[space].lines
+	switch n := c.b.nodes[idx].Type.(type) {
+	case *pb.BSPNode_Leaf:
+		if !n.Leaf.IsSolid {
+			return idx
+		}
+		return c.wrap(idx, clipped, lines)
+
+	case *pb.BSPNode_Split:
+		line := Line{Normal: Vector2{X: n.Split.NormalX, Y: n.Split.NormalY}, Distance: n.Split.Distance}
+		front, back := c.carveSplit(line, n.Split.FrontIndex, n.Split.BackIndex, clipped, space)
+		if front == n.Split.FrontIndex && back == n.Split.BackIndex {
+			return idx
+		}
+		return c.b.addSplitNode(line.Normal.X, line.Normal.Y, line.Distance, front, back)
+
+	case *pb.BSPNode_AxisSplit:
+		line := axisSplitLine(n.AxisSplit)
+		front, back := c.carveSplit(line, n.AxisSplit.FrontIndex, n.AxisSplit.BackIndex, clipped, space)
+		if front == n.AxisSplit.FrontIndex && back == n.AxisSplit.BackIndex {
+			return idx
+		}
+		return c.b.addSplitNode(line.Normal.X, line.Normal.Y, line.Distance, front, back)
+
+	case *pb.BSPNode_Circle:
+		// The disc is solid on its own, so it is tested after the polygon, as a whole
+		circle := circleFromNode(n.Circle)
+		boundsMin, boundsMax := carveBounds(clipped)
+		if boundsMax.X < circle.Center.X-circle.Radius || boundsMin.X > circle.Center.X+circle.Radius ||
+			boundsMax.Y < circle.Center.Y-circle.Radius || boundsMin.Y > circle.Center.Y+circle.Radius {
+			outside := c.carve(n.Circle.OutsideIndex, clipped, space)
+			if outside == n.Circle.OutsideIndex {
+				return idx
+			}
+			copied := *n.Circle
+			copied.OutsideIndex = outside
+			newIdx := int32(len(c.b.nodes))
+			c.b.nodes = append(c.b.nodes, &pb.BSPNode{Type: &pb.BSPNode_Circle{Circle: &copied}})
+			return newIdx
+		}
+		return c.wrap(idx, clipped, lines)
+
+	case *pb.BSPNode_Instance:
+		// The prefab subtree is carved in its local space, into a copy for this instance only
+		worldToLocal := instanceTransform(n.Instance)
+		local := make([]carveVertex, len(clipped))
+		for i, v := range clipped {
+			local[i] = carveVertex{Point: worldToLocal.Apply(v.Point), Edge: v.Edge}
+		}
+		subtree := c.carve(n.Instance.SubtreeIndex, local, c.addSpace(worldToLocal))
+		next := c.carve(n.Instance.NextIndex, clipped, space)
+		if subtree == n.Instance.SubtreeIndex && next == n.Instance.NextIndex {
+			return idx
+		}
+		return c.b.addInstanceNode(subtree, worldToLocal, next)
+	}
+	return idx
+}
+
+// carveSplit carves the children of a split into the parts of the polygon on their side
+// Points on the plane belong to the back side, like in PointInBSP
+func (c *carver) carveSplit(line Line, frontIdx, backIdx int32, clipped []carveVertex, space int) (int32, int32) {
+	if front := clipCarvePolygon(clipped, line, true); front != nil {
+		frontIdx = c.carve(frontIdx, front, space)
+	}
+	if back := clipCarvePolygon(clipped, line, false); back != nil {
+		backIdx = c.carve(backIdx, back, space)
+	}
+	return frontIdx, backIdx
+}
+
+// wrap tests the edges of the polygon that cross the cell before the subtree
+// Points inside all of them end in an empty leaf, all others continue in the subtree
+// Edges that do not appear in the clipped polygon are implied by the cell and skipped
+func (c *carver) wrap(idx int32, clipped []carveVertex, lines []Line) int32 {
+	var edges []int
+	seen := make(map[int]bool, len(clipped))
+	// Axis-aligned edges first, their nodes are the cheapest to evaluate
+	for pass := 0; pass < 2; pass++ {
+		for _, v := range clipped {
+			if v.Edge < 0 || seen[v.Edge] {
+				continue
+			}
+			normal := lines[v.Edge].Normal
+			axisAligned := normal.X == 0 || normal.Y == 0
+			if axisAligned == (pass == 0) {
+				seen[v.Edge] = true
+				edges = append(edges, v.Edge)
+			}
+		}
+	}
+
+	// The whole cell is inside the polygon
+	if len(edges) == 0 {
+		return c.emptyLeaf()
+	}
+
+	nodeIdx := c.emptyLeaf()
+	for i := len(edges) - 1; i >= 0; i-- {
+		line := lines[edges[i]]
+		nodeIdx = c.b.addSplitNode(line.Normal.X, line.Normal.Y, line.Distance, idx, nodeIdx)
+	}
+	return nodeIdx
+}
+
+// emptyLeaf returns the empty leaf that carved space ends in, it is added on first use
+func (c *carver) emptyLeaf() int32 {
+	if c.empty < 0 {
+		c.empty = c.b.addLeafNode(c.neighborSector(), []int32{}, false)
+	}
+	return c.empty
+}
+
+// neighborSector returns the sector most probes just outside the polygon's edges fall into, so
+// PointSector keeps answering with the room the carved space opens into
+// Returns 0 if the level has no sectors or solid space surrounds the polygon
+func (c *carver) neighborSector() int32 {
+	if !c.sectors {
+		return 0
+	}
+	counts := make(map[int32]int)
+	best := int32(0)
+	for i, a := range c.polygon {
+		b := c.polygon[(i+1)%len(c.polygon)]
+		// The polygon is CCW, its outside is to the right of every edge
+		dir := Vector2{X: b.X - a.X, Y: b.Y - a.Y}.Normalize()
+		for _, t := range []float32{0.25, 0.5, 0.75} {
+			p := Point{
+				X: a.X + t*(b.X-a.X) + dir.Y*carveSectorProbe,
+				Y: a.Y + t*(b.Y-a.Y) - dir.X*carveSectorProbe,
+			}
+			sector := PointSector(c.b.nodes, c.root, p)
+			if sector == 0 {
+				continue
+			}
+			counts[sector]++
+			if counts[sector] > counts[best] || (counts[sector] == counts[best] && sector < best) {
+				best = sector
+			}
+		}
+	}
+	return best
+}
+
+// carveLines returns the planes of a CCW polygon's edges in the space of the given transform,
+// with the front side outside the polygon
+func carveLines(polygon []Point, transform Transform2D) []Line {
+	flip := float32(1)
+	if transform.Determinant() < 0 {
+		// Mirrored spaces turn the polygon clockwise
+		flip = -1
+	}
+
+	lines := make([]Line, len(polygon))
+	for i := range polygon {
+		v1 := transform.Apply(polygon[i])
+		v2 := transform.Apply(polygon[(i+1)%len(polygon)])
+		edge := Vector2{X: v2.X - v1.X, Y: v2.Y - v1.Y}
+
+		// Axis-aligned edges get an exact unit normal, so they become axis-aligned split nodes
+		normal := Vector2{X: flip * edge.Y, Y: -flip * edge.X}.Normalize()
+		if edge.X == 0 && edge.Y != 0 {
+			normal = Vector2{X: sign(flip * edge.Y), Y: 0}
+		} else if edge.Y == 0 && edge.X != 0 {
+			normal = Vector2{X: 0, Y: -sign(flip * edge.X)}
+		}
+		lines[i] = Line{Normal: normal, Distance: normal.X*v1.X + normal.Y*v1.Y}
+	}
+	return lines
+}
+
+// clipCarvePolygon clips a convex polygon to the front (d > 0) or back (d <= 0) side of a line
+// New edges along the line are marked with Edge -1
+// Returns nil if nothing of the polygon is left on that side
+func clipCarvePolygon(polygon []carveVertex, line Line, front bool) []carveVertex {
+	keep := func(d float32) bool {
+		if front {
+			return d > 0
+		}
+		return d <= 0
+	}
+
+	n := len(polygon)
+	sides := make([]float32, n)
+	kept := 0
+	for i, v := range polygon {
+		sides[i] = line.PointSide(v.Point)
+		if keep(sides[i]) {
+			kept++
+		}
+	}
+	if kept == 0 {
+		return nil
+	}
+	if kept == n {
+		return polygon
+	}
+
+	clipped := make([]carveVertex, 0, n+1)
+	for i, a := range polygon {
+		j := (i + 1) % n
+		b := polygon[j]
+		inA, inB := keep(sides[i]), keep(sides[j])
+		if inA {
+			clipped = append(clipped, a)
+		}
+		if inA != inB {
+			t := sides[i] / (sides[i] - sides[j])
+			crossing := Point{X: a.Point.X + t*(b.Point.X-a.Point.X), Y: a.Point.Y + t*(b.Point.Y-a.Point.Y)}
+			if inA {
+				// Leaving the kept side, the next edge runs along the line
+				clipped = append(clipped, carveVertex{Point: crossing, Edge: -1})
+			} else {
+				// Entering the kept side, the edge continues on the polygon's edge
+				clipped = append(clipped, carveVertex{Point: crossing, Edge: a.Edge})
+			}
+		}
+	}
+	if len(clipped) < 3 {
+		return nil
+	}
+	return clipped
+}
+
+// carveBounds returns the bounding box of a clipped polygon
+func carveBounds(polygon []carveVertex) (Point, Point) {
+	boundsMin, boundsMax := polygon[0].Point, polygon[0].Point
+	for _, v := range polygon[1:] {
+		boundsMin.X = min(boundsMin.X, v.Point.X)
+		boundsMin.Y = min(boundsMin.Y, v.Point.Y)
+		boundsMax.X = max(boundsMax.X, v.Point.X)
+		boundsMax.Y = max(boundsMax.Y, v.Point.Y)
+	}
+	return boundsMin, boundsMax
+}
+
+// isConvex returns true if all turns of the outline go the same way
+func isConvex(vertices []Point) bool {
+	n := len(vertices)
+	turn := 0
+	for i := range vertices {
+		side := orient2d(vertices[i], vertices[(i+1)%n], vertices[(i+2)%n])
+		if side == 0 {
+			continue
+		}
+		if turn != 0 && side != turn {
+			return false
+		}
+		turn = side
+	}
+	return turn != 0
+}
@@ -0,0 +1,222 @@
+package bsp
+
+import (
+	"math"
+	"math/rand"
+	"testing"
+	"time"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// carveTestHoles cut through a wall, a pillar, a rotated crate and the barrel
+var carveTestHoles = []Polygon{
+	{Vertices: []Point{{X: 0.5, Y: -1}, {X: 2, Y: -1}, {X: 2, Y: 0.5}, {X: 0.5, Y: 0.5}}},
+	{Vertices: []Point{{X: 7, Y: 5}, {X: 9, Y: 6}, {X: 7, Y: 7}}},
+	{Vertices: []Point{{X: 9, Y: -6}, {X: 10.5, Y: -5.5}, {X: 10, Y: -4}, {X: 8.5, Y: -4.5}}},
+	{Vertices: []Point{{X: 19.5, Y: -7}, {X: 20.5, Y: -7}, {X: 20.5, Y: -5}, {X: 19.5, Y: -5}}},
+}
+
+// insideConvex returns true if p is inside a convex polygon, and how far it is from its outline
+func insideConvex(poly Polygon, p Point) (bool, float32) {
+	vertices := ensureCCW(poly).Vertices
+	inside := true
+	distance := float32(math.MaxFloat32)
+	for i, a := range vertices {
+		b := vertices[(i+1)%len(vertices)]
+		if (b.X-a.X)*(p.Y-a.Y)-(b.Y-a.Y)*(p.X-a.X) < 0 {
+			inside = false
+		}
+		distance = min(distance, pointSegmentDistance(p, a, b))
+	}
+	return inside, distance
+}
+
+// checkCarved compares a carved level with the original minus the holes on a grid
+func checkCarved(t *testing.T, carved, original *pb.LevelData, holes []Polygon) {
+	t.Helper()
+	for y := float32(-8.13); y < 9; y += 0.17 {
+		for x := float32(-2.07); x < 52; x += 0.19 {
+			p := Point{X: x, Y: y}
+			want := PointInBSP(original.Nodes, original.RootIndex, p)
+			nearOutline := false
+			for _, hole := range holes {
+				inside, distance := insideConvex(hole, p)
+				if inside {
+					want = false
+				}
+				nearOutline = nearOutline || distance < 0.001
+			}
+			if nearOutline {
+				continue
+			}
+			if got := PointInBSP(carved.Nodes, carved.RootIndex, p); got != want {
+				t.Errorf("Point (%.2f, %.2f): carved level says solid=%v, expected %v", x, y, got, want)
+			}
+		}
+	}
+}
+
+func TestCarveBSP(t *testing.T) {
+	original := bvhTestBuilder().Build()
+
+	t.Run("Carved space is empty, the rest is unchanged", func(t *testing.T) {
+		levelData := bvhTestBuilder().Build()
+		for _, hole := range carveTestHoles {
+			report, err := CarveBSP(levelData, hole, 0)
+			if err != nil {
+				t.Fatalf("Carving failed: %v", err)
+			}
+			if !report.Local || report.Visited > DefaultCarveVisits || report.Added == 0 {
+				t.Errorf("Expected a local carve within budget, got %+v", report)
+			}
+		}
+		checkCarved(t, levelData, original, carveTestHoles)
+
+		// A trace through the hole in the first wall passes, next to it the wall still blocks
+		if hit, _, _ := LineTraceBSPNode(levelData.Nodes, levelData.RootIndex, Point{X: 1, Y: -2}, Point{X: 1, Y: 0.3}, 0, 1); hit {
+			t.Error("Expected the trace through the hole to pass")
+		}
+		if hit, _, _ := LineTraceBSPNode(levelData.Nodes, levelData.RootIndex, Point{X: 2.5, Y: -2}, Point{X: 2.5, Y: 0.3}, 0, 1); !hit {
+			t.Error("Expected the trace next to the hole to hit the wall")
+		}
+	})
+
+	t.Run("Over budget carves only deepen queries near the polygon", func(t *testing.T) {
+		levelData := bvhTestBuilder().Build()
+		for _, hole := range carveTestHoles {
+			report, err := CarveBSP(levelData, hole, 10)
+			if err != nil {
+				t.Fatalf("Carving failed: %v", err)
+			}
+			if report.Local || report.Visited != 10 {
+				t.Errorf("Expected the carve to run out of its 10 visits, got %+v", report)
+			}
+		}
+		checkCarved(t, levelData, original, carveTestHoles)
+
+		// Stacked above the root, every query would test at least one more edge per carve
+		total, deeper, added := 0, 0, 0
+		for y := float32(-8.13); y < 9; y += 0.17 {
+			for x := float32(-2.07); x < 52; x += 0.19 {
+				p := Point{X: x, Y: y}
+				_, before := bspPointCost(original.Nodes, original.RootIndex, p)
+				_, after := bspPointCost(levelData.Nodes, levelData.RootIndex, p)
+				total++
+				if after > before {
+					deeper++
+					added += after - before
+				}
+			}
+		}
+		if deeper*2 > total || added >= total {
+			t.Errorf("Expected most queries to keep their depth, %d of %d got %d nodes deeper in total", deeper, total, added)
+		}
+	})
+
+	t.Run("Compacting keeps the carved tree", func(t *testing.T) {
+		levelData := bvhTestBuilder().Build()
+		for _, hole := range carveTestHoles {
+			if _, err := CarveBSP(levelData, hole, 0); err != nil {
+				t.Fatalf("Carving failed: %v", err)
+			}
+		}
+		before := len(levelData.Nodes)
+		CompactBSP(levelData)
+		if len(levelData.Nodes) >= before {
+			t.Errorf("Expected compacting to drop replaced nodes, still %d of %d", len(levelData.Nodes), before)
+		}
+		checkCarved(t, levelData, original, carveTestHoles)
+	})
+
+	t.Run("Invalid carves are rejected", func(t *testing.T) {
+		levelData := bvhTestBuilder().Build()
+		concave := Polygon{Vertices: []Point{{X: 0, Y: 0}, {X: 4, Y: 0}, {X: 4, Y: 2}, {X: 2, Y: 1}, {X: 0, Y: 2}}}
+		if _, err := CarveBSP(levelData, concave, 0); err == nil {
+			t.Error("Expected an error for a concave polygon")
+		}
+		if _, err := CarveBSP(&pb.LevelData{RootIndex: -1, CollisionBvh: &pb.CollisionBVH{}}, carveTestHoles[0], 0); err == nil {
+			t.Error("Expected an error for a level without BSP tree")
+		}
+	})
+}
+
+func TestCarveBSPSectors(t *testing.T) {
+	// Two 10x10 rooms side by side, the wall between them runs from x = 10 to x = 11
+	levelData := NewBSPBuilder([]Polygon{
+		{Vertices: []Point{{X: -1, Y: -1}, {X: 22, Y: -1}, {X: 22, Y: 0}, {X: -1, Y: 0}}, IsSolid: true},
+		{Vertices: []Point{{X: -1, Y: 10}, {X: 22, Y: 10}, {X: 22, Y: 11}, {X: -1, Y: 11}}, IsSolid: true},
+		{Vertices: []Point{{X: -1, Y: 0}, {X: 0, Y: 0}, {X: 0, Y: 10}, {X: -1, Y: 10}}, IsSolid: true},
+		{Vertices: []Point{{X: 21, Y: 0}, {X: 22, Y: 0}, {X: 22, Y: 10}, {X: 21, Y: 10}}, IsSolid: true},
+		{Vertices: []Point{{X: 10, Y: 0}, {X: 11, Y: 0}, {X: 11, Y: 10}, {X: 10, Y: 10}}, IsSolid: true},
+	}).Build()
+	if sectors := BuildSectors(levelData, Point{X: -1, Y: -1}, Point{X: 22, Y: 11}); len(sectors) != 2 {
+		t.Fatalf("Expected two sectors, got %d", len(sectors))
+	}
+	left := PointSector(levelData.Nodes, levelData.RootIndex, Point{X: 5, Y: 5})
+	right := PointSector(levelData.Nodes, levelData.RootIndex, Point{X: 15, Y: 5})
+
+	// A niche carved into the wall from the left room
+	report, err := CarveBSP(levelData, Polygon{Vertices: []Point{{X: 9, Y: 4}, {X: 10.5, Y: 4}, {X: 10.5, Y: 6}, {X: 9, Y: 6}}}, 0)
+	if err != nil {
+		t.Fatalf("Carving failed: %v", err)
+	}
+	if !report.Local || report.Added == 0 {
+		t.Errorf("Expected a local carve, got %+v", report)
+	}
+	for _, probe := range []struct {
+		p    Point
+		want int32
+	}{
+		{Point{X: 10.3, Y: 5}, left},
+		{Point{X: 9.5, Y: 5}, left},
+		{Point{X: 5, Y: 5}, left},
+		{Point{X: 10.8, Y: 5}, 0},
+		{Point{X: 15, Y: 5}, right},
+	} {
+		if got := PointSector(levelData.Nodes, levelData.RootIndex, probe.p); got != probe.want {
+			t.Errorf("Expected sector %d at (%v, %v), got %d", probe.want, probe.p.X, probe.p.Y, got)
+		}
+	}
+
+	// Carving empty space changes nothing, not even the node array
+	report, err = CarveBSP(levelData, Polygon{Vertices: []Point{{X: 3, Y: 3}, {X: 4, Y: 3}, {X: 4, Y: 4}, {X: 3, Y: 4}}}, 0)
+	if err != nil {
+		t.Fatalf("Carving failed: %v", err)
+	}
+	if report.Added != 0 {
+		t.Errorf("Expected a carve in empty space to add no nodes, got %+v", report)
+	}
+}
+
+// BenchmarkCarveBSP measures small carves into a compacted level, and how many fit into a 60 Hz frame
+func BenchmarkCarveBSP(b *testing.B) {
+	levelData, _, err := bvhTestBuilder().BuildWithinBudget(Budget{})
+	if err != nil {
+		b.Fatal(err)
+	}
+	rng := rand.New(rand.NewSource(5))
+	holes := make([]Polygon, 256)
+	for i := range holes {
+		holes[i] = regularPolygon(Point{X: rng.Float32()*50 - 1, Y: rng.Float32()*16 - 8}, 0.3+rng.Float32()*0.5, 6)
+	}
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if i%len(holes) == 0 {
+			// Start over with a fresh copy now and then, so the tree does not keep growing
+			b.StopTimer()
+			levelData, _, _ = bvhTestBuilder().BuildWithinBudget(Budget{})
+			b.StartTimer()
+		}
+		if _, err := CarveBSP(levelData, holes[i%len(holes)], 0); err != nil {
+			b.Fatal(err)
+		}
+	}
+	b.StopTimer()
+
+	perCarve := b.Elapsed() / time.Duration(b.N)
+	if perCarve > 0 {
+		b.ReportMetric(float64(time.Second/60)/float64(perCarve), "carves/frame")
+	}
+}
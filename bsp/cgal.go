@@ -15,6 +15,16 @@ import (
 	"unsafe"
 )
 
+// Point and C.CVertex share their layout, so vertex slices are handed to CGAL as they are
+// The two array types fail to compile if the sizes ever differ
+var _ [unsafe.Sizeof(Point{}) - unsafe.Sizeof(C.CVertex{})]byte
+var _ [unsafe.Sizeof(C.CVertex{}) - unsafe.Sizeof(Point{})]byte
+
+// cVertices returns the vertices as a C array, without copying them
+func cVertices(vertices []Point) *C.CVertex {
+	return (*C.CVertex)(unsafe.Pointer(&vertices[0]))
+}
+
 // PartitionPolygonConvex takes a polygon and partitions it into convex sub-polygons
 // using CGAL's approx_convex_partition_2 algorithm.
 // If the polygon is already convex, it returns it as-is.
@@ -24,15 +34,8 @@ func PartitionPolygonConvex(polygon Polygon) ([]Polygon, error) {
 		return nil, fmt.Errorf("polygon must have at least 3 vertices")
 	}
 
-	// Convert Go points to C points
-	cPoints := make([]C.CPoint, len(polygon.Vertices))
-	for i, v := range polygon.Vertices {
-		cPoints[i].x = C.double(v.X)
-		cPoints[i].y = C.double(v.Y)
-	}
-
 	// Call C function
-	result := C.partition_polygon_convex(&cPoints[0], C.int(len(cPoints)))
+	result := C.partition_polygon_convex(cVertices(polygon.Vertices), C.int(len(polygon.Vertices)))
 	defer C.free_partition_result(&result)
 
 	// Check for errors
@@ -53,16 +56,9 @@ func PartitionPolygonConvex(polygon Polygon) ([]Polygon, error) {
 	for i := 0; i < int(result.count); i++ {
 		cPoly := cPolygons[i]
 
-		// Access the C array of points for this polygon
-		cPolyPoints := (*[1 << 30]C.CPoint)(unsafe.Pointer(cPoly.points))[:cPoly.count:cPoly.count]
-
+		// The C array of points for this polygon has the layout of a Point slice
 		vertices := make([]Point, cPoly.count)
-		for j := 0; j < int(cPoly.count); j++ {
-			vertices[j] = Point{
-				X: float32(cPolyPoints[j].x),
-				Y: float32(cPolyPoints[j].y),
-			}
-		}
+		copy(vertices, unsafe.Slice((*Point)(unsafe.Pointer(cPoly.points)), cPoly.count))
 
 		goPolygons[i] = Polygon{
 			Vertices: vertices,
@@ -72,3 +68,68 @@ func PartitionPolygonConvex(polygon Polygon) ([]Polygon, error) {
 
 	return goPolygons, nil
 }
+
+// DetectCircle checks whether a polygon outline approximates a circle
+// The outline and the returned circle deviate by at most tolerance anywhere
+// Outlines with fewer than minVertices vertices are never circles
+func DetectCircle(polygon Polygon, tolerance float32, minVertices int) (Circle, bool) {
+	if len(polygon.Vertices) < 3 {
+		return Circle{}, false
+	}
+
+	result := C.detect_circle(cVertices(polygon.Vertices), C.int(len(polygon.Vertices)), C.double(tolerance), C.int(minVertices))
+	if result.is_circle == 0 {
+		return Circle{}, false
+	}
+
+	return Circle{
+		Center: Point{X: float32(result.center.x), Y: float32(result.center.y)},
+		Radius: float32(result.radius),
+	}, true
+}
+
+// ValidateGeometry checks all outlines together for self-intersections, crossings between
+// outlines, slivers thinner than sliverTolerance and duplicate vertices
+// All edges are sorted once and swept, so only nearby edge pairs are tested exactly
+// Polygon and edge indices of the returned issues refer to the given polygons
+func ValidateGeometry(polygons []Polygon, sliverTolerance float32) ([]GeometryIssue, error) {
+	total := 0
+	for _, poly := range polygons {
+		total += len(poly.Vertices)
+	}
+	if total == 0 {
+		return nil, nil
+	}
+
+	// Flat vertex array with one vertex count per polygon, cgo can't pass nested Go pointers
+	points := make([]Point, 0, total)
+	cCounts := make([]C.int, len(polygons))
+	for i, poly := range polygons {
+		points = append(points, poly.Vertices...)
+		cCounts[i] = C.int(len(poly.Vertices))
+	}
+
+	result := C.validate_geometry(cVertices(points), &cCounts[0], C.int(len(polygons)), C.double(sliverTolerance))
+	defer C.free_validation_result(&result)
+
+	if result.error != nil {
+		return nil, fmt.Errorf("CGAL validation error: %s", C.GoString(result.error))
+	}
+	if result.count == 0 {
+		return nil, nil
+	}
+
+	cIssues := (*[1 << 30]C.CGeometryIssue)(unsafe.Pointer(result.issues))[:result.count:result.count]
+	issues := make([]GeometryIssue, result.count)
+	for i, c := range cIssues {
+		issues[i] = GeometryIssue{
+			Kind:         IssueKind(c.kind),
+			Polygon:      int(c.polygon),
+			Edge:         int(c.edge),
+			OtherPolygon: int(c.other_polygon),
+			OtherEdge:    int(c.other_edge),
+			Location:     Point{X: float32(c.location.x), Y: float32(c.location.y)},
+		}
+	}
+	return issues, nil
+}
@@ -7,6 +7,8 @@
 #include <list>
 #include <cstring>
 #include <cstdlib>
+#include <cmath>
+#include <algorithm>
 
 typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
 typedef CGAL::Partition_traits_2<K> Traits;
@@ -25,7 +27,7 @@ static char* alloc_error(const char* msg) {
 
 extern "C" {
 
-CPartitionResult partition_polygon_convex(const CPoint* points, int count) {
+CPartitionResult partition_polygon_convex(const CVertex* points, int count) {
     CPartitionResult result = {NULL, 0, NULL};
     
     // Validate input
@@ -62,7 +64,7 @@ CPartitionResult partition_polygon_convex(const CPoint* points, int count) {
             
             result.count = 1;
             result.polygons[0].count = count;
-            result.polygons[0].points = (CPoint*)malloc(count * sizeof(CPoint));
+            result.polygons[0].points = (CVertex*)malloc(count * sizeof(CVertex));
             if (!result.polygons[0].points) {
                 free(result.polygons);
                 result.polygons = NULL;
@@ -103,7 +105,7 @@ CPartitionResult partition_polygon_convex(const CPoint* points, int count) {
         for (const auto& part_poly : partition_polys) {
             int n = part_poly.size();
             result.polygons[poly_idx].count = n;
-            result.polygons[poly_idx].points = (CPoint*)malloc(n * sizeof(CPoint));
+            result.polygons[poly_idx].points = (CVertex*)malloc(n * sizeof(CVertex));
             
             if (!result.polygons[poly_idx].points) {
                 // Clean up previously allocated polygons
@@ -119,8 +121,9 @@ CPartitionResult partition_polygon_convex(const CPoint* points, int count) {
             
             int pt_idx = 0;
             for (auto vit = part_poly.vertices_begin(); vit != part_poly.vertices_end(); ++vit) {
-                result.polygons[poly_idx].points[pt_idx].x = CGAL::to_double(vit->x());
-                result.polygons[poly_idx].points[pt_idx].y = CGAL::to_double(vit->y());
+                // Partition vertices are input vertices, narrowing them back is exact
+                result.polygons[poly_idx].points[pt_idx].x = (float)CGAL::to_double(vit->x());
+                result.polygons[poly_idx].points[pt_idx].y = (float)CGAL::to_double(vit->y());
                 pt_idx++;
             }
             
@@ -161,5 +164,88 @@ void free_partition_result(CPartitionResult* result) {
     result->count = 0;
 }
 
+CCircleResult detect_circle(const CVertex* points, int count, double tolerance, int min_vertices) {
+    CCircleResult result = {0, {0, 0}, 0};
+
+    if (points == NULL || count < 3 || count < min_vertices) {
+        return result;
+    }
+
+    // Work relative to the centroid for numerical stability
+    double mean_x = 0, mean_y = 0;
+    for (int i = 0; i < count; i++) {
+        mean_x += points[i].x;
+        mean_y += points[i].y;
+    }
+    mean_x /= count;
+    mean_y /= count;
+
+    // Algebraic least-squares circle fit (Kasa):
+    // minimize sum((x^2 + y^2) - 2*a*x - 2*b*y - c)^2
+    double suu = 0, svv = 0, suv = 0, suuu = 0, svvv = 0, suvv = 0, svuu = 0;
+    for (int i = 0; i < count; i++) {
+        double u = points[i].x - mean_x;
+        double v = points[i].y - mean_y;
+        suu += u * u;
+        svv += v * v;
+        suv += u * v;
+        suuu += u * u * u;
+        svvv += v * v * v;
+        suvv += u * v * v;
+        svuu += v * u * u;
+    }
+
+    double det = suu * svv - suv * suv;
+    if (std::fabs(det) < 1e-12) {
+        return result; // Collinear points
+    }
+
+    double rhs_u = 0.5 * (suuu + suvv);
+    double rhs_v = 0.5 * (svvv + svuu);
+    double uc = (rhs_u * svv - rhs_v * suv) / det;
+    double vc = (rhs_v * suu - rhs_u * suv) / det;
+    double radius = std::sqrt(uc * uc + vc * vc + (suu + svv) / count);
+    double center_x = uc + mean_x;
+    double center_y = vc + mean_y;
+
+    // Every vertex must lie on the circle, and the vertices must walk around the
+    // center once in a consistent direction
+    const double two_pi = 2 * M_PI;
+    double max_deviation = 0;
+    double max_gap = 0;
+    double total_turn = 0;
+    for (int i = 0; i < count; i++) {
+        const CVertex& p = points[i];
+        const CVertex& q = points[(i + 1) % count];
+
+        double deviation = std::fabs(std::hypot(p.x - center_x, p.y - center_y) - radius);
+        max_deviation = std::max(max_deviation, deviation);
+
+        double angle_p = std::atan2(p.y - center_y, p.x - center_x);
+        double angle_q = std::atan2(q.y - center_y, q.x - center_x);
+        double step = angle_q - angle_p;
+        if (step > M_PI) step -= two_pi;
+        if (step < -M_PI) step += two_pi;
+        total_turn += step;
+        max_gap = std::max(max_gap, std::fabs(step));
+    }
+
+    if (std::fabs(std::fabs(total_turn) - two_pi) > 1e-6) {
+        return result; // Does not go around the center exactly once
+    }
+
+    // A chord spanning 'max_gap' leaves the circle by up to its sagitta
+    double sagitta = radius * (1 - std::cos(max_gap / 2));
+    if (max_deviation + sagitta > tolerance) {
+        return result;
+    }
+
+    result.is_circle = 1;
+    result.center.x = center_x;
+    result.center.y = center_y;
+    result.radius = radius;
+    return result;
+}
+
 } // extern "C"
 
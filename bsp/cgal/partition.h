@@ -11,9 +11,17 @@ typedef struct {
     double y;
 } CPoint;
 
+// Input vertex in single precision, laid out like bsp.Point on the Go side,
+// so vertex slices are passed without a conversion pass
+// Every float converts to double exactly, predicates on them stay exact
+typedef struct {
+    float x;
+    float y;
+} CVertex;
+
 // C-compatible polygon structure
 typedef struct {
-    CPoint* points;
+    CVertex* points;
     int count;
 } CPolygon;
 
@@ -24,15 +32,65 @@ typedef struct {
     char* error; // NULL if success, error message otherwise
 } CPartitionResult;
 
+// Result of fitting a circle to a polygon outline
+typedef struct {
+    int is_circle; // 1 if the outline is a circle within tolerance, 0 otherwise
+    CPoint center;
+    double radius;
+} CCircleResult;
+
 // Partition a polygon into convex sub-polygons
 // Input: points array and count
 // Output: CPartitionResult with convex polygons
+// The parts only use input vertices, so they are returned in single precision without rounding
 // Caller must free the result using free_partition_result
-CPartitionResult partition_polygon_convex(const CPoint* points, int count);
+CPartitionResult partition_polygon_convex(const CVertex* points, int count);
 
 // Free memory allocated by partition_polygon_convex
 void free_partition_result(CPartitionResult* result);
 
+// Detect whether a polygon outline approximates a circle
+// The outline and the fitted circle deviate by at most 'tolerance' anywhere,
+// including the chords between vertices
+// Needs at least 'min_vertices' vertices, so plain boxes and triangles are never circles
+// Nothing is allocated, the result does not have to be freed
+CCircleResult detect_circle(const CVertex* points, int count, double tolerance, int min_vertices);
+
+// Kinds of geometry issues found by validate_geometry
+typedef enum {
+    ISSUE_SELF_INTERSECTION = 0, // Two edges of the same outline touch or cross
+    ISSUE_CROSSING = 1,          // Edges of two different outlines properly cross
+    ISSUE_SLIVER = 2,            // An outline is thinner than the tolerance, or pinches to within it
+    ISSUE_DUPLICATE_VERTEX = 3   // An outline visits the same point twice
+} CGeometryIssueKind;
+
+// A single geometry issue
+typedef struct {
+    int kind;          // CGeometryIssueKind
+    int polygon;       // Index of the polygon
+    int edge;          // Edge (index of its start vertex), -1 if the whole polygon is affected
+    int other_polygon; // Second polygon involved, -1 if none
+    int other_edge;    // Edge of the second polygon (or second vertex for duplicates), -1 if none
+    CPoint location;
+} CGeometryIssue;
+
+// Result of validate_geometry
+typedef struct {
+    CGeometryIssue* issues;
+    int count;
+    char* error; // NULL if success, error message otherwise
+} CValidationResult;
+
+// Validate all outlines of a level in a single sweep over their edges
+// The polygons are passed as one flat point array; counts[i] is the vertex count of polygon i
+// Reports self-intersections, crossings between outlines, slivers thinner than
+// 'sliver_tolerance' and duplicate vertices, sorted by polygon and edge
+// Caller must free the result using free_validation_result
+CValidationResult validate_geometry(const CVertex* points, const int* counts, int polygon_count, double sliver_tolerance);
+
+// Free memory allocated by validate_geometry
+void free_validation_result(CValidationResult* result);
+
 #ifdef __cplusplus
 }
 #endif
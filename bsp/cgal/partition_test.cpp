@@ -1,9 +1,10 @@
 #include <stdio.h>
+#include <math.h>
 #include "partition.h"
 
 int main() {
     // Test with a simple L-shaped polygon (concave)
-    CPoint points[] = {
+    CVertex points[] = {
         {0, 0},
         {4, 0},
         {4, 2},
@@ -38,7 +39,7 @@ int main() {
     
     // Test with a convex square (should return as-is)
     printf("\nTesting with convex square...\n");
-    CPoint square[] = {
+    CVertex square[] = {
         {0, 0},
         {1, 0},
         {1, 1},
@@ -56,6 +57,89 @@ int main() {
     printf("Success! Square partitioned into %d polygon(s) (should be 1)\n", result.count);
     free_partition_result(&result);
     
+    // Test circle detection with a 32-gon around (5, 5)
+    printf("\nTesting circle detection...\n");
+    CVertex circle[32];
+    for (int i = 0; i < 32; i++) {
+        double angle = 2 * M_PI * i / 32;
+        circle[i].x = 5 + 2 * cos(angle);
+        circle[i].y = 5 + 2 * sin(angle);
+    }
+
+    CCircleResult fit = detect_circle(circle, 32, 0.05, 8);
+    if (!fit.is_circle) {
+        printf("ERROR: 32-gon was not detected as a circle\n");
+        return 1;
+    }
+    printf("Success! Circle at (%f, %f) with radius %f\n", fit.center.x, fit.center.y, fit.radius);
+
+    fit = detect_circle(points, count, 0.05, 3);
+    if (fit.is_circle) {
+        printf("ERROR: L-shape was detected as a circle\n");
+        return 1;
+    }
+    printf("Success! L-shape is not a circle\n");
+
+    // Test whole-level validation: a bowtie, two crossing boxes, a sliver and a duplicate vertex
+    printf("\nTesting geometry validation...\n");
+    CVertex level[] = {
+        // 0: bowtie, its edges 0 and 2 cross at (1, 1)
+        {0, 0}, {2, 2}, {2, 0}, {0, 2},
+        // 1 and 2: boxes whose outlines cross each other
+        {10, 0}, {14, 0}, {14, 4}, {10, 4},
+        {12, 2}, {16, 2}, {16, 6}, {12, 6},
+        // 3: sliver, 5 units long and 0.001 thick
+        {20, 0}, {25, 0}, {25, 0.001}, {20, 0.001},
+        // 4: triangle that visits (30, 0) twice
+        {30, 0}, {34, 0}, {30, 0}, {32, 3},
+        // 5: clean box touching box 1 along its right edge
+        {14, 0}, {18, 0}, {18, -4}, {14, -4}
+    };
+    int counts[] = {4, 4, 4, 4, 4, 4};
+    CValidationResult validation = validate_geometry(level, counts, 6, 0.01);
+    if (validation.error != NULL) {
+        printf("ERROR: %s\n", validation.error);
+        free_validation_result(&validation);
+        return 1;
+    }
+
+    int found[4][6] = {{0}};
+    for (int i = 0; i < validation.count; i++) {
+        CGeometryIssue issue = validation.issues[i];
+        printf("  Issue kind %d: polygon %d edge %d, other %d edge %d at (%f, %f)\n", issue.kind,
+               issue.polygon, issue.edge, issue.other_polygon, issue.other_edge, issue.location.x, issue.location.y);
+        found[issue.kind][issue.polygon]++;
+    }
+    free_validation_result(&validation);
+
+    if (!found[ISSUE_SELF_INTERSECTION][0]) {
+        printf("ERROR: bowtie self-intersection was not reported\n");
+        return 1;
+    }
+    if (found[ISSUE_SLIVER][0]) {
+        printf("ERROR: bowtie was reported as a sliver\n");
+        return 1;
+    }
+    if (!found[ISSUE_CROSSING][1]) {
+        printf("ERROR: crossing boxes were not reported\n");
+        return 1;
+    }
+    if (found[ISSUE_SLIVER][3] != 1) {
+        printf("ERROR: sliver was reported %d times, expected once\n", found[ISSUE_SLIVER][3]);
+        return 1;
+    }
+    if (!found[ISSUE_DUPLICATE_VERTEX][4]) {
+        printf("ERROR: duplicate vertex was not reported\n");
+        return 1;
+    }
+    for (int kind = 0; kind < 4; kind++) {
+        if (found[kind][5]) {
+            printf("ERROR: clean box touching another box was reported (kind %d)\n", kind);
+            return 1;
+        }
+    }
+    printf("Success! All geometry issues were found\n");
+
     printf("\nAll tests passed!\n");
     return 0;
 }
@@ -0,0 +1,302 @@
+#include "partition.h"
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/box_intersection_d.h>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+
+typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
+typedef K::Point_2 Point_2;
+typedef K::Segment_2 Segment_2;
+
+namespace {
+
+// An outline edge with its bounding box grown by the sliver tolerance
+struct SweepEdge {
+    int polygon;
+    int index; // Index of the start vertex
+    int ring;  // Position among the polygon's edges of nonzero length, to recognize neighbors
+    int count; // Number of edges of nonzero length in the polygon
+    Point_2 a, b;
+    double min_x, max_x, min_y, max_y;
+};
+
+// Grown bounding box of an edge for the box intersection
+typedef CGAL::Box_intersection_d::Box_with_handle_d<double, 2, const SweepEdge*> EdgeBox;
+
+char* alloc_error(const char* msg) {
+    char* err = (char*)malloc(strlen(msg) + 1);
+    if (err) {
+        strcpy(err, msg);
+    }
+    return err;
+}
+
+CPoint to_cpoint(const Point_2& p) {
+    CPoint c = {CGAL::to_double(p.x()), CGAL::to_double(p.y())};
+    return c;
+}
+
+CGeometryIssue make_issue(int kind, int polygon, int edge, int other_polygon, int other_edge, CPoint location) {
+    CGeometryIssue issue = {kind, polygon, edge, other_polygon, other_edge, location};
+    return issue;
+}
+
+// Point where two intersecting segments meet
+// For overlapping collinear segments, an endpoint inside the overlap
+CPoint meeting_point(const SweepEdge& e, const SweepEdge& f) {
+    Segment_2 seg_e(e.a, e.b), seg_f(f.a, f.b);
+    if (CGAL::orientation(e.a, e.b, f.a) == CGAL::COLLINEAR && CGAL::orientation(e.a, e.b, f.b) == CGAL::COLLINEAR) {
+        if (seg_e.has_on(f.a)) return to_cpoint(f.a);
+        if (seg_e.has_on(f.b)) return to_cpoint(f.b);
+        return to_cpoint(e.a);
+    }
+
+    double ex = CGAL::to_double(e.b.x() - e.a.x()), ey = CGAL::to_double(e.b.y() - e.a.y());
+    double fx = CGAL::to_double(f.b.x() - f.a.x()), fy = CGAL::to_double(f.b.y() - f.a.y());
+    double gx = CGAL::to_double(f.a.x() - e.a.x()), gy = CGAL::to_double(f.a.y() - e.a.y());
+    double denom = ex * fy - ey * fx;
+    double t = denom != 0 ? (gx * fy - gy * fx) / denom : 0;
+    t = std::min(1.0, std::max(0.0, t));
+    CPoint c = {CGAL::to_double(e.a.x()) + t * ex, CGAL::to_double(e.a.y()) + t * ey};
+    return c;
+}
+
+// Endpoint of either segment that is closest to the other segment
+CPoint closest_endpoint(const SweepEdge& e, const SweepEdge& f) {
+    Segment_2 seg_e(e.a, e.b), seg_f(f.a, f.b);
+    const Point_2* best = &e.a;
+    double best_distance = CGAL::to_double(CGAL::squared_distance(e.a, seg_f));
+    const Point_2* candidates[] = {&e.b, &f.a, &f.b};
+    for (const Point_2* p : candidates) {
+        const Segment_2& other = (p == &e.b) ? seg_f : seg_e;
+        double d = CGAL::to_double(CGAL::squared_distance(*p, other));
+        if (d < best_distance) {
+            best_distance = d;
+            best = p;
+        }
+    }
+    return to_cpoint(*best);
+}
+
+// Checks a pair of edges whose grown bounding boxes overlap
+void check_pair(const SweepEdge& e, const SweepEdge& f, double tolerance, std::vector<CGeometryIssue>& issues) {
+    Segment_2 seg_e(e.a, e.b), seg_f(f.a, f.b);
+    double squared_tolerance = tolerance * tolerance;
+
+    if (e.polygon == f.polygon) {
+        bool e_then_f = (e.ring + 1) % e.count == f.ring;
+        bool f_then_e = (f.ring + 1) % f.count == e.ring;
+        if (e_then_f || f_then_e) {
+            // Neighbors share a vertex, they only overlap if the outline folds back on itself
+            const Point_2& shared = e_then_f ? e.b : e.a;
+            const Point_2& e_other = e_then_f ? e.a : e.b;
+            const Point_2& f_other = e_then_f ? f.b : f.a;
+            if (CGAL::orientation(shared, e_other, f_other) == CGAL::COLLINEAR &&
+                (e_other - shared) * (f_other - shared) > 0) {
+                issues.push_back(make_issue(ISSUE_SELF_INTERSECTION, e.polygon, e.index, f.polygon, f.index, to_cpoint(shared)));
+            } else if (CGAL::to_double(CGAL::squared_distance(f_other, seg_e)) < squared_tolerance ||
+                       CGAL::to_double(CGAL::squared_distance(e_other, seg_f)) < squared_tolerance) {
+                // Spike, or an edge shorter than the tolerance
+                issues.push_back(make_issue(ISSUE_SLIVER, e.polygon, e.index, f.polygon, f.index, to_cpoint(shared)));
+            }
+            return;
+        }
+    }
+
+    if (CGAL::do_intersect(seg_e, seg_f)) {
+        if (e.polygon == f.polygon) {
+            issues.push_back(make_issue(ISSUE_SELF_INTERSECTION, e.polygon, e.index, f.polygon, f.index, meeting_point(e, f)));
+            return;
+        }
+
+        // Outlines of different polygons may touch and overlap (solid space is their union),
+        // but edges that properly cross each other usually mean misplaced geometry
+        int o1 = CGAL::orientation(e.a, e.b, f.a), o2 = CGAL::orientation(e.a, e.b, f.b);
+        int o3 = CGAL::orientation(f.a, f.b, e.a), o4 = CGAL::orientation(f.a, f.b, e.b);
+        if (o1 * o2 < 0 && o3 * o4 < 0) {
+            bool e_first = e.polygon < f.polygon;
+            const SweepEdge& first = e_first ? e : f;
+            const SweepEdge& second = e_first ? f : e;
+            issues.push_back(make_issue(ISSUE_CROSSING, first.polygon, first.index, second.polygon, second.index, meeting_point(e, f)));
+        }
+        return;
+    }
+
+    // Two parts of the same outline that come closer than the tolerance form a thin neck
+    if (e.polygon == f.polygon && CGAL::to_double(CGAL::squared_distance(seg_e, seg_f)) < squared_tolerance) {
+        issues.push_back(make_issue(ISSUE_SLIVER, e.polygon, e.index, f.polygon, f.index, closest_endpoint(e, f)));
+    }
+}
+
+bool issue_less(const CGeometryIssue& a, const CGeometryIssue& b) {
+    if (a.polygon != b.polygon) return a.polygon < b.polygon;
+    if (a.edge != b.edge) return a.edge < b.edge;
+    if (a.kind != b.kind) return a.kind < b.kind;
+    if (a.other_polygon != b.other_polygon) return a.other_polygon < b.other_polygon;
+    return a.other_edge < b.other_edge;
+}
+
+} // namespace
+
+extern "C" {
+
+CValidationResult validate_geometry(const CVertex* points, const int* counts, int polygon_count, double sliver_tolerance) {
+    CValidationResult result = {NULL, 0, NULL};
+
+    if (polygon_count < 0 || (polygon_count > 0 && (points == NULL || counts == NULL))) {
+        result.error = alloc_error("Invalid input: missing points or counts");
+        return result;
+    }
+
+    try {
+        std::vector<CGeometryIssue> issues;
+        std::vector<SweepEdge> edges;
+        std::vector<bool> whole_sliver(polygon_count, false);
+
+        int offset = 0;
+        for (int p = 0; p < polygon_count; p++) {
+            const CVertex* poly = points + offset;
+            int n = counts[p];
+            offset += n;
+
+            // Degenerate outlines and outlines thinner than the tolerance (2 * area / perimeter)
+            double area = 0, perimeter = 0, cx = 0, cy = 0;
+            for (int i = 0; i < n; i++) {
+                double ax = poly[i].x, ay = poly[i].y;
+                double bx = poly[(i + 1) % n].x, by = poly[(i + 1) % n].y;
+                area += ax * by - bx * ay;
+                perimeter += std::hypot(bx - ax, by - ay);
+                cx += ax / n;
+                cy += ay / n;
+            }
+            area = std::fabs(area) / 2;
+            if (n < 3 || perimeter == 0 || 2 * area / perimeter < sliver_tolerance) {
+                CPoint center = {cx, cy};
+                issues.push_back(make_issue(ISSUE_SLIVER, p, -1, -1, -1, center));
+                whole_sliver[p] = true;
+            }
+
+            // Duplicate vertices: sort the vertex indices by position, equal neighbors are duplicates
+            std::vector<int> order(n);
+            for (int i = 0; i < n; i++) order[i] = i;
+            std::sort(order.begin(), order.end(), [poly](int i, int j) {
+                if (poly[i].x != poly[j].x) return poly[i].x < poly[j].x;
+                if (poly[i].y != poly[j].y) return poly[i].y < poly[j].y;
+                return i < j;
+            });
+            for (int k = 1; k < n; k++) {
+                const CVertex& a = poly[order[k - 1]];
+                const CVertex& b = poly[order[k]];
+                if (a.x == b.x && a.y == b.y) {
+                    CPoint location = {a.x, a.y};
+                    issues.push_back(make_issue(ISSUE_DUPLICATE_VERTEX, p, order[k - 1], -1, order[k], location));
+                }
+            }
+
+            if (n < 3) {
+                continue;
+            }
+            // Zero-length edges are reported as duplicate vertices, their neighbors count as adjacent
+            size_t first = edges.size();
+            for (int i = 0; i < n; i++) {
+                const CVertex& a = poly[i];
+                const CVertex& b = poly[(i + 1) % n];
+                if (a.x == b.x && a.y == b.y) {
+                    continue;
+                }
+                SweepEdge edge;
+                edge.polygon = p;
+                edge.index = i;
+                edge.ring = (int)(edges.size() - first);
+                edge.a = Point_2(a.x, a.y);
+                edge.b = Point_2(b.x, b.y);
+                edge.min_x = std::min(a.x, b.x) - sliver_tolerance;
+                edge.max_x = std::max(a.x, b.x) + sliver_tolerance;
+                edge.min_y = std::min(a.y, b.y) - sliver_tolerance;
+                edge.max_y = std::max(a.y, b.y) + sliver_tolerance;
+                edges.push_back(edge);
+            }
+            for (size_t i = first; i < edges.size(); i++) {
+                edges[i].count = (int)(edges.size() - first);
+            }
+        }
+
+        // Find all pairs of edges whose grown boxes overlap with CGAL's box intersection, which
+        // sweeps in x and keeps the edges crossing the sweep line in a segment tree on y, so the
+        // cost is O(n log^2 n) plus one exact test per nearby pair, even for long or stacked edges
+        // Edges are sorted by their left end and every pair is checked in that order, so the
+        // issues don't depend on the order the boxes are reported in
+        std::sort(edges.begin(), edges.end(), [](const SweepEdge& a, const SweepEdge& b) {
+            return a.min_x < b.min_x;
+        });
+        std::vector<EdgeBox> boxes;
+        boxes.reserve(edges.size());
+        for (const SweepEdge& edge : edges) {
+            boxes.push_back(EdgeBox(CGAL::Bbox_2(edge.min_x, edge.min_y, edge.max_x, edge.max_y), &edge));
+        }
+        CGAL::box_self_intersection_d(boxes.begin(), boxes.end(), [&](const EdgeBox& a, const EdgeBox& b) {
+            const SweepEdge* e = a.handle();
+            const SweepEdge* f = b.handle();
+            if (f < e) {
+                std::swap(e, f);
+            }
+            check_pair(*e, *f, sliver_tolerance, issues);
+        });
+
+        // Outlines that are slivers as a whole are reported once, not per edge
+        // Broken outlines are not reported as slivers: their area cancels out, they are not thin
+        std::vector<bool> broken(polygon_count, false);
+        for (const CGeometryIssue& issue : issues) {
+            if (issue.kind == ISSUE_SELF_INTERSECTION || issue.kind == ISSUE_DUPLICATE_VERTEX) {
+                broken[issue.polygon] = true;
+            }
+        }
+        issues.erase(std::remove_if(issues.begin(), issues.end(), [&](const CGeometryIssue& issue) {
+            if (issue.kind != ISSUE_SLIVER) return false;
+            return issue.edge >= 0 ? bool(whole_sliver[issue.polygon]) : bool(broken[issue.polygon]);
+        }), issues.end());
+        std::sort(issues.begin(), issues.end(), issue_less);
+
+        if (issues.empty()) {
+            return result;
+        }
+        result.issues = (CGeometryIssue*)malloc(issues.size() * sizeof(CGeometryIssue));
+        if (!result.issues) {
+            result.error = alloc_error("Memory allocation failed");
+            return result;
+        }
+        std::copy(issues.begin(), issues.end(), result.issues);
+        result.count = issues.size();
+        return result;
+
+    } catch (const std::exception& e) {
+        result.error = alloc_error(e.what());
+        return result;
+    } catch (...) {
+        result.error = alloc_error("Unknown error during validation");
+        return result;
+    }
+}
+
+void free_validation_result(CValidationResult* result) {
+    if (result == NULL) {
+        return;
+    }
+
+    if (result->issues != NULL) {
+        free(result->issues);
+        result->issues = NULL;
+    }
+
+    if (result->error != NULL) {
+        free(result->error);
+        result->error = NULL;
+    }
+
+    result->count = 0;
+}
+
+} // extern "C"
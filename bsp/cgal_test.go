@@ -78,3 +78,73 @@ func TestCGALPartition(t *testing.T) {
 		}
 	})
 }
+
+func TestValidateGeometry(t *testing.T) {
+	box := func(x0, y0, x1, y1 float32) Polygon {
+		return Polygon{Vertices: []Point{{X: x0, Y: y0}, {X: x1, Y: y0}, {X: x1, Y: y1}, {X: x0, Y: y1}}, IsSolid: true}
+	}
+	// countIssues counts the issues of one kind on one polygon
+	countIssues := func(issues []GeometryIssue, kind IssueKind, polygon int) int {
+		n := 0
+		for _, issue := range issues {
+			if issue.Kind == kind && issue.Polygon == polygon {
+				n++
+			}
+		}
+		return n
+	}
+
+	t.Run("Clean touching boxes", func(t *testing.T) {
+		issues, err := ValidateGeometry([]Polygon{box(0, 0, 4, 4), box(4, 0, 8, 4), box(2, 2, 3, 3)}, SliverTolerance)
+		if err != nil {
+			t.Fatalf("Validation failed: %v", err)
+		}
+		if len(issues) != 0 {
+			t.Errorf("Expected no issues, got %v", issues)
+		}
+	})
+
+	t.Run("Every kind is found with its location", func(t *testing.T) {
+		polygons := []Polygon{
+			{Vertices: []Point{{X: 0, Y: 0}, {X: 2, Y: 2}, {X: 2, Y: 0}, {X: 0, Y: 2}}, IsSolid: true},
+			box(10, 0, 14, 4),
+			box(12, 2, 16, 6),
+			box(20, 0, 25, 0.001),
+			{Vertices: []Point{{X: 30, Y: 0}, {X: 34, Y: 0}, {X: 34, Y: 3}, {X: 34, Y: 3}, {X: 30, Y: 3}}, IsSolid: true},
+		}
+		issues, err := ValidateGeometry(polygons, SliverTolerance)
+		if err != nil {
+			t.Fatalf("Validation failed: %v", err)
+		}
+
+		if countIssues(issues, IssueSelfIntersection, 0) != 1 {
+			t.Errorf("Expected one self-intersection of the bowtie, got %v", issues)
+		}
+		for _, issue := range issues {
+			if issue.Kind == IssueSelfIntersection && (issue.Location.X != 1 || issue.Location.Y != 1) {
+				t.Errorf("Expected the bowtie to cross at (1, 1), got %v", issue)
+			}
+		}
+		if countIssues(issues, IssueCrossing, 1) != 2 {
+			t.Errorf("Expected two crossings between the boxes, got %v", issues)
+		}
+		if countIssues(issues, IssueSliver, 3) != 1 {
+			t.Errorf("Expected the sliver once, got %v", issues)
+		}
+		if countIssues(issues, IssueDuplicateVertex, 4) != 1 {
+			t.Errorf("Expected one duplicate vertex, got %v", issues)
+		}
+	})
+
+	t.Run("Builder validates prefabs in local space", func(t *testing.T) {
+		builder := NewBSPBuilder([]Polygon{box(0, 0, 1, 1)})
+		builder.Prefabs = map[string][]Polygon{"crate": {box(0, 0, 1, 1), box(0.5, 0.5, 1.5, 1.5)}}
+		issues, err := builder.Validate()
+		if err != nil {
+			t.Fatalf("Validation failed: %v", err)
+		}
+		if len(issues) != 2 || issues[0].Prefab != "crate" || issues[0].Kind != IssueCrossing {
+			t.Errorf("Expected two crossings in the crate prefab, got %v", issues)
+		}
+	})
+}
@@ -0,0 +1,315 @@
+package bsp
+
+import (
+	"math"
+	"sort"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// LayoutChunkSize is the edge length (in world units) of the chunks of a chunk-stable tree
+const LayoutChunkSize = 16
+
+// chunkMargin grows shape bounds before they are assigned to chunks,
+// so shapes that end exactly on a chunk border are found from both sides
+const chunkMargin = 1e-3
+
+// chunkShape is the tree of one solid shape with its world-space bounds
+type chunkShape struct {
+	root     int32
+	min, max Point
+}
+
+// chunkCell is one non-empty chunk and the shapes that overlap it
+type chunkCell struct {
+	x, y   int
+	shapes []chunkShape
+	root   int32 // Root of the cell in the laid out node array
+}
+
+// BuildChunked builds the tree like Build, but lays it out so that an edit only changes the nodes
+// of the chunks it touches. Chunk-local edits then stay small in binary patches.
+// Every chunk gets its own merged tree with only the shapes that overlap it, and a tree of
+// axis-aligned splits on chunk borders picks the chunk of a query. Each chunk is one block of
+// the node array, padded to a stable capacity with its root in the last slot, so blocks after
+// an edited chunk keep their indices as long as the edited chunk stays within its capacity.
+// The order of the outlines and placements in the level does not matter.
+func (b *BSPBuilder) BuildChunked(chunkSize float32) *pb.LevelData {
+	shapes, prefabRoots := b.chunkShapes()
+	if len(shapes) == 0 {
+		root := b.addLeafNode(0, []int32{}, false)
+		return &pb.LevelData{Nodes: b.nodes, RootIndex: root}
+	}
+
+	// Assign shapes to the chunks their bounds overlap
+	cellIndex := make(map[[2]int]*chunkCell)
+	var cells []*chunkCell
+	for _, shape := range shapes {
+		x0, y0 := chunkCoord(shape.min.X-chunkMargin, chunkSize), chunkCoord(shape.min.Y-chunkMargin, chunkSize)
+		x1, y1 := chunkCoord(shape.max.X+chunkMargin, chunkSize), chunkCoord(shape.max.Y+chunkMargin, chunkSize)
+		for y := y0; y <= y1; y++ {
+			for x := x0; x <= x1; x++ {
+				cell, ok := cellIndex[[2]int{x, y}]
+				if !ok {
+					cell = &chunkCell{x: x, y: y}
+					cellIndex[[2]int{x, y}] = cell
+					cells = append(cells, cell)
+				}
+				cell.shapes = append(cell.shapes, shape)
+			}
+		}
+	}
+	sort.Slice(cells, func(i, j int) bool {
+		if cells[i].y != cells[j].y {
+			return cells[i].y < cells[j].y
+		}
+		return cells[i].x < cells[j].x
+	})
+
+	layout := &chunkLayout{prefabs: make(map[int32]int32)}
+	if len(prefabRoots) > 0 {
+		for i, root := range layout.block(prefabRoots, b.nodes) {
+			layout.prefabs[prefabRoots[i]] = root
+		}
+	}
+	for _, cell := range cells {
+		// Shapes are merged in spatial order, not in the order they appear in the level
+		sort.SliceStable(cell.shapes, func(i, j int) bool {
+			a, b := cell.shapes[i], cell.shapes[j]
+			switch {
+			case a.min.Y != b.min.Y:
+				return a.min.Y < b.min.Y
+			case a.min.X != b.min.X:
+				return a.min.X < b.min.X
+			case a.max.Y != b.max.Y:
+				return a.max.Y < b.max.Y
+			default:
+				return a.max.X < b.max.X
+			}
+		})
+		roots := make([]int32, len(cell.shapes))
+		for i, shape := range cell.shapes {
+			roots[i] = shape.root
+		}
+		cell.root = layout.block([]int32{b.mergeTrees(roots)}, b.nodes)[0]
+	}
+
+	// The chunk tree is the last block, so the root is the last node
+	grid := &BSPBuilder{}
+	gridRoot := grid.buildChunkGrid(cells, chunkSize)
+	root := layout.block([]int32{gridRoot}, grid.nodes)[0]
+	return &pb.LevelData{Nodes: layout.nodes, RootIndex: root}
+}
+
+// chunkCoord returns the chunk a coordinate falls into
+func chunkCoord(v, chunkSize float32) int {
+	return int(math.Floor(float64(v / chunkSize)))
+}
+
+// chunkShapes builds one tree per solid piece, circle and placement with its world-space bounds
+// Returns the shapes and the roots of the prefab subtrees, sorted by prefab name
+func (b *BSPBuilder) chunkShapes() ([]chunkShape, []int32) {
+	var shapes []chunkShape
+	for _, poly := range b.Polygons {
+		if !poly.IsSolid {
+			continue
+		}
+		if circle, ok := DetectCircle(poly, CircleTolerance, CircleMinVertices); ok {
+			shapes = append(shapes, chunkShape{
+				root: b.buildCircleTree(circle),
+				min:  Point{X: circle.Center.X - circle.Radius, Y: circle.Center.Y - circle.Radius},
+				max:  Point{X: circle.Center.X + circle.Radius, Y: circle.Center.Y + circle.Radius},
+			})
+			continue
+		}
+		pieces, err := b.partition(poly)
+		if err != nil {
+			continue
+		}
+		for _, piece := range pieces {
+			if !piece.IsSolid || len(piece.Vertices) < 3 {
+				continue
+			}
+			shape := chunkShape{root: b.buildConvexPolygonTree(piece), min: piece.Vertices[0], max: piece.Vertices[0]}
+			for _, v := range piece.Vertices[1:] {
+				shape.min = Point{X: min(shape.min.X, v.X), Y: min(shape.min.Y, v.Y)}
+				shape.max = Point{X: max(shape.max.X, v.X), Y: max(shape.max.Y, v.Y)}
+			}
+			shapes = append(shapes, shape)
+		}
+	}
+
+	names := make([]string, 0, len(b.Prefabs))
+	for name := range b.Prefabs {
+		names = append(names, name)
+	}
+	sort.Strings(names)
+	subtrees := make(map[string]*prefabSubtree)
+	var prefabRoots []int32
+	for _, name := range names {
+		if subtree := b.buildPrefabSubtree(b.Prefabs[name]); subtree != nil {
+			subtrees[name] = subtree
+			prefabRoots = append(prefabRoots, subtree.rootIndex)
+		}
+	}
+	for _, inst := range b.Instances {
+		subtree := subtrees[inst.Prefab]
+		if subtree == nil || inst.Transform.Determinant() == 0 {
+			continue
+		}
+		worldMin, worldMax := subtree.worldBounds(inst.Transform)
+		shapes = append(shapes, chunkShape{root: b.buildInstanceTree(subtree, inst.Transform), min: worldMin, max: worldMax})
+	}
+	return shapes, prefabRoots
+}
+
+// buildChunkGrid builds a tree of axis-aligned splits on chunk borders with one cell per leaf
+// Cells are split at the median along the axis they spread most on. Queries that end in a cell
+// outside of its chunk are in an empty chunk, where no shape of the cell is solid either.
+// The cell roots are negative placeholders (-1 - cell) that chunkLayout resolves
+func (b *BSPBuilder) buildChunkGrid(cells []*chunkCell, chunkSize float32) int32 {
+	var build func(cells []*chunkCell) int32
+	build = func(cells []*chunkCell) int32 {
+		if len(cells) == 1 {
+			return -1 - cells[0].root
+		}
+		minX, maxX, minY, maxY := cells[0].x, cells[0].x, cells[0].y, cells[0].y
+		for _, cell := range cells[1:] {
+			minX, maxX = min(minX, cell.x), max(maxX, cell.x)
+			minY, maxY = min(minY, cell.y), max(maxY, cell.y)
+		}
+		splitX := maxX-minX >= maxY-minY
+
+		sorted := append([]*chunkCell(nil), cells...)
+		sort.SliceStable(sorted, func(i, j int) bool {
+			if splitX {
+				return sorted[i].x < sorted[j].x
+			}
+			return sorted[i].y < sorted[j].y
+		})
+		// First cell of the upper half, moved down if neighbors share its coordinate
+		mid := len(sorted) / 2
+		coord := func(cell *chunkCell) int {
+			if splitX {
+				return cell.x
+			}
+			return cell.y
+		}
+		for mid > 0 && coord(sorted[mid-1]) == coord(sorted[mid]) {
+			mid--
+		}
+		if mid == 0 {
+			mid = len(sorted) / 2
+			for mid < len(sorted) && coord(sorted[mid-1]) == coord(sorted[mid]) {
+				mid++
+			}
+		}
+
+		threshold := float32(coord(sorted[mid])) * chunkSize
+		belowIdx := build(sorted[:mid])
+		aboveIdx := build(sorted[mid:])
+		if splitX {
+			return b.addSplitNode(1, 0, threshold, aboveIdx, belowIdx)
+		}
+		return b.addSplitNode(0, 1, threshold, aboveIdx, belowIdx)
+	}
+	return build(cells)
+}
+
+// chunkLayout copies subtrees into blocks of a new node array
+type chunkLayout struct {
+	nodes   []*pb.BSPNode
+	prefabs map[int32]int32 // Prefab subtree roots in the builder -> index in nodes
+}
+
+// chunkCapacity returns the number of slots reserved for a block of n nodes
+// Capacities grow by 1.5x or 4/3x steps, so most edits fit into the capacity a block already has
+func chunkCapacity(n int) int {
+	capacity := 16
+	for capacity < n {
+		if capacity&(capacity-1) == 0 {
+			capacity += capacity / 2
+		} else {
+			capacity += capacity / 3
+		}
+	}
+	return capacity
+}
+
+// block copies the subtrees at roots into one padded block and returns their new indices
+// Nodes are copied children first, so every node points backwards in the array. Instances point
+// into the prefab block, which is laid out first. With a single root, it takes the last slot.
+// Negative indices are cell roots that are already laid out (see buildChunkGrid)
+func (l *chunkLayout) block(roots []int32, src []*pb.BSPNode) []int32 {
+	start := len(l.nodes)
+	remap := make(map[int32]int32)
+
+	var visit func(idx int32) int32
+	visit = func(idx int32) int32 {
+		if idx < 0 {
+			return -1 - idx
+		}
+		if newIdx, ok := remap[idx]; ok {
+			return newIdx
+		}
+		if int(idx) >= len(src) {
+			return idx
+		}
+
+		var node *pb.BSPNode
+		switch n := src[idx].Type.(type) {
+		case *pb.BSPNode_Split:
+			split := *n.Split
+			split.FrontIndex = visit(n.Split.FrontIndex)
+			split.BackIndex = visit(n.Split.BackIndex)
+			node = &pb.BSPNode{Type: &pb.BSPNode_Split{Split: &split}}
+		case *pb.BSPNode_AxisSplit:
+			split := *n.AxisSplit
+			split.FrontIndex = visit(n.AxisSplit.FrontIndex)
+			split.BackIndex = visit(n.AxisSplit.BackIndex)
+			node = &pb.BSPNode{Type: &pb.BSPNode_AxisSplit{AxisSplit: &split}}
+		case *pb.BSPNode_Instance:
+			inst := *n.Instance
+			if subtree, ok := l.prefabs[n.Instance.SubtreeIndex]; ok {
+				inst.SubtreeIndex = subtree
+			} else {
+				inst.SubtreeIndex = visit(n.Instance.SubtreeIndex)
+			}
+			inst.NextIndex = visit(n.Instance.NextIndex)
+			node = &pb.BSPNode{Type: &pb.BSPNode_Instance{Instance: &inst}}
+		case *pb.BSPNode_Circle:
+			circle := *n.Circle
+			circle.OutsideIndex = visit(n.Circle.OutsideIndex)
+			node = &pb.BSPNode{Type: &pb.BSPNode_Circle{Circle: &circle}}
+		default:
+			node = src[idx]
+		}
+
+		newIdx := int32(len(l.nodes))
+		l.nodes = append(l.nodes, node)
+		remap[idx] = newIdx
+		return newIdx
+	}
+
+	newRoots := make([]int32, len(roots))
+	for i, root := range roots {
+		newRoots[i] = visit(root)
+	}
+
+	// Pad with unreachable empty leaves, keeping a single root at the end
+	end := start + chunkCapacity(len(l.nodes)-start)
+	var last *pb.BSPNode
+	if len(roots) == 1 && int(newRoots[0]) == len(l.nodes)-1 && len(l.nodes) > start {
+		last = l.nodes[len(l.nodes)-1]
+		l.nodes = l.nodes[:len(l.nodes)-1]
+		end--
+	}
+	for len(l.nodes) < end {
+		l.nodes = append(l.nodes, &pb.BSPNode{Type: &pb.BSPNode_Leaf{Leaf: &pb.Leaf{}}})
+	}
+	if last != nil {
+		newRoots[0] = int32(len(l.nodes))
+		l.nodes = append(l.nodes, last)
+	}
+	return newRoots
+}
@@ -0,0 +1,68 @@
+package bsp
+
+import (
+	"testing"
+
+	"google.golang.org/protobuf/proto"
+)
+
+// chunkTestPolygons returns a grid of squares, one every 10 units, shifted by offset[i] each
+func chunkTestPolygons(offsets map[int]float32) []Polygon {
+	var polygons []Polygon
+	for i := 0; i < 64; i++ {
+		x, y := float32(i%8)*10+offsets[i], float32(i/8)*10
+		polygons = append(polygons, Polygon{
+			Vertices: []Point{{X: x, Y: y}, {X: x + 3, Y: y}, {X: x + 3, Y: y + 3}, {X: x, Y: y + 3}},
+			IsSolid:  true,
+		})
+	}
+	return polygons
+}
+
+func TestBuildChunked(t *testing.T) {
+	t.Run("Queries match the exact tree", func(t *testing.T) {
+		want := bvhTestBuilder().Build()
+		got := bvhTestBuilder().BuildChunked(LayoutChunkSize)
+		for y := float32(-8.13); y < 9; y += 0.31 {
+			for x := float32(-2.07); x < 52; x += 0.29 {
+				p := Point{X: x, Y: y}
+				if PointInBSP(got.Nodes, got.RootIndex, p) != PointInBSP(want.Nodes, want.RootIndex, p) {
+					t.Errorf("Point (%.2f, %.2f): chunked tree disagrees with the exact tree", x, y)
+				}
+			}
+		}
+		if int(got.RootIndex) != len(got.Nodes)-1 {
+			t.Errorf("Expected the root in the last slot, got %d of %d", got.RootIndex, len(got.Nodes))
+		}
+	})
+
+	t.Run("Outline order does not matter", func(t *testing.T) {
+		polygons := chunkTestPolygons(nil)
+		reversed := make([]Polygon, len(polygons))
+		for i, poly := range polygons {
+			reversed[len(polygons)-1-i] = poly
+		}
+		a := NewBSPBuilder(polygons).BuildChunked(LayoutChunkSize)
+		b := NewBSPBuilder(reversed).BuildChunked(LayoutChunkSize)
+		if !proto.Equal(a, b) {
+			t.Error("Expected the same layout for reordered outlines")
+		}
+	})
+
+	t.Run("Edits stay in their chunk", func(t *testing.T) {
+		before := NewBSPBuilder(chunkTestPolygons(nil)).BuildChunked(LayoutChunkSize)
+		after := NewBSPBuilder(chunkTestPolygons(map[int]float32{27: 0.5})).BuildChunked(LayoutChunkSize)
+		if len(before.Nodes) != len(after.Nodes) {
+			t.Fatalf("Expected the same number of nodes, got %d and %d", len(before.Nodes), len(after.Nodes))
+		}
+		changed := 0
+		for i := range before.Nodes {
+			if !proto.Equal(before.Nodes[i], after.Nodes[i]) {
+				changed++
+			}
+		}
+		if changed == 0 || changed > len(before.Nodes)/8 {
+			t.Errorf("Expected a few changed nodes, got %d of %d", changed, len(before.Nodes))
+		}
+	})
+}
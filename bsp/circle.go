@@ -0,0 +1,118 @@
+package bsp
+
+import (
+	"math"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+const (
+	// CircleTolerance is how far (in world units) a circle may deviate from the outline it replaces
+	CircleTolerance = 0.05
+	// CircleMinVertices is the minimum vertex count of an outline to be considered a circle
+	CircleMinVertices = 8
+)
+
+// Circle is a solid disc
+type Circle struct {
+	Center Point
+	Radius float32
+}
+
+// Contains returns true if the point is inside or on the circle
+func (c Circle) Contains(p Point) bool {
+	dx := p.X - c.Center.X
+	dy := p.Y - c.Center.Y
+	return dx*dx+dy*dy <= c.Radius*c.Radius
+}
+
+// circleFromNode reads the circle stored in a circle node
+func circleFromNode(c *pb.Circle) Circle {
+	return Circle{
+		Center: Point{X: c.CenterX, Y: c.CenterY},
+		Radius: c.Radius,
+	}
+}
+
+// traceCircle returns the parametric value where the segment from `from` to `to` first
+// touches the circle within [t0, t1]
+func traceCircle(c Circle, from, to Point, t0, t1 float32) (bool, float32) {
+	// Solve |from + t*d - center|^2 = r^2 for t
+	dx := float64(to.X - from.X)
+	dy := float64(to.Y - from.Y)
+	fx := float64(from.X - c.Center.X)
+	fy := float64(from.Y - c.Center.Y)
+	r := float64(c.Radius)
+
+	startX := fx + float64(t0)*dx
+	startY := fy + float64(t0)*dy
+	if startX*startX+startY*startY <= r*r {
+		// Segment starts inside
+		return true, t0
+	}
+
+	a := dx*dx + dy*dy
+	if a == 0 {
+		return false, 0
+	}
+	b := 2 * (fx*dx + fy*dy)
+	cc := fx*fx + fy*fy - r*r
+	disc := b*b - 4*a*cc
+	if disc < 0 {
+		return false, 0
+	}
+
+	// The segment starts outside, so the smaller root is the entry
+	t := float32((-b - math.Sqrt(disc)) / (2 * a))
+	if t < t0 || t > t1 {
+		return false, 0
+	}
+	return true, t
+}
+
+// buildCircleTrees replaces solid outlines that approximate a circle by circle primitives
+// Returns the circle trees and the polygons that are not circles
+func (b *BSPBuilder) buildCircleTrees(polygons []Polygon) ([]int32, []Polygon) {
+	var circleTrees []int32
+	remaining := make([]Polygon, 0, len(polygons))
+	for _, poly := range polygons {
+		if poly.IsSolid {
+			if circle, ok := DetectCircle(poly, CircleTolerance, CircleMinVertices); ok {
+				circleTrees = append(circleTrees, b.buildCircleTree(circle))
+				continue
+			}
+		}
+		remaining = append(remaining, poly)
+	}
+	return circleTrees, remaining
+}
+
+// buildCircleTree builds a circle node guarded by the bounding box of the circle
+func (b *BSPBuilder) buildCircleTree(circle Circle) int32 {
+	// Empty space around the circle is a non-solid leaf, so mergeTreePair can hang other trees there
+	outsideIdx := b.addLeafNode(0, []int32{}, false)
+	nodeIdx := b.addCircleNode(circle, outsideIdx)
+
+	return b.addBoundsGuard(
+		Point{X: circle.Center.X - circle.Radius, Y: circle.Center.Y - circle.Radius},
+		Point{X: circle.Center.X + circle.Radius, Y: circle.Center.Y + circle.Radius},
+		nodeIdx,
+	)
+}
+
+// addCircleNode creates a new circle node and adds it to the flat array
+func (b *BSPBuilder) addCircleNode(circle Circle, outsideIdx int32) int32 {
+	idx := int32(len(b.nodes))
+	node := &pb.BSPNode{
+		Type: &pb.BSPNode_Circle{
+			Circle: &pb.Circle{
+				CenterX:      circle.Center.X,
+				CenterY:      circle.Center.Y,
+				Radius:       circle.Radius,
+				OutsideIndex: outsideIdx,
+			},
+		},
+	}
+	b.nodes = append(b.nodes, node)
+	return idx
+}
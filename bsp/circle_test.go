@@ -0,0 +1,129 @@
+package bsp
+
+import (
+	"math"
+	"testing"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// regularPolygon returns an n-gon with its vertices on the given circle
+func regularPolygon(center Point, radius float32, n int) Polygon {
+	vertices := make([]Point, n)
+	for i := range vertices {
+		angle := 2 * math.Pi * float64(i) / float64(n)
+		vertices[i] = Point{
+			X: center.X + radius*float32(math.Cos(angle)),
+			Y: center.Y + radius*float32(math.Sin(angle)),
+		}
+	}
+	return Polygon{Vertices: vertices, IsSolid: true}
+}
+
+func TestDetectCircle(t *testing.T) {
+	t.Run("Round pillar", func(t *testing.T) {
+		circle, ok := DetectCircle(regularPolygon(Point{X: 3, Y: -2}, 1.5, 48), CircleTolerance, CircleMinVertices)
+		if !ok {
+			t.Fatal("Expected a 48-gon to be detected as a circle")
+		}
+		if math.Abs(float64(circle.Center.X-3)) > 0.001 || math.Abs(float64(circle.Center.Y+2)) > 0.001 {
+			t.Errorf("Expected center (3, -2), got (%f, %f)", circle.Center.X, circle.Center.Y)
+		}
+		if math.Abs(float64(circle.Radius-1.5)) > 0.001 {
+			t.Errorf("Expected radius 1.5, got %f", circle.Radius)
+		}
+	})
+
+	t.Run("Coarse polygon", func(t *testing.T) {
+		// The chords of a large 8-gon leave the circle by far more than the tolerance
+		if _, ok := DetectCircle(regularPolygon(Point{}, 10, 8), CircleTolerance, CircleMinVertices); ok {
+			t.Error("Expected a large octagon not to be a circle")
+		}
+	})
+
+	t.Run("Square", func(t *testing.T) {
+		square := Polygon{Vertices: []Point{{X: 0, Y: 0}, {X: 1, Y: 0}, {X: 1, Y: 1}, {X: 0, Y: 1}}, IsSolid: true}
+		if _, ok := DetectCircle(square, CircleTolerance, 3); ok {
+			t.Error("Expected a square not to be a circle")
+		}
+	})
+}
+
+func TestCircleBSP(t *testing.T) {
+	pillar := regularPolygon(Point{X: 5, Y: 0}, 1, 64)
+	wall := Polygon{
+		Vertices: []Point{{X: -1, Y: -3}, {X: 0, Y: -3}, {X: 0, Y: 3}, {X: -1, Y: 3}},
+		IsSolid:  true,
+	}
+
+	builder := NewBSPBuilder([]Polygon{pillar, wall})
+	levelData := builder.Build()
+
+	circles := 0
+	for _, node := range levelData.Nodes {
+		if _, ok := node.Type.(*pb.BSPNode_Circle); ok {
+			circles++
+		}
+	}
+	if circles == 0 {
+		t.Fatal("Expected the pillar to become a circle node")
+	}
+
+	// A 64-gon would need 64 edge planes, the circle only needs its bounding box guard
+	if len(levelData.Nodes) > 30 {
+		t.Errorf("Expected a small tree, got %d nodes", len(levelData.Nodes))
+	}
+
+	tests := []struct {
+		name  string
+		point Point
+		solid bool
+	}{
+		{"Center of pillar", Point{X: 5, Y: 0}, true},
+		{"Inside pillar near the edge", Point{X: 5.7, Y: 0.7}, true},
+		{"Bounding box corner outside pillar", Point{X: 5.9, Y: 0.9}, false},
+		{"Inside wall", Point{X: -0.5, Y: 0}, true},
+		{"Between wall and pillar", Point{X: 2, Y: 0}, false},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			if got := PointInBSP(levelData.Nodes, levelData.RootIndex, tt.point); got != tt.solid {
+				t.Errorf("PointInBSP(%v) = %v, expected %v", tt.point, got, tt.solid)
+			}
+		})
+	}
+
+	t.Run("Trace hits pillar exactly", func(t *testing.T) {
+		hit, hitX, hitY := LineTraceBSPNode(levelData.Nodes, levelData.RootIndex, Point{X: 10, Y: 0.6}, Point{X: 2, Y: 0.6}, 0, 1)
+		if !hit {
+			t.Fatal("Expected the trace to hit the pillar")
+		}
+		// Entry at x = 5 + sqrt(1 - 0.36) = 5.8
+		if math.Abs(float64(hitX-5.8)) > 0.0001 || math.Abs(float64(hitY-0.6)) > 0.0001 {
+			t.Errorf("Expected hit at (5.8, 0.6), got (%f, %f)", hitX, hitY)
+		}
+	})
+
+	t.Run("Trace picks the nearest hit", func(t *testing.T) {
+		hit, hitX, _ := LineTraceBSPNode(levelData.Nodes, levelData.RootIndex, Point{X: 2, Y: 0}, Point{X: 10, Y: 0}, 0, 1)
+		if !hit || math.Abs(float64(hitX-4)) > 0.0001 {
+			t.Errorf("Expected to hit the pillar at x = 4, got hit=%v at %f", hit, hitX)
+		}
+
+		hit, hitX, _ = LineTraceBSPNode(levelData.Nodes, levelData.RootIndex, Point{X: 10, Y: 0}, Point{X: -5, Y: 0}, 0, 1)
+		if !hit || math.Abs(float64(hitX-6)) > 0.0001 {
+			t.Errorf("Expected to hit the pillar at x = 6 before the wall, got hit=%v at %f", hit, hitX)
+		}
+
+		hit, hitX, _ = LineTraceBSPNode(levelData.Nodes, levelData.RootIndex, Point{X: 2, Y: 0}, Point{X: -5, Y: 0}, 0, 1)
+		if !hit || math.Abs(float64(hitX)) > 0.0001 {
+			t.Errorf("Expected to hit the wall at x = 0, got hit=%v at %f", hit, hitX)
+		}
+	})
+
+	t.Run("Trace passes beside pillar", func(t *testing.T) {
+		if hit, _, _ := LineTraceBSPNode(levelData.Nodes, levelData.RootIndex, Point{X: 10, Y: 0.95}, Point{X: 5.5, Y: 1.5}, 0, 1); hit {
+			t.Error("Expected the trace to miss the pillar")
+		}
+	})
+}
@@ -0,0 +1,385 @@
+package bsp
+
+import (
+	"fmt"
+	"hash/fnv"
+	"math"
+	"sort"
+	"strconv"
+	"strings"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// CodegenLanguage selects the language of generated query code
+type CodegenLanguage string
+
+const (
+	CodegenC    CodegenLanguage = "c"
+	CodegenOdin CodegenLanguage = "odin"
+)
+
+// MaxCodegenNodes is the largest BSP tree that is compiled into code
+// Straight-line code only pays off for small trees, bigger ones mostly grow the binary
+const MaxCodegenNodes = 4096
+
+// CodegenLevel is a level whose point query is compiled into source code
+type CodegenLevel struct {
+	Path      string // Level path as loaded by the game, e.g. "levels/arena.pb"
+	LevelData *pb.LevelData
+}
+
+// CodegenName turns a level path into the identifier prefix of its generated functions
+// GenerateQuerySource appends a hash of the path to names that several of its levels share
+func CodegenName(path string) string {
+	path = strings.TrimSuffix(path, ".pb")
+	path = strings.TrimSuffix(path, ".yaml")
+	var name strings.Builder
+	for _, r := range path {
+		switch {
+		case r >= 'a' && r <= 'z', r >= '0' && r <= '9', r == '_':
+			name.WriteRune(r)
+		case r >= 'A' && r <= 'Z':
+			name.WriteRune(r - 'A' + 'a')
+		default:
+			name.WriteByte('_')
+		}
+	}
+	return "level_" + name.String()
+}
+
+// codegenNames returns the identifier prefix of every level
+// Paths that only differ in characters CodegenName replaces (a-b.pb and a_b.pb) would define the
+// same functions twice, so names that collide get a hash of their level path appended
+func codegenNames(levels []CodegenLevel) ([]string, error) {
+	names := make([]string, len(levels))
+	counts := make(map[string]int)
+	for i, lvl := range levels {
+		names[i] = CodegenName(lvl.Path)
+		counts[names[i]]++
+	}
+
+	paths := make(map[string]string)
+	for i, lvl := range levels {
+		if counts[names[i]] > 1 {
+			h := fnv.New32a()
+			h.Write([]byte(lvl.Path))
+			names[i] = fmt.Sprintf("%s_%08x", names[i], h.Sum32())
+		}
+		if other, ok := paths[names[i]]; ok {
+			return nil, fmt.Errorf("levels %s and %s both generate %s", other, lvl.Path, names[i])
+		}
+		paths[names[i]] = lvl.Path
+	}
+	return names, nil
+}
+
+// GenerateQuerySource compiles the BSP trees of the given levels into a source file
+// Every level gets a function `<name>_point_in_solid(x, y)` with its planes inlined as constants
+// in nested branches, answering exactly like PointInBSP, plus a lookup by level path
+// C output is a single translation unit; Odin output belongs to the given package
+func GenerateQuerySource(lang CodegenLanguage, pkg string, levels []CodegenLevel) (string, error) {
+	if lang != CodegenC && lang != CodegenOdin {
+		return "", fmt.Errorf("unknown codegen language %q (c/odin)", lang)
+	}
+
+	names, err := codegenNames(levels)
+	if err != nil {
+		return "", err
+	}
+
+	var out strings.Builder
+	out.WriteString("// Code generated by venture. DO NOT EDIT.\n\n")
+	if lang == CodegenC {
+		out.WriteString("#include <stdbool.h>\n#include <stddef.h>\n#include <string.h>\n\n")
+		out.WriteString("typedef bool (*venture_point_query)(float x, float y);\n")
+	} else {
+		fmt.Fprintf(&out, "package %s\n\n", pkg)
+		out.WriteString("Point_Query :: #type proc \"contextless\" (x, y: f32) -> bool\n")
+	}
+
+	for i, lvl := range levels {
+		if err := generateLevelQuery(&out, lang, names[i], lvl.LevelData); err != nil {
+			return "", fmt.Errorf("generating query for %s: %w", lvl.Path, err)
+		}
+	}
+
+	// Lookup by level path
+	if lang == CodegenC {
+		out.WriteString("\nventure_point_query venture_level_point_query(const char *path) {\n")
+		for i, lvl := range levels {
+			fmt.Fprintf(&out, "\tif (strcmp(path, %s) == 0) return %s_point_in_solid;\n", strconv.Quote(lvl.Path), names[i])
+		}
+		out.WriteString("\treturn NULL;\n}\n")
+	} else {
+		out.WriteString("\npoint_query :: proc(path: string) -> (Point_Query, bool) {\n\tswitch path {\n")
+		for i, lvl := range levels {
+			fmt.Fprintf(&out, "\tcase %s:\n\t\treturn %s_point_in_solid, true\n", strconv.Quote(lvl.Path), names[i])
+		}
+		out.WriteString("\t}\n\treturn nil, false\n}\n")
+	}
+
+	return out.String(), nil
+}
+
+// queryCodegen emits the functions of a single level
+type queryCodegen struct {
+	out       *strings.Builder
+	lang      CodegenLanguage
+	name      string
+	nodes     []*pb.BSPNode
+	functions map[int32]bool // Nodes that get their own function instead of being inlined
+	blocks    int            // Counter for unique local names in Odin scopes
+}
+
+// generateLevelQuery emits the point query of a single level
+func generateLevelQuery(out *strings.Builder, lang CodegenLanguage, name string, levelData *pb.LevelData) error {
+	if len(levelData.Nodes) == 0 {
+		return fmt.Errorf("level has no BSP tree")
+	}
+	if len(levelData.Nodes) > MaxCodegenNodes {
+		return fmt.Errorf("BSP tree has %d nodes, code is only generated up to %d", len(levelData.Nodes), MaxCodegenNodes)
+	}
+
+	g := &queryCodegen{
+		out:       out,
+		lang:      lang,
+		name:      name,
+		nodes:     levelData.Nodes,
+		functions: sharedQueryNodes(levelData.Nodes, levelData.RootIndex),
+	}
+
+	roots := make([]int32, 0, len(g.functions))
+	for idx := range g.functions {
+		roots = append(roots, idx)
+	}
+	sort.Slice(roots, func(i, j int) bool { return roots[i] < roots[j] })
+
+	// C needs the helpers declared before they are called
+	out.WriteString("\n")
+	if lang == CodegenC {
+		for _, idx := range roots {
+			if idx != levelData.RootIndex {
+				fmt.Fprintf(out, "static bool %s(float x, float y);\n", g.functionName(idx))
+			}
+		}
+	}
+
+	for _, idx := range roots {
+		if err := g.function(idx, idx == levelData.RootIndex); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// sharedQueryNodes returns the nodes that become functions: the root, prefab subtrees
+// and every node reached from more than one parent (merged trees share subtrees)
+func sharedQueryNodes(nodes []*pb.BSPNode, rootIndex int32) map[int32]bool {
+	refs := make(map[int32]int)
+	functions := map[int32]bool{rootIndex: true}
+
+	var visit func(idx int32)
+	visit = func(idx int32) {
+		if idx < 0 || int(idx) >= len(nodes) {
+			return
+		}
+		refs[idx]++
+		if refs[idx] > 1 {
+			if _, ok := nodes[idx].Type.(*pb.BSPNode_Leaf); !ok {
+				functions[idx] = true
+			}
+			return
+		}
+		switch n := nodes[idx].Type.(type) {
+		case *pb.BSPNode_Split:
+			visit(n.Split.FrontIndex)
+			visit(n.Split.BackIndex)
+		case *pb.BSPNode_AxisSplit:
+			visit(n.AxisSplit.FrontIndex)
+			visit(n.AxisSplit.BackIndex)
+		case *pb.BSPNode_Instance:
+			functions[n.Instance.SubtreeIndex] = true
+			visit(n.Instance.SubtreeIndex)
+			visit(n.Instance.NextIndex)
+		case *pb.BSPNode_Circle:
+			visit(n.Circle.OutsideIndex)
+		}
+	}
+	visit(rootIndex)
+	return functions
+}
+
+// functionName returns the name of the function generated for a node
+func (g *queryCodegen) functionName(idx int32) string {
+	return fmt.Sprintf("%s_node_%d", g.name, idx)
+}
+
+// function emits the function of a node
+func (g *queryCodegen) function(idx int32, public bool) error {
+	name := g.functionName(idx)
+	if public {
+		name = g.name + "_point_in_solid"
+	}
+
+	switch {
+	case g.lang == CodegenC && public:
+		fmt.Fprintf(g.out, "\nbool %s(float x, float y) {\n", name)
+	case g.lang == CodegenC:
+		fmt.Fprintf(g.out, "\nstatic bool %s(float x, float y) {\n", name)
+	case public:
+		fmt.Fprintf(g.out, "\n%s :: proc \"contextless\" (x, y: f32) -> bool {\n", name)
+	default:
+		fmt.Fprintf(g.out, "\n@(private = \"file\")\n%s :: proc \"contextless\" (x, y: f32) -> bool {\n", name)
+	}
+	if err := g.body(idx, 1, true); err != nil {
+		return err
+	}
+	g.out.WriteString("}\n")
+	return nil
+}
+
+// body emits the statements answering a query at a node
+// Every branch ends in a return, so back sides follow their split without an else
+func (g *queryCodegen) body(idx int32, depth int, top bool) error {
+	indent := strings.Repeat("\t", depth)
+	if idx < 0 || int(idx) >= len(g.nodes) || g.nodes[idx] == nil {
+		fmt.Fprintf(g.out, "%sreturn false%s\n", indent, g.semicolon())
+		return nil
+	}
+	if !top && g.functions[idx] {
+		fmt.Fprintf(g.out, "%sreturn %s(x, y)%s\n", indent, g.functionName(idx), g.semicolon())
+		return nil
+	}
+
+	switch n := g.nodes[idx].Type.(type) {
+	case *pb.BSPNode_Leaf:
+		fmt.Fprintf(g.out, "%sreturn %t%s\n", indent, n.Leaf.IsSolid, g.semicolon())
+		return nil
+
+	case *pb.BSPNode_Split:
+		split := n.Split
+		nx, err := g.literal(split.NormalX)
+		if err != nil {
+			return err
+		}
+		ny, err := g.literal(split.NormalY)
+		if err != nil {
+			return err
+		}
+		d, err := g.literal(float32(math.Abs(float64(split.Distance))))
+		if err != nil {
+			return err
+		}
+		op := "-"
+		if split.Distance < 0 {
+			op = "+"
+		}
+		g.branch(indent, fmt.Sprintf("%s * x + %s * y %s %s > 0", nx, ny, op, d))
+		if err := g.body(split.FrontIndex, depth+1, false); err != nil {
+			return err
+		}
+		fmt.Fprintf(g.out, "%s}\n", indent)
+		return g.body(split.BackIndex, depth, false)
+
+	case *pb.BSPNode_AxisSplit:
+		split := n.AxisSplit
+		threshold, err := g.literal(split.Threshold)
+		if err != nil {
+			return err
+		}
+		coord, cmp := "x", ">"
+		if split.Axis == axisY {
+			coord = "y"
+		}
+		if split.FrontBelow {
+			cmp = "<"
+		}
+		g.branch(indent, fmt.Sprintf("%s %s %s", coord, cmp, threshold))
+		if err := g.body(split.FrontIndex, depth+1, false); err != nil {
+			return err
+		}
+		fmt.Fprintf(g.out, "%s}\n", indent)
+		return g.body(split.BackIndex, depth, false)
+
+	case *pb.BSPNode_Circle:
+		c := n.Circle
+		cx, err := g.literal(c.CenterX)
+		if err != nil {
+			return err
+		}
+		cy, err := g.literal(c.CenterY)
+		if err != nil {
+			return err
+		}
+		// Same float32 product as Circle.Contains
+		r2, err := g.literal(c.Radius * c.Radius)
+		if err != nil {
+			return err
+		}
+		g.blocks++
+		dx, dy := fmt.Sprintf("dx%d", g.blocks), fmt.Sprintf("dy%d", g.blocks)
+		if g.lang == CodegenC {
+			fmt.Fprintf(g.out, "%s{\n%s\tfloat %s = x - %s;\n%s\tfloat %s = y - %s;\n", indent, indent, dx, cx, indent, dy, cy)
+		} else {
+			fmt.Fprintf(g.out, "%s{\n%s\t%s := x - %s\n%s\t%s := y - %s\n", indent, indent, dx, cx, indent, dy, cy)
+		}
+		g.branch(indent+"\t", fmt.Sprintf("%s * %s + %s * %s <= %s", dx, dx, dy, dy, r2))
+		fmt.Fprintf(g.out, "%s\t\treturn true%s\n%s\t}\n%s}\n", indent, g.semicolon(), indent, indent)
+		return g.body(c.OutsideIndex, depth, false)
+
+	case *pb.BSPNode_Instance:
+		inst := n.Instance
+		var m [6]string
+		for i, v := range []float32{inst.M00, inst.M01, inst.Tx, inst.M10, inst.M11, inst.Ty} {
+			lit, err := g.literal(v)
+			if err != nil {
+				return err
+			}
+			m[i] = lit
+		}
+		// Same float32 arithmetic as Transform2D.Apply
+		g.branch(indent, fmt.Sprintf("%s(%s * x + %s * y + %s, %s * x + %s * y + %s)",
+			g.functionName(inst.SubtreeIndex), m[0], m[1], m[2], m[3], m[4], m[5]))
+		fmt.Fprintf(g.out, "%s\treturn true%s\n%s}\n", indent, g.semicolon(), indent)
+		return g.body(inst.NextIndex, depth, false)
+	}
+
+	fmt.Fprintf(g.out, "%sreturn false%s\n", indent, g.semicolon())
+	return nil
+}
+
+// branch opens an if statement
+func (g *queryCodegen) branch(indent, cond string) {
+	if g.lang == CodegenC {
+		fmt.Fprintf(g.out, "%sif (%s) {\n", indent, cond)
+	} else {
+		fmt.Fprintf(g.out, "%sif %s {\n", indent, cond)
+	}
+}
+
+// semicolon ends a statement
+func (g *queryCodegen) semicolon() string {
+	if g.lang == CodegenC {
+		return ";"
+	}
+	return ""
+}
+
+// literal formats a float32 constant so it parses back to exactly the same value
+func (g *queryCodegen) literal(v float32) (string, error) {
+	if math.IsInf(float64(v), 0) || math.IsNaN(float64(v)) {
+		return "", fmt.Errorf("cannot emit non-finite constant %v", v)
+	}
+	s := strconv.FormatFloat(float64(v), 'g', -1, 32)
+	if !strings.ContainsAny(s, ".e") {
+		s += ".0"
+	}
+	if g.lang == CodegenC {
+		s += "f"
+	}
+	if v < 0 {
+		s = "(" + s + ")"
+	}
+	return s, nil
+}
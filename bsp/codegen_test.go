@@ -0,0 +1,255 @@
+package bsp
+
+import (
+	"fmt"
+	"math/rand"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"strings"
+	"testing"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// codegenBenchQueries is the number of random points the generated C code is checked and timed on
+const codegenBenchQueries = 4096
+
+// codegenBenchDriver checks the generated query against PointInBSP's answers and times it
+// against a data-driven traversal of the same node array
+// It expects QUERY, the node table, the query points and the expected results to be defined before it
+const codegenBenchDriver = `
+#include <stdio.h>
+#include <time.h>
+
+static bool table_query(int idx, float x, float y) {
+	for (;;) {
+		if (idx < 0 || idx >= NODE_COUNT) return false;
+		const struct node *n = &nodes[idx];
+		switch (n->kind) {
+		case 0:
+			return n->i0 != 0;
+		case 1:
+			idx = n->f[0] * x + n->f[1] * y - n->f[2] > 0 ? n->i0 : n->i1;
+			break;
+		case 2: {
+			float side = (n->f[1] != 0 ? y : x) - n->f[0];
+			if (n->f[2] != 0) side = -side;
+			idx = side > 0 ? n->i0 : n->i1;
+			break;
+		}
+		case 3: {
+			float dx = x - n->f[0], dy = y - n->f[1];
+			if (dx * dx + dy * dy <= n->f[2]) return true;
+			idx = n->i0;
+			break;
+		}
+		case 4:
+			if (table_query(n->i0, n->f[0] * x + n->f[1] * y + n->f[2], n->f[3] * x + n->f[4] * y + n->f[5])) return true;
+			idx = n->i1;
+			break;
+		default:
+			return false;
+		}
+	}
+}
+
+static double seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+	int mismatches = 0;
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		if (QUERY(points[i][0], points[i][1]) != expected[i]) mismatches++;
+		if (table_query(ROOT_INDEX, points[i][0], points[i][1]) != expected[i]) mismatches++;
+	}
+
+	const int rounds = 200;
+	volatile int sink = 0;
+	double start = seconds();
+	for (int r = 0; r < rounds; r++)
+		for (int i = 0; i < QUERY_COUNT; i++) sink += QUERY(points[i][0], points[i][1]);
+	double generated = seconds() - start;
+	start = seconds();
+	for (int r = 0; r < rounds; r++)
+		for (int i = 0; i < QUERY_COUNT; i++) sink += table_query(ROOT_INDEX, points[i][0], points[i][1]);
+	double table = seconds() - start;
+
+	double queries = (double)rounds * QUERY_COUNT;
+	printf("generated %.2f ns/query, table %.2f ns/query\n", generated / queries * 1e9, table / queries * 1e9);
+	return mismatches;
+}
+`
+
+// writeCodegenNodeTable writes the node array as a C table for the data-driven traversal
+func writeCodegenNodeTable(out *strings.Builder, levelData *pb.LevelData) {
+	out.WriteString("struct node { int kind; float f[6]; int i0, i1; };\n")
+	fmt.Fprintf(out, "#define NODE_COUNT %d\n#define ROOT_INDEX %d\n", len(levelData.Nodes), levelData.RootIndex)
+	out.WriteString("static const struct node nodes[] = {\n")
+	for _, node := range levelData.Nodes {
+		var kind, i0, i1 int32
+		var f [6]float32
+		switch n := node.Type.(type) {
+		case *pb.BSPNode_Leaf:
+			if n.Leaf.IsSolid {
+				i0 = 1
+			}
+		case *pb.BSPNode_Split:
+			kind, i0, i1 = 1, n.Split.FrontIndex, n.Split.BackIndex
+			f[0], f[1], f[2] = n.Split.NormalX, n.Split.NormalY, n.Split.Distance
+		case *pb.BSPNode_AxisSplit:
+			kind, i0, i1 = 2, n.AxisSplit.FrontIndex, n.AxisSplit.BackIndex
+			f[0], f[1] = n.AxisSplit.Threshold, float32(n.AxisSplit.Axis)
+			if n.AxisSplit.FrontBelow {
+				f[2] = 1
+			}
+		case *pb.BSPNode_Circle:
+			kind, i0 = 3, n.Circle.OutsideIndex
+			f[0], f[1], f[2] = n.Circle.CenterX, n.Circle.CenterY, n.Circle.Radius*n.Circle.Radius
+		case *pb.BSPNode_Instance:
+			inst := n.Instance
+			kind, i0, i1 = 4, inst.SubtreeIndex, inst.NextIndex
+			f = [6]float32{inst.M00, inst.M01, inst.Tx, inst.M10, inst.M11, inst.Ty}
+		}
+		fmt.Fprintf(out, "\t{%d, {%s}, %d, %d},\n", kind, cLiterals(f[:]...), i0, i1)
+	}
+	out.WriteString("};\n")
+}
+
+// cLiterals formats float32 values as a comma-separated list of exact C constants
+func cLiterals(values ...float32) string {
+	g := &queryCodegen{lang: CodegenC}
+	literals := make([]string, len(values))
+	for i, v := range values {
+		literals[i], _ = g.literal(v)
+	}
+	return strings.Join(literals, ", ")
+}
+
+func TestGenerateQuerySourceC(t *testing.T) {
+	cc, err := exec.LookPath("cc")
+	if err != nil {
+		t.Skip("no C compiler available")
+	}
+
+	levelData := bvhTestBuilder().Build()
+	source, err := GenerateQuerySource(CodegenC, "", []CodegenLevel{
+		{Path: "levels/arena.pb", LevelData: levelData},
+		{Path: "levels/box.pb", LevelData: NewBSPBuilder([]Polygon{{
+			Vertices: []Point{{X: 0, Y: 0}, {X: 1, Y: 0}, {X: 1, Y: 1}, {X: 0, Y: 1}},
+			IsSolid:  true,
+		}}).Build()},
+	})
+	if err != nil {
+		t.Fatalf("Generating C: %v", err)
+	}
+
+	var driver strings.Builder
+	driver.WriteString(source)
+	driver.WriteString("\n#define QUERY level_levels_arena_point_in_solid\n")
+	writeCodegenNodeTable(&driver, levelData)
+
+	rng := rand.New(rand.NewSource(3))
+	fmt.Fprintf(&driver, "#define QUERY_COUNT %d\nstatic const float points[][2] = {\n", codegenBenchQueries)
+	var expected strings.Builder
+	for i := 0; i < codegenBenchQueries; i++ {
+		p := Point{X: rng.Float32()*56 - 3, Y: rng.Float32()*18 - 9}
+		fmt.Fprintf(&driver, "\t{%s},\n", cLiterals(p.X, p.Y))
+		solid := 0
+		if PointInBSP(levelData.Nodes, levelData.RootIndex, p) {
+			solid = 1
+		}
+		fmt.Fprintf(&expected, "%d,", solid)
+	}
+	fmt.Fprintf(&driver, "};\nstatic const bool expected[] = {%s};\n", expected.String())
+	driver.WriteString(codegenBenchDriver)
+
+	dir := t.TempDir()
+	src := filepath.Join(dir, "query.c")
+	bin := filepath.Join(dir, "query")
+	if err := os.WriteFile(src, []byte(driver.String()), 0644); err != nil {
+		t.Fatal(err)
+	}
+	// No FMA contraction, so the C arithmetic rounds exactly like the Go traversal
+	if output, err := exec.Command(cc, "-std=c99", "-D_POSIX_C_SOURCE=199309L", "-O2", "-ffp-contract=off", "-Wall", "-Werror", "-o", bin, src).CombinedOutput(); err != nil {
+		t.Fatalf("Compiling generated C: %v\n%s", err, output)
+	}
+	output, err := exec.Command(bin).CombinedOutput()
+	if err != nil {
+		t.Fatalf("Generated query disagrees with PointInBSP (%v): %s", err, output)
+	}
+	t.Logf("%d nodes: %s", len(levelData.Nodes), strings.TrimSpace(string(output)))
+}
+
+func TestGenerateQuerySourceOdin(t *testing.T) {
+	source, err := GenerateQuerySource(CodegenOdin, "levels", []CodegenLevel{
+		{Path: "levels/Arena 2.pb", LevelData: bvhTestBuilder().Build()},
+	})
+	if err != nil {
+		t.Fatalf("Generating Odin: %v", err)
+	}
+
+	for _, want := range []string{
+		"package levels\n",
+		"level_levels_arena_2_point_in_solid :: proc \"contextless\" (x, y: f32) -> bool {",
+		"case \"levels/Arena 2.pb\":",
+	} {
+		if !strings.Contains(source, want) {
+			t.Errorf("Expected the Odin source to contain %q", want)
+		}
+	}
+	if strings.Contains(source, ";") {
+		t.Error("Odin source contains semicolons")
+	}
+	if strings.Count(source, "{") != strings.Count(source, "}") {
+		t.Error("Unbalanced braces in the Odin source")
+	}
+}
+
+func TestGenerateQuerySourceNameCollisions(t *testing.T) {
+	box := NewBSPBuilder([]Polygon{{
+		Vertices: []Point{{X: 0, Y: 0}, {X: 1, Y: 0}, {X: 1, Y: 1}, {X: 0, Y: 1}},
+		IsSolid:  true,
+	}}).Build()
+	levels := []CodegenLevel{
+		{Path: "levels/a-b.pb", LevelData: box},
+		{Path: "levels/a_b.pb", LevelData: box},
+		{Path: "levels/c.pb", LevelData: box},
+	}
+
+	names, err := codegenNames(levels)
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if names[0] == names[1] || !strings.HasPrefix(names[0], "level_levels_a_b_") || !strings.HasPrefix(names[1], "level_levels_a_b_") {
+		t.Errorf("Expected distinct names with a hash suffix, got %q and %q", names[0], names[1])
+	}
+	if names[2] != "level_levels_c" {
+		t.Errorf("Expected names without collision to stay unchanged, got %q", names[2])
+	}
+
+	source, err := GenerateQuerySource(CodegenOdin, "levels", levels)
+	if err != nil {
+		t.Fatalf("Generating Odin: %v", err)
+	}
+	for i, name := range names {
+		want := fmt.Sprintf("case %q:\n\t\treturn %s_point_in_solid, true", levels[i].Path, name)
+		if strings.Count(source, name+"_point_in_solid :: proc") != 1 || !strings.Contains(source, want) {
+			t.Errorf("Expected one query function %s for %s", name, levels[i].Path)
+		}
+	}
+
+	if _, err := GenerateQuerySource(CodegenC, "", []CodegenLevel{levels[0], levels[0]}); err == nil {
+		t.Error("Expected an error for a level listed twice")
+	}
+}
+
+func TestGenerateQuerySourceRejectsBVHLevels(t *testing.T) {
+	levelData := &pb.LevelData{RootIndex: -1, CollisionBvh: &pb.CollisionBVH{}}
+	if _, err := GenerateQuerySource(CodegenC, "", []CodegenLevel{{Path: "levels/a.pb", LevelData: levelData}}); err == nil {
+		t.Error("Expected an error for a level without BSP tree")
+	}
+}
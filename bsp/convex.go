@@ -0,0 +1,419 @@
+package bsp
+
+import (
+	"container/heap"
+	"math"
+	"sort"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// ConvexMergeTolerance is the thickness (in world units) of the sliver two convex shapes may grow by
+// when they are merged into their convex hull
+const ConvexMergeTolerance = 1e-3
+
+// vec64 is a point in double precision, so merge decisions do not suffer from float32 rounding
+type vec64 struct{ x, y float64 }
+
+// cross64 is the z component of (b - a) x (c - a), positive if c is left of a -> b
+func cross64(a, b, c vec64) float64 {
+	return (b.x-a.x)*(c.y-a.y) - (b.y-a.y)*(c.x-a.x)
+}
+
+// convexShape is a convex shape while shapes are merged
+type convexShape struct {
+	vertices []vec64 // CCW, without collinear vertices
+	area     float64
+	min, max vec64
+	alive    bool
+}
+
+// newConvexShape creates a shape from the convex hull of the points
+func newConvexShape(points []vec64) *convexShape {
+	hull := convexHull64(points)
+	shape := &convexShape{vertices: hull, area: area64(hull), alive: true}
+	if len(hull) > 0 {
+		shape.min, shape.max = hull[0], hull[0]
+		for _, v := range hull[1:] {
+			shape.min = vec64{math.Min(shape.min.x, v.x), math.Min(shape.min.y, v.y)}
+			shape.max = vec64{math.Max(shape.max.x, v.x), math.Max(shape.max.y, v.y)}
+		}
+	}
+	return shape
+}
+
+// touches returns true if the bounds of both shapes overlap or touch, within the merge tolerance
+func (s *convexShape) touches(other *convexShape) bool {
+	return s.min.x <= other.max.x+ConvexMergeTolerance && other.min.x <= s.max.x+ConvexMergeTolerance &&
+		s.min.y <= other.max.y+ConvexMergeTolerance && other.min.y <= s.max.y+ConvexMergeTolerance
+}
+
+// ExportConvexShapes exports the solid geometry as convex shapes for external physics engines
+// World polygons and placed prefabs are partitioned like for the BSP tree, then neighboring pieces
+// are merged, across outlines as well, whenever their union is convex. Larger merges go first,
+// so the result is a few large shapes instead of many small ones.
+// Returns nil if there is no solid geometry
+func (b *BSPBuilder) ExportConvexShapes() *pb.ConvexShapes {
+	var parts [][]Point
+	for _, poly := range b.Polygons {
+		if poly.IsSolid {
+			parts = append(parts, b.convexParts(poly, Transform2D{M00: 1, M11: 1})...)
+		}
+	}
+	for _, inst := range b.Instances {
+		if inst.Transform.Determinant() == 0 {
+			continue
+		}
+		for _, poly := range b.Prefabs[inst.Prefab] {
+			if poly.IsSolid {
+				parts = append(parts, b.convexParts(poly, inst.Transform)...)
+			}
+		}
+	}
+
+	merged := mergeConvexParts(parts)
+	if len(merged) == 0 {
+		return nil
+	}
+	shapes := &pb.ConvexShapes{Offsets: make([]uint32, 0, len(merged)+1)}
+	for _, part := range merged {
+		shapes.Offsets = append(shapes.Offsets, uint32(len(shapes.Vertices)/2))
+		for _, v := range part {
+			shapes.Vertices = append(shapes.Vertices, v.X, v.Y)
+		}
+	}
+	shapes.Offsets = append(shapes.Offsets, uint32(len(shapes.Vertices)/2))
+	return shapes
+}
+
+// ConvexShape returns the vertices of shape i of an export
+func ConvexShape(shapes *pb.ConvexShapes, i int) []Point {
+	first, last := shapes.Offsets[i], shapes.Offsets[i+1]
+	vertices := make([]Point, 0, last-first)
+	for j := first; j < last; j++ {
+		vertices = append(vertices, Point{X: shapes.Vertices[2*j], Y: shapes.Vertices[2*j+1]})
+	}
+	return vertices
+}
+
+// convexMerge is a pair or triple of shapes whose union is convex, waiting in a merge queue
+// c is -1 for pairs, in triples a is the shape that touches both others
+type convexMerge struct {
+	a, b, c int
+	hull    *convexShape
+}
+
+// convexMergeQueue is a max-heap of merges by the area of the merged shape
+type convexMergeQueue []convexMerge
+
+func (q convexMergeQueue) Len() int { return len(q) }
+func (q convexMergeQueue) Less(i, j int) bool {
+	if q[i].hull.area != q[j].hull.area {
+		return q[i].hull.area > q[j].hull.area
+	}
+	if q[i].a != q[j].a {
+		return q[i].a < q[j].a
+	}
+	if q[i].b != q[j].b {
+		return q[i].b < q[j].b
+	}
+	return q[i].c < q[j].c
+}
+func (q convexMergeQueue) Swap(i, j int) { q[i], q[j] = q[j], q[i] }
+func (q *convexMergeQueue) Push(x any)   { *q = append(*q, x.(convexMerge)) }
+func (q *convexMergeQueue) Pop() any {
+	old := *q
+	item := old[len(old)-1]
+	*q = old[:len(old)-1]
+	return item
+}
+
+// mergeConvexParts greedily merges convex parts whose union is convex, largest result first
+// Pairs are merged until none is left, then the best triple whose union is convex (like an L-shape
+// and the square filling its notch), which may enable new pairs, until nothing merges any more
+func mergeConvexParts(parts [][]Point) [][]Point {
+	var shapes []*convexShape
+	for _, part := range parts {
+		points := make([]vec64, len(part))
+		for i, v := range part {
+			points[i] = vec64{float64(v.X), float64(v.Y)}
+		}
+		if shape := newConvexShape(points); len(shape.vertices) >= 3 && shape.area > 0 {
+			shapes = append(shapes, shape)
+		}
+	}
+
+	// Neighbors are found once, merges only update the shapes they touch
+	neighbors := make([]map[int]bool, len(shapes))
+	for i := range neighbors {
+		neighbors[i] = make(map[int]bool)
+	}
+	for _, pair := range touchingShapes(shapes) {
+		neighbors[pair[0]][pair[1]] = true
+		neighbors[pair[1]][pair[0]] = true
+	}
+
+	pairs, triples := &convexMergeQueue{}, &convexMergeQueue{}
+	tryPair := func(i, j int) {
+		if hull, ok := mergeConvexShapes(shapes[i], shapes[j]); ok {
+			heap.Push(pairs, convexMerge{a: min(i, j), b: max(i, j), c: -1, hull: hull})
+		}
+	}
+	tryTriple := func(i, j, k int) {
+		if hull, ok := mergeConvexShapes(shapes[i], shapes[j], shapes[k]); ok {
+			heap.Push(triples, convexMerge{a: i, b: min(j, k), c: max(j, k), hull: hull})
+		}
+	}
+	// tryTriples queues the triples of a shape and two of its neighbors
+	tryTriples := func(i int) {
+		adjacent := sortedNeighbors(neighbors[i])
+		for ni, j := range adjacent {
+			for _, k := range adjacent[ni+1:] {
+				tryTriple(i, j, k)
+			}
+		}
+	}
+
+	// Triples are only needed once no pair is left, shapes that are new since then are fresh
+	fresh := make(map[int]bool, len(shapes))
+	for i := range shapes {
+		fresh[i] = true
+	}
+	// queueTriples queues the triples fresh shapes form, with their neighbors and among each other
+	queueTriples := func() {
+		for _, i := range sortedNeighbors(fresh) {
+			if !shapes[i].alive {
+				continue
+			}
+			tryTriples(i)
+			// Triples of an older shape and two of its neighbors, one of them fresh
+			for _, j := range sortedNeighbors(neighbors[i]) {
+				if fresh[j] {
+					continue
+				}
+				for _, k := range sortedNeighbors(neighbors[j]) {
+					if k != i && !(fresh[k] && k < i) {
+						tryTriple(j, i, k)
+					}
+				}
+			}
+		}
+		clear(fresh)
+	}
+
+	// replace retires merged shapes and queues the pairs the new shape can form
+	// The new shape's bounds are the union of the merged shapes' bounds, its neighbors are
+	// among theirs
+	replace := func(hull *convexShape, merged ...int) {
+		idx := len(shapes)
+		candidates := make(map[int]bool)
+		for _, i := range merged {
+			shapes[i].alive = false
+			for j := range neighbors[i] {
+				candidates[j] = true
+				delete(neighbors[j], i)
+			}
+			neighbors[i] = nil
+		}
+		shapes = append(shapes, hull)
+		adjacent := make(map[int]bool)
+		for j := range candidates {
+			if shapes[j].alive && shapes[j].touches(hull) {
+				adjacent[j] = true
+				neighbors[j][idx] = true
+			}
+		}
+		neighbors = append(neighbors, adjacent)
+		fresh[idx] = true
+		for _, j := range sortedNeighbors(adjacent) {
+			tryPair(j, idx)
+		}
+	}
+
+	for i := range shapes {
+		for _, j := range sortedNeighbors(neighbors[i]) {
+			if i < j {
+				tryPair(i, j)
+			}
+		}
+	}
+
+	// Pairs go first, the best triple only merges once no pair is left
+	alive := func(merge convexMerge) bool {
+		return shapes[merge.a].alive && shapes[merge.b].alive && (merge.c < 0 || shapes[merge.c].alive)
+	}
+	for {
+		if pairs.Len() > 0 {
+			if merge := heap.Pop(pairs).(convexMerge); alive(merge) {
+				replace(merge.hull, merge.a, merge.b)
+			}
+			continue
+		}
+		queueTriples()
+		if triples.Len() == 0 {
+			break
+		}
+		if merge := heap.Pop(triples).(convexMerge); alive(merge) {
+			replace(merge.hull, merge.a, merge.b, merge.c)
+		}
+	}
+
+	var result [][]Point
+	for _, shape := range shapes {
+		if !shape.alive {
+			continue
+		}
+		vertices := make([]Point, len(shape.vertices))
+		for i, v := range shape.vertices {
+			vertices[i] = Point{X: float32(v.x), Y: float32(v.y)}
+		}
+		result = append(result, vertices)
+	}
+	return result
+}
+
+// touchingShapes returns the pairs of alive shapes whose bounds touch, lower index first,
+// found by sweeping along x
+func touchingShapes(shapes []*convexShape) [][2]int {
+	var order []int
+	for i, shape := range shapes {
+		if shape.alive {
+			order = append(order, i)
+		}
+	}
+	sort.SliceStable(order, func(i, j int) bool { return shapes[order[i]].min.x < shapes[order[j]].min.x })
+
+	var pairs [][2]int
+	for oi, i := range order {
+		for _, j := range order[oi+1:] {
+			if shapes[j].min.x > shapes[i].max.x+ConvexMergeTolerance {
+				break
+			}
+			if shapes[i].touches(shapes[j]) {
+				pairs = append(pairs, [2]int{min(i, j), max(i, j)})
+			}
+		}
+	}
+	return pairs
+}
+
+// sortedNeighbors returns the indices of a neighbor set in ascending order, so merges are
+// queued in the same order on every run
+func sortedNeighbors(set map[int]bool) []int {
+	indices := make([]int, 0, len(set))
+	for i := range set {
+		indices = append(indices, i)
+	}
+	sort.Ints(indices)
+	return indices
+}
+
+// mergeConvexShapes returns the convex hull of the shapes if it adds at most a sliver to their union
+// The union is measured by inclusion-exclusion over the intersections, which are convex as well
+func mergeConvexShapes(shapes ...*convexShape) (*convexShape, bool) {
+	var points []vec64
+	for _, shape := range shapes {
+		points = append(points, shape.vertices...)
+	}
+	hull := newConvexShape(points)
+
+	var union float64
+	for subset := 1; subset < 1<<len(shapes); subset++ {
+		var intersection []vec64
+		count := 0
+		for i, shape := range shapes {
+			if subset&(1<<i) == 0 {
+				continue
+			}
+			if count == 0 {
+				intersection = shape.vertices
+			} else {
+				intersection = clipConvex64(intersection, shape.vertices)
+			}
+			count++
+		}
+		if count%2 == 1 {
+			union += area64(intersection)
+		} else {
+			union -= area64(intersection)
+		}
+	}
+	return hull, hull.area-union <= ConvexMergeTolerance*perimeter64(hull.vertices)
+}
+
+// convexHull64 returns the convex hull of the points in CCW order without collinear vertices
+// (Andrew's monotone chain)
+func convexHull64(points []vec64) []vec64 {
+	sorted := append([]vec64(nil), points...)
+	sort.Slice(sorted, func(i, j int) bool {
+		if sorted[i].x != sorted[j].x {
+			return sorted[i].x < sorted[j].x
+		}
+		return sorted[i].y < sorted[j].y
+	})
+	if len(sorted) < 3 {
+		return sorted
+	}
+
+	hull := make([]vec64, 0, 2*len(sorted))
+	for _, p := range sorted {
+		for len(hull) >= 2 && cross64(hull[len(hull)-2], hull[len(hull)-1], p) <= 0 {
+			hull = hull[:len(hull)-1]
+		}
+		hull = append(hull, p)
+	}
+	lower := len(hull) + 1
+	for i := len(sorted) - 2; i >= 0; i-- {
+		p := sorted[i]
+		for len(hull) >= lower && cross64(hull[len(hull)-2], hull[len(hull)-1], p) <= 0 {
+			hull = hull[:len(hull)-1]
+		}
+		hull = append(hull, p)
+	}
+	return hull[:len(hull)-1]
+}
+
+// clipConvex64 returns the intersection of two CCW convex polygons (Sutherland-Hodgman)
+func clipConvex64(subject, clip []vec64) []vec64 {
+	result := subject
+	for i, a := range clip {
+		b := clip[(i+1)%len(clip)]
+		if len(result) == 0 {
+			return nil
+		}
+		input := result
+		result = make([]vec64, 0, len(input)+1)
+		for j, p := range input {
+			q := input[(j+1)%len(input)]
+			dp, dq := cross64(a, b, p), cross64(a, b, q)
+			if dp >= 0 {
+				result = append(result, p)
+			}
+			if (dp >= 0) != (dq >= 0) {
+				t := dp / (dp - dq)
+				result = append(result, vec64{p.x + t*(q.x-p.x), p.y + t*(q.y-p.y)})
+			}
+		}
+	}
+	return result
+}
+
+// area64 returns the area of a CCW polygon
+func area64(vertices []vec64) float64 {
+	var area float64
+	for i, a := range vertices {
+		b := vertices[(i+1)%len(vertices)]
+		area += a.x*b.y - b.x*a.y
+	}
+	return area / 2
+}
+
+// perimeter64 returns the length of the outline of a polygon
+func perimeter64(vertices []vec64) float64 {
+	var length float64
+	for i, a := range vertices {
+		b := vertices[(i+1)%len(vertices)]
+		length += math.Hypot(b.x-a.x, b.y-a.y)
+	}
+	return length
+}
@@ -0,0 +1,117 @@
+package bsp
+
+import (
+	"math"
+	"testing"
+)
+
+// insideAnyConvex returns true if p is inside one of the convex shapes, and how far it is from the closest outline
+func insideAnyConvex(shapes [][]Point, p Point) (bool, float32) {
+	inside := false
+	distance := float32(1e9)
+	for _, shape := range shapes {
+		in, d := insideConvex(Polygon{Vertices: shape}, p)
+		inside = inside || in
+		distance = min(distance, d)
+	}
+	return inside, distance
+}
+
+func TestExportConvexShapes(t *testing.T) {
+	t.Run("Pieces merge across outlines", func(t *testing.T) {
+		// An L-shaped outline and the square that fills its notch form one large square
+		builder := NewBSPBuilder([]Polygon{
+			{Vertices: []Point{{X: 0, Y: 0}, {X: 4, Y: 0}, {X: 4, Y: 2}, {X: 2, Y: 2}, {X: 2, Y: 4}, {X: 0, Y: 4}}, IsSolid: true},
+			{Vertices: []Point{{X: 2, Y: 2}, {X: 4, Y: 2}, {X: 4, Y: 4}, {X: 2, Y: 4}}, IsSolid: true},
+		})
+		shapes := builder.ExportConvexShapes()
+		if shapes == nil || len(shapes.Offsets) != 2 {
+			t.Fatalf("Expected a single shape, got %v", shapes)
+		}
+		square := ConvexShape(shapes, 0)
+		if len(square) != 4 || signedArea(Polygon{Vertices: square}) != 16 {
+			t.Errorf("Expected the 4x4 square, got %v", square)
+		}
+	})
+
+	t.Run("Non-convex unions stay apart", func(t *testing.T) {
+		// Two overlapping bars form a cross
+		builder := NewBSPBuilder([]Polygon{
+			{Vertices: []Point{{X: -3, Y: -1}, {X: 3, Y: -1}, {X: 3, Y: 1}, {X: -3, Y: 1}}, IsSolid: true},
+			{Vertices: []Point{{X: -1, Y: -3}, {X: 1, Y: -3}, {X: 1, Y: 3}, {X: -1, Y: 3}}, IsSolid: true},
+		})
+		if shapes := builder.ExportConvexShapes(); len(shapes.Offsets) != 3 {
+			t.Errorf("Expected both bars, got %d shapes", len(shapes.Offsets)-1)
+		}
+	})
+
+	t.Run("Merged shapes cover the same space", func(t *testing.T) {
+		builder := bvhTestBuilder()
+		var parts [][]Point
+		for _, poly := range builder.Polygons {
+			parts = append(parts, builder.convexParts(poly, Transform2D{M00: 1, M11: 1})...)
+		}
+		for _, inst := range builder.Instances {
+			for _, poly := range builder.Prefabs[inst.Prefab] {
+				parts = append(parts, builder.convexParts(poly, inst.Transform)...)
+			}
+		}
+
+		shapes := builder.ExportConvexShapes()
+		var merged [][]Point
+		for i := 0; i < len(shapes.Offsets)-1; i++ {
+			shape := ConvexShape(shapes, i)
+			if signedArea(Polygon{Vertices: shape}) <= 0 {
+				t.Errorf("Shape %d is not counter-clockwise", i)
+			}
+			merged = append(merged, shape)
+		}
+		if len(merged) >= len(parts) {
+			t.Errorf("Expected fewer shapes than the %d partitioned pieces, got %d", len(parts), len(merged))
+		}
+
+		for y := float32(-8.13); y < 9; y += 0.13 {
+			for x := float32(-2.07); x < 52; x += 0.11 {
+				p := Point{X: x, Y: y}
+				want, wantDistance := insideAnyConvex(parts, p)
+				got, gotDistance := insideAnyConvex(merged, p)
+				if got != want && min(wantDistance, gotDistance) > ConvexMergeTolerance {
+					t.Errorf("Point (%.2f, %.2f): merged shapes say solid=%v, pieces say %v", x, y, got, want)
+				}
+			}
+		}
+	})
+
+	t.Run("Thousands of parts", func(t *testing.T) {
+		// Hexagons split into three rhombi, no two of which have a convex union, so every
+		// hexagon is merged by its own triple
+		const hexagons = 1500
+		var parts [][]Point
+		for n := 0; n < hexagons; n++ {
+			center := Point{X: float32(n%40) * 5, Y: float32(n/40) * 5}
+			var corners [6]Point
+			for i := range corners {
+				angle := float64(i) * math.Pi / 3
+				corners[i] = Point{X: center.X + float32(2*math.Cos(angle)), Y: center.Y + float32(2*math.Sin(angle))}
+			}
+			for r := 0; r < 3; r++ {
+				parts = append(parts, []Point{center, corners[2*r], corners[2*r+1], corners[(2*r+2)%6]})
+			}
+		}
+		merged := mergeConvexParts(parts)
+		if len(merged) != hexagons {
+			t.Fatalf("Expected %d hexagons, got %d shapes", hexagons, len(merged))
+		}
+		for i, shape := range merged {
+			if len(shape) != 6 {
+				t.Errorf("Shape %d: expected a hexagon, got %v", i, shape)
+			}
+		}
+	})
+
+	t.Run("No solid geometry", func(t *testing.T) {
+		if shapes := NewBSPBuilder(nil).ExportConvexShapes(); shapes != nil {
+			t.Errorf("Expected no shapes, got %v", shapes)
+		}
+	})
+}
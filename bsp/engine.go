@@ -0,0 +1,193 @@
+package bsp
+
+import (
+	"math/rand"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// Engine names the structure that answers the collision queries of a level
+type Engine string
+
+const (
+	EngineBSP Engine = "bsp"
+	EngineBVH Engine = "bvh"
+)
+
+const (
+	// engineQueries is the number of point queries the cost of both engines is counted on
+	engineQueries = 2000
+	// engineMargin is how much cheaper the BVH has to be to be shipped,
+	// so levels where both are about equal keep answering with the BSP tree
+	engineMargin = 0.9
+)
+
+// EngineReport describes which engine was selected for a level and why
+type EngineReport struct {
+	Engine  Engine
+	BSPCost float64 // Average operations per point query of the BSP tree
+	BVHCost float64 // Average operations per point query of the BVH (0 if it was not counted)
+	Queries int     // Point queries the costs were counted on
+}
+
+// SelectEngine counts the operations the BSP tree and the BVH need for the same fixed point
+// queries and ships the BVH next to the BSP tree if it is clearly cheaper
+// Operations are counted, not timed, so the same level always selects the same engine,
+// on every machine and under any load. A node visit counts as one operation, a BVH piece
+// costs one operation per edge tested (one for a disc).
+// The BSP tree always stays in the level data: carving, code generation and sectors work on it.
+// The BVH is only considered if both structures fit the budget together (nodes plus pieces, and depth)
+func SelectEngine(levelData *pb.LevelData, bvh *pb.CollisionBVH, budget Budget) EngineReport {
+	report := EngineReport{Engine: EngineBSP, Queries: engineQueries}
+	levelData.CollisionBvh = nil
+	if bvh == nil || len(bvh.Nodes) == 0 || !budget.fits(len(levelData.Nodes)+len(bvh.Nodes)+len(bvh.Pieces), BVHDepth(bvh)) {
+		return report
+	}
+
+	// Queries cover the solid geometry and some empty space around it
+	root := bvh.Nodes[0]
+	padX := (root.MaxX - root.MinX) * 0.1
+	padY := (root.MaxY - root.MinY) * 0.1
+	boundsMin := Point{X: root.MinX - padX, Y: root.MinY - padY}
+	boundsMax := Point{X: root.MaxX + padX, Y: root.MaxY + padY}
+
+	// Fixed seed, so every build counts the same queries
+	rng := rand.New(rand.NewSource(1))
+	bspOps, bvhOps := 0, 0
+	for i := 0; i < engineQueries; i++ {
+		p := Point{
+			X: boundsMin.X + rng.Float32()*(boundsMax.X-boundsMin.X),
+			Y: boundsMin.Y + rng.Float32()*(boundsMax.Y-boundsMin.Y),
+		}
+		_, ops := bspPointCost(levelData.Nodes, levelData.RootIndex, p)
+		bspOps += ops
+		bvhOps += bvhPointCost(bvh, p)
+	}
+	report.BSPCost = float64(bspOps) / engineQueries
+	report.BVHCost = float64(bvhOps) / engineQueries
+
+	if report.BVHCost < report.BSPCost*engineMargin {
+		report.Engine = EngineBVH
+		levelData.CollisionBvh = bvh
+	}
+	return report
+}
+
+// bspPointCost answers a point query like PointInBSP and counts the nodes it visits
+func bspPointCost(nodes []*pb.BSPNode, nodeIndex int32, point Point) (solid bool, ops int) {
+	for nodeIndex >= 0 && int(nodeIndex) < len(nodes) && nodes[nodeIndex] != nil {
+		ops++
+		switch n := nodes[nodeIndex].Type.(type) {
+		case *pb.BSPNode_Leaf:
+			return n.Leaf.IsSolid, ops
+		case *pb.BSPNode_Split:
+			line := Line{Normal: Vector2{X: n.Split.NormalX, Y: n.Split.NormalY}, Distance: n.Split.Distance}
+			if line.PointSide(point) > 0 {
+				nodeIndex = n.Split.FrontIndex
+			} else {
+				nodeIndex = n.Split.BackIndex
+			}
+		case *pb.BSPNode_AxisSplit:
+			if axisSplitSide(n.AxisSplit, point) > 0 {
+				nodeIndex = n.AxisSplit.FrontIndex
+			} else {
+				nodeIndex = n.AxisSplit.BackIndex
+			}
+		case *pb.BSPNode_Instance:
+			inside, subtreeOps := bspPointCost(nodes, n.Instance.SubtreeIndex, instanceTransform(n.Instance).Apply(point))
+			ops += subtreeOps
+			if inside {
+				return true, ops
+			}
+			nodeIndex = n.Instance.NextIndex
+		case *pb.BSPNode_Circle:
+			if circleFromNode(n.Circle).Contains(point) {
+				return true, ops
+			}
+			nodeIndex = n.Circle.OutsideIndex
+		default:
+			return false, ops
+		}
+	}
+	return false, ops
+}
+
+// bvhPointCost answers a point query like PointInBVH and counts the node visits and edge tests
+func bvhPointCost(bvh *pb.CollisionBVH, point Point) int {
+	ops := 0
+	stack := make([]int32, 1, bvhStackSize)
+	for len(stack) > 0 {
+		idx := stack[len(stack)-1]
+		stack = stack[:len(stack)-1]
+		node := bvh.Nodes[idx]
+		ops++
+		if point.X < node.MinX || point.X > node.MaxX || point.Y < node.MinY || point.Y > node.MaxY {
+			continue
+		}
+
+		if node.PieceCount > 0 {
+			for _, piece := range bvh.Pieces[node.FirstPiece : node.FirstPiece+node.PieceCount] {
+				if piece.VertexCount == 0 {
+					ops++
+				} else {
+					ops += pieceEdgesTested(bvh, piece, point)
+				}
+				if pieceContains(bvh, piece, point) {
+					return ops
+				}
+			}
+			continue
+		}
+
+		stack = append(stack, idx+1, node.RightIndex)
+	}
+	return ops
+}
+
+// pieceEdgesTested returns how many edges pieceContains tests before it has an answer
+func pieceEdgesTested(bvh *pb.CollisionBVH, piece *pb.ConvexPiece, p Point) int {
+	vertices := bvh.Vertices[2*piece.FirstVertex : 2*(piece.FirstVertex+piece.VertexCount)]
+	n := int(piece.VertexCount)
+	for i := 0; i < n; i++ {
+		j := (i + 1) % n
+		a := Point{X: vertices[2*i], Y: vertices[2*i+1]}
+		b := Point{X: vertices[2*j], Y: vertices[2*j+1]}
+		if orient2d(a, b, p) < 0 {
+			return i + 1
+		}
+	}
+	return n
+}
+
+// BVHDepth returns the number of nodes on the longest root-to-leaf path
+func BVHDepth(bvh *pb.CollisionBVH) int {
+	if bvh == nil || len(bvh.Nodes) == 0 {
+		return 0
+	}
+	var depth func(idx int32) int
+	depth = func(idx int32) int {
+		node := bvh.Nodes[idx]
+		if node.PieceCount > 0 {
+			return 1
+		}
+		return 1 + max(depth(idx+1), depth(node.RightIndex))
+	}
+	return depth(0)
+}
+
+// PointInLevel tests if a point is inside solid geometry with the engine shipped in the level
+func PointInLevel(levelData *pb.LevelData, point Point) bool {
+	if levelData.CollisionBvh != nil {
+		return PointInBVH(levelData.CollisionBvh, point)
+	}
+	return PointInBSP(levelData.Nodes, levelData.RootIndex, point)
+}
+
+// LineTraceLevel traces a segment with the engine shipped in the level
+// Returns true and the first solid point if the segment hits solid geometry
+func LineTraceLevel(levelData *pb.LevelData, from, to Point) (hit bool, hitX, hitY float32) {
+	if levelData.CollisionBvh != nil {
+		return LineTraceBVH(levelData.CollisionBvh, from, to, 0, 1)
+	}
+	return LineTraceBSPNode(levelData.Nodes, levelData.RootIndex, from, to, 0, 1)
+}
@@ -0,0 +1,274 @@
+package bsp
+
+import (
+	"container/heap"
+	"math"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+const (
+	// FlowCellSize is the edge length of a flow field cell in world units
+	FlowCellSize = 1.0
+	// maxFlowCells bounds the flow field grid, larger levels get coarser cells
+	maxFlowCells = 1 << 16
+	// flowDistanceScale is the number of stored distance steps per world unit
+	flowDistanceScale = 16
+)
+
+// flowNeighbors are the grid offsets of the eight neighbors of a cell
+// The first four point forward in the row-major order, the last four are their opposites
+var flowNeighbors = [8][2]int{{1, 0}, {-1, 1}, {0, 1}, {1, 1}, {-1, 0}, {1, -1}, {0, -1}, {-1, -1}}
+
+// flowDirections decodes the direction bytes of a flow field
+var flowDirections = func() [256]Vector2 {
+	var dirs [256]Vector2
+	for k := 1; k < 256; k++ {
+		angle := float64(k-1) * 2 * math.Pi / 255
+		dirs[k] = Vector2{X: float32(math.Cos(angle)), Y: float32(math.Sin(angle))}
+	}
+	return dirs
+}()
+
+// FlowInput is everything BakeFlowFields needs besides the tree
+type FlowInput struct {
+	Targets []LOSPoint
+	// Bounds of the grid, usually the bounds of the whole level
+	BoundsMin, BoundsMax Point
+}
+
+// flowGrid is the walkable graph of the cells shared by all flow fields
+type flowGrid struct {
+	cellSize      float32
+	min           Point
+	width, height int
+	free          []bool  // false if the cell center is solid
+	links         []uint8 // Bit d is set if the agent can walk to flowNeighbors[d]
+}
+
+// center returns the world-space center of a cell
+func (g *flowGrid) center(cell int) Point {
+	return Point{
+		X: g.min.X + (float32(cell%g.width)+0.5)*g.cellSize,
+		Y: g.min.Y + (float32(cell/g.width)+0.5)*g.cellSize,
+	}
+}
+
+// BakeFlowFields computes a flow field toward every target: per cell the walking distance to
+// the target around the collision geometry and the direction to walk in
+// Cells that see their target get the straight distance and direction, all others continue from
+// there with Dijkstra over the eight neighbors. Targets are baked in parallel.
+// It traces with the collision engine shipped in the level data, so fields match runtime traces
+// Returns nil if there are no targets
+func BakeFlowFields(levelData *pb.LevelData, input FlowInput) *pb.FlowFields {
+	if len(input.Targets) == 0 {
+		return nil
+	}
+
+	// Grid of cells, coarsened until it fits
+	cellSize := float32(FlowCellSize)
+	extent := Point{X: input.BoundsMax.X - input.BoundsMin.X, Y: input.BoundsMax.Y - input.BoundsMin.Y}
+	width, height := gridSize(extent, cellSize)
+	for width*height > maxFlowCells {
+		cellSize *= 2
+		width, height = gridSize(extent, cellSize)
+	}
+	grid := &flowGrid{cellSize: cellSize, min: input.BoundsMin, width: width, height: height}
+	grid.free, grid.links = flowLinks(levelData, grid)
+
+	flow := &pb.FlowFields{
+		CellSize: cellSize,
+		MinX:     input.BoundsMin.X,
+		MinY:     input.BoundsMin.Y,
+		Width:    int32(width),
+		Height:   int32(height),
+		Fields:   make([]*pb.FlowField, len(input.Targets)),
+	}
+	parallelFor(len(input.Targets), func(i int) {
+		flow.Fields[i] = bakeFlowField(levelData, grid, input.Targets[i])
+	})
+	return flow
+}
+
+// flowLinks finds the free cells and which of their neighbors can be walked to
+// Diagonal steps need both straight steps around them, so agents do not cut corners
+func flowLinks(levelData *pb.LevelData, grid *flowGrid) ([]bool, []uint8) {
+	n := grid.width * grid.height
+	free := make([]bool, n)
+	parallelFor(n, func(cell int) {
+		free[cell] = !PointInLevel(levelData, grid.center(cell))
+	})
+
+	// Every cell traces its forward neighbors, the backward links are mirrored afterwards
+	links := make([]uint8, n)
+	parallelFor(n, func(cell int) {
+		if !free[cell] {
+			return
+		}
+		x, y := cell%grid.width, cell/grid.width
+		for d := 0; d < 4; d++ {
+			nx, ny := x+flowNeighbors[d][0], y+flowNeighbors[d][1]
+			if nx < 0 || ny < 0 || nx >= grid.width || ny >= grid.height || !free[ny*grid.width+nx] {
+				continue
+			}
+			if hit, _, _ := LineTraceLevel(levelData, grid.center(cell), grid.center(ny*grid.width+nx)); !hit {
+				links[cell] |= 1 << d
+			}
+		}
+	})
+	for cell := range links {
+		x, y := cell%grid.width, cell/grid.width
+		for d := 0; d < 4; d++ {
+			if links[cell]&(1<<d) != 0 {
+				links[(y+flowNeighbors[d][1])*grid.width+x+flowNeighbors[d][0]] |= 1 << (d + 4)
+			}
+		}
+	}
+
+	// A diagonal step also needs the four straight steps around it, in both directions
+	const right, upLeft, up, upRight, left, down = 0, 1, 2, 3, 4, 6
+	has := func(cell, d int) bool { return links[cell]&(1<<d) != 0 }
+	for cell := range links {
+		x, y := cell%grid.width, cell/grid.width
+		if has(cell, upRight) {
+			other := (y+1)*grid.width + x + 1
+			if !has(cell, right) || !has(cell, up) || !has(other, left) || !has(other, down) {
+				links[cell] &^= 1 << upRight
+				links[other] &^= 1 << (upRight + 4)
+			}
+		}
+		if has(cell, upLeft) {
+			other := (y+1)*grid.width + x - 1
+			if !has(cell, left) || !has(cell, up) || !has(other, right) || !has(other, down) {
+				links[cell] &^= 1 << upLeft
+				links[other] &^= 1 << (upLeft + 4)
+			}
+		}
+	}
+	return free, links
+}
+
+// bakeFlowField computes the distances and directions toward one target
+func bakeFlowField(levelData *pb.LevelData, grid *flowGrid, target LOSPoint) *pb.FlowField {
+	n := grid.width * grid.height
+	field := &pb.FlowField{
+		Kind:       target.Kind,
+		Name:       target.Name,
+		X:          target.Position.X,
+		Y:          target.Position.Y,
+		Distances:  make([]uint32, n),
+		Directions: make([]byte, n),
+	}
+
+	// Cells that see the target walk straight to it
+	distances := make([]float64, n)
+	parent := make([]int32, n) // Neighbor to walk to, -1 for the target itself
+	queue := &flowQueue{}
+	for cell := range distances {
+		distances[cell] = math.Inf(1)
+		parent[cell] = -1
+		if !grid.free[cell] {
+			continue
+		}
+		center := grid.center(cell)
+		if hit, _, _ := LineTraceLevel(levelData, center, target.Position); !hit {
+			distances[cell] = math.Hypot(float64(target.Position.X-center.X), float64(target.Position.Y-center.Y))
+			heap.Push(queue, flowItem{cell: cell, distance: distances[cell]})
+		}
+	}
+
+	// Dijkstra from there around the geometry
+	for queue.Len() > 0 {
+		item := heap.Pop(queue).(flowItem)
+		if item.distance > distances[item.cell] {
+			continue
+		}
+		x, y := item.cell%grid.width, item.cell/grid.width
+		for d, offset := range flowNeighbors {
+			if grid.links[item.cell]&(1<<d) == 0 {
+				continue
+			}
+			neighbor := (y+offset[1])*grid.width + x + offset[0]
+			step := float64(grid.cellSize)
+			if offset[0] != 0 && offset[1] != 0 {
+				step *= math.Sqrt2
+			}
+			if distance := item.distance + step; distance < distances[neighbor] {
+				distances[neighbor] = distance
+				parent[neighbor] = int32(item.cell)
+				heap.Push(queue, flowItem{cell: neighbor, distance: distance})
+			}
+		}
+	}
+
+	for cell, distance := range distances {
+		if math.IsInf(distance, 1) {
+			continue
+		}
+		field.Distances[cell] = uint32(math.Round(distance*flowDistanceScale)) + 1
+
+		center := grid.center(cell)
+		to := target.Position
+		if parent[cell] >= 0 {
+			to = grid.center(int(parent[cell]))
+		}
+		if dx, dy := float64(to.X-center.X), float64(to.Y-center.Y); dx != 0 || dy != 0 {
+			angle := math.Atan2(dy, dx)
+			if angle < 0 {
+				angle += 2 * math.Pi
+			}
+			field.Directions[cell] = byte(int(math.Round(angle/(2*math.Pi)*255))%255 + 1)
+		}
+	}
+	return field
+}
+
+// flowItem is a cell waiting in the Dijkstra queue
+type flowItem struct {
+	cell     int
+	distance float64
+}
+
+// flowQueue is a min-heap of cells by distance
+type flowQueue []flowItem
+
+func (q flowQueue) Len() int           { return len(q) }
+func (q flowQueue) Less(i, j int) bool { return q[i].distance < q[j].distance }
+func (q flowQueue) Swap(i, j int)      { q[i], q[j] = q[j], q[i] }
+func (q *flowQueue) Push(x any)        { *q = append(*q, x.(flowItem)) }
+func (q *flowQueue) Pop() any {
+	old := *q
+	item := old[len(old)-1]
+	*q = old[:len(old)-1]
+	return item
+}
+
+// FlowFieldIndex returns the index of the flow field toward a target, or -1 if there is none
+func FlowFieldIndex(flow *pb.FlowFields, kind, name string) int {
+	for i, field := range flow.GetFields() {
+		if field.Kind == kind && field.Name == name {
+			return i
+		}
+	}
+	return -1
+}
+
+// SampleFlowField looks up the walking direction (unit length) and distance toward the target
+// of a flow field from the grid cell containing p
+// Returns false outside of the grid and in cells the target cannot be reached from
+func SampleFlowField(flow *pb.FlowFields, field int, p Point) (Vector2, float32, bool) {
+	if flow == nil || field < 0 || field >= len(flow.Fields) || flow.CellSize <= 0 {
+		return Vector2{}, 0, false
+	}
+	x := int(math.Floor(float64((p.X - flow.MinX) / flow.CellSize)))
+	y := int(math.Floor(float64((p.Y - flow.MinY) / flow.CellSize)))
+	if x < 0 || y < 0 || x >= int(flow.Width) || y >= int(flow.Height) {
+		return Vector2{}, 0, false
+	}
+	cell := y*int(flow.Width) + x
+	f := flow.Fields[field]
+	if cell >= len(f.Distances) || cell >= len(f.Directions) || f.Distances[cell] == 0 {
+		return Vector2{}, 0, false
+	}
+	return flowDirections[f.Directions[cell]], float32(f.Distances[cell]-1) / flowDistanceScale, true
+}
@@ -0,0 +1,67 @@
+package bsp
+
+import (
+	"math"
+	"testing"
+)
+
+func TestBakeFlowFields(t *testing.T) {
+	// A wall between x = 4 and x = 5 with a gap above y = 6, and a closed ring around (15, -6)
+	levelData := NewBSPBuilder([]Polygon{
+		{Vertices: []Point{{X: 4, Y: -10}, {X: 5, Y: -10}, {X: 5, Y: 6}, {X: 4, Y: 6}}, IsSolid: true},
+		{Vertices: []Point{{X: 12, Y: -9}, {X: 18, Y: -9}, {X: 18, Y: -8}, {X: 12, Y: -8}}, IsSolid: true},
+		{Vertices: []Point{{X: 12, Y: -4}, {X: 18, Y: -4}, {X: 18, Y: -3}, {X: 12, Y: -3}}, IsSolid: true},
+		{Vertices: []Point{{X: 12, Y: -8}, {X: 13, Y: -8}, {X: 13, Y: -4}, {X: 12, Y: -4}}, IsSolid: true},
+		{Vertices: []Point{{X: 17, Y: -8}, {X: 18, Y: -8}, {X: 18, Y: -4}, {X: 17, Y: -4}}, IsSolid: true},
+	}).Build()
+	flow := BakeFlowFields(levelData, FlowInput{
+		Targets:   []LOSPoint{{Kind: "portal", Name: "0", Position: Point{X: 0, Y: 0}}},
+		BoundsMin: Point{X: -10, Y: -10},
+		BoundsMax: Point{X: 20, Y: 10},
+	})
+	field := FlowFieldIndex(flow, "portal", "0")
+	if field != 0 || flow.Width != 30 || flow.Height != 20 {
+		t.Fatalf("Expected one field on a 30x20 grid, got index %d and %dx%d", field, flow.Width, flow.Height)
+	}
+
+	t.Run("Visible cells point at the target", func(t *testing.T) {
+		dir, distance, ok := SampleFlowField(flow, field, Point{X: -5.2, Y: 0.3})
+		if !ok {
+			t.Fatal("Expected a sample next to the target")
+		}
+		// The cell center is (-5.5, 0.5)
+		if math.Abs(float64(distance)-math.Hypot(5.5, 0.5)) > 0.1 || dir.X < 0.99 {
+			t.Errorf("Expected to walk straight to the target, got direction %v and distance %.2f", dir, distance)
+		}
+	})
+
+	t.Run("Agents walk around the wall", func(t *testing.T) {
+		p := Point{X: 10, Y: 0}
+		_, distance, ok := SampleFlowField(flow, field, p)
+		if !ok || distance < 15 || distance > 19 {
+			t.Fatalf("Expected a walking distance around the wall, got %.2f (ok=%v)", distance, ok)
+		}
+
+		for step := 0; step < 400 && math.Hypot(float64(p.X), float64(p.Y)) > 0.5; step++ {
+			dir, _, ok := SampleFlowField(flow, field, p)
+			if !ok {
+				t.Fatalf("Lost the field at (%.2f, %.2f)", p.X, p.Y)
+			}
+			p = Point{X: p.X + dir.X*0.1, Y: p.Y + dir.Y*0.1}
+			if PointInBSP(levelData.Nodes, levelData.RootIndex, p) {
+				t.Fatalf("Walked into the wall at (%.2f, %.2f)", p.X, p.Y)
+			}
+		}
+		if math.Hypot(float64(p.X), float64(p.Y)) > 0.5 {
+			t.Errorf("Did not reach the target, stopped at (%.2f, %.2f)", p.X, p.Y)
+		}
+	})
+
+	t.Run("Closed off and solid cells have no flow", func(t *testing.T) {
+		for _, p := range []Point{{X: 15, Y: -6}, {X: 4.5, Y: 0}, {X: 25, Y: 0}} {
+			if _, _, ok := SampleFlowField(flow, field, p); ok {
+				t.Errorf("Expected no flow at (%v, %v)", p.X, p.Y)
+			}
+		}
+	})
+}
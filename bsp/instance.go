@@ -0,0 +1,158 @@
+package bsp
+
+import (
+	"math"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// Transform2D is a 2D affine transform: p' = M * p + T
+type Transform2D struct {
+	M00, M01 float32
+	M10, M11 float32
+	TX, TY   float32
+}
+
+// Instance places a prefab into the world
+type Instance struct {
+	Prefab    string      // Key into BSPBuilder.Prefabs
+	Transform Transform2D // Local-to-world transform of the placement
+}
+
+// NewTransform2D creates a local-to-world transform that scales, then rotates, then translates
+// The rotation is in degrees, turning the +X axis towards +Y
+func NewTransform2D(translation Point, rotationDegrees float64, scale Vector2) Transform2D {
+	rad := rotationDegrees * math.Pi / 180
+	cos := float32(math.Cos(rad))
+	sin := float32(math.Sin(rad))
+	return Transform2D{
+		M00: cos * scale.X, M01: -sin * scale.Y,
+		M10: sin * scale.X, M11: cos * scale.Y,
+		TX: translation.X, TY: translation.Y,
+	}
+}
+
+// Apply transforms a point
+func (t Transform2D) Apply(p Point) Point {
+	return Point{
+		X: t.M00*p.X + t.M01*p.Y + t.TX,
+		Y: t.M10*p.X + t.M11*p.Y + t.TY,
+	}
+}
+
+// Determinant returns the determinant of the linear part
+// A zero determinant means the transform collapses the plane and cannot be inverted
+func (t Transform2D) Determinant() float32 {
+	return t.M00*t.M11 - t.M01*t.M10
+}
+
+// Inverse returns the inverse transform
+// The caller must make sure the determinant is not zero
+func (t Transform2D) Inverse() Transform2D {
+	invDet := 1 / t.Determinant()
+	inv := Transform2D{
+		M00: t.M11 * invDet, M01: -t.M01 * invDet,
+		M10: -t.M10 * invDet, M11: t.M00 * invDet,
+	}
+	inv.TX = -(inv.M00*t.TX + inv.M01*t.TY)
+	inv.TY = -(inv.M10*t.TX + inv.M11*t.TY)
+	return inv
+}
+
+// instanceTransform reads the world-to-local transform stored in an instance node
+func instanceTransform(inst *pb.Instance) Transform2D {
+	return Transform2D{
+		M00: inst.M00, M01: inst.M01,
+		M10: inst.M10, M11: inst.M11,
+		TX: inst.Tx, TY: inst.Ty,
+	}
+}
+
+// prefabSubtree is a prefab that has been built into the shared node array
+type prefabSubtree struct {
+	rootIndex int32
+	min, max  Point // Local-space bounds of the prefab polygons
+}
+
+// buildInstanceTrees builds every referenced prefab exactly once and returns one tree per placement
+// Each placement only costs a bounding box guard and an instance node, no matter how complex the prefab is
+func (b *BSPBuilder) buildInstanceTrees() []int32 {
+	subtrees := make(map[string]*prefabSubtree)
+
+	var instanceTrees []int32
+	for _, inst := range b.Instances {
+		subtree, built := subtrees[inst.Prefab]
+		if !built {
+			subtree = b.buildPrefabSubtree(b.Prefabs[inst.Prefab])
+			subtrees[inst.Prefab] = subtree
+		}
+		if subtree == nil {
+			// Unknown or empty prefab
+			continue
+		}
+
+		if inst.Transform.Determinant() == 0 {
+			// Zero-sized placement has no area to collide with
+			continue
+		}
+
+		instanceTrees = append(instanceTrees, b.buildInstanceTree(subtree, inst.Transform))
+	}
+	return instanceTrees
+}
+
+// buildPrefabSubtree builds the local-space tree of a prefab
+// Returns nil if the prefab has no solid geometry
+func (b *BSPBuilder) buildPrefabSubtree(polygons []Polygon) *prefabSubtree {
+	trees := b.buildPolygonTrees(polygons)
+	if len(trees) == 0 {
+		return nil
+	}
+
+	subtree := &prefabSubtree{
+		rootIndex: b.mergeTrees(trees),
+		min:       Point{X: float32(math.Inf(1)), Y: float32(math.Inf(1))},
+		max:       Point{X: float32(math.Inf(-1)), Y: float32(math.Inf(-1))},
+	}
+	for _, poly := range polygons {
+		for _, v := range poly.Vertices {
+			subtree.min.X = min(subtree.min.X, v.X)
+			subtree.min.Y = min(subtree.min.Y, v.Y)
+			subtree.max.X = max(subtree.max.X, v.X)
+			subtree.max.Y = max(subtree.max.Y, v.Y)
+		}
+	}
+	return subtree
+}
+
+// worldBounds returns the world-space bounding box of the transformed local bounds
+func (s *prefabSubtree) worldBounds(localToWorld Transform2D) (Point, Point) {
+	corners := []Point{
+		localToWorld.Apply(Point{X: s.min.X, Y: s.min.Y}),
+		localToWorld.Apply(Point{X: s.max.X, Y: s.min.Y}),
+		localToWorld.Apply(Point{X: s.max.X, Y: s.max.Y}),
+		localToWorld.Apply(Point{X: s.min.X, Y: s.max.Y}),
+	}
+	worldMin := corners[0]
+	worldMax := corners[0]
+	for _, c := range corners[1:] {
+		worldMin.X = min(worldMin.X, c.X)
+		worldMin.Y = min(worldMin.Y, c.Y)
+		worldMax.X = max(worldMax.X, c.X)
+		worldMax.Y = max(worldMax.Y, c.Y)
+	}
+	return worldMin, worldMax
+}
+
+// buildInstanceTree places a prefab subtree into the world
+// The instance node is guarded by the world-space bounding box of the placement,
+// so queries away from the prop pay four plane tests instead of a transform
+func (b *BSPBuilder) buildInstanceTree(subtree *prefabSubtree, localToWorld Transform2D) int32 {
+	worldMin, worldMax := subtree.worldBounds(localToWorld)
+
+	// Empty space around the prefab is a non-solid leaf, so mergeTreePair can hang other trees there
+	emptyIdx := b.addLeafNode(0, []int32{}, false)
+	nodeIdx := b.addInstanceNode(subtree.rootIndex, localToWorld.Inverse(), emptyIdx)
+
+	return b.addBoundsGuard(worldMin, worldMax, nodeIdx)
+}
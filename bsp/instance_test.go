@@ -0,0 +1,136 @@
+package bsp
+
+import (
+	"math"
+	"testing"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// unitBoxPrefab is a prefab outline covering the whole object: (-0.5, -0.5) to (0.5, 0.5)
+var unitBoxPrefab = []Polygon{
+	{
+		Vertices: []Point{
+			{X: -0.5, Y: -0.5},
+			{X: 0.5, Y: -0.5},
+			{X: 0.5, Y: 0.5},
+			{X: -0.5, Y: 0.5},
+		},
+		IsSolid: true,
+	},
+}
+
+func TestTransform2DInverse(t *testing.T) {
+	transform := NewTransform2D(Point{X: 3, Y: -2}, 30, Vector2{X: 2, Y: 0.5})
+	inverse := transform.Inverse()
+
+	for _, p := range []Point{{X: 0, Y: 0}, {X: 1, Y: 0}, {X: -4, Y: 7}} {
+		roundTrip := inverse.Apply(transform.Apply(p))
+		if math.Abs(float64(roundTrip.X-p.X)) > 1e-4 || math.Abs(float64(roundTrip.Y-p.Y)) > 1e-4 {
+			t.Errorf("Round trip of (%v, %v) gave (%v, %v)", p.X, p.Y, roundTrip.X, roundTrip.Y)
+		}
+	}
+}
+
+func TestInstancedPrefab(t *testing.T) {
+	builder := NewBSPBuilder(nil)
+	builder.Prefabs = map[string][]Polygon{"crate": unitBoxPrefab}
+	builder.Instances = []Instance{
+		// 2x2 crate at (10, 0)
+		{Prefab: "crate", Transform: NewTransform2D(Point{X: 10, Y: 0}, 0, Vector2{X: 2, Y: 2})},
+		// 4x1 crate at (-10, 0), rotated by 90 degrees so it stands upright
+		{Prefab: "crate", Transform: NewTransform2D(Point{X: -10, Y: 0}, 90, Vector2{X: 4, Y: 1})},
+		// Unknown prefabs are ignored
+		{Prefab: "missing", Transform: NewTransform2D(Point{X: 0, Y: 0}, 0, Vector2{X: 1, Y: 1})},
+	}
+	levelData := builder.Build()
+
+	testCases := []TestCase{
+		{Name: "Center of first crate", Point: Point{X: 10, Y: 0}, ExpectSolid: true},
+		{Name: "Inside first crate near corner", Point: Point{X: 10.9, Y: 0.9}, ExpectSolid: true},
+		{Name: "Outside first crate", Point: Point{X: 11.5, Y: 0}, ExpectSolid: false},
+		{Name: "Rotated crate along its long side", Point: Point{X: -10, Y: 1.8}, ExpectSolid: true},
+		{Name: "Rotated crate across its short side", Point: Point{X: -11, Y: 0}, ExpectSolid: false},
+		{Name: "Missing prefab location", Point: Point{X: 0, Y: 0}, ExpectSolid: false},
+	}
+	runTestCases(t, levelData, testCases)
+}
+
+func TestInstancedPrefabWithWorldGeometry(t *testing.T) {
+	// World wall and a prefab placed on the other side of it
+	wall := Polygon{
+		Vertices: []Point{
+			{X: -1, Y: -5},
+			{X: 1, Y: -5},
+			{X: 1, Y: 5},
+			{X: -1, Y: 5},
+		},
+		IsSolid: true,
+	}
+
+	builder := NewBSPBuilder([]Polygon{wall})
+	builder.Prefabs = map[string][]Polygon{"crate": unitBoxPrefab}
+	builder.Instances = []Instance{
+		{Prefab: "crate", Transform: NewTransform2D(Point{X: 5, Y: 0}, 45, Vector2{X: 2, Y: 2})},
+	}
+	levelData := builder.Build()
+
+	runTestCases(t, levelData, []TestCase{
+		{Name: "Inside wall", Point: Point{X: 0, Y: 0}, ExpectSolid: true},
+		{Name: "Inside rotated crate", Point: Point{X: 5, Y: 1.2}, ExpectSolid: true},
+		{Name: "Between wall and crate", Point: Point{X: 3, Y: 0}, ExpectSolid: false},
+	})
+
+	// Trace from the crate side towards the wall: the crate is hit first
+	result := LineTraceBSP(levelData, 10, 0, -10, 0)
+	if !result.Hit {
+		t.Fatal("Expected trace to hit the crate")
+	}
+	// The crate is rotated by 45 degrees, so its corner reaches x = 5 + sqrt(2)
+	expectedX := float32(5 + math.Sqrt2)
+	if math.Abs(float64(result.HitX-expectedX)) > 0.01 {
+		t.Errorf("Expected hit at x=%.3f, got x=%.3f", expectedX, result.HitX)
+	}
+
+	// Trace from the wall side away from the crate: the wall is hit first
+	result = LineTraceBSP(levelData, 2, 0, -10, 0)
+	if !result.Hit || math.Abs(float64(result.HitX-1)) > 0.01 {
+		t.Errorf("Expected trace to hit the wall at x=1, got hit=%v x=%.3f", result.Hit, result.HitX)
+	}
+}
+
+func TestPrefabSubtreeIsShared(t *testing.T) {
+	// An octagon needs many planes; placing it many times must not duplicate them
+	octagon := make([]Point, 8)
+	for i := range octagon {
+		angle := float64(i) * math.Pi / 4
+		octagon[i] = Point{X: float32(0.5 * math.Cos(angle)), Y: float32(0.5 * math.Sin(angle))}
+	}
+
+	builder := NewBSPBuilder(nil)
+	builder.Prefabs = map[string][]Polygon{"pillar": {{Vertices: octagon, IsSolid: true}}}
+	for i := 0; i < 20; i++ {
+		builder.Instances = append(builder.Instances, Instance{
+			Prefab:    "pillar",
+			Transform: NewTransform2D(Point{X: float32(i) * 3, Y: 0}, 0, Vector2{X: 1, Y: 1}),
+		})
+	}
+	levelData := builder.Build()
+
+	subtrees := make(map[int32]bool)
+	for _, node := range levelData.Nodes {
+		if inst, ok := node.Type.(*pb.BSPNode_Instance); ok {
+			subtrees[inst.Instance.SubtreeIndex] = true
+		}
+	}
+	if len(subtrees) != 1 {
+		t.Errorf("Expected all instances to share one subtree, got %d subtrees", len(subtrees))
+	}
+
+	for i := 0; i < 20; i++ {
+		p := Point{X: float32(i) * 3, Y: 0}
+		if !PointInBSP(levelData.Nodes, levelData.RootIndex, p) {
+			t.Errorf("Pillar %d at (%v, %v) should be solid", i, p.X, p.Y)
+		}
+	}
+}
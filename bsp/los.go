@@ -0,0 +1,283 @@
+package bsp
+
+import (
+	"math"
+	"runtime"
+	"sync"
+	"sync/atomic"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+const (
+	// LOSCellSize is the edge length of a line of sight grid cell in world units
+	LOSCellSize = 2.0
+	// maxLOSCells bounds the line of sight grid, larger levels get coarser cells
+	maxLOSCells = 1 << 16
+	// maxLOSOps bounds the estimated work of the cell masks in solid vertex tests (a few seconds
+	// on one core), so the bake stays well within the per-level compile timeout; levels with deep
+	// trees, many points or many solids get coarser cells
+	maxLOSOps = 1 << 30
+	// losTraceOpsPerLevel is the estimated cost of one line trace per level of the collision tree,
+	// in solid vertex tests (traces visit more than one node per level where they cross planes)
+	losTraceOpsPerLevel = 100
+)
+
+// LOSPoint is a point that takes part in baked line of sight
+type LOSPoint struct {
+	Kind     string // "spawn", "portal" or "marker"
+	Name     string
+	Position Point
+}
+
+// LOSInput is everything BakeLineOfSight needs besides the tree
+type LOSInput struct {
+	Points []LOSPoint
+	// Bounds of the grid, usually the bounds of the whole level
+	BoundsMin, BoundsMax Point
+	// One world-space vertex of every solid piece, used to find obstacles that
+	// lie entirely inside the area between a point and a cell
+	SolidVertices []Point
+}
+
+// BakeLineOfSight computes line of sight between all points and the per-cell visibility masks
+// It traces with the collision engine shipped in the level data, so baked answers match runtime traces
+// Returns nil if there are no points
+func BakeLineOfSight(levelData *pb.LevelData, input LOSInput) *pb.LineOfSight {
+	n := len(input.Points)
+	if n == 0 {
+		return nil
+	}
+
+	los := &pb.LineOfSight{
+		Points:       make([]*pb.LOSPoint, n),
+		WordsPerCell: int32((n + 63) / 64),
+	}
+	for i, p := range input.Points {
+		los.Points[i] = &pb.LOSPoint{Kind: p.Kind, Name: p.Name, X: p.Position.X, Y: p.Position.Y}
+	}
+
+	// Pairwise matrix, one row per job
+	// Rows are computed in parallel and packed afterwards, because rows share words
+	rows := make([][]bool, n)
+	parallelFor(n, func(i int) {
+		row := make([]bool, n)
+		row[i] = !PointInLevel(levelData, input.Points[i].Position)
+		for j := i + 1; j < n; j++ {
+			hit, _, _ := LineTraceLevel(levelData, input.Points[i].Position, input.Points[j].Position)
+			row[j] = !hit
+		}
+		rows[i] = row
+	})
+	los.Matrix = make([]uint64, (n*n+63)/64)
+	for i := 0; i < n; i++ {
+		for j := i; j < n; j++ {
+			if rows[i][j] {
+				setBit(los.Matrix, i*n+j)
+				setBit(los.Matrix, j*n+i)
+			}
+		}
+	}
+
+	// Grid of cells, coarsened until it fits
+	extent := Point{X: input.BoundsMax.X - input.BoundsMin.X, Y: input.BoundsMax.Y - input.BoundsMin.Y}
+	traceDepth := TreeDepth(levelData.Nodes, levelData.RootIndex)
+	if levelData.CollisionBvh != nil {
+		traceDepth = BVHDepth(levelData.CollisionBvh)
+	}
+	cellSize, width, height := losGrid(extent, n, len(input.SolidVertices), traceDepth)
+	los.CellSize = cellSize
+	los.MinX = input.BoundsMin.X
+	los.MinY = input.BoundsMin.Y
+	los.Width = int32(width)
+	los.Height = int32(height)
+
+	// Every cell owns its words, so cells can be written in parallel
+	words := int(los.WordsPerCell)
+	los.CellMasks = make([]uint64, width*height*words)
+	parallelFor(width*height, func(cell int) {
+		cellMin := Point{
+			X: los.MinX + float32(cell%width)*cellSize,
+			Y: los.MinY + float32(cell/width)*cellSize,
+		}
+		cellMax := Point{X: cellMin.X + cellSize, Y: cellMin.Y + cellSize}
+		corners := [4]Point{
+			{X: cellMin.X, Y: cellMin.Y},
+			{X: cellMax.X, Y: cellMin.Y},
+			{X: cellMax.X, Y: cellMax.Y},
+			{X: cellMin.X, Y: cellMax.Y},
+		}
+
+		// A cell with solid inside of it is not fully visible from anywhere
+		for i, corner := range corners {
+			if hit, _, _ := LineTraceLevel(levelData, corner, corners[(i+1)%4]); hit {
+				return
+			}
+		}
+		for _, v := range input.SolidVertices {
+			if v.X >= cellMin.X && v.X <= cellMax.X && v.Y >= cellMin.Y && v.Y <= cellMax.Y {
+				return
+			}
+		}
+
+		mask := los.CellMasks[cell*words : (cell+1)*words]
+		for j, p := range input.Points {
+			if cellFullyVisible(levelData, p.Position, corners, input.SolidVertices) {
+				setBit(mask, j)
+			}
+		}
+	})
+
+	return los
+}
+
+// losGrid returns the cell size and dimensions of the line of sight grid
+// Cells start at LOSCellSize and double until the grid has at most maxLOSCells cells and the
+// estimated work of the cell masks is within maxLOSOps
+// traceDepth is the depth of the collision engine the bake traces with
+func losGrid(extent Point, points, solidVertices, traceDepth int) (float32, int, int) {
+	cellSize := float32(LOSCellSize)
+	width, height := gridSize(extent, cellSize)
+	for width*height > 1 && (width*height > maxLOSCells || losOps(width*height, points, solidVertices, traceDepth) > maxLOSOps) {
+		cellSize *= 2
+		width, height = gridSize(extent, cellSize)
+	}
+	return cellSize, width, height
+}
+
+// losOps estimates the work of the cell masks: every cell traces its edges and tests every solid
+// vertex, and every point tests its hull against every solid vertex with up to five traces
+func losOps(cells, points, solidVertices, traceDepth int) float64 {
+	trace := float64(losTraceOpsPerLevel * max(traceDepth, 1))
+	perCell := 4*trace + float64(solidVertices) + float64(points)*(5*trace+float64(solidVertices))
+	return float64(cells) * perCell
+}
+
+// cellFullyVisible returns true if every point of a cell without solids sees the viewer
+// That is the case if the convex hull of the viewer and the cell is free of solids:
+// no solid crosses its boundary (traced) and no solid lies entirely inside of it (vertex test)
+func cellFullyVisible(levelData *pb.LevelData, viewer Point, corners [4]Point, solidVertices []Point) bool {
+	// Most hidden cells are rejected by a single trace to the center
+	center := Point{X: (corners[0].X + corners[2].X) / 2, Y: (corners[0].Y + corners[2].Y) / 2}
+	if hit, _, _ := LineTraceLevel(levelData, viewer, center); hit {
+		return false
+	}
+
+	// The hull is the union of the triangles from the viewer to every cell edge
+	hullMin := Point{X: min(viewer.X, corners[0].X), Y: min(viewer.Y, corners[0].Y)}
+	hullMax := Point{X: max(viewer.X, corners[2].X), Y: max(viewer.Y, corners[2].Y)}
+	for _, v := range solidVertices {
+		if v.X < hullMin.X || v.X > hullMax.X || v.Y < hullMin.Y || v.Y > hullMax.Y {
+			continue
+		}
+		for i, corner := range corners {
+			if pointInTriangle(v, viewer, corner, corners[(i+1)%4]) {
+				return false
+			}
+		}
+	}
+
+	// Together with the cell edges, the segments to the corners cover the boundary of the hull
+	for _, corner := range corners {
+		if hit, _, _ := LineTraceLevel(levelData, viewer, corner); hit {
+			return false
+		}
+	}
+	return true
+}
+
+// pointInTriangle returns true if p is inside or on the triangle abc (any winding)
+func pointInTriangle(p, a, b, c Point) bool {
+	d1 := orient2d(a, b, p)
+	d2 := orient2d(b, c, p)
+	d3 := orient2d(c, a, p)
+	hasNeg := d1 < 0 || d2 < 0 || d3 < 0
+	hasPos := d1 > 0 || d2 > 0 || d3 > 0
+	return !(hasNeg && hasPos)
+}
+
+// gridSize returns the number of cells needed to cover the extent
+func gridSize(extent Point, cellSize float32) (int, int) {
+	width := max(int(math.Ceil(float64(extent.X/cellSize))), 1)
+	height := max(int(math.Ceil(float64(extent.Y/cellSize))), 1)
+	return width, height
+}
+
+// parallelFor calls fn for 0 <= i < n on all CPUs
+func parallelFor(n int, fn func(i int)) {
+	var next atomic.Int64
+	var wg sync.WaitGroup
+	workers := min(runtime.GOMAXPROCS(0), n)
+	for w := 0; w < workers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for {
+				i := int(next.Add(1) - 1)
+				if i >= n {
+					return
+				}
+				fn(i)
+			}
+		}()
+	}
+	wg.Wait()
+}
+
+func setBit(words []uint64, bit int) {
+	words[bit/64] |= 1 << (bit % 64)
+}
+
+func testBit(words []uint64, bit int) bool {
+	return bit/64 < len(words) && words[bit/64]&(1<<(bit%64)) != 0
+}
+
+// LOSPointIndex returns the index of a baked point, or -1 if there is none
+func LOSPointIndex(los *pb.LineOfSight, kind, name string) int {
+	for i, p := range los.GetPoints() {
+		if p.Kind == kind && p.Name == name {
+			return i
+		}
+	}
+	return -1
+}
+
+// LOSVisible returns true if the baked points i and j see each other
+func LOSVisible(los *pb.LineOfSight, i, j int) bool {
+	n := len(los.GetPoints())
+	if i < 0 || j < 0 || i >= n || j >= n {
+		return false
+	}
+	return testBit(los.Matrix, i*n+j)
+}
+
+// LOSCellVisible returns true if point j is known to be visible from the grid cell containing p
+// A false result is not conclusive, the caller has to trace
+func LOSCellVisible(los *pb.LineOfSight, p Point, j int) bool {
+	if los == nil || j < 0 || j >= len(los.Points) || los.CellSize <= 0 {
+		return false
+	}
+	x := int(math.Floor(float64((p.X - los.MinX) / los.CellSize)))
+	y := int(math.Floor(float64((p.Y - los.MinY) / los.CellSize)))
+	if x < 0 || y < 0 || x >= int(los.Width) || y >= int(los.Height) {
+		return false
+	}
+	cell := y*int(los.Width) + x
+	words := int(los.WordsPerCell)
+	return testBit(los.CellMasks[cell*words:(cell+1)*words], j)
+}
+
+// PointSeesLOSPoint returns true if the baked point j is visible from p
+// The cell mask answers most queries, the rest fall back to a line trace
+func PointSeesLOSPoint(levelData *pb.LevelData, p Point, j int) bool {
+	los := levelData.GetLineOfSight()
+	if j < 0 || j >= len(los.GetPoints()) {
+		return false
+	}
+	if LOSCellVisible(los, p, j) {
+		return true
+	}
+	target := Point{X: los.Points[j].X, Y: los.Points[j].Y}
+	hit, _, _ := LineTraceLevel(levelData, p, target)
+	return !hit
+}
@@ -0,0 +1,113 @@
+package bsp
+
+import (
+	"testing"
+)
+
+func TestBakeLineOfSight(t *testing.T) {
+	// A wall between a and b, c sees both around its end
+	wall := Polygon{
+		Vertices: []Point{{X: 4, Y: 0}, {X: 5, Y: 0}, {X: 5, Y: 6}, {X: 4, Y: 6}},
+		IsSolid:  true,
+	}
+	// A small pillar that fits between the traced segments of some cells
+	pillar := regularPolygon(Point{X: 1.5, Y: 9}, 0.25, 12)
+	levelData := NewBSPBuilder([]Polygon{wall, pillar}).Build()
+
+	input := LOSInput{
+		Points: []LOSPoint{
+			{Kind: "spawn", Name: "a", Position: Point{X: 1, Y: 3}},
+			{Kind: "spawn", Name: "b", Position: Point{X: 8, Y: 3}},
+			{Kind: "marker", Name: "c", Position: Point{X: 4.5, Y: 10}},
+		},
+		BoundsMin:     Point{X: 0, Y: 0},
+		BoundsMax:     Point{X: 10, Y: 12},
+		SolidVertices: []Point{wall.Vertices[0], pillar.Vertices[0]},
+	}
+	los := BakeLineOfSight(levelData, input)
+	levelData.LineOfSight = los
+
+	a := LOSPointIndex(los, "spawn", "a")
+	b := LOSPointIndex(los, "spawn", "b")
+	c := LOSPointIndex(los, "marker", "c")
+	if a < 0 || b < 0 || c < 0 {
+		t.Fatalf("Expected all points to be baked, got %d %d %d", a, b, c)
+	}
+	if LOSPointIndex(los, "portal", "0") != -1 {
+		t.Error("Expected no index for an unknown point")
+	}
+
+	if LOSVisible(los, a, b) || LOSVisible(los, b, a) {
+		t.Error("Expected the wall to block a and b")
+	}
+	if !LOSVisible(los, a, c) || !LOSVisible(los, c, b) {
+		t.Error("Expected c to see a and b")
+	}
+	if !LOSVisible(los, a, a) {
+		t.Error("Expected a point outside of solids to see itself")
+	}
+
+	// Cell masks are conservative: a set bit means visible from every point in the cell
+	known := 0
+	for y := float32(0.05); y < 12; y += 0.1 {
+		for x := float32(0.05); x < 10; x += 0.1 {
+			p := Point{X: x, Y: y}
+			for j, target := range input.Points {
+				hit, _, _ := LineTraceBSPNode(levelData.Nodes, levelData.RootIndex, p, target.Position, 0, 1)
+				if LOSCellVisible(los, p, j) {
+					known++
+					if hit {
+						t.Fatalf("Cell of %v claims to see %s, but the trace hits", p, target.Name)
+					}
+				}
+				if PointSeesLOSPoint(levelData, p, j) == hit {
+					t.Fatalf("PointSeesLOSPoint disagrees with the trace from %v to %s", p, target.Name)
+				}
+			}
+		}
+	}
+	if known == 0 {
+		t.Error("Expected some cells to be known visible")
+	}
+}
+
+func TestCellFullyVisibleIsland(t *testing.T) {
+	// A pillar between the traced segments from the viewer to the cell
+	pillar := regularPolygon(Point{X: 5, Y: 0.25}, 0.1, 12)
+	levelData := NewBSPBuilder([]Polygon{pillar}).Build()
+	viewer := Point{X: 0, Y: 0}
+	corners := [4]Point{{X: 10, Y: -1}, {X: 12, Y: -1}, {X: 12, Y: 1}, {X: 10, Y: 1}}
+
+	if !cellFullyVisible(levelData, viewer, corners, nil) {
+		t.Fatal("Expected the traces alone to miss the pillar")
+	}
+	if cellFullyVisible(levelData, viewer, corners, []Point{pillar.Vertices[0]}) {
+		t.Error("Expected the pillar vertex to make the cell not fully visible")
+	}
+}
+
+func TestLOSGrid(t *testing.T) {
+	extent := Point{X: 100, Y: 100}
+	if cellSize, width, height := losGrid(extent, 8, 200, 20); cellSize != LOSCellSize || width != 50 || height != 50 {
+		t.Errorf("Expected the default %v unit cells for a small level, got %v (%dx%d)", float32(LOSCellSize), cellSize, width, height)
+	}
+
+	// Deep trees, many points and many solids get coarser cells instead of running into the compile timeout
+	for _, size := range []struct{ points, solidVertices, traceDepth int }{
+		{64, 200000, 20},
+		{16, 400, 2400},
+	} {
+		cellSize, width, height := losGrid(extent, size.points, size.solidVertices, size.traceDepth)
+		if cellSize <= LOSCellSize {
+			t.Errorf("Expected coarser cells for %+v, got %v", size, cellSize)
+		}
+		if ops := losOps(width*height, size.points, size.solidVertices, size.traceDepth); ops > maxLOSOps {
+			t.Errorf("Expected the estimated work for %+v within %.0f, got %.0f", size, float64(maxLOSOps), ops)
+		}
+	}
+
+	// The grid never gets smaller than one cell
+	if _, width, height := losGrid(extent, 1<<20, 1<<20, 1<<10); width != 1 || height != 1 {
+		t.Errorf("Expected a single cell, got %dx%d", width, height)
+	}
+}
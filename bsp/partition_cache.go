@@ -0,0 +1,144 @@
+package bsp
+
+import (
+	"container/list"
+	"encoding/binary"
+	"hash/fnv"
+	"math"
+	"sync"
+)
+
+// DefaultPartitionCacheSize is the number of partitions NewPartitionCache keeps
+// Dragging a vertex creates a new outline every frame, so the cache has to forget old ones
+const DefaultPartitionCacheSize = 4096
+
+// PartitionCache remembers the convex partitions of polygons, keyed by their vertices
+// Share one cache between builders to skip partitioning outlines that did not change
+// It keeps a bounded number of partitions and forgets the least recently used ones first
+// It is safe for concurrent use
+type PartitionCache struct {
+	mu      sync.Mutex
+	limit   int
+	entries map[uint64][]*list.Element // polygon hash -> elements of recent
+	recent  *list.List                 // *partitionEntry, most recently used first
+}
+
+// partitionEntry is a cached partition, with the polygon it belongs to for collision checks
+type partitionEntry struct {
+	key     uint64
+	polygon Polygon
+	pieces  []Polygon
+}
+
+// NewPartitionCache creates an empty partition cache of DefaultPartitionCacheSize partitions
+func NewPartitionCache() *PartitionCache {
+	return NewPartitionCacheSize(DefaultPartitionCacheSize)
+}
+
+// NewPartitionCacheSize creates an empty partition cache that keeps up to limit partitions
+func NewPartitionCacheSize(limit int) *PartitionCache {
+	return &PartitionCache{
+		limit:   max(limit, 1),
+		entries: make(map[uint64][]*list.Element),
+		recent:  list.New(),
+	}
+}
+
+// Len returns the number of cached partitions
+func (c *PartitionCache) Len() int {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	return c.recent.Len()
+}
+
+// Partition returns the convex partition of a polygon, partitioning it on a cache miss
+// Failed partitions are not cached
+func (c *PartitionCache) Partition(poly Polygon) ([]Polygon, error) {
+	key := polygonHash(poly)
+
+	c.mu.Lock()
+	for _, elem := range c.entries[key] {
+		entry := elem.Value.(*partitionEntry)
+		if samePolygon(entry.polygon, poly) {
+			c.recent.MoveToFront(elem)
+			c.mu.Unlock()
+			return entry.pieces, nil
+		}
+	}
+	c.mu.Unlock()
+
+	pieces, err := PartitionPolygonConvex(poly)
+	if err != nil {
+		return nil, err
+	}
+
+	// The cache owns its copy, callers may modify the polygon afterwards
+	owned := Polygon{Vertices: append([]Point(nil), poly.Vertices...), IsSolid: poly.IsSolid}
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	for _, elem := range c.entries[key] {
+		if samePolygon(elem.Value.(*partitionEntry).polygon, poly) {
+			return pieces, nil // Partitioned concurrently
+		}
+	}
+	elem := c.recent.PushFront(&partitionEntry{key: key, polygon: owned, pieces: pieces})
+	c.entries[key] = append(c.entries[key], elem)
+	for c.recent.Len() > c.limit {
+		c.evict(c.recent.Back())
+	}
+	return pieces, nil
+}
+
+// evict removes an element from the cache
+func (c *PartitionCache) evict(elem *list.Element) {
+	key := elem.Value.(*partitionEntry).key
+	c.recent.Remove(elem)
+	bucket := c.entries[key]
+	for i, other := range bucket {
+		if other == elem {
+			bucket = append(bucket[:i], bucket[i+1:]...)
+			break
+		}
+	}
+	if len(bucket) == 0 {
+		delete(c.entries, key)
+	} else {
+		c.entries[key] = bucket
+	}
+}
+
+// partition partitions a polygon through the builder's cache, if it has one
+func (b *BSPBuilder) partition(poly Polygon) ([]Polygon, error) {
+	if b.Partitions == nil {
+		return PartitionPolygonConvex(poly)
+	}
+	return b.Partitions.Partition(poly)
+}
+
+// polygonHash hashes the vertices and solidity of a polygon
+func polygonHash(poly Polygon) uint64 {
+	h := fnv.New64a()
+	var buf [8]byte
+	for _, v := range poly.Vertices {
+		binary.LittleEndian.PutUint32(buf[0:4], math.Float32bits(v.X))
+		binary.LittleEndian.PutUint32(buf[4:8], math.Float32bits(v.Y))
+		h.Write(buf[:])
+	}
+	if poly.IsSolid {
+		h.Write([]byte{1})
+	}
+	return h.Sum64()
+}
+
+// samePolygon returns true if both polygons have exactly the same vertices and solidity
+func samePolygon(a, b Polygon) bool {
+	if a.IsSolid != b.IsSolid || len(a.Vertices) != len(b.Vertices) {
+		return false
+	}
+	for i := range a.Vertices {
+		if a.Vertices[i] != b.Vertices[i] {
+			return false
+		}
+	}
+	return true
+}
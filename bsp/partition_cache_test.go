@@ -0,0 +1,96 @@
+package bsp
+
+import (
+	"testing"
+)
+
+func TestPartitionCache(t *testing.T) {
+	cache := NewPartitionCache()
+	lShape := Polygon{
+		Vertices: []Point{
+			{X: 0, Y: 0}, {X: 3, Y: 0}, {X: 3, Y: 1},
+			{X: 1, Y: 1}, {X: 1, Y: 3}, {X: 0, Y: 3},
+		},
+		IsSolid: true,
+	}
+
+	first, err := cache.Partition(lShape)
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if cache.Len() != 1 {
+		t.Fatalf("Expected 1 cached partition, got %d", cache.Len())
+	}
+
+	// Changing the caller's polygon must not change the cached entry
+	moved := Polygon{Vertices: append([]Point(nil), lShape.Vertices...), IsSolid: true}
+	moved.Vertices[0].X = -1
+	if _, err := cache.Partition(moved); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if cache.Len() != 2 {
+		t.Errorf("Expected the moved polygon to be a miss, got %d cached partitions", cache.Len())
+	}
+
+	again, err := cache.Partition(lShape)
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if cache.Len() != 2 || len(again) != len(first) {
+		t.Errorf("Expected a cache hit, got %d pieces and %d cached partitions", len(again), cache.Len())
+	}
+
+	// Builders sharing the cache produce the same tree as uncached builds
+	uncached := NewBSPBuilder([]Polygon{lShape, moved}).Build()
+	builder := NewBSPBuilder([]Polygon{lShape, moved})
+	builder.Partitions = cache
+	cached := builder.Build()
+	if len(cached.Nodes) != len(uncached.Nodes) {
+		t.Errorf("Expected %d nodes like the uncached build, got %d", len(uncached.Nodes), len(cached.Nodes))
+	}
+	for x := float32(-1.5); x < 4; x += 0.25 {
+		for y := float32(-0.5); y < 4; y += 0.25 {
+			p := Point{X: x, Y: y}
+			if PointInBSP(cached.Nodes, cached.RootIndex, p) != PointInBSP(uncached.Nodes, uncached.RootIndex, p) {
+				t.Fatalf("Cached and uncached builds disagree at %v", p)
+			}
+		}
+	}
+	if cache.Len() != 2 {
+		t.Errorf("Expected the build to hit the cache, got %d cached partitions", cache.Len())
+	}
+}
+
+func TestPartitionCacheEviction(t *testing.T) {
+	cache := NewPartitionCacheSize(3)
+	square := func(x float32) Polygon {
+		return Polygon{Vertices: []Point{{X: x, Y: 0}, {X: x + 1, Y: 0}, {X: x + 1, Y: 1}, {X: x, Y: 1}}, IsSolid: true}
+	}
+	partition := func(x float32) {
+		if _, err := cache.Partition(square(x)); err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+	}
+	cached := func(x float32) bool {
+		cache.mu.Lock()
+		defer cache.mu.Unlock()
+		return len(cache.entries[polygonHash(square(x))]) > 0
+	}
+
+	// A dragged vertex creates a new outline every frame
+	for i := 0; i < 10; i++ {
+		partition(float32(i))
+	}
+	if cache.Len() != 3 {
+		t.Fatalf("Expected the cache to stay at 3 partitions, got %d", cache.Len())
+	}
+
+	// Using square 7 again keeps it, square 8 is now the least recently used
+	partition(7)
+	partition(10)
+	for x, want := range map[float32]bool{0: false, 6: false, 7: true, 8: false, 9: true, 10: true} {
+		if cached(x) != want {
+			t.Errorf("Square %v: expected cached=%v", x, want)
+		}
+	}
+}
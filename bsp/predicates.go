@@ -0,0 +1,137 @@
+package bsp
+
+import (
+	"math"
+	"math/big"
+)
+
+// Robust geometric predicates on float32 coordinates
+// Every float32 converts to float64 exactly and the product of two float32 values fits a float64
+// mantissa, so the predicates are evaluated in float64 first and only fall back to exact big.Float
+// arithmetic when the result is closer to zero than its rounding error bound (Shewchuk's filter)
+
+const (
+	// predicateEpsilon is half a float64 ulp, the relative rounding error of a single operation
+	predicateEpsilon = 1.0 / (1 << 53)
+	// orientErrorBound bounds the rounding error of the orientation determinant relative to the
+	// sum of the magnitudes of its two products
+	orientErrorBound = (3 + 16*predicateEpsilon) * predicateEpsilon
+	// lineErrorBound bounds the rounding error of n . p - d relative to the sum of the magnitudes
+	// of its terms, the products are exact, the two additions round
+	lineErrorBound = (2 + 8*predicateEpsilon) * predicateEpsilon
+	// exactPrecision holds any sum of products of differences of float32 values without rounding
+	// (a float32 is an integer multiple of 2^-149 below 2^128)
+	exactPrecision = 1200
+)
+
+// orient2d returns 1 if c is left of the directed line a -> b, -1 if it is right of it and 0 if the
+// three points are exactly collinear
+func orient2d(a, b, c Point) int {
+	left := (float64(b.X) - float64(a.X)) * (float64(c.Y) - float64(a.Y))
+	right := (float64(b.Y) - float64(a.Y)) * (float64(c.X) - float64(a.X))
+	det := left - right
+	if math.Abs(det) > orientErrorBound*(math.Abs(left)+math.Abs(right)) {
+		return sign64(det)
+	}
+	if !finite(det) {
+		return 0
+	}
+	return orient2dExact(a, b, c)
+}
+
+// orient2dExact is orient2d in exact arithmetic
+func orient2dExact(a, b, c Point) int {
+	bx, by := exactSub(b.X, a.X), exactSub(b.Y, a.Y)
+	cx, cy := exactSub(c.X, a.X), exactSub(c.Y, a.Y)
+	left := exactFloat().Mul(bx, cy)
+	right := exactFloat().Mul(by, cx)
+	return left.Cmp(right)
+}
+
+// orientDistance returns orient2d(a, b, c) scaled by the length of a -> b, an approximate signed
+// distance of c to the line with the exact sign, or 0 exactly when the points are collinear
+func orientDistance(a, b, c Point) (int, float64) {
+	side := orient2d(a, b, c)
+	if side == 0 {
+		return 0, 0
+	}
+	ex, ey := float64(b.X)-float64(a.X), float64(b.Y)-float64(a.Y)
+	d := (ex*(float64(c.Y)-float64(a.Y)) - ey*(float64(c.X)-float64(a.X))) / math.Hypot(ex, ey)
+	// Near the line the float64 value may have the wrong sign or be zero, the exact sign wins
+	if sign64(d) != side {
+		d = float64(side) * math.SmallestNonzeroFloat64
+	}
+	return side, d
+}
+
+// lineSide returns the exact sign of l.PointSide(p) for the float32 plane l
+func lineSide(l Line, p Point) int {
+	x := float64(l.Normal.X) * float64(p.X)
+	y := float64(l.Normal.Y) * float64(p.Y)
+	d := float64(l.Distance)
+	side := x + y - d
+	if math.Abs(side) > lineErrorBound*(math.Abs(x)+math.Abs(y)+math.Abs(d)) {
+		return sign64(side)
+	}
+	if !finite(side) {
+		return 0
+	}
+
+	exactX := exactFloat().Mul(exactFloat().SetFloat64(float64(l.Normal.X)), exactFloat().SetFloat64(float64(p.X)))
+	exactY := exactFloat().Mul(exactFloat().SetFloat64(float64(l.Normal.Y)), exactFloat().SetFloat64(float64(p.Y)))
+	return exactX.Add(exactX, exactY).Cmp(exactFloat().SetFloat64(d))
+}
+
+// polygonOrientation returns 1 for a CCW outline, -1 for a CW outline and 0 for a degenerate one
+// The turn at the lowest (then leftmost) vertex is convex for any simple outline, so its exact
+// orientation is the winding of the whole outline
+func polygonOrientation(vertices []Point) int {
+	n := len(vertices)
+	if n < 3 {
+		return 0
+	}
+	lowest := 0
+	for i, v := range vertices {
+		if v.Y < vertices[lowest].Y || (v.Y == vertices[lowest].Y && v.X < vertices[lowest].X) {
+			lowest = i
+		}
+	}
+	// Skip neighbors that coincide with the lowest vertex
+	prev, next := (lowest+n-1)%n, (lowest+1)%n
+	for prev != lowest && vertices[prev] == vertices[lowest] {
+		prev = (prev + n - 1) % n
+	}
+	for next != lowest && vertices[next] == vertices[lowest] {
+		next = (next + 1) % n
+	}
+	if side := orient2d(vertices[prev], vertices[lowest], vertices[next]); side != 0 {
+		return side
+	}
+	// Collinear at the extreme vertex only happens for outlines without area, or spikes
+	return sign64(float64(signedArea(Polygon{Vertices: vertices})))
+}
+
+// exactFloat returns a big.Float that computes without rounding
+func exactFloat() *big.Float {
+	return new(big.Float).SetPrec(exactPrecision)
+}
+
+// exactSub returns a - b without rounding
+func exactSub(a, b float32) *big.Float {
+	return exactFloat().Sub(exactFloat().SetFloat64(float64(a)), exactFloat().SetFloat64(float64(b)))
+}
+
+// sign64 returns the sign of v as -1, 0 or 1
+func sign64(v float64) int {
+	if v > 0 {
+		return 1
+	} else if v < 0 {
+		return -1
+	}
+	return 0
+}
+
+// finite returns false for infinities and NaN, which have no exact sign to fall back to
+func finite(v float64) bool {
+	return !math.IsInf(v, 0) && !math.IsNaN(v)
+}
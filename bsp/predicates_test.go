@@ -0,0 +1,131 @@
+package bsp
+
+import (
+	"math"
+	"math/big"
+	"math/rand"
+	"testing"
+)
+
+// ratOrient is the orientation of three points in rational arithmetic
+func ratOrient(a, b, c Point) int {
+	rat := func(v float32) *big.Rat { return new(big.Rat).SetFloat64(float64(v)) }
+	bx, by := new(big.Rat).Sub(rat(b.X), rat(a.X)), new(big.Rat).Sub(rat(b.Y), rat(a.Y))
+	cx, cy := new(big.Rat).Sub(rat(c.X), rat(a.X)), new(big.Rat).Sub(rat(c.Y), rat(a.Y))
+	return new(big.Rat).Mul(bx, cy).Cmp(new(big.Rat).Mul(by, cx))
+}
+
+func TestOrient2d(t *testing.T) {
+	rng := rand.New(rand.NewSource(1))
+	magnitudes := []float32{1e-30, 1e-3, 1, 1e4, 1e30}
+
+	t.Run("Matches rational arithmetic", func(t *testing.T) {
+		for i := 0; i < 20000; i++ {
+			var p [3]Point
+			for j := range p {
+				scale := magnitudes[rng.Intn(len(magnitudes))]
+				p[j] = Point{X: (rng.Float32() - 0.5) * scale, Y: (rng.Float32() - 0.5) * scale}
+			}
+			if got, want := orient2d(p[0], p[1], p[2]), ratOrient(p[0], p[1], p[2]); got != want {
+				t.Fatalf("orient2d(%v) = %d, expected %d", p, got, want)
+			}
+		}
+	})
+
+	t.Run("Nearly collinear points", func(t *testing.T) {
+		// Points on a diagonal, nudged by a single float32 ulp, far from the origin
+		for i := 0; i < 20000; i++ {
+			scale := magnitudes[rng.Intn(len(magnitudes))]
+			a := Point{X: rng.Float32() * scale, Y: rng.Float32() * scale}
+			d := Point{X: rng.Float32() * scale, Y: rng.Float32() * scale}
+			b := Point{X: a.X + d.X, Y: a.Y + d.Y}
+			s := rng.Float32() * 3
+			c := Point{X: a.X + s*d.X, Y: a.Y + s*d.Y}
+			switch rng.Intn(3) {
+			case 0:
+				c.X = math.Nextafter32(c.X, float32(math.Inf(1)))
+			case 1:
+				c.Y = math.Nextafter32(c.Y, float32(math.Inf(-1)))
+			}
+			if got, want := orient2d(a, b, c), ratOrient(a, b, c); got != want {
+				t.Fatalf("orient2d(%v, %v, %v) = %d, expected %d", a, b, c, got, want)
+			}
+		}
+	})
+
+	t.Run("Collinear points are exactly zero", func(t *testing.T) {
+		a, b := Point{X: 0.1, Y: 0.1}, Point{X: 12345.6, Y: 12345.6}
+		if side := orient2d(a, b, Point{X: 777.7, Y: 777.7}); side != 0 {
+			t.Errorf("Expected collinear points, got side %d", side)
+		}
+	})
+}
+
+func TestLineSide(t *testing.T) {
+	rng := rand.New(rand.NewSource(2))
+	for i := 0; i < 20000; i++ {
+		l := Line{Normal: Vector2{X: rng.Float32() - 0.5, Y: rng.Float32() - 0.5}.Normalize()}
+		p := Point{X: (rng.Float32() - 0.5) * 1000, Y: (rng.Float32() - 0.5) * 1000}
+		// Put the line through p, up to the rounding of the float32 distance
+		l.Distance = l.Normal.X*p.X + l.Normal.Y*p.Y
+
+		rat := func(v float32) *big.Rat { return new(big.Rat).SetFloat64(float64(v)) }
+		side := new(big.Rat).Add(new(big.Rat).Mul(rat(l.Normal.X), rat(p.X)), new(big.Rat).Mul(rat(l.Normal.Y), rat(p.Y)))
+		if got, want := lineSide(l, p), side.Cmp(rat(l.Distance)); got != want {
+			t.Fatalf("lineSide(%v, %v) = %d, expected %d", l, p, got, want)
+		}
+	}
+}
+
+func TestPolygonOrientation(t *testing.T) {
+	// A thin sliver far from the origin
+	sliver := []Point{{X: 10000, Y: 10000}, {X: 10010, Y: 10000.001}, {X: 10020, Y: 10000.002}, {X: 10010, Y: 10000.002}}
+	if got := polygonOrientation(sliver); got != 1 {
+		t.Errorf("Expected a CCW sliver, got %d", got)
+	}
+	reversed := []Point{sliver[3], sliver[2], sliver[1], sliver[0]}
+	if got := polygonOrientation(reversed); got != -1 {
+		t.Errorf("Expected a CW sliver, got %d", got)
+	}
+	if got := polygonOrientation([]Point{{X: 0, Y: 0}, {X: 1, Y: 1}, {X: 2, Y: 2}}); got != 0 {
+		t.Errorf("Expected a degenerate outline, got %d", got)
+	}
+}
+
+func TestSplitPolygon(t *testing.T) {
+	// A diagonal edge far from the origin: its rounded float32 plane puts the edge's own vertices
+	// off the line, the exact test keeps them on it
+	a, b := Point{X: 10000.1, Y: 20000.3}, Point{X: 10003.7, Y: 20001.9}
+	split := splitEdge{a: a, b: b}
+
+	// A triangle on the edge, on the right of a -> b
+	triangle := Polygon{Vertices: []Point{a, {X: 10004, Y: 19990}, b}, IsSolid: true}
+	if got := classifyPolygon(triangle, split); got != PolygonBack {
+		t.Errorf("Expected the triangle behind its own edge, got %v", got)
+	}
+	if front, back := splitPolygon(triangle, split); front != nil || back == nil || len(back.Vertices) != 3 {
+		t.Errorf("Expected the triangle to stay whole behind the edge, got %v and %v", front, back)
+	}
+
+	// A square crossed by the horizontal line through its center
+	square := Polygon{Vertices: []Point{{X: 0, Y: 0}, {X: 2, Y: 0}, {X: 2, Y: 2}, {X: 0, Y: 2}}, IsSolid: true}
+	horizontal := splitEdge{a: Point{X: -5, Y: 1}, b: Point{X: 5, Y: 1}}
+	if got := classifyPolygon(square, horizontal); got != PolygonSpanning {
+		t.Fatalf("Expected a spanning square, got %v", got)
+	}
+	front, back := splitPolygon(square, horizontal)
+	if front == nil || back == nil {
+		t.Fatal("Expected both halves")
+	}
+	if area := signedArea(*front); area != 2 {
+		t.Errorf("Expected a front half of area 2, got %v", area)
+	}
+	if area := signedArea(*back); area != 2 {
+		t.Errorf("Expected a back half of area 2, got %v", area)
+	}
+	for _, v := range front.Vertices {
+		if v.Y < 1 {
+			t.Errorf("Front vertex %v is behind the line", v)
+		}
+	}
+}
@@ -0,0 +1,449 @@
+package bsp
+
+import (
+	"container/heap"
+	"math"
+	"math/bits"
+	"sort"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+const (
+	// SectorCellSize is the edge length of the cells empty space is clustered in, in world units
+	SectorCellSize = 0.5
+	// maxSectorCells bounds the sector grid, larger levels get coarser cells
+	maxSectorCells = 1 << 16
+	// SectorPortalRatio decides where one sector ends and the next begins: two regions stay apart
+	// where the passage between them is at most this fraction as wide as the narrower region
+	SectorPortalRatio = 0.5
+)
+
+// BuildSectors clusters the empty space of a level into sectors (rooms) and routes every empty
+// leaf of the tree through a sector lookup, so a point query ends in a leaf with the sector_id
+// of the room the point is in (the index into the sector table plus one, 0 outside of all rooms)
+// Empty space is sampled on a grid between boundsMin and boundsMax. Every free cell gets its
+// clearance, the walking distance to the nearest wall, and regions grow from the widest cells
+// down (watershed). Where two regions meet, they merge unless the passage is narrow compared to
+// both of them (SectorPortalRatio), so doors and thin corridors separate rooms while bumps and
+// corners of a room do not
+// The lookup is an axis-aligned kd-tree over the cells, appended to the nodes; empty leaves
+// reached in world space are replaced by copies of its root. The level has to ship the BSP tree
+// Returns the sector table, which is also stored in the level data
+func BuildSectors(levelData *pb.LevelData, boundsMin, boundsMax Point) []*pb.Sector {
+	// Grid of cells, coarsened until it fits
+	cellSize := float32(SectorCellSize)
+	extent := Point{X: boundsMax.X - boundsMin.X, Y: boundsMax.Y - boundsMin.Y}
+	width, height := gridSize(extent, cellSize)
+	for width*height > maxSectorCells {
+		cellSize *= 2
+		width, height = gridSize(extent, cellSize)
+	}
+	grid := &flowGrid{cellSize: cellSize, min: boundsMin, width: width, height: height}
+	grid.free, grid.links = flowLinks(levelData, grid)
+
+	cells, count := clusterSectors(grid, sectorClearance(grid))
+	sectors := sectorTable(grid, cells, count)
+
+	builder := &BSPBuilder{nodes: levelData.Nodes}
+	root := builder.buildSectorTree(grid, cells, count, 0, 0, width, height)
+	levelData.Nodes = builder.nodes
+	routeEmptyLeaves(levelData, root)
+	levelData.Sectors = sectors
+	return sectors
+}
+
+// sectorClearance returns the walking distance in cells from every free cell to the nearest
+// blocked step, +Inf for cells that are not free
+// Cells next to a wall (or the grid border) have clearance 1
+func sectorClearance(grid *flowGrid) []float64 {
+	n := grid.width * grid.height
+	clearance := make([]float64, n)
+	queue := &flowQueue{}
+	const straight = 1<<0 | 1<<2 | 1<<4 | 1<<6
+	for cell := range clearance {
+		clearance[cell] = math.Inf(1)
+		if grid.free[cell] && grid.links[cell]&straight != straight {
+			clearance[cell] = 1
+			heap.Push(queue, flowItem{cell: cell, distance: 1})
+		}
+	}
+
+	for queue.Len() > 0 {
+		item := heap.Pop(queue).(flowItem)
+		if item.distance > clearance[item.cell] {
+			continue
+		}
+		x, y := item.cell%grid.width, item.cell/grid.width
+		for d, offset := range flowNeighbors {
+			if grid.links[item.cell]&(1<<d) == 0 {
+				continue
+			}
+			neighbor := (y+offset[1])*grid.width + x + offset[0]
+			step := 1.0
+			if offset[0] != 0 && offset[1] != 0 {
+				step = math.Sqrt2
+			}
+			if distance := item.distance + step; distance < clearance[neighbor] {
+				clearance[neighbor] = distance
+				heap.Push(queue, flowItem{cell: neighbor, distance: distance})
+			}
+		}
+	}
+	return clearance
+}
+
+// clusterSectors grows regions over the free cells from the widest cells down and returns the
+// sector of every cell (1-based, 0 for cells that are not free) and the number of sectors
+// Sectors are numbered in the row-major order of their first cell
+func clusterSectors(grid *flowGrid, clearance []float64) ([]int32, int) {
+	n := grid.width * grid.height
+	order := make([]int, 0, n)
+	for cell := 0; cell < n; cell++ {
+		if grid.free[cell] {
+			order = append(order, cell)
+		}
+	}
+	sort.SliceStable(order, func(i, j int) bool {
+		return clearance[order[i]] > clearance[order[j]]
+	})
+
+	// Union-find over the cells, the root of a region keeps its widest clearance
+	parent := make([]int32, n)
+	peak := make([]float64, n)
+	for cell := range parent {
+		parent[cell] = -1 // Not reached yet
+	}
+	var find func(cell int32) int32
+	find = func(cell int32) int32 {
+		for parent[cell] != cell {
+			parent[cell] = parent[parent[cell]]
+			cell = parent[cell]
+		}
+		return cell
+	}
+
+	var roots []int32
+	for _, cell := range order {
+		x, y := cell%grid.width, cell/grid.width
+		roots = roots[:0]
+		for d, offset := range flowNeighbors {
+			if grid.links[cell]&(1<<d) == 0 {
+				continue
+			}
+			neighbor := (y+offset[1])*grid.width + x + offset[0]
+			if parent[neighbor] < 0 {
+				continue
+			}
+			root := find(int32(neighbor))
+			if !containsInt32(roots, root) {
+				roots = append(roots, root)
+			}
+		}
+
+		if len(roots) == 0 {
+			// A local maximum starts a region
+			parent[cell] = int32(cell)
+			peak[cell] = clearance[cell]
+			continue
+		}
+
+		// Join the widest neighboring region, then merge the others unless this cell is a portal
+		sort.Slice(roots, func(i, j int) bool {
+			if peak[roots[i]] != peak[roots[j]] {
+				return peak[roots[i]] > peak[roots[j]]
+			}
+			return roots[i] < roots[j]
+		})
+		parent[cell] = roots[0]
+		for _, other := range roots[1:] {
+			a, b := find(roots[0]), find(other)
+			if a == b || clearance[cell] <= SectorPortalRatio*min(peak[a], peak[b]) {
+				continue
+			}
+			if peak[b] > peak[a] || (peak[b] == peak[a] && b < a) {
+				a, b = b, a
+			}
+			parent[b] = a
+		}
+	}
+
+	sectors := make([]int32, n)
+	ids := make(map[int32]int32)
+	for cell := 0; cell < n; cell++ {
+		if parent[cell] < 0 {
+			continue
+		}
+		root := find(int32(cell))
+		id, ok := ids[root]
+		if !ok {
+			id = int32(len(ids) + 1)
+			ids[root] = id
+		}
+		sectors[cell] = id
+	}
+	return sectors, len(ids)
+}
+
+// containsInt32 returns true if values contains v
+func containsInt32(values []int32, v int32) bool {
+	for _, value := range values {
+		if value == v {
+			return true
+		}
+	}
+	return false
+}
+
+// sectorTable returns the bounds of every sector and the sectors it can be walked to
+func sectorTable(grid *flowGrid, cells []int32, count int) []*pb.Sector {
+	sectors := make([]*pb.Sector, count)
+	neighbors := make([]map[int32]bool, count)
+	for cell, id := range cells {
+		if id == 0 {
+			continue
+		}
+		x, y := cell%grid.width, cell/grid.width
+		minX := grid.min.X + float32(x)*grid.cellSize
+		minY := grid.min.Y + float32(y)*grid.cellSize
+		maxX, maxY := minX+grid.cellSize, minY+grid.cellSize
+
+		sector := sectors[id-1]
+		if sector == nil {
+			sector = &pb.Sector{MinX: minX, MinY: minY, MaxX: maxX, MaxY: maxY}
+			sectors[id-1] = sector
+			neighbors[id-1] = make(map[int32]bool)
+		}
+		sector.MinX = min(sector.MinX, minX)
+		sector.MinY = min(sector.MinY, minY)
+		sector.MaxX = max(sector.MaxX, maxX)
+		sector.MaxY = max(sector.MaxY, maxY)
+
+		for d, offset := range flowNeighbors {
+			if grid.links[cell]&(1<<d) == 0 {
+				continue
+			}
+			if other := cells[(y+offset[1])*grid.width+x+offset[0]]; other != id {
+				neighbors[id-1][other] = true
+			}
+		}
+	}
+
+	for i, sector := range sectors {
+		for other := range neighbors[i] {
+			sector.Neighbors = append(sector.Neighbors, other)
+		}
+		sort.Slice(sector.Neighbors, func(a, b int) bool { return sector.Neighbors[a] < sector.Neighbors[b] })
+	}
+	return sectors
+}
+
+// buildSectorTree builds the kd-tree that returns the sector of the cells [x0, x1) x [y0, y1)
+// Cells that are not free can be answered with any sector, so regions only split while they
+// hold free cells of more than one sector. Each split goes between the columns or rows that
+// leave the fewest sectors on both sides together, the most central one on ties
+func (b *BSPBuilder) buildSectorTree(grid *flowGrid, cells []int32, count, x0, y0, x1, y1 int) int32 {
+	words := (count + 64) / 64
+	set := func() []uint64 { return make([]uint64, words) }
+	add := func(s []uint64, id int32) { s[id/64] |= 1 << (id % 64) }
+	union := func(dst, a, b []uint64) {
+		for i := range dst {
+			dst[i] = a[i] | b[i]
+		}
+	}
+	size := func(s []uint64) int {
+		total := 0
+		for _, w := range s {
+			total += bits.OnesCount64(w)
+		}
+		return total
+	}
+
+	// Sectors per column and per row of the region
+	columns := make([][]uint64, x1-x0)
+	rows := make([][]uint64, y1-y0)
+	all := set()
+	for i := range columns {
+		columns[i] = set()
+	}
+	for i := range rows {
+		rows[i] = set()
+	}
+	for y := y0; y < y1; y++ {
+		for x := x0; x < x1; x++ {
+			if id := cells[y*grid.width+x]; id != 0 {
+				add(columns[x-x0], id)
+				add(rows[y-y0], id)
+				add(all, id)
+			}
+		}
+	}
+
+	if size(all) <= 1 {
+		sector := int32(0)
+		for i, w := range all {
+			if w != 0 {
+				sector = int32(i*64 + bits.TrailingZeros64(w))
+			}
+		}
+		return b.addLeafNode(sector, []int32{}, false)
+	}
+
+	// Best split of one axis: the position k in (0, len(lines)) with the fewest sectors on both sides
+	bestSplit := func(lines [][]uint64) (int, int) {
+		n := len(lines)
+		prefix := make([]int, n+1)
+		acc := set()
+		for i, line := range lines {
+			union(acc, acc, line)
+			prefix[i+1] = size(acc)
+		}
+		best, bestCost := -1, math.MaxInt
+		acc = set()
+		for k := n - 1; k >= 1; k-- {
+			union(acc, acc, lines[k])
+			cost := prefix[k] + size(acc)
+			if cost < bestCost || (cost == bestCost && absInt(2*k-n) < absInt(2*best-n)) {
+				best, bestCost = k, cost
+			}
+		}
+		return best, bestCost
+	}
+
+	kx, costX := bestSplit(columns)
+	ky, costY := bestSplit(rows)
+	if kx >= 0 && (ky < 0 || costX < costY || (costX == costY && x1-x0 >= y1-y0)) {
+		// Front is x > threshold
+		threshold := grid.min.X + float32(x0+kx)*grid.cellSize
+		right := b.buildSectorTree(grid, cells, count, x0+kx, y0, x1, y1)
+		left := b.buildSectorTree(grid, cells, count, x0, y0, x0+kx, y1)
+		return b.addSplitNode(1, 0, threshold, right, left)
+	}
+	// Front is y > threshold
+	threshold := grid.min.Y + float32(y0+ky)*grid.cellSize
+	above := b.buildSectorTree(grid, cells, count, x0, y0+ky, x1, y1)
+	below := b.buildSectorTree(grid, cells, count, x0, y0, x1, y0+ky)
+	return b.addSplitNode(0, 1, threshold, above, below)
+}
+
+// absInt returns the absolute value of v
+func absInt(v int) int {
+	if v < 0 {
+		return -v
+	}
+	return v
+}
+
+// routeEmptyLeaves replaces every empty leaf that world-space queries end in by a copy of the
+// sector tree root, so they continue into the sector lookup
+// Leaves only reached inside prefab subtrees are in local space and stay as they are. The sector
+// tree only has empty leaves, so solidity does not change anywhere, also not for leaves shared
+// between the world and a prefab
+func routeEmptyLeaves(levelData *pb.LevelData, sectorRoot int32) {
+	nodes := levelData.Nodes
+	if levelData.RootIndex < 0 {
+		// No collision at all, the sector tree is the whole tree
+		levelData.RootIndex = sectorRoot
+		return
+	}
+
+	visited := make(map[int32]bool)
+	var leaves []int32
+	stack := []int32{levelData.RootIndex}
+	for len(stack) > 0 {
+		idx := stack[len(stack)-1]
+		stack = stack[:len(stack)-1]
+		if idx < 0 || idx >= sectorRoot || visited[idx] {
+			continue
+		}
+		visited[idx] = true
+		switch n := nodes[idx].Type.(type) {
+		case *pb.BSPNode_Leaf:
+			if !n.Leaf.IsSolid {
+				leaves = append(leaves, idx)
+			}
+		default:
+			stack = append(stack, nodeChildren(nodes[idx])...)
+		}
+	}
+
+	for _, idx := range leaves {
+		nodes[idx] = copyNode(nodes[sectorRoot])
+	}
+}
+
+// nodeChildren returns the nodes a world-space query continues at, instances continue after
+// their prefab
+func nodeChildren(node *pb.BSPNode) []int32 {
+	switch n := node.Type.(type) {
+	case *pb.BSPNode_Split:
+		return []int32{n.Split.FrontIndex, n.Split.BackIndex}
+	case *pb.BSPNode_AxisSplit:
+		return []int32{n.AxisSplit.FrontIndex, n.AxisSplit.BackIndex}
+	case *pb.BSPNode_Instance:
+		return []int32{n.Instance.NextIndex}
+	case *pb.BSPNode_Circle:
+		return []int32{n.Circle.OutsideIndex}
+	}
+	return nil
+}
+
+// copyNode returns a copy of a leaf or split node
+func copyNode(node *pb.BSPNode) *pb.BSPNode {
+	switch n := node.Type.(type) {
+	case *pb.BSPNode_Leaf:
+		leaf := *n.Leaf
+		return &pb.BSPNode{Type: &pb.BSPNode_Leaf{Leaf: &pb.Leaf{SectorId: leaf.SectorId, PolygonIndices: leaf.PolygonIndices, IsSolid: leaf.IsSolid}}}
+	case *pb.BSPNode_AxisSplit:
+		s := n.AxisSplit
+		return &pb.BSPNode{Type: &pb.BSPNode_AxisSplit{AxisSplit: &pb.AxisSplit{
+			Axis: s.Axis, Threshold: s.Threshold, FrontBelow: s.FrontBelow, FrontIndex: s.FrontIndex, BackIndex: s.BackIndex,
+		}}}
+	case *pb.BSPNode_Split:
+		s := n.Split
+		return &pb.BSPNode{Type: &pb.BSPNode_Split{Split: &pb.Split{
+			NormalX: s.NormalX, NormalY: s.NormalY, Distance: s.Distance, FrontIndex: s.FrontIndex, BackIndex: s.BackIndex,
+		}}}
+	}
+	return node
+}
+
+// PointSector returns the sector_id of the empty leaf a point query ends in: the index into the
+// sector table plus one, or 0 for solid points and points outside of all sectors
+func PointSector(nodes []*pb.BSPNode, nodeIndex int32, point Point) int32 {
+	for nodeIndex >= 0 && int(nodeIndex) < len(nodes) {
+		switch n := nodes[nodeIndex].Type.(type) {
+		case *pb.BSPNode_Leaf:
+			if n.Leaf.IsSolid {
+				return 0
+			}
+			return n.Leaf.SectorId
+		case *pb.BSPNode_Split:
+			line := Line{Normal: Vector2{X: n.Split.NormalX, Y: n.Split.NormalY}, Distance: n.Split.Distance}
+			if line.PointSide(point) > 0 {
+				nodeIndex = n.Split.FrontIndex
+			} else {
+				nodeIndex = n.Split.BackIndex
+			}
+		case *pb.BSPNode_AxisSplit:
+			if axisSplitSide(n.AxisSplit, point) > 0 {
+				nodeIndex = n.AxisSplit.FrontIndex
+			} else {
+				nodeIndex = n.AxisSplit.BackIndex
+			}
+		case *pb.BSPNode_Instance:
+			if PointInBSP(nodes, n.Instance.SubtreeIndex, instanceTransform(n.Instance).Apply(point)) {
+				return 0
+			}
+			nodeIndex = n.Instance.NextIndex
+		case *pb.BSPNode_Circle:
+			if circleFromNode(n.Circle).Contains(point) {
+				return 0
+			}
+			nodeIndex = n.Circle.OutsideIndex
+		default:
+			return 0
+		}
+	}
+	return 0
+}
@@ -0,0 +1,103 @@
+package bsp
+
+import (
+	"testing"
+)
+
+func TestBuildSectors(t *testing.T) {
+	// Two 10x10 rooms side by side, the wall between them has a door from y = 4.25 to y = 5.75
+	levelData := NewBSPBuilder([]Polygon{
+		{Vertices: []Point{{X: -1, Y: -1}, {X: 22, Y: -1}, {X: 22, Y: 0}, {X: -1, Y: 0}}, IsSolid: true},
+		{Vertices: []Point{{X: -1, Y: 10}, {X: 22, Y: 10}, {X: 22, Y: 11}, {X: -1, Y: 11}}, IsSolid: true},
+		{Vertices: []Point{{X: -1, Y: 0}, {X: 0, Y: 0}, {X: 0, Y: 10}, {X: -1, Y: 10}}, IsSolid: true},
+		{Vertices: []Point{{X: 21, Y: 0}, {X: 22, Y: 0}, {X: 22, Y: 10}, {X: 21, Y: 10}}, IsSolid: true},
+		{Vertices: []Point{{X: 10, Y: 0}, {X: 11, Y: 0}, {X: 11, Y: 4.25}, {X: 10, Y: 4.25}}, IsSolid: true},
+		{Vertices: []Point{{X: 10, Y: 5.75}, {X: 11, Y: 5.75}, {X: 11, Y: 10}, {X: 10, Y: 10}}, IsSolid: true},
+	}).Build()
+
+	probes := []Point{
+		{X: 2, Y: 2}, {X: 5, Y: 5}, {X: 9.5, Y: 9.5}, {X: 10.5, Y: 0.5}, {X: 15, Y: 5}, {X: 20.5, Y: 0.5}, {X: -0.5, Y: 5},
+	}
+	solid := make([]bool, len(probes))
+	for i, p := range probes {
+		solid[i] = PointInBSP(levelData.Nodes, levelData.RootIndex, p)
+	}
+
+	sectors := BuildSectors(levelData, Point{X: -1, Y: -1}, Point{X: 22, Y: 11})
+	if len(sectors) != 2 || len(levelData.Sectors) != 2 {
+		t.Fatalf("Expected two sectors, got %d", len(sectors))
+	}
+
+	t.Run("Solidity does not change", func(t *testing.T) {
+		for i, p := range probes {
+			if got := PointInBSP(levelData.Nodes, levelData.RootIndex, p); got != solid[i] {
+				t.Errorf("Expected solid=%v at (%v, %v), got %v", solid[i], p.X, p.Y, got)
+			}
+		}
+	})
+
+	t.Run("A point query returns the room", func(t *testing.T) {
+		left := PointSector(levelData.Nodes, levelData.RootIndex, Point{X: 5, Y: 5})
+		right := PointSector(levelData.Nodes, levelData.RootIndex, Point{X: 15, Y: 5})
+		if left == 0 || right == 0 || left == right {
+			t.Fatalf("Expected two different sectors, got %d and %d", left, right)
+		}
+		for _, p := range []Point{{X: 0.3, Y: 0.3}, {X: 9.7, Y: 9.7}, {X: 2, Y: 8}} {
+			if got := PointSector(levelData.Nodes, levelData.RootIndex, p); got != left {
+				t.Errorf("Expected sector %d at (%v, %v), got %d", left, p.X, p.Y, got)
+			}
+		}
+		for _, p := range []Point{{X: 11.3, Y: 0.3}, {X: 20.7, Y: 9.7}, {X: 18, Y: 2}} {
+			if got := PointSector(levelData.Nodes, levelData.RootIndex, p); got != right {
+				t.Errorf("Expected sector %d at (%v, %v), got %d", right, p.X, p.Y, got)
+			}
+		}
+		for _, p := range []Point{{X: 10.5, Y: 2}, {X: -0.5, Y: 5}} {
+			if got := PointSector(levelData.Nodes, levelData.RootIndex, p); got != 0 {
+				t.Errorf("Expected no sector in the wall at (%v, %v), got %d", p.X, p.Y, got)
+			}
+		}
+	})
+
+	t.Run("Sector table", func(t *testing.T) {
+		left := sectors[PointSector(levelData.Nodes, levelData.RootIndex, Point{X: 5, Y: 5})-1]
+		if left.MinX != 0 || left.MinY != 0 || left.MaxY != 10 || left.MaxX < 10 || left.MaxX > 11 {
+			t.Errorf("Expected the left room to span (0, 0) to about (10, 10), got (%v, %v) to (%v, %v)",
+				left.MinX, left.MinY, left.MaxX, left.MaxY)
+		}
+		for i, sector := range sectors {
+			other := int32(2 - i)
+			if len(sector.Neighbors) != 1 || sector.Neighbors[0] != other {
+				t.Errorf("Expected sector %d to neighbor sector %d, got %v", i+1, other, sector.Neighbors)
+			}
+		}
+	})
+}
+
+func TestBuildSectorsWide(t *testing.T) {
+	// A room with a pillar and a wide opening to a second room is a single sector
+	levelData := NewBSPBuilder([]Polygon{
+		{Vertices: []Point{{X: 4, Y: 4}, {X: 5, Y: 4}, {X: 5, Y: 5}, {X: 4, Y: 5}}, IsSolid: true},
+		{Vertices: []Point{{X: 10, Y: 0}, {X: 11, Y: 0}, {X: 11, Y: 1}, {X: 10, Y: 1}}, IsSolid: true},
+		{Vertices: []Point{{X: 10, Y: 9}, {X: 11, Y: 9}, {X: 11, Y: 10}, {X: 10, Y: 10}}, IsSolid: true},
+	}).Build()
+	if sectors := BuildSectors(levelData, Point{X: 0, Y: 0}, Point{X: 20, Y: 10}); len(sectors) != 1 {
+		t.Fatalf("Expected one sector, got %d", len(sectors))
+	}
+	if got := PointSector(levelData.Nodes, levelData.RootIndex, Point{X: 15, Y: 5}); got != 1 {
+		t.Errorf("Expected sector 1, got %d", got)
+	}
+	if !PointInBSP(levelData.Nodes, levelData.RootIndex, Point{X: 4.5, Y: 4.5}) {
+		t.Error("Expected the pillar to stay solid")
+	}
+
+	t.Run("Empty level", func(t *testing.T) {
+		levelData := NewBSPBuilder(nil).Build()
+		if sectors := BuildSectors(levelData, Point{X: 0, Y: 0}, Point{X: 4, Y: 4}); len(sectors) != 1 {
+			t.Fatalf("Expected one sector, got %d", len(sectors))
+		}
+		if got := PointSector(levelData.Nodes, levelData.RootIndex, Point{X: 2, Y: 2}); got != 1 {
+			t.Errorf("Expected sector 1, got %d", got)
+		}
+	})
+}
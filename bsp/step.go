@@ -0,0 +1,587 @@
+package bsp
+
+import (
+	"fmt"
+	"math"
+	"slices"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+const (
+	// stepPacketSize is the number of Morton-ordered entities swept through the tree together
+	// Neighbors take the same paths through the upper levels, so a packet visits those nodes once
+	stepPacketSize = 64
+	// stepIterations bounds how often an entity slides along a surface within one step
+	stepIterations = 3
+	// StepSkin is the distance resolved entities keep from collision, in world units, so the next
+	// step does not start on or inside a surface
+	StepSkin = 0.01
+)
+
+// EntityBatch holds the moving entities of one tick as parallel arrays (structure of arrays)
+// All slices must have the same length
+type EntityBatch struct {
+	X, Y    []float32 // Positions, replaced by the resolved positions
+	VX, VY  []float32 // Velocities in units per second, the part into a surface is removed on contact
+	Radius  []float32 // Radii of the entities' discs
+	Contact []bool    // Set if the entity touched collision during the step, cleared otherwise
+}
+
+// Len returns the number of entities in the batch
+func (b EntityBatch) Len() int {
+	return len(b.X)
+}
+
+// EntityStepper resolves the motion of entity batches against the static collision of a level
+// Entities are sorted along a Morton curve and swept in packets of neighbors, each packet
+// traverses the tree once: a node is visited for all entities of the packet that reach it,
+// instead of once per entity. The scratch buffers are kept between steps, so steps do not
+// allocate once the buffers have grown to the batch size
+// Discs are swept by offsetting every plane by the radius, like a line trace with a thickness.
+// That is exact along edges and extends convex corners to their mitered point, so entities stop
+// a little early at sharp corners but never pass through collision
+// A stepper is not safe for concurrent use, use one per goroutine
+type EntityStepper struct {
+	levelData *pb.LevelData
+
+	keys      []uint64        // Morton code << 32 | entity index
+	moveX     []float32       // Remaining motion of the current packet, x
+	moveY     []float32       // Remaining motion of the current packet, y
+	entities  []int32         // Entities of the current packet
+	hits      []sweepHit      // Earliest hit of each packet entity
+	fragments []sweepFragment // Arena of the fragment groups on the traversal path
+	spaces    []sweepSpace    // Prefab spaces on the traversal path, 0 is world space
+
+	// Merged trees are DAGs: a disc reaching both sides of a split reaches the subtrees they share
+	// twice, and again below. The ranges already swept through each shared node are kept, so
+	// every part of a motion passes a shared node once
+	sharedNodes int          // Number of nodes of the tree the index was built for
+	shared      []int32      // Slot of each shared node, -1 for the others
+	swept       []sweptRange // Swept range per slot and packet entity
+	sweep       uint32       // Current sweep, older swept ranges are stale
+	nextSpace   uint32       // Id of the last prefab space entered in this sweep
+}
+
+// sweepFragment is the part [t0, t1] of an entity's motion that reaches a node
+type sweepFragment struct {
+	entity   int32 // Index into the packet
+	radius   float32
+	from, to Point // Motion in the space of the node
+	t0, t1   float32
+	normal   Point // World normal of the surface crossed at t0, zero if the motion starts there
+}
+
+// sweepHit is the earliest contact of an entity's motion
+type sweepHit struct {
+	t      float32
+	normal Point
+}
+
+// sweepSpace is the world-to-local transform of a prefab the traversal is in
+type sweepSpace struct {
+	id           uint32 // Unique per instance visit, 0 is world space
+	worldToLocal Transform2D
+	stretch      float32 // Largest factor a world distance is scaled with in this space
+}
+
+// sweptRange is the part of an entity's motion that has been swept through a shared node
+type sweptRange struct {
+	sweep, space uint32
+	t0, t1       float32
+}
+
+// NewEntityStepper creates a stepper for the collision shipped in the level, BSP tree or BVH
+func NewEntityStepper(levelData *pb.LevelData) *EntityStepper {
+	return &EntityStepper{
+		levelData: levelData,
+		spaces:    []sweepSpace{{worldToLocal: Transform2D{M00: 1, M11: 1}, stretch: 1}},
+	}
+}
+
+// Step moves every entity of the batch by its velocity for dt seconds and resolves the motion
+// against the collision: entities stop StepSkin before a surface and slide along it with the
+// rest of their motion. Entities that start inside collision do not move
+func (s *EntityStepper) Step(batch EntityBatch, dt float32) error {
+	n := batch.Len()
+	if len(batch.Y) != n || len(batch.VX) != n || len(batch.VY) != n || len(batch.Radius) != n || len(batch.Contact) != n {
+		return fmt.Errorf("entity batch arrays differ in length")
+	}
+	if n == 0 {
+		return nil
+	}
+
+	s.sortEntities(batch)
+	for start := 0; start < n; start += stepPacketSize {
+		end := min(start+stepPacketSize, n)
+		s.entities = s.entities[:0]
+		s.moveX = s.moveX[:0]
+		s.moveY = s.moveY[:0]
+		for _, key := range s.keys[start:end] {
+			e := int32(key)
+			s.entities = append(s.entities, e)
+			s.moveX = append(s.moveX, batch.VX[e]*dt)
+			s.moveY = append(s.moveY, batch.VY[e]*dt)
+			batch.Contact[e] = false
+		}
+		s.stepPacket(batch)
+	}
+	return nil
+}
+
+// sortEntities orders the entities along a Morton curve over the bounds of their positions
+func (s *EntityStepper) sortEntities(batch EntityBatch) {
+	boundsMin := Point{X: batch.X[0], Y: batch.Y[0]}
+	boundsMax := boundsMin
+	for i := range batch.X {
+		boundsMin = Point{X: min(boundsMin.X, batch.X[i]), Y: min(boundsMin.Y, batch.Y[i])}
+		boundsMax = Point{X: max(boundsMax.X, batch.X[i]), Y: max(boundsMax.Y, batch.Y[i])}
+	}
+	s.keys = s.keys[:0]
+	for i := range batch.X {
+		code := mortonCode(Point{X: batch.X[i], Y: batch.Y[i]}, boundsMin, boundsMax)
+		s.keys = append(s.keys, uint64(code)<<32|uint64(i))
+	}
+	slices.Sort(s.keys)
+}
+
+// stepPacket resolves the motion of the current packet, one sweep of all moving entities per iteration
+func (s *EntityStepper) stepPacket(batch EntityBatch) {
+	for iteration := 0; iteration < stepIterations; iteration++ {
+		s.fragments = s.fragments[:0]
+		s.hits = s.hits[:0]
+		for i, e := range s.entities {
+			s.hits = append(s.hits, sweepHit{t: math.MaxFloat32})
+			if s.moveX[i] == 0 && s.moveY[i] == 0 {
+				continue
+			}
+			from := Point{X: batch.X[e], Y: batch.Y[e]}
+			s.fragments = append(s.fragments, sweepFragment{
+				entity: int32(i),
+				radius: batch.Radius[e],
+				from:   from,
+				to:     Point{X: from.X + s.moveX[i], Y: from.Y + s.moveY[i]},
+				t1:     1,
+			})
+		}
+		if len(s.fragments) == 0 {
+			return
+		}
+
+		if bvh := s.levelData.CollisionBvh; bvh != nil {
+			if len(bvh.Nodes) > 0 {
+				s.sweepBVH(bvh, 0, 0)
+			}
+		} else {
+			s.indexSharedNodes()
+			s.sweep++
+			s.nextSpace = 0
+			if s.sweep == 0 {
+				clear(s.swept)
+				s.sweep = 1
+			}
+			s.sweepNode(s.levelData.Nodes, s.levelData.RootIndex, 0, 0)
+		}
+
+		for i, e := range s.entities {
+			move := Point{X: s.moveX[i], Y: s.moveY[i]}
+			if move.X == 0 && move.Y == 0 {
+				continue
+			}
+			hit := s.hits[i]
+			if hit.t > 1 {
+				batch.X[e] += move.X
+				batch.Y[e] += move.Y
+				s.moveX[i], s.moveY[i] = 0, 0
+				continue
+			}
+
+			batch.Contact[e] = true
+			if hit.normal == (Point{}) {
+				// Starts inside collision
+				s.moveX[i], s.moveY[i] = 0, 0
+				continue
+			}
+
+			// Stop StepSkin away from the surface, measured along its normal
+			// Contacts are only recorded for surfaces the motion approaches, so this divides by more than 0
+			approach := -(move.X*hit.normal.X + move.Y*hit.normal.Y)
+			t := max(0, hit.t-StepSkin/approach)
+			batch.X[e] += move.X * t
+			batch.Y[e] += move.Y * t
+
+			// Slide along the surface with the rest of the motion and the velocity
+			rest := Point{X: move.X * (1 - t), Y: move.Y * (1 - t)}
+			rest = clipAgainst(rest, hit.normal)
+			s.moveX[i], s.moveY[i] = rest.X, rest.Y
+			v := clipAgainst(Point{X: batch.VX[e], Y: batch.VY[e]}, hit.normal)
+			batch.VX[e], batch.VY[e] = v.X, v.Y
+		}
+	}
+}
+
+// clipAgainst removes the part of v that points into a surface with the given normal
+func clipAgainst(v, normal Point) Point {
+	if d := v.X*normal.X + v.Y*normal.Y; d < 0 {
+		return Point{X: v.X - d*normal.X, Y: v.Y - d*normal.Y}
+	}
+	return v
+}
+
+// record keeps a contact of a fragment if it is the earliest of its entity
+// Surfaces the motion leaves are no contact, a zero normal means the disc starts inside collision
+func (s *EntityStepper) record(f *sweepFragment, t float32, normal Point) {
+	if normal != (Point{}) && s.moveX[f.entity]*normal.X+s.moveY[f.entity]*normal.Y >= 0 {
+		return
+	}
+	if hit := &s.hits[f.entity]; t < hit.t {
+		hit.t = t
+		hit.normal = normal
+	}
+}
+
+// live returns true if a fragment can still produce an earlier contact than the one found
+func (s *EntityStepper) live(f *sweepFragment) bool {
+	return f.t0 < s.hits[f.entity].t
+}
+
+// at returns the point of a fragment's motion at parameter t
+func (f *sweepFragment) at(t float32) Point {
+	return Point{X: f.from.X + t*(f.to.X-f.from.X), Y: f.from.Y + t*(f.to.Y-f.from.Y)}
+}
+
+// indexSharedNodes finds the shared nodes of the tree, again whenever carving changed it
+func (s *EntityStepper) indexSharedNodes() {
+	nodes := s.levelData.Nodes
+	if s.shared != nil && s.sharedNodes == len(nodes) {
+		return
+	}
+	s.sharedNodes = len(nodes)
+	s.shared = make([]int32, len(nodes))
+	for i := range s.shared {
+		s.shared[i] = -1
+	}
+	slots := int32(0)
+	for idx := range sharedQueryNodes(nodes, s.levelData.RootIndex) {
+		if idx >= 0 && int(idx) < len(nodes) {
+			s.shared[idx] = slots
+			slots++
+		}
+	}
+	s.swept = make([]sweptRange, int(slots)*stepPacketSize)
+}
+
+// sweepNode sweeps the fragments from start to the end of the arena through a BSP node
+// The fragments are in the given space; groups for the children are appended behind them
+// and dropped again when the child is done
+func (s *EntityStepper) sweepNode(nodes []*pb.BSPNode, nodeIndex int32, start int, space int) {
+	if nodeIndex < 0 || int(nodeIndex) >= len(nodes) || start == len(s.fragments) {
+		return
+	}
+	slot := s.shared[nodeIndex]
+	if slot < 0 {
+		s.sweepNodeOnce(nodes, nodeIndex, start, space)
+		return
+	}
+
+	// Only the parts of the motions that have not been swept through this node yet
+	end := len(s.fragments)
+	id := s.spaces[space].id
+	for i := start; i < end; i++ {
+		f := s.fragments[i]
+		if !s.live(&f) {
+			continue
+		}
+		swept := &s.swept[int(slot)*stepPacketSize+int(f.entity)]
+		if swept.sweep != s.sweep || swept.space != id || f.t1 < swept.t0 || f.t0 > swept.t1 {
+			*swept = sweptRange{sweep: s.sweep, space: id, t0: f.t0, t1: f.t1}
+		} else {
+			lo, hi := swept.t0, swept.t1
+			swept.t0, swept.t1 = min(lo, f.t0), max(hi, f.t1)
+			switch {
+			case f.t0 >= lo && f.t1 <= hi:
+				continue
+			case f.t0 >= lo:
+				f.t0 = hi
+			case f.t1 <= hi:
+				f.t1 = lo
+			}
+		}
+		s.fragments = append(s.fragments, f)
+	}
+	s.sweepNodeOnce(nodes, nodeIndex, end, space)
+	s.fragments = s.fragments[:end]
+}
+
+// sweepNodeOnce is sweepNode without the shared node check
+func (s *EntityStepper) sweepNodeOnce(nodes []*pb.BSPNode, nodeIndex int32, start int, space int) {
+	if start == len(s.fragments) {
+		return
+	}
+
+	switch n := nodes[nodeIndex].Type.(type) {
+	case *pb.BSPNode_Leaf:
+		if n.Leaf.IsSolid {
+			for i := start; i < len(s.fragments); i++ {
+				f := &s.fragments[i]
+				s.record(f, f.t0, f.normal)
+			}
+		}
+
+	case *pb.BSPNode_Split:
+		split := n.Split
+		s.sweepSplit(nodes, Point{X: split.NormalX, Y: split.NormalY}, split.Distance, split.FrontIndex, split.BackIndex, start, space)
+
+	case *pb.BSPNode_AxisSplit:
+		split := n.AxisSplit
+		normal, distance := Point{X: 1}, split.Threshold
+		if split.Axis == axisY {
+			normal = Point{Y: 1}
+		}
+		if split.FrontBelow {
+			normal, distance = Point{X: -normal.X, Y: -normal.Y}, -distance
+		}
+		s.sweepSplit(nodes, normal, distance, split.FrontIndex, split.BackIndex, start, space)
+
+	case *pb.BSPNode_Instance:
+		// The prefab in its own space, then the rest of the world
+		inst := n.Instance
+		worldToLocal := composeTransforms(instanceTransform(inst), s.spaces[space].worldToLocal)
+		s.nextSpace++
+		s.spaces = append(s.spaces, sweepSpace{id: s.nextSpace, worldToLocal: worldToLocal, stretch: maxStretch(worldToLocal)})
+		local := len(s.spaces) - 1
+		end := len(s.fragments)
+		for i := start; i < end; i++ {
+			f := s.fragments[i]
+			if !s.live(&f) {
+				continue
+			}
+			// Affine maps preserve the motion parameter
+			f.from, f.to = instanceTransform(inst).Apply(f.from), instanceTransform(inst).Apply(f.to)
+			s.fragments = append(s.fragments, f)
+		}
+		s.sweepNode(nodes, inst.SubtreeIndex, end, local)
+		s.fragments = s.fragments[:end]
+		s.spaces = s.spaces[:local]
+		s.sweepNode(nodes, inst.NextIndex, start, space)
+
+	case *pb.BSPNode_Circle:
+		// The disc grown by the radius, exact in world space
+		circle := circleFromNode(n.Circle)
+		stretch := s.spaces[space].stretch
+		for i := start; i < len(s.fragments); i++ {
+			f := &s.fragments[i]
+			if !s.live(f) {
+				continue
+			}
+			grown := Circle{Center: circle.Center, Radius: circle.Radius + f.radius*stretch}
+			if hit, t := traceCircle(grown, f.from, f.to, f.t0, f.t1); hit {
+				p := f.at(t)
+				s.record(f, t, s.worldNormal(space, Point{X: p.X - circle.Center.X, Y: p.Y - circle.Center.Y}))
+			}
+		}
+		s.sweepNode(nodes, n.Circle.OutsideIndex, start, space)
+	}
+}
+
+// sweepSplit sends every fragment to the sides of a split its disc reaches
+// A disc reaches the front where its center is at most the radius behind the plane and the back
+// where it is at most the radius in front of it; the fragment is clipped to those ranges
+func (s *EntityStepper) sweepSplit(nodes []*pb.BSPNode, normal Point, distance float32, frontIndex, backIndex int32, start int, space int) {
+	// The offset is the support of the disc along the normal, in the units of the plane distance
+	w := s.spaces[space].worldToLocal
+	stretch := float32(math.Hypot(float64(w.M00*normal.X+w.M10*normal.Y), float64(w.M01*normal.X+w.M11*normal.Y)))
+
+	// Upper levels mostly see the whole packet on one side, it goes on without being copied
+	end := len(s.fragments)
+	front, back := 0, 0
+	for i := start; i < end; i++ {
+		f := &s.fragments[i]
+		p0, p1 := f.at(f.t0), f.at(f.t1)
+		d0 := normal.X*p0.X + normal.Y*p0.Y - distance
+		d1 := normal.X*p1.X + normal.Y*p1.Y - distance
+		offset := f.radius * stretch
+		if d0 >= -offset || d1 >= -offset {
+			front++
+		}
+		if d0 <= offset || d1 <= offset {
+			back++
+		}
+	}
+	switch {
+	case back == 0:
+		s.sweepNode(nodes, frontIndex, start, space)
+		return
+	case front == 0:
+		s.sweepNode(nodes, backIndex, start, space)
+		return
+	}
+
+	frontNormal := s.worldNormal(space, Point{X: -normal.X, Y: -normal.Y}) // Faced when entering the front
+	backNormal := Point{X: -frontNormal.X, Y: -frontNormal.Y}
+	for _, side := range [2]float32{1, -1} {
+		child, entryNormal := frontIndex, frontNormal
+		if side < 0 {
+			child, entryNormal = backIndex, backNormal
+		}
+		for i := start; i < end; i++ {
+			f := s.fragments[i]
+			if !s.live(&f) {
+				continue
+			}
+			// Distances toward the side: the side is reached where d >= -offset
+			p0, p1 := f.at(f.t0), f.at(f.t1)
+			d0 := side * (normal.X*p0.X + normal.Y*p0.Y - distance)
+			d1 := side * (normal.X*p1.X + normal.Y*p1.Y - distance)
+			offset := f.radius * stretch
+			if d0 < -offset && d1 < -offset {
+				continue
+			}
+			if d0 < -offset {
+				// Enters the side on the way
+				f.t0 += (f.t1 - f.t0) * (-offset - d0) / (d1 - d0)
+				f.normal = entryNormal
+			} else if d1 < -offset {
+				// Leaves the side on the way
+				f.t1 = f.t0 + (f.t1-f.t0)*(-offset-d0)/(d1-d0)
+			}
+			s.fragments = append(s.fragments, f)
+		}
+		s.sweepNode(nodes, child, end, space)
+		s.fragments = s.fragments[:end]
+	}
+}
+
+// sweepBVH sweeps the fragments from start to the end of the arena through a BVH node
+func (s *EntityStepper) sweepBVH(bvh *pb.CollisionBVH, nodeIndex int32, start int) {
+	node := bvh.Nodes[nodeIndex]
+	end := len(s.fragments)
+	for i := start; i < end; i++ {
+		f := s.fragments[i]
+		if !s.live(&f) {
+			continue
+		}
+		grownMin := Point{X: node.MinX - f.radius, Y: node.MinY - f.radius}
+		grownMax := Point{X: node.MaxX + f.radius, Y: node.MaxY + f.radius}
+		d := Point{X: f.to.X - f.from.X, Y: f.to.Y - f.from.Y}
+		if _, ok := segmentRangeInBox(grownMin, grownMax, f.from, d, f.t0, f.t1); ok {
+			s.fragments = append(s.fragments, f)
+		}
+	}
+	if len(s.fragments) == end {
+		return
+	}
+
+	if node.PieceCount > 0 {
+		for _, piece := range bvh.Pieces[node.FirstPiece : node.FirstPiece+node.PieceCount] {
+			for i := end; i < len(s.fragments); i++ {
+				s.sweepPiece(bvh, piece, &s.fragments[i])
+			}
+		}
+	} else {
+		s.sweepBVH(bvh, nodeIndex+1, end)
+		s.sweepBVH(bvh, node.RightIndex, end)
+	}
+	s.fragments = s.fragments[:end]
+}
+
+// sweepPiece records where the disc of a fragment first touches a convex piece
+func (s *EntityStepper) sweepPiece(bvh *pb.CollisionBVH, piece *pb.ConvexPiece, f *sweepFragment) {
+	if !s.live(f) {
+		return
+	}
+	if piece.VertexCount == 0 {
+		worldToLocal := pieceTransform(piece)
+		circle := pieceCircle(piece)
+		grown := Circle{Center: circle.Center, Radius: circle.Radius + f.radius*maxStretch(worldToLocal)}
+		from, to := worldToLocal.Apply(f.from), worldToLocal.Apply(f.to)
+		if hit, t := traceCircle(grown, from, to, f.t0, f.t1); hit {
+			p := Point{X: from.X + t*(to.X-from.X), Y: from.Y + t*(to.Y-from.Y)}
+			normal := Point{X: p.X - circle.Center.X, Y: p.Y - circle.Center.Y}
+			s.record(f, t, transposeApply(worldToLocal, normal))
+		}
+		return
+	}
+
+	// Cyrus-Beck clipping against the edges of the CCW outline, each pushed out by the radius
+	d := Point{X: f.to.X - f.from.X, Y: f.to.Y - f.from.Y}
+	enter, exit := f.t0, f.t1
+	entryNormal := f.normal
+	vertices := bvh.Vertices[2*piece.FirstVertex : 2*(piece.FirstVertex+piece.VertexCount)]
+	n := int(piece.VertexCount)
+	for i := 0; i < n; i++ {
+		j := (i + 1) % n
+		a := Point{X: vertices[2*i], Y: vertices[2*i+1]}
+		b := Point{X: vertices[2*j], Y: vertices[2*j+1]}
+
+		// Outward normal of a CCW edge, inside where normal . (p - a) <= radius * |normal|
+		normal := Point{X: b.Y - a.Y, Y: a.X - b.X}
+		length := float32(math.Hypot(float64(normal.X), float64(normal.Y)))
+		if length == 0 {
+			continue
+		}
+		num := normal.X*(f.from.X-a.X) + normal.Y*(f.from.Y-a.Y) - f.radius*length
+		denom := normal.X*d.X + normal.Y*d.Y
+		if denom == 0 {
+			if num > 0 {
+				return
+			}
+			continue
+		}
+		t := -num / denom
+		if denom < 0 {
+			if t > enter {
+				enter = t
+				entryNormal = Point{X: normal.X / length, Y: normal.Y / length}
+			}
+		} else {
+			exit = min(exit, t)
+		}
+		if enter > exit {
+			return
+		}
+	}
+	s.record(f, enter, entryNormal)
+}
+
+// worldNormal turns a normal of the given space into a unit world normal
+func (s *EntityStepper) worldNormal(space int, normal Point) Point {
+	if space != 0 {
+		normal = transposeApply(s.spaces[space].worldToLocal, normal)
+	}
+	length := float32(math.Hypot(float64(normal.X), float64(normal.Y)))
+	if length == 0 {
+		return Point{}
+	}
+	return Point{X: normal.X / length, Y: normal.Y / length}
+}
+
+// transposeApply maps a local normal to world space with the transposed linear part of a
+// world-to-local transform, normalized
+func transposeApply(t Transform2D, normal Point) Point {
+	world := Point{X: t.M00*normal.X + t.M10*normal.Y, Y: t.M01*normal.X + t.M11*normal.Y}
+	length := float32(math.Hypot(float64(world.X), float64(world.Y)))
+	if length == 0 {
+		return Point{}
+	}
+	return Point{X: world.X / length, Y: world.Y / length}
+}
+
+// composeTransforms returns the transform that applies inner, then outer
+func composeTransforms(outer, inner Transform2D) Transform2D {
+	return Transform2D{
+		M00: outer.M00*inner.M00 + outer.M01*inner.M10, M01: outer.M00*inner.M01 + outer.M01*inner.M11,
+		M10: outer.M10*inner.M00 + outer.M11*inner.M10, M11: outer.M10*inner.M01 + outer.M11*inner.M11,
+		TX: outer.M00*inner.TX + outer.M01*inner.TY + outer.TX,
+		TY: outer.M10*inner.TX + outer.M11*inner.TY + outer.TY,
+	}
+}
+
+// maxStretch returns the largest factor the linear part of a transform scales a length with
+// (its largest singular value)
+func maxStretch(t Transform2D) float32 {
+	a, b, c, d := float64(t.M00), float64(t.M01), float64(t.M10), float64(t.M11)
+	half := (a*a + b*b + c*c + d*d) / 2
+	det := a*d - b*c
+	return float32(math.Sqrt(half + math.Sqrt(max(0, half*half-det*det))))
+}
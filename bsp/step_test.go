@@ -0,0 +1,184 @@
+package bsp
+
+import (
+	"math"
+	"math/rand"
+	"testing"
+	"time"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// newEntityBatch creates a batch of n entities with all arrays allocated
+func newEntityBatch(n int) EntityBatch {
+	return EntityBatch{
+		X: make([]float32, n), Y: make([]float32, n),
+		VX: make([]float32, n), VY: make([]float32, n),
+		Radius:  make([]float32, n),
+		Contact: make([]bool, n),
+	}
+}
+
+// discClear returns true if no point of a disc (sampled on its outline and center) is solid
+func discClear(levelData *pb.LevelData, center Point, radius float32) bool {
+	if PointInLevel(levelData, center) {
+		return false
+	}
+	for i := 0; i < 16; i++ {
+		angle := 2 * math.Pi * float64(i) / 16
+		p := Point{X: center.X + radius*float32(math.Cos(angle)), Y: center.Y + radius*float32(math.Sin(angle))}
+		if PointInLevel(levelData, p) {
+			return false
+		}
+	}
+	return true
+}
+
+func TestEntityStepperWall(t *testing.T) {
+	// A wall from x = 5 to x = 6
+	levelData := NewBSPBuilder([]Polygon{
+		{Vertices: []Point{{X: 5, Y: -10}, {X: 6, Y: -10}, {X: 6, Y: 10}, {X: 5, Y: 10}}, IsSolid: true},
+	}).Build()
+	stepper := NewEntityStepper(levelData)
+
+	batch := newEntityBatch(3)
+	batch.Radius[0], batch.VX[0] = 0.5, 10                 // Into the wall
+	batch.Radius[1], batch.VX[1], batch.VY[1] = 0.5, 10, 2 // Into the wall at an angle
+	batch.Radius[2], batch.Y[2], batch.VY[2] = 0.5, 0, 3   // Along the wall
+	batch.X[2] = 4
+	if err := stepper.Step(batch, 1); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+
+	const tolerance = 1e-3
+	if !batch.Contact[0] || math.Abs(float64(batch.X[0]-(4.5-StepSkin))) > tolerance || batch.Y[0] != 0 || batch.VX[0] != 0 {
+		t.Errorf("Expected to stop at the wall, got (%v, %v) with velocity %v, contact=%v", batch.X[0], batch.Y[0], batch.VX[0], batch.Contact[0])
+	}
+	if !batch.Contact[1] || math.Abs(float64(batch.X[1]-(4.5-StepSkin))) > tolerance || math.Abs(float64(batch.Y[1]-2)) > tolerance {
+		t.Errorf("Expected to slide along the wall to y = 2, got (%v, %v)", batch.X[1], batch.Y[1])
+	}
+	if batch.VX[1] != 0 || batch.VY[1] != 2 {
+		t.Errorf("Expected the velocity into the wall to be removed, got (%v, %v)", batch.VX[1], batch.VY[1])
+	}
+	if batch.Contact[2] || batch.X[2] != 4 || batch.Y[2] != 3 {
+		t.Errorf("Expected to move freely past the wall, got (%v, %v), contact=%v", batch.X[2], batch.Y[2], batch.Contact[2])
+	}
+
+	if err := stepper.Step(EntityBatch{X: []float32{0}}, 1); err == nil {
+		t.Error("Expected an error for arrays of different lengths")
+	}
+}
+
+func TestEntityStepperNeverEntersCollision(t *testing.T) {
+	bspLevel, _, err := bvhTestBuilder().BuildWithinBudget(Budget{})
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	bvhLevel := &pb.LevelData{CollisionBvh: bvhTestBuilder().BuildBVH()}
+
+	for name, levelData := range map[string]*pb.LevelData{"bsp": bspLevel, "bvh": bvhLevel} {
+		t.Run(name, func(t *testing.T) {
+			rng := rand.New(rand.NewSource(11))
+			batch := newEntityBatch(2000)
+			for i := range batch.X {
+				batch.Radius[i] = 0.1 + rng.Float32()*0.4
+				for {
+					batch.X[i], batch.Y[i] = rng.Float32()*56-3, rng.Float32()*18-9
+					if discClear(levelData, Point{X: batch.X[i], Y: batch.Y[i]}, batch.Radius[i]) {
+						break
+					}
+				}
+			}
+
+			stepper := NewEntityStepper(levelData)
+			contacts := 0
+			for tick := 0; tick < 10; tick++ {
+				for i := range batch.X {
+					angle := rng.Float64() * 2 * math.Pi
+					batch.VX[i], batch.VY[i] = float32(math.Cos(angle))*40, float32(math.Sin(angle))*40
+				}
+				if err := stepper.Step(batch, 1.0/20); err != nil {
+					t.Fatalf("Unexpected error: %v", err)
+				}
+				for i := range batch.X {
+					if batch.Contact[i] {
+						contacts++
+					}
+					if !discClear(levelData, Point{X: batch.X[i], Y: batch.Y[i]}, batch.Radius[i]) {
+						t.Fatalf("Entity %d with radius %v entered collision at (%v, %v)", i, batch.Radius[i], batch.X[i], batch.Y[i])
+					}
+				}
+			}
+			if contacts == 0 {
+				t.Error("Expected some entities to run into collision")
+			}
+		})
+	}
+}
+
+func TestEntityStepperBatchMatchesSingle(t *testing.T) {
+	levelData := bvhTestBuilder().Build()
+	rng := rand.New(rand.NewSource(3))
+	batch := newEntityBatch(300)
+	for i := range batch.X {
+		batch.X[i], batch.Y[i] = rng.Float32()*56-3, rng.Float32()*18-9
+		batch.VX[i], batch.VY[i] = rng.Float32()*20-10, rng.Float32()*20-10
+		batch.Radius[i] = rng.Float32() * 0.5
+	}
+
+	// Packets share the traversal, but every entity is resolved on its own
+	stepper := NewEntityStepper(levelData)
+	want := newEntityBatch(len(batch.X))
+	for i := range batch.X {
+		single := newEntityBatch(1)
+		single.X[0], single.Y[0] = batch.X[i], batch.Y[i]
+		single.VX[0], single.VY[0] = batch.VX[i], batch.VY[i]
+		single.Radius[0] = batch.Radius[i]
+		if err := stepper.Step(single, 0.1); err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+		want.X[i], want.Y[i], want.Contact[i] = single.X[0], single.Y[0], single.Contact[0]
+	}
+	if err := stepper.Step(batch, 0.1); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+
+	for i := range batch.X {
+		if batch.X[i] != want.X[i] || batch.Y[i] != want.Y[i] || batch.Contact[i] != want.Contact[i] {
+			t.Errorf("Entity %d: batch resolved (%v, %v) contact=%v, alone (%v, %v) contact=%v",
+				i, batch.X[i], batch.Y[i], batch.Contact[i], want.X[i], want.Y[i], want.Contact[i])
+		}
+	}
+}
+
+func BenchmarkEntityStepper(b *testing.B) {
+	levelData, _, err := bvhTestBuilder().BuildWithinBudget(Budget{})
+	if err != nil {
+		b.Fatal(err)
+	}
+	const entities = 4096
+	rng := rand.New(rand.NewSource(5))
+	batch := newEntityBatch(entities)
+	for i := range batch.X {
+		batch.Radius[i] = 0.3
+		for {
+			batch.X[i], batch.Y[i] = rng.Float32()*56-3, rng.Float32()*18-9
+			if discClear(levelData, Point{X: batch.X[i], Y: batch.Y[i]}, batch.Radius[i]) {
+				break
+			}
+		}
+		batch.VX[i], batch.VY[i] = rng.Float32()*8-4, rng.Float32()*8-4
+	}
+	stepper := NewEntityStepper(levelData)
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if err := stepper.Step(batch, 1.0/60); err != nil {
+			b.Fatal(err)
+		}
+	}
+	b.StopTimer()
+
+	perStep := b.Elapsed() / time.Duration(b.N)
+	b.ReportMetric(float64(perStep.Nanoseconds())/entities, "ns/entity")
+}
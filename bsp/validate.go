@@ -0,0 +1,94 @@
+package bsp
+
+import (
+	"fmt"
+	"sort"
+)
+
+// SliverTolerance is the thickness (in world units) below which outlines and gaps count as slivers
+const SliverTolerance = 0.01
+
+// IssueKind is the kind of a geometry issue, matching CGeometryIssueKind in cgal/partition.h
+type IssueKind int
+
+const (
+	IssueSelfIntersection IssueKind = iota // Two edges of the same outline cross or overlap
+	IssueCrossing                          // Edges of two different outlines properly cross each other
+	IssueSliver                            // Outline, spike or neck thinner than the tolerance
+	IssueDuplicateVertex                   // Same vertex twice in one outline
+)
+
+// String returns a readable name of the issue kind
+func (k IssueKind) String() string {
+	switch k {
+	case IssueSelfIntersection:
+		return "self-intersection"
+	case IssueCrossing:
+		return "crossing"
+	case IssueSliver:
+		return "sliver"
+	case IssueDuplicateVertex:
+		return "duplicate vertex"
+	default:
+		return fmt.Sprintf("issue %d", int(k))
+	}
+}
+
+// GeometryIssue is a problem found in collision outlines
+// Edge i runs from vertex i to vertex i+1, -1 means the outline as a whole
+type GeometryIssue struct {
+	Kind         IssueKind
+	Prefab       string // Prefab the outlines belong to, empty for world polygons
+	Polygon      int
+	Edge         int
+	OtherPolygon int // Second outline involved, -1 if none
+	OtherEdge    int // Second edge involved, -1 if none
+	Location     Point
+}
+
+// String describes the issue with its location
+func (i GeometryIssue) String() string {
+	where := fmt.Sprintf("polygon %d", i.Polygon)
+	if i.Prefab != "" {
+		where = fmt.Sprintf("prefab %s %s", i.Prefab, where)
+	}
+	if i.Edge >= 0 {
+		where += fmt.Sprintf(" edge %d", i.Edge)
+	}
+	if i.OtherPolygon >= 0 && i.OtherPolygon != i.Polygon {
+		where += fmt.Sprintf(" and polygon %d", i.OtherPolygon)
+		if i.OtherEdge >= 0 {
+			where += fmt.Sprintf(" edge %d", i.OtherEdge)
+		}
+	} else if i.OtherEdge >= 0 && i.OtherEdge != i.Edge {
+		where += fmt.Sprintf(" and edge %d", i.OtherEdge)
+	}
+	return fmt.Sprintf("%s: %s at (%.3f, %.3f)", i.Kind, where, i.Location.X, i.Location.Y)
+}
+
+// Validate checks the world polygons and every prefab for self-intersections, crossings,
+// slivers and duplicate vertices, in one pass over all edges per outline set
+// Prefabs are checked in their local space, because their instances may overlap anything
+func (b *BSPBuilder) Validate() ([]GeometryIssue, error) {
+	issues, err := ValidateGeometry(b.Polygons, SliverTolerance)
+	if err != nil {
+		return nil, fmt.Errorf("validating world polygons: %w", err)
+	}
+
+	names := make([]string, 0, len(b.Prefabs))
+	for name := range b.Prefabs {
+		names = append(names, name)
+	}
+	sort.Strings(names)
+	for _, name := range names {
+		prefabIssues, err := ValidateGeometry(b.Prefabs[name], SliverTolerance)
+		if err != nil {
+			return nil, fmt.Errorf("validating prefab %s: %w", name, err)
+		}
+		for _, issue := range prefabIssues {
+			issue.Prefab = name
+			issues = append(issues, issue)
+		}
+	}
+	return issues, nil
+}
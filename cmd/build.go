@@ -1,16 +1,23 @@
 package cmd
 
 import (
+	"cmp"
 	"context"
+	"errors"
 	"fmt"
 	"iter"
 	"os"
 	"path/filepath"
+	"runtime"
+	"runtime/debug"
+	"slices"
 	"strings"
+	"sync"
 	"time"
 
 	"github.com/bloodmagesoftware/venture/bsp"
 	"github.com/bloodmagesoftware/venture/clay"
+	"github.com/bloodmagesoftware/venture/compiler"
 	"github.com/bloodmagesoftware/venture/level"
 	"github.com/bloodmagesoftware/venture/linter"
 	"github.com/bloodmagesoftware/venture/odin"
@@ -26,15 +33,30 @@ import (
 )
 
 var (
-	buildPlatform string
-	buildDebug    bool
-	buildRelease  bool
+	buildPlatform    string
+	buildDebug       bool
+	buildRelease     bool
+	buildBSPMaxNodes int
+	buildBSPMaxDepth int
+	buildBSPCodegen  string
+	buildPackAssets  bool
+	buildStripAssets bool
+	buildConvex      bool
+	buildChunked     bool
+	buildSectors     bool
+	buildRetrainDict bool
+	buildConfigs     []string
+	buildLevelJobs   int
+	buildMemoryMiB   int
 )
 
 var buildCmd = &cobra.Command{
 	Use:   "build",
 	Short: "Build and package the project for distribution",
-	Long:  `Builds the project for the current OS and creates a distribution package (.app on macOS, bundled directory on Linux).`,
+	Long: `Builds the project for the current OS and creates a distribution package (.app on macOS, bundled directory on Linux).
+Several platforms and configurations are built in one run with --platform steam,fallback and --config debug,release.
+Linting, protobuf generation, level conversion and asset selection run once for all of them,
+the Odin compilation and packaging of each variant run concurrently.`,
 	RunE: func(cmd *cobra.Command, args []string) error {
 		projectRoot, err := getProjectRoot()
 		if err != nil {
@@ -53,7 +75,27 @@ var buildCmd = &cobra.Command{
 			return fmt.Errorf("detecting current platform: %w", err)
 		}
 
-		fmt.Printf("Building for current platform: %s, platform: %s\n", target, buildPlatform)
+		variants, err := parseBuildVariants(buildPlatform, buildConfigs, buildDebug, buildRelease)
+		if err != nil {
+			return err
+		}
+		if len(variants) == 1 {
+			fmt.Printf("Building for current platform: %s, platform: %s\n", target, variants[0].Platform)
+		} else {
+			names := make([]string, len(variants))
+			for i, variant := range variants {
+				names[i] = variant.name()
+			}
+			fmt.Printf("Building for current platform: %s, variants: %s\n", target, strings.Join(names, ", "))
+		}
+
+		// Memory is sampled per build stage and per level for the build summary
+		buildMemory := compiler.StartMemorySampler("lint")
+		defer buildMemory.Stop()
+		if buildMemoryMiB > 0 {
+			// The Go collector works toward the same limit the level conversions are throttled to
+			debug.SetMemoryLimit(int64(buildMemoryMiB) << 20)
+		}
 
 		// Lint
 		srcDir := filepath.Join(projectRoot, "src")
@@ -63,6 +105,7 @@ var buildCmd = &cobra.Command{
 		}
 
 		// Placing Level Protobuf
+		buildMemory.Stage("protobuf")
 		levelProtoPath := filepath.Join(projectRoot, "proto", "level.proto")
 		if err := os.WriteFile(levelProtoPath, myproto.LevelProto, 0644); err != nil {
 			return fmt.Errorf("writing level protobuf: %w", err)
@@ -75,12 +118,128 @@ var buildCmd = &cobra.Command{
 			return fmt.Errorf("generating protobuf: %w", err)
 		}
 
-		// Create level building iterator
+		// Query code from an earlier build must not outlive the flag, the Odin compiler would pick it up
+		// The game is Odin, C query code has no build step that would compile and link it
+		if buildBSPCodegen != "" && bsp.CodegenLanguage(buildBSPCodegen) != bsp.CodegenOdin {
+			return fmt.Errorf("--bsp-codegen: unknown language %q (odin)", buildBSPCodegen)
+		}
+		levelQueryDir := filepath.Join(generatedDir, "levels")
+		if err := os.RemoveAll(levelQueryDir); err != nil {
+			return fmt.Errorf("removing %s: %w", levelQueryDir, err)
+		}
+
+		// Convert levels once per distinct set of options, platforms can have different BSP budgets
+		buildMemory.Stage("levels")
 		fmt.Println("Preparing level conversion with 30s timeout per level...")
 		assetsDir := filepath.Join(projectRoot, "assets")
-		levelIterator := buildLevelsIterator(assetsDir)
+		// Without a budget levels convert one at a time: every level's memory adds up, and the
+		// per-level numbers only belong to one level if nothing else converts at the same time
+		levelJobs := buildLevelJobs
+		if levelJobs <= 0 {
+			levelJobs = 1
+			if buildMemoryMiB > 0 {
+				levelJobs = runtime.NumCPU()
+			}
+		}
+		conversion := &levelConversion{jobs: levelJobs}
+		// Reuse the warm level compiler service if it is running
+		levelCompiler, err := compiler.Dial(compiler.SocketPath(projectRoot))
+		if errors.Is(err, compiler.ErrVersionMismatch) {
+			fmt.Printf("Not using the running level compiler service: %v\n", err)
+		}
+		if err == nil {
+			defer levelCompiler.Close()
+			fmt.Println("Using the running level compiler service")
+			if buildMemoryMiB > 0 {
+				fmt.Println("  The memory budget does not apply to the service, it converts levels in its own process")
+			}
+		} else {
+			conversion.budget = compiler.NewMemoryBudget(uint64(buildMemoryMiB) << 20)
+		}
+		levelOptions := func(platformName string) compiler.Options {
+			bspBudget := config.BSPBudgets[platformName]
+			if cmd.Flags().Changed("bsp-max-nodes") {
+				bspBudget.MaxNodes = buildBSPMaxNodes
+			}
+			if cmd.Flags().Changed("bsp-max-depth") {
+				bspBudget.MaxDepth = buildBSPMaxDepth
+			}
+			return compiler.Options{
+				Budget: bsp.Budget{
+					MaxNodes: bspBudget.MaxNodes,
+					MaxDepth: bspBudget.MaxDepth,
+				},
+				ConvexShapes: buildConvex,
+				Chunked:      buildChunked,
+				Sectors:      buildSectors,
+			}
+		}
+		compiledLevels := make(map[compiler.Options][]levelFile)
+		levelDictPath := filepath.Join(projectRoot, packager.LevelDictionaryFile)
+		levelDict, haveLevelDict, err := packager.ReadLevelDictionary(levelDictPath)
+		if err != nil {
+			return err
+		}
+		for _, variant := range variants {
+			options := levelOptions(variant.Platform)
+			if _, ok := compiledLevels[options]; ok {
+				continue
+			}
+			levelIterator := buildLevelsIterator(assetsDir, options, levelCompiler, conversion)
+
+			// Compile the BSP trees of small levels into query functions, before the Odin sources are compiled
+			// The generated sources are shared by all variants, so they need to ship the same levels
+			if buildBSPCodegen != "" {
+				if len(compiledLevels) > 0 {
+					return fmt.Errorf("--bsp-codegen needs the same BSP budget for all platforms")
+				}
+				levelIterator, err = generateLevelQueries(levelIterator, levelQueryDir)
+				if err != nil {
+					return fmt.Errorf("generating level queries: %w", err)
+				}
+			}
+
+			// The dictionary is trained once and checked in, so a level edit only changes that level's bytes
+			if !haveLevelDict || buildRetrainDict {
+				trainingLevels := collectLevels(levelIterator)
+				levelIterator = levelFiles(trainingLevels)
+				levelDict, err = packager.WriteLevelDictionary(levelDictPath, levelIterator)
+				if err != nil {
+					return err
+				}
+				haveLevelDict, buildRetrainDict = true, false
+				if len(levelDict) == 0 {
+					fmt.Println("Not enough levels to train a level dictionary, levels are compressed without one until there are")
+				} else {
+					fmt.Printf("Trained a %d byte level dictionary, check in %s to keep level bytes stable between builds\n", len(levelDict), packager.LevelDictionaryFile)
+				}
+			}
+			compiledLevels[options] = collectLevels(packager.CompressLevels(levelIterator, levelDict))
+		}
+		conversion.printSummary()
+
+		// The game decompresses levels through the generated level_reader package
+		levelReaderDir := filepath.Join(generatedDir, "level_reader")
+		if err := os.MkdirAll(levelReaderDir, 0755); err != nil {
+			return fmt.Errorf("creating %s: %w", levelReaderDir, err)
+		}
+		if err := os.WriteFile(filepath.Join(levelReaderDir, "level_reader.odin"), packager.LevelReaderOdin, 0644); err != nil {
+			return fmt.Errorf("writing level reader: %w", err)
+		}
+
+		// The game reads the asset pack through the generated asset_pack package
+		if buildPackAssets {
+			packReaderDir := filepath.Join(generatedDir, "asset_pack")
+			if err := os.MkdirAll(packReaderDir, 0755); err != nil {
+				return fmt.Errorf("creating %s: %w", packReaderDir, err)
+			}
+			if err := os.WriteFile(filepath.Join(packReaderDir, "asset_pack.odin"), packager.PackReaderOdin, 0644); err != nil {
+				return fmt.Errorf("writing asset pack reader: %w", err)
+			}
+		}
 
 		// Compile Clay
+		buildMemory.Stage("clay and libraries")
 		clayDir := filepath.Join(projectRoot, "vendor", "clay")
 
 		clayObject, err := clay.Compile(clayDir, target)
@@ -89,129 +248,317 @@ var buildCmd = &cobra.Command{
 		}
 		fmt.Printf("Clay object file: %s\n", clayObject)
 
-		// Ensure Steam libraries (if platform is steam)
+		// Ensure Steam libraries (if a variant targets steam)
 		fmt.Println("Checking Steam libraries...")
 		var steamLib *steamworks.LibraryInfo
-		if buildPlatform == "steam" {
-			steamworksDir := filepath.Join(projectRoot, "vendor", "steamworks", "redistributable_bin")
-			steamLib, err = steamworks.EnsureLibraries(target, steamworksDir)
-			if err != nil {
-				return fmt.Errorf("ensuring steam libraries: %w", err)
+		for _, variant := range variants {
+			if variant.Platform == "steam" && steamLib == nil {
+				steamworksDir := filepath.Join(projectRoot, "vendor", "steamworks", "redistributable_bin")
+				steamLib, err = steamworks.EnsureLibraries(target, steamworksDir)
+				if err != nil {
+					return fmt.Errorf("ensuring steam libraries: %w", err)
+				}
 			}
 		}
 
-		// Compile Odin
-		fmt.Println("Starting Odin compilation...")
-		outputName := platform.GetOutputName(target, config.BinaryName)
-		outputPath := filepath.Join(projectRoot, outputName)
-		platformCollectionPath := fmt.Sprintf("src/platforms/%s", buildPlatform)
-
-		compileConfig := odin.CompileConfig{
-			SrcDir:         srcDir,
-			OutputPath:     outputPath,
-			Target:         target,
-			Platform:       buildPlatform,
-			Debug:          buildDebug,
-			Release:        buildRelease,
-			CollectionPath: platformCollectionPath,
+		// Ship only the textures that levels reference or the keep-list names
+		var assetSelection *packager.AssetSelection
+		if buildStripAssets {
+			references, err := collectTextureReferences(assetsDir)
+			if err != nil {
+				return fmt.Errorf("collecting texture references: %w", err)
+			}
+			assetSelection, err = packager.NewAssetSelection(references, config.KeepAssets)
+			if err != nil {
+				return fmt.Errorf("keep_assets in venture.yaml: %w", err)
+			}
 		}
 
-		if err := odin.Compile(compileConfig); err != nil {
-			return fmt.Errorf("compiling odin: %w", err)
+		// Fetch the libraries once, the variants share the cache
+		libraryVersions := packager.LibraryVersions{
+			SDL:      config.Libraries.SDL,
+			SDLTTF:   config.Libraries.SDLTTF,
+			SDLImage: config.Libraries.SDLImage,
+		}
+		if err := packager.FetchLibraries(libraryVersions); err != nil {
+			return fmt.Errorf("fetching libraries: %w", err)
 		}
-		fmt.Println("Odin compilation completed successfully")
 
-		// Package for distribution
-		fmt.Println("Starting packaging...")
+		// Compile and package every variant concurrently
+		buildMemory.Stage("compile and package")
 		buildDir := filepath.Join(projectRoot, "build")
+		packagePaths := make([]string, len(variants))
+		errs := make([]error, len(variants))
+		var wg sync.WaitGroup
+		for i, variant := range variants {
+			wg.Add(1)
+			go func() {
+				defer wg.Done()
+
+				// A single build keeps its binary in the project root, variants must not share one
+				outputDir := projectRoot
+				packageVariant := ""
+				if len(variants) > 1 {
+					packageVariant = variant.name()
+					outputDir = filepath.Join(buildDir, "variants", packageVariant)
+					if err := os.MkdirAll(outputDir, 0755); err != nil {
+						errs[i] = fmt.Errorf("%s: creating %s: %w", variant.name(), outputDir, err)
+						return
+					}
+				}
 
-		var libraries []string
-		if buildPlatform == "steam" && steamLib != nil {
-			libraries = append(libraries, steamLib.RuntimeLib)
-		}
+				// Compile Odin
+				fmt.Printf("Starting Odin compilation (%s)...\n", variant.name())
+				outputPath := filepath.Join(outputDir, platform.GetOutputName(target, config.BinaryName))
+				compileConfig := odin.CompileConfig{
+					SrcDir:         srcDir,
+					OutputPath:     outputPath,
+					Target:         target,
+					Platform:       variant.Platform,
+					Debug:          variant.Debug,
+					Release:        variant.Release,
+					CollectionPath: fmt.Sprintf("src/platforms/%s", variant.Platform),
+				}
+				if err := odin.Compile(compileConfig); err != nil {
+					errs[i] = fmt.Errorf("%s: compiling odin: %w", variant.name(), err)
+					return
+				}
+				fmt.Printf("Odin compilation completed successfully (%s)\n", variant.name())
 
-		packageConfig := packager.PackageConfig{
-			ProjectRoot: projectRoot,
-			BinaryPath:  outputPath,
-			BinaryName:  config.BinaryName,
-			AssetsDir:   assetsDir,
-			Libraries:   libraries,
-			LibraryVersions: packager.LibraryVersions{
-				SDL:      config.Libraries.SDL,
-				SDLTTF:   config.Libraries.SDLTTF,
-				SDLImage: config.Libraries.SDLImage,
-			},
-			Target:        target,
-			OutputDir:     buildDir,
-			LevelIterator: levelIterator,
+				// Package for distribution
+				fmt.Printf("Starting packaging (%s)...\n", variant.name())
+				var libraries []string
+				if variant.Platform == "steam" && steamLib != nil {
+					libraries = append(libraries, steamLib.RuntimeLib)
+				}
+				packageConfig := packager.PackageConfig{
+					ProjectRoot:     projectRoot,
+					BinaryPath:      outputPath,
+					BinaryName:      config.BinaryName,
+					AssetsDir:       assetsDir,
+					Libraries:       libraries,
+					LibraryVersions: libraryVersions,
+					Target:          target,
+					Variant:         packageVariant,
+					OutputDir:       buildDir,
+					LevelIterator:   levelFiles(compiledLevels[levelOptions(variant.Platform)]),
+					PackAssets:      buildPackAssets,
+					Assets:          assetSelection,
+				}
+				packagePaths[i], errs[i] = packager.Package(packageConfig)
+				if errs[i] != nil {
+					errs[i] = fmt.Errorf("%s: packaging: %w", variant.name(), errs[i])
+				}
+			}()
+		}
+		wg.Wait()
+		if err := errors.Join(errs...); err != nil {
+			return err
 		}
 
-		packagePath, err := packager.Package(packageConfig)
-		if err != nil {
-			return fmt.Errorf("packaging: %w", err)
+		fmt.Println("\nBuild memory by stage (peak of the build process):")
+		for _, stage := range buildMemory.Stop() {
+			fmt.Printf("  %s: %s Go heap, %s native\n", stage.Stage, formatMiB(stage.GoHeap), formatMiB(stage.Native))
 		}
 
-		fmt.Printf("\n✅ Build complete: %s\n", packagePath)
+		for _, packagePath := range packagePaths {
+			fmt.Printf("\n✅ Build complete: %s\n", packagePath)
+		}
 		return nil
 	},
 }
 
+// buildVariant is one platform and configuration a build packages
+type buildVariant struct {
+	Platform string // steam or fallback
+	Debug    bool
+	Release  bool
+}
+
+// name returns the platform and configuration, like steam-release
+func (v buildVariant) name() string {
+	switch {
+	case v.Debug:
+		return v.Platform + "-debug"
+	case v.Release:
+		return v.Platform + "-release"
+	}
+	return v.Platform
+}
+
+// parseBuildVariants returns every combination of the comma-separated platforms and configurations
+// Without configurations, the --debug and --release flags pick the single configuration
+func parseBuildVariants(platforms string, configs []string, debug, release bool) ([]buildVariant, error) {
+	type configuration struct{ debug, release bool }
+	configurations := []configuration{{debug: debug, release: release && !debug}}
+	if len(configs) > 0 {
+		configurations = configurations[:0]
+		for _, name := range configs {
+			switch strings.TrimSpace(name) {
+			case "debug":
+				configurations = append(configurations, configuration{debug: true})
+			case "release":
+				configurations = append(configurations, configuration{release: true})
+			case "default":
+				configurations = append(configurations, configuration{})
+			default:
+				return nil, fmt.Errorf("unknown configuration %q (debug/release/default)", name)
+			}
+		}
+	}
+
+	var variants []buildVariant
+	seen := make(map[buildVariant]bool)
+	for _, platformName := range strings.Split(platforms, ",") {
+		platformName = strings.TrimSpace(platformName)
+		if platformName != "steam" && platformName != "fallback" {
+			return nil, fmt.Errorf("unknown platform %q (steam/fallback)", platformName)
+		}
+		for _, c := range configurations {
+			variant := buildVariant{Platform: platformName, Debug: c.debug, Release: c.release}
+			if !seen[variant] {
+				seen[variant] = true
+				variants = append(variants, variant)
+			}
+		}
+	}
+	return variants, nil
+}
+
+// levelFile is a compiled level that several variants ship
+type levelFile struct {
+	relPath string
+	data    []byte
+}
+
+// collectLevels runs a level iterator to completion
+func collectLevels(levels iter.Seq2[string, []byte]) []levelFile {
+	var files []levelFile
+	for relPath, data := range levels {
+		files = append(files, levelFile{relPath, data})
+	}
+	return files
+}
+
+// levelFiles returns an iterator over collected levels, which can be iterated any number of times
+func levelFiles(files []levelFile) iter.Seq2[string, []byte] {
+	return func(yield func(string, []byte) bool) {
+		for _, f := range files {
+			if !yield(f.relPath, f.data) {
+				return
+			}
+		}
+	}
+}
+
 func init() {
 	rootCmd.AddCommand(buildCmd)
-	buildCmd.Flags().StringVarP(&buildPlatform, "platform", "p", "fallback", "Platform (steam/fallback)")
+	buildCmd.Flags().StringVarP(&buildPlatform, "platform", "p", "fallback", "Platforms, comma-separated (steam/fallback)")
+	buildCmd.Flags().StringSliceVar(&buildConfigs, "config", nil, "Configurations, comma-separated (debug/release/default), overrides --debug and --release")
 	buildCmd.Flags().BoolVarP(&buildDebug, "debug", "d", false, "Build with debug symbols")
 	buildCmd.Flags().BoolVarP(&buildRelease, "release", "r", false, "Build with optimizations")
+	buildCmd.Flags().IntVar(&buildBSPMaxNodes, "bsp-max-nodes", 0, "Maximum BSP nodes per level, overrides venture.yaml (0 = no limit)")
+	buildCmd.Flags().IntVar(&buildBSPMaxDepth, "bsp-max-depth", 0, "Maximum BSP query depth per level, overrides venture.yaml (0 = no limit)")
+	buildCmd.Flags().StringVar(&buildBSPCodegen, "bsp-codegen", "", "Compile small level BSP trees into Odin point query code (odin)")
+	buildCmd.Flags().BoolVar(&buildPackAssets, "pack-assets", false, "Ship assets and levels as one indexed assets.pak instead of loose files")
+	buildCmd.Flags().BoolVar(&buildChunked, "chunked-levels", false, "Lay levels out in spatial chunks, so level edits only change a few bytes of the build (see venture patch)")
+	buildCmd.Flags().BoolVar(&buildSectors, "sectors", false, "Cluster the empty space of every level into sectors (rooms), so collision point queries also return the room")
+	buildCmd.Flags().BoolVar(&buildRetrainDict, "retrain-level-dictionary", false, "Train the level dictionary ("+packager.LevelDictionaryFile+") again from the current levels, this changes the bytes of every shipped level")
+	buildCmd.Flags().BoolVar(&buildConvex, "convex-shapes", false, "Export the merged convex decomposition of the collision into every level for physics engines")
+	buildCmd.Flags().BoolVar(&buildStripAssets, "strip-assets", false, "Leave out textures that no level references and keep_assets does not list")
+	buildCmd.Flags().IntVar(&buildLevelJobs, "level-jobs", 0, "Levels converted at the same time (0 = 1, or the number of CPUs with --memory-budget)")
+	buildCmd.Flags().IntVar(&buildMemoryMiB, "memory-budget", 0, "Memory budget of the build in MiB, level conversions are throttled to stay below it (0 = no limit)")
 }
 
-// convertLevelToProto converts a YAML level to protobuf format
-func convertLevelToProto(yamlLevel *level.Level) (*pb.LevelData, error) {
-	if yamlLevel == nil {
-		return nil, fmt.Errorf("nil level provided")
-	}
+// levelConversion schedules the level conversions of a build
+type levelConversion struct {
+	jobs   int                    // Levels converted at the same time
+	budget *compiler.MemoryBudget // Throttles the conversions, nil for no limit
 
-	// Convert collision polygons to BSP tree
-	var bspPolygons []bsp.Polygon
-	for _, collision := range yamlLevel.Collisions {
-		vertices := make([]bsp.Point, len(collision.Outline))
-		for i, v := range collision.Outline {
-			vertices[i] = bsp.Point{X: v.X, Y: v.Y}
-		}
-		bspPolygons = append(bspPolygons, bsp.Polygon{
-			Vertices: vertices,
-			IsSolid:  true,
-		})
+	mu      sync.Mutex
+	memory  []levelMemory // Per-level memory, in conversion order
+	running []*levelRun   // Conversions in progress
+}
+
+// levelRun is one level conversion in progress
+type levelRun struct {
+	overlapped bool // Another level converted at the same time, so its memory is in the samples
+}
+
+// levelMemory is the peak memory of the build while a level converted
+type levelMemory struct {
+	relPath    string
+	peak       compiler.StageMemory // Stage with the highest memory
+	overlapped bool
+}
+
+// begin marks the start of a level conversion
+// Conversions that run at the same time are marked as overlapped, memory is sampled process-wide
+func (c *levelConversion) begin() *levelRun {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	run := &levelRun{overlapped: len(c.running) > 0}
+	for _, other := range c.running {
+		other.overlapped = true
 	}
+	c.running = append(c.running, run)
+	return run
+}
 
-	// Build BSP tree
-	builder := bsp.NewBSPBuilder(bspPolygons)
-	bspLevelData := builder.Build()
+// end marks the end of a level conversion
+func (c *levelConversion) end(run *levelRun) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.running = slices.DeleteFunc(c.running, func(other *levelRun) bool { return other == run })
+}
 
-	// Convert ground tiles
-	groundTiles := make([]*pb.Tile, len(yamlLevel.Ground))
-	for i, tile := range yamlLevel.Ground {
-		groundTiles[i] = &pb.Tile{
-			Position: &pb.Vec2I{
-				X: tile.Position.X,
-				Y: tile.Position.Y,
-			},
-			Texture: tile.Texture,
-		}
+// record keeps the memory of a converted level for the build summary
+func (c *levelConversion) record(relPath string, stages []compiler.StageMemory, run *levelRun) {
+	if len(stages) == 0 {
+		return
 	}
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.memory = append(c.memory, levelMemory{relPath: relPath, peak: compiler.PeakStage(stages), overlapped: run.overlapped})
+}
 
-	// Create level data with BSP nodes and ground tiles
-	levelData := &pb.LevelData{
-		Nodes:     bspLevelData.Nodes,
-		RootIndex: bspLevelData.RootIndex,
-		Ground:    groundTiles,
+// printSummary prints the memory of every level, heaviest first
+func (c *levelConversion) printSummary() {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if len(c.memory) == 0 {
+		return
+	}
+	levels := slices.Clone(c.memory)
+	slices.SortStableFunc(levels, func(a, b levelMemory) int {
+		return cmp.Compare(b.peak.Total(), a.peak.Total())
+	})
+	fmt.Println("Level memory (peak of the converting process, heaviest stage):")
+	overlapped := 0
+	for _, lvl := range levels {
+		if lvl.overlapped {
+			overlapped++
+			continue
+		}
+		fmt.Printf("  %s: %s Go heap, %s native (%s)\n", lvl.relPath, formatMiB(lvl.peak.GoHeap), formatMiB(lvl.peak.Native), lvl.peak.Stage)
 	}
+	if overlapped > 0 {
+		fmt.Printf("  %d level(s) converted at the same time as others, their memory cannot be told apart (use --level-jobs 1)\n", overlapped)
+	}
+}
 
-	return levelData, nil
+// formatMiB formats a byte count in MiB
+func formatMiB(bytes uint64) string {
+	return fmt.Sprintf("%.1f MiB", float64(bytes)/(1<<20))
 }
 
 // buildLevelsIterator creates an iterator that yields (relativePath, protoBytes) pairs
-// for each level file, with a 30-second timeout per level conversion.
-// If any level times out, the build fails with an error.
-func buildLevelsIterator(assetsDir string) iter.Seq2[string, []byte] {
+// for each level file compiled with the given options, with a 30-second timeout per level conversion.
+// Up to conversion.jobs levels are converted at the same time, as far as the memory budget admits them;
+// levels are yielded in file order either way. The timeout starts when a level is admitted.
+// Levels are compiled by the level compiler service if levelCompiler is not nil.
+// If any level times out or does not fit the BSP budget, the build fails with an error.
+func buildLevelsIterator(assetsDir string, options compiler.Options, levelCompiler *compiler.Client, conversion *levelConversion) iter.Seq2[string, []byte] {
 	return func(yield func(string, []byte) bool) {
 		levelsDir := filepath.Join(assetsDir, "levels")
 
@@ -232,76 +579,214 @@ func buildLevelsIterator(assetsDir string) iter.Seq2[string, []byte] {
 			return
 		}
 
-		// Process each level with timeout
-		for _, yamlPath := range matches {
-			// Create context with 30-second timeout
-			ctx, cancel := context.WithTimeout(context.Background(), 30*time.Second)
-
-			// Channel to receive the result
-			type result struct {
-				relPath string
-				bytes   []byte
-				err     error
-			}
-			resultChan := make(chan result, 1)
-
-			// Run conversion in goroutine
-			go func() {
-				defer cancel()
-
-				// Load the YAML level
-				lvl := level.New()
-				if err := lvl.Load(yamlPath); err != nil {
-					resultChan <- result{err: fmt.Errorf("loading level %s: %w", yamlPath, err)}
-					return
-				}
-
-				// Convert to protobuf
-				protoLevel, err := convertLevelToProto(lvl)
-				if err != nil {
-					resultChan <- result{err: fmt.Errorf("converting level %s to protobuf: %w", yamlPath, err)}
-					return
-				}
+		type result struct {
+			relPath string
+			bytes   []byte
+			report  compiler.Report
+			run     *levelRun
+			err     error
+		}
+		results := make([]chan result, len(matches))
+		for i := range results {
+			results[i] = make(chan result, 1)
+		}
 
-				// Serialize to bytes
-				protoBytes, err := proto.Marshal(protoLevel)
-				if err != nil {
-					resultChan <- result{err: fmt.Errorf("marshaling level %s: %w", yamlPath, err)}
+		// Admit levels in order, each one holds a job slot and its share of the memory budget
+		// Admission ends with the iteration, also when a level timed out and still holds its share
+		admit, stopAdmitting := context.WithCancel(context.Background())
+		defer stopAdmitting()
+		go func() {
+			slots := make(chan struct{}, max(conversion.jobs, 1))
+			for i, yamlPath := range matches {
+				select {
+				case slots <- struct{}{}:
+				case <-admit.Done():
 					return
 				}
-
-				// Get relative path from assets directory and change extension
-				relPath, err := filepath.Rel(assetsDir, yamlPath)
+				release, err := conversion.budget.Acquire(admit)
 				if err != nil {
-					resultChan <- result{err: fmt.Errorf("getting relative path for %s: %w", yamlPath, err)}
 					return
 				}
-				// Change .yaml extension to .pb
-				relPath = strings.TrimSuffix(relPath, ".yaml") + ".pb"
 
-				resultChan <- result{relPath: relPath, bytes: protoBytes, err: nil}
-			}()
+				go func() {
+					defer func() { <-slots }()
+
+					// Create context with 30-second timeout
+					ctx, cancel := context.WithTimeout(context.Background(), 30*time.Second)
+					defer cancel()
+
+					// Run conversion in goroutine, it releases its memory share when it is done
+					resultChan := make(chan result, 1)
+					go func() {
+						run := conversion.begin()
+						protoBytes, report, err := compileLevelFile(yamlPath, options, levelCompiler)
+						conversion.end(run)
+						release(report.Memory)
+						if err != nil {
+							resultChan <- result{report: report, err: err}
+							return
+						}
+
+						// Get relative path from assets directory and change extension
+						relPath, err := filepath.Rel(assetsDir, yamlPath)
+						if err != nil {
+							resultChan <- result{err: fmt.Errorf("getting relative path for %s: %w", yamlPath, err)}
+							return
+						}
+						// Change .yaml extension to .pb
+						relPath = strings.TrimSuffix(relPath, ".yaml") + ".pb"
+
+						resultChan <- result{relPath: relPath, bytes: protoBytes, report: report, run: run}
+					}()
+
+					// Wait for result or timeout
+					select {
+					case <-ctx.Done():
+						results[i] <- result{err: fmt.Errorf("level conversion timed out after 30s: %s", yamlPath)}
+					case res := <-resultChan:
+						results[i] <- res
+					}
+				}()
+			}
+		}()
 
-			// Wait for result or timeout
-			select {
-			case <-ctx.Done():
-				// Timeout occurred
-				fmt.Printf("ERROR: Level conversion timed out after 30s: %s\n", yamlPath)
-				cancel()
+		for i, yamlPath := range matches {
+			res := <-results[i]
+			printLevelReport(res.report)
+			if res.err != nil {
+				fmt.Printf("ERROR: %v\n", res.err)
 				return // Stop iteration, build will fail
-			case res := <-resultChan:
-				cancel()
-				if res.err != nil {
-					fmt.Printf("ERROR: %v\n", res.err)
-					return // Stop iteration, build will fail
-				}
+			}
+			conversion.record(res.relPath, res.report.Memory, res.run)
 
-				// Yield the result
-				fmt.Printf("  Converted: %s -> %s\n", filepath.Base(yamlPath), res.relPath)
-				if !yield(res.relPath, res.bytes) {
-					return // Consumer requested stop
-				}
+			// Yield the result
+			fmt.Printf("  Converted: %s -> %s\n", filepath.Base(yamlPath), res.relPath)
+			if !yield(res.relPath, res.bytes) {
+				return // Consumer requested stop
 			}
 		}
 	}
 }
+
+// collectTextureReferences returns the textures drawn by any level in the assets directory
+func collectTextureReferences(assetsDir string) ([]string, error) {
+	var references []string
+	err := filepath.Walk(filepath.Join(assetsDir, "levels"), func(path string, info os.FileInfo, err error) error {
+		if err != nil {
+			return err
+		}
+		if info.IsDir() || !strings.HasSuffix(path, ".yaml") {
+			return nil
+		}
+		lvl := level.New()
+		if err := lvl.Load(path); err != nil {
+			return fmt.Errorf("loading level %s: %w", path, err)
+		}
+		references = append(references, lvl.TextureReferences()...)
+		return nil
+	})
+	if err != nil && !os.IsNotExist(err) {
+		return nil, err
+	}
+	return references, nil
+}
+
+// compileLevelFile loads a YAML level file and returns the marshaled protobuf level and its report
+func compileLevelFile(yamlPath string, options compiler.Options, levelCompiler *compiler.Client) ([]byte, compiler.Report, error) {
+	var protoBytes []byte
+	var report compiler.Report
+	if levelCompiler != nil {
+		res, err := levelCompiler.CompileLevel(yamlPath, options)
+		if err != nil {
+			return nil, res.Report, fmt.Errorf("converting level %s to protobuf: %w", yamlPath, err)
+		}
+		protoBytes, report = res.Data, res.Report
+	} else {
+		// Load the YAML level
+		lvl := level.New()
+		if err := lvl.Load(yamlPath); err != nil {
+			return nil, report, fmt.Errorf("loading level %s: %w", yamlPath, err)
+		}
+
+		// Convert to protobuf
+		protoLevel, compileReport, err := compiler.CompileLevel(lvl, options, nil)
+		report = compileReport
+		if err != nil {
+			return nil, report, fmt.Errorf("converting level %s to protobuf: %w", yamlPath, err)
+		}
+
+		// Serialize to bytes
+		protoBytes, err = proto.Marshal(protoLevel)
+		if err != nil {
+			return nil, report, fmt.Errorf("marshaling level %s: %w", yamlPath, err)
+		}
+	}
+	return protoBytes, report, nil
+}
+
+// printLevelReport prints the warnings and collision decisions of a converted level
+func printLevelReport(report compiler.Report) {
+	for _, issue := range report.Issues {
+		fmt.Printf("  warning: %s\n", issue)
+	}
+	if report.Budget.Simplified {
+		fmt.Printf("  Simplified collision to fit BSP budget: %d nodes, depth %d, max geometric error %.3f units\n",
+			report.Budget.Nodes, report.Budget.Depth, report.Budget.GeometricError)
+	}
+	if report.Engine.Engine == bsp.EngineBVH {
+		fmt.Printf("  Shipping BVH collision next to the BSP tree: %.1f vs. %.1f operations per query (%d queries)\n",
+			report.Engine.BVHCost, report.Engine.BSPCost, report.Engine.Queries)
+	}
+	if report.Sectors > 0 {
+		fmt.Printf("  Clustered empty space into %d sectors\n", report.Sectors)
+	}
+}
+
+// generateLevelQueries compiles all levels up front and writes the point queries of the levels that
+// ship a small enough BSP tree as Odin source into outputDir (levels.odin in package levels)
+// Returns an iterator over the compiled levels, so they are not compiled twice
+func generateLevelQueries(levels iter.Seq2[string, []byte], outputDir string) (iter.Seq2[string, []byte], error) {
+	type compiledLevel struct {
+		relPath string
+		bytes   []byte
+	}
+	var compiled []compiledLevel
+	var queries []bsp.CodegenLevel
+	for relPath, protoBytes := range levels {
+		compiled = append(compiled, compiledLevel{relPath, protoBytes})
+
+		levelData := &pb.LevelData{}
+		if err := proto.Unmarshal(protoBytes, levelData); err != nil {
+			return nil, fmt.Errorf("unmarshaling level %s: %w", relPath, err)
+		}
+		switch {
+		case len(levelData.Nodes) == 0:
+			fmt.Printf("  Skipping query code for %s: it has no BSP tree\n", relPath)
+		case len(levelData.Nodes) > bsp.MaxCodegenNodes:
+			fmt.Printf("  Skipping query code for %s: %d BSP nodes (limit %d)\n", relPath, len(levelData.Nodes), bsp.MaxCodegenNodes)
+		default:
+			queries = append(queries, bsp.CodegenLevel{Path: filepath.ToSlash(relPath), LevelData: levelData})
+		}
+	}
+
+	source, err := bsp.GenerateQuerySource(bsp.CodegenOdin, "levels", queries)
+	if err != nil {
+		return nil, err
+	}
+	if err := os.MkdirAll(outputDir, 0755); err != nil {
+		return nil, fmt.Errorf("creating %s: %w", outputDir, err)
+	}
+	outputPath := filepath.Join(outputDir, "levels.odin")
+	if err := os.WriteFile(outputPath, []byte(source), 0644); err != nil {
+		return nil, fmt.Errorf("writing %s: %w", outputPath, err)
+	}
+	fmt.Printf("Generated point queries for %d levels: %s\n", len(queries), outputPath)
+
+	return func(yield func(string, []byte) bool) {
+		for _, lvl := range compiled {
+			if !yield(lvl.relPath, lvl.bytes) {
+				return
+			}
+		}
+	}, nil
+}
@@ -0,0 +1,44 @@
+package cmd
+
+import (
+	"context"
+	"fmt"
+	"os"
+	"os/signal"
+	"syscall"
+
+	"github.com/bloodmagesoftware/venture/compiler"
+	"github.com/spf13/cobra"
+)
+
+var compilerCmd = &cobra.Command{
+	Use:   "compiler",
+	Short: "Run the level compiler service",
+	Long: `Runs a long-running level compiler for the project on a Unix socket.
+It keeps parsed levels, convex partitions and built collision trees in memory,
+so repeated builds and collision tests in the level editor are cache hits.
+"venture build" and "venture level" use it automatically while it is running.`,
+	RunE: func(cmd *cobra.Command, args []string) error {
+		projectRoot, err := getProjectRoot()
+		if err != nil {
+			return fmt.Errorf("getting project root: %w", err)
+		}
+
+		socketPath := compiler.SocketPath(projectRoot)
+		listener, err := compiler.Listen(socketPath)
+		if err != nil {
+			return err
+		}
+		defer os.Remove(socketPath)
+
+		ctx, stop := signal.NotifyContext(context.Background(), os.Interrupt, syscall.SIGTERM)
+		defer stop()
+
+		fmt.Printf("Level compiler listening on %s\n", socketPath)
+		return compiler.NewServer().Serve(ctx, listener)
+	},
+}
+
+func init() {
+	rootCmd.AddCommand(compilerCmd)
+}
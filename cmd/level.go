@@ -3,6 +3,7 @@
 package cmd
 
 import (
+	"errors"
 	"image/color"
 	"log"
 	"os"
@@ -12,10 +13,13 @@ import (
 	"gioui.org/io/system"
 	"gioui.org/op"
 	"gioui.org/widget/material"
+	"github.com/bloodmagesoftware/venture/compiler"
 	"github.com/bloodmagesoftware/venture/level"
 	"github.com/spf13/cobra"
 )
 
+var levelRecord string
+
 var levelCmd = &cobra.Command{
 	Use:   "level {level-name}",
 	Short: "Edit the specified level",
@@ -43,10 +47,32 @@ var levelCmd = &cobra.Command{
 			log.Printf("loaded level %s", levelFilePath)
 		}
 
+		var recorder *level.SessionRecorder
+		if levelRecord != "" {
+			recorder, err = level.NewSessionRecorder(levelRecord)
+			if err != nil {
+				return err
+			}
+			log.Printf("recording session to %s", levelRecord)
+		}
+
+		// Build collision test trees in the warm level compiler service if it is running
+		levelCompiler, err := compiler.Dial(compiler.SocketPath(projectRoot))
+		if err == nil {
+			log.Printf("using the running level compiler service")
+		} else if errors.Is(err, compiler.ErrVersionMismatch) {
+			log.Printf("warning: not using the running level compiler service: %v", err)
+		}
+
 		go func() {
 			window := new(app.Window)
 			window.Perform(system.ActionMaximize)
-			err := run(window, levelFilePath, assetsDir, lvl)
+			err := run(window, levelFilePath, assetsDir, lvl, recorder, levelCompiler)
+			if recorder != nil {
+				if closeErr := recorder.Close(); closeErr != nil {
+					log.Printf("warning: %v", closeErr)
+				}
+			}
 			if err != nil {
 				log.Fatal(err)
 			}
@@ -58,18 +84,29 @@ var levelCmd = &cobra.Command{
 	},
 }
 
-func run(window *app.Window, levelFilePath, assetsDir string, lvl *level.Level) error {
-	theme := material.NewTheme()
-
-	// Apply dark mode palette
-	theme.Palette = material.Palette{
-		Bg:         color.NRGBA{R: 30, G: 30, B: 30, A: 255},    // Dark background
-		Fg:         color.NRGBA{R: 220, G: 220, B: 220, A: 255}, // Light text
-		ContrastBg: color.NRGBA{R: 50, G: 50, B: 50, A: 255},    // Slightly lighter background
-		ContrastFg: color.NRGBA{R: 255, G: 255, B: 255, A: 255}, // White text for contrast
-	}
-
+func run(window *app.Window, levelFilePath, assetsDir string, lvl *level.Level, recorder *level.SessionRecorder, levelCompiler *compiler.Client) error {
+	theme := newEditorTheme()
 	editor := level.NewEditor(theme, levelFilePath, assetsDir, lvl)
+	if recorder != nil {
+		editor.RecordSession(recorder)
+	}
+	// The service watches the level file, so changes by other programs are reloaded
+	fileChanged := make(chan struct{}, 1)
+	if levelCompiler != nil {
+		editor.SetCollisionCompiler(levelCompiler)
+		if err := levelCompiler.Watch(levelFilePath); err != nil {
+			log.Printf("warning: watching %s: %v", levelFilePath, err)
+		}
+		go func() {
+			for range levelCompiler.Invalidations() {
+				select {
+				case fileChanged <- struct{}{}:
+				default:
+				}
+				window.Invalidate()
+			}
+		}()
+	}
 
 	// Load assets from the assets directory
 	if err := editor.LoadAssets(); err != nil {
@@ -94,6 +131,14 @@ func run(window *app.Window, levelFilePath, assetsDir string, lvl *level.Level)
 				return nil
 			}
 
+			select {
+			case <-fileChanged:
+				if _, err := editor.ReloadFromDisk(); err != nil {
+					log.Printf("warning: %v", err)
+				}
+			default:
+			}
+
 			// This graphics context is used for managing the rendering state.
 			gtx := app.NewContext(&ops, e)
 
@@ -106,6 +151,22 @@ func run(window *app.Window, levelFilePath, assetsDir string, lvl *level.Level)
 	}
 }
 
+// newEditorTheme creates the dark theme of the level editor
+func newEditorTheme() *material.Theme {
+	theme := material.NewTheme()
+
+	// Apply dark mode palette
+	theme.Palette = material.Palette{
+		Bg:         color.NRGBA{R: 30, G: 30, B: 30, A: 255},    // Dark background
+		Fg:         color.NRGBA{R: 220, G: 220, B: 220, A: 255}, // Light text
+		ContrastBg: color.NRGBA{R: 50, G: 50, B: 50, A: 255},    // Slightly lighter background
+		ContrastFg: color.NRGBA{R: 255, G: 255, B: 255, A: 255}, // White text for contrast
+	}
+
+	return theme
+}
+
 func init() {
+	levelCmd.Flags().StringVar(&levelRecord, "record", "", "Record the editor input to a session file (JSON Lines) for level-bench")
 	rootCmd.AddCommand(levelCmd)
 }
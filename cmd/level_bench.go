@@ -0,0 +1,176 @@
+//go:build !cli
+
+package cmd
+
+import (
+	"fmt"
+	"io/fs"
+	"os"
+	"path/filepath"
+	"sort"
+	"strings"
+	"time"
+
+	"github.com/bloodmagesoftware/venture/level"
+	"github.com/spf13/cobra"
+)
+
+var (
+	levelBenchLevel    string
+	levelBenchTiles    int
+	levelBenchPolygons int
+	levelBenchSeed     int64
+	levelBenchRepeat   int
+	levelBenchGenerate string
+)
+
+var levelBenchCmd = &cobra.Command{
+	Use:   "level-bench [session-file]",
+	Short: "Replay a recorded editor session as a benchmark",
+	Long: `Replays a session recorded with "venture level --record" against the level editor without opening a window
+and reports frame times. A frame covers input handling and laying out the canvas, not GPU rendering.
+
+A session has to be replayed against the level it was recorded on (--level).
+Without --level, a generated level is used (--tiles, --polygons, --seed).
+To record a session on a large level, write a generated level with --generate {level-name} first
+and open it with "venture level {level-name} --record session.jsonl".`,
+	RunE: func(cmd *cobra.Command, args []string) error {
+		projectRoot, err := getProjectRoot()
+		if err != nil {
+			return err
+		}
+		assetsDir := filepath.Join(projectRoot, "assets")
+
+		if levelBenchGenerate != "" {
+			textures, err := benchTextures(assetsDir)
+			if err != nil {
+				return err
+			}
+			levelFilePath := filepath.Join(assetsDir, "levels", levelBenchGenerate+".yaml")
+			lvl := level.GenerateLevel(levelBenchTiles, levelBenchPolygons, textures, levelBenchSeed)
+			if err := lvl.Save(levelFilePath); err != nil {
+				return fmt.Errorf("saving generated level: %w", err)
+			}
+			fmt.Printf("generated %s (%d tiles, %d polygons)\n", levelFilePath, len(lvl.Ground), len(lvl.Collisions))
+			return nil
+		}
+
+		if len(args) != 1 {
+			return cmd.Help()
+		}
+
+		events, err := level.LoadSession(args[0])
+		if err != nil {
+			return err
+		}
+
+		var all level.SessionTimings
+		all.Sections = make(map[string]time.Duration)
+		for range max(levelBenchRepeat, 1) {
+			// Every run starts from the same level, so edits from earlier runs do not pile up
+			lvl, levelFilePath, err := loadBenchLevel(assetsDir)
+			if err != nil {
+				return err
+			}
+
+			editor := level.NewEditor(newEditorTheme(), levelFilePath, assetsDir, lvl)
+			if err := editor.LoadAssets(); err != nil {
+				return fmt.Errorf("loading assets: %w", err)
+			}
+
+			timings := editor.ReplaySession(events)
+			all.Frames = append(all.Frames, timings.Frames...)
+			for name, d := range timings.Sections {
+				all.Sections[name] += d
+			}
+		}
+
+		printSessionTimings(all)
+		return nil
+	},
+}
+
+// loadBenchLevel loads the level selected by the level-bench flags
+// Returns the level and the path it would be saved to (the editor never saves during a replay)
+func loadBenchLevel(assetsDir string) (*level.Level, string, error) {
+	if levelBenchLevel != "" {
+		levelFilePath := filepath.Join(assetsDir, "levels", levelBenchLevel+".yaml")
+		lvl := level.New()
+		if err := lvl.Load(levelFilePath); err != nil {
+			return nil, "", fmt.Errorf("loading level %s: %w", levelFilePath, err)
+		}
+		return lvl, levelFilePath, nil
+	}
+
+	textures, err := benchTextures(assetsDir)
+	if err != nil {
+		return nil, "", err
+	}
+	lvl := level.GenerateLevel(levelBenchTiles, levelBenchPolygons, textures, levelBenchSeed)
+	return lvl, filepath.Join(os.TempDir(), "venture-level-bench.yaml"), nil
+}
+
+// benchTextures lists the QOI textures in the assets directory, relative to it
+func benchTextures(assetsDir string) ([]string, error) {
+	var textures []string
+	err := filepath.WalkDir(assetsDir, func(path string, d fs.DirEntry, err error) error {
+		if err != nil {
+			return err
+		}
+		if d.IsDir() || !strings.HasSuffix(d.Name(), ".qoi") {
+			return nil
+		}
+		relPath, err := filepath.Rel(assetsDir, path)
+		if err != nil {
+			return err
+		}
+		textures = append(textures, relPath)
+		return nil
+	})
+	if err != nil {
+		return nil, fmt.Errorf("listing textures: %w", err)
+	}
+	return textures, nil
+}
+
+// printSessionTimings prints the frame time statistics of a replay
+func printSessionTimings(t level.SessionTimings) {
+	frames := len(t.Frames)
+	if frames == 0 {
+		fmt.Println("session contains no frames")
+		return
+	}
+
+	total := t.Total()
+	var worst time.Duration
+	for _, d := range t.Frames {
+		worst = max(worst, d)
+	}
+
+	fmt.Printf("frames:  %d\n", frames)
+	fmt.Printf("total:   %v\n", total)
+	fmt.Printf("mean:    %v\n", total/time.Duration(frames))
+	fmt.Printf("p50:     %v\n", t.Percentile(50))
+	fmt.Printf("p95:     %v\n", t.Percentile(95))
+	fmt.Printf("max:     %v\n", worst)
+
+	names := make([]string, 0, len(t.Sections))
+	for name := range t.Sections {
+		names = append(names, name)
+	}
+	sort.Strings(names)
+	fmt.Println("mean per frame:")
+	for _, name := range names {
+		fmt.Printf("  %-16s %v\n", name, t.Sections[name]/time.Duration(frames))
+	}
+}
+
+func init() {
+	rootCmd.AddCommand(levelBenchCmd)
+	levelBenchCmd.Flags().StringVar(&levelBenchLevel, "level", "", "Level to replay the session on")
+	levelBenchCmd.Flags().IntVar(&levelBenchTiles, "tiles", 512, "Ground tiles per side of the generated level")
+	levelBenchCmd.Flags().IntVar(&levelBenchPolygons, "polygons", 2000, "Collision polygons of the generated level")
+	levelBenchCmd.Flags().Int64Var(&levelBenchSeed, "seed", 1, "Seed of the generated level")
+	levelBenchCmd.Flags().StringVar(&levelBenchGenerate, "generate", "", "Write a generated level with this name instead of replaying a session")
+	levelBenchCmd.Flags().IntVar(&levelBenchRepeat, "repeat", 1, "Number of times to replay the session")
+}
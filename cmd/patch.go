@@ -0,0 +1,72 @@
+package cmd
+
+import (
+	"fmt"
+	"os"
+
+	"github.com/bloodmagesoftware/venture/patch"
+	"github.com/spf13/cobra"
+)
+
+var patchCmd = &cobra.Command{
+	Use:   "patch",
+	Short: "Create and apply binary patches between two builds",
+	Long: `Creates and applies binary patches between two builds of the project.
+Changed files are shipped as deltas, so a patch is about as large as the edit.
+Build levels with "venture build --chunked-levels" to keep level edits local.`,
+}
+
+var patchCreateCmd = &cobra.Command{
+	Use:   "create <old build> <new build> <patch file>",
+	Short: "Create a patch from an old to a new build (package zips or directories)",
+	Args:  cobra.ExactArgs(3),
+	RunE: func(cmd *cobra.Command, args []string) error {
+		f, err := os.Create(args[2])
+		if err != nil {
+			return fmt.Errorf("creating patch file: %w", err)
+		}
+		stats, err := patch.Create(args[0], args[1], f)
+		if closeErr := f.Close(); err == nil && closeErr != nil {
+			err = fmt.Errorf("writing patch file: %w", closeErr)
+		}
+		if err != nil {
+			os.Remove(args[2])
+			return fmt.Errorf("creating patch: %w", err)
+		}
+
+		info, err := os.Stat(args[2])
+		if err != nil {
+			return err
+		}
+		fmt.Printf("Patch %s: %d changed (%d in place), %d added, %d removed, %d unchanged, %d bytes\n",
+			args[2], stats.Changed, stats.InPlace, stats.Added, stats.Removed, stats.Unchanged, info.Size())
+		return nil
+	},
+}
+
+var patchApplyCmd = &cobra.Command{
+	Use:   "apply <build directory> <patch file>",
+	Short: "Apply a patch to an installed build",
+	Args:  cobra.ExactArgs(2),
+	RunE: func(cmd *cobra.Command, args []string) error {
+		f, err := os.Open(args[1])
+		if err != nil {
+			return fmt.Errorf("opening patch file: %w", err)
+		}
+		defer f.Close()
+
+		stats, err := patch.Apply(args[0], f)
+		if err != nil {
+			return fmt.Errorf("applying patch: %w", err)
+		}
+		fmt.Printf("Patched %s: %d changed (%d in place), %d added, %d removed\n",
+			args[0], stats.Changed, stats.InPlace, stats.Added, stats.Removed)
+		return nil
+	},
+}
+
+func init() {
+	rootCmd.AddCommand(patchCmd)
+	patchCmd.AddCommand(patchCreateCmd)
+	patchCmd.AddCommand(patchApplyCmd)
+}
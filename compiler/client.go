@@ -0,0 +1,181 @@
+package compiler
+
+import (
+	"bufio"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"net"
+	"sync"
+	"time"
+
+	"github.com/bloodmagesoftware/venture/bsp"
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+	"google.golang.org/protobuf/proto"
+)
+
+// dialTimeout keeps clients from hanging on a stale socket
+const dialTimeout = 500 * time.Millisecond
+
+// Client talks to a running compiler service
+// It is safe for concurrent use
+type Client struct {
+	conn net.Conn
+
+	encMu sync.Mutex
+	enc   *json.Encoder
+
+	mu      sync.Mutex
+	nextID  uint64
+	pending map[uint64]chan Response
+	err     error // set once the connection is lost
+
+	invalidations chan string
+}
+
+// Result is a compiled level
+type Result struct {
+	Data   []byte // Marshaled pb.LevelData
+	Report Report
+	Cached bool // true if the service had the level in memory
+}
+
+// Dial connects to the compiler service listening on socketPath
+func Dial(socketPath string) (*Client, error) {
+	conn, err := net.DialTimeout("unix", socketPath, dialTimeout)
+	if err != nil {
+		return nil, fmt.Errorf("connecting to level compiler: %w", err)
+	}
+
+	c := &Client{
+		conn:          conn,
+		enc:           json.NewEncoder(conn),
+		pending:       make(map[uint64]chan Response),
+		invalidations: make(chan string, 16),
+	}
+	go c.readLoop()
+
+	// A service from another build would serve stale compiler output
+	if _, err := c.call(Request{Op: OpHello, Version: ProtocolVersion, Binary: BinaryID()}); err != nil {
+		c.mu.Lock()
+		lost := c.err != nil
+		c.mu.Unlock()
+		c.Close()
+		if lost {
+			return nil, err
+		}
+		return nil, fmt.Errorf("%w: %v", ErrVersionMismatch, err)
+	}
+	return c, nil
+}
+
+// Close closes the connection
+func (c *Client) Close() error {
+	return c.conn.Close()
+}
+
+// Invalidations receives the paths of watched level files that changed on disk
+// The channel is closed when the connection is lost
+func (c *Client) Invalidations() <-chan string {
+	return c.invalidations
+}
+
+// CompileLevel compiles a level file with the given options
+func (c *Client) CompileLevel(path string, options Options) (Result, error) {
+	res, err := c.call(Request{Op: OpCompile, Path: path, Budget: options.Budget, ConvexShapes: options.ConvexShapes, Chunked: options.Chunked, Sectors: options.Sectors})
+	if err != nil {
+		return Result{}, err
+	}
+	return Result{Data: res.Data, Report: res.Report, Cached: res.Cached}, nil
+}
+
+// BuildCollision builds the collision tree of loose polygons and prefab instances
+func (c *Client) BuildCollision(polygons []bsp.Polygon, prefabs map[string][]bsp.Polygon, instances []bsp.Instance) (*pb.LevelData, error) {
+	res, err := c.call(Request{Op: OpCollision, Polygons: polygons, Prefabs: prefabs, Instances: instances})
+	if err != nil {
+		return nil, err
+	}
+	levelData := &pb.LevelData{}
+	if err := proto.Unmarshal(res.Data, levelData); err != nil {
+		return nil, fmt.Errorf("unmarshaling collision: %w", err)
+	}
+	return levelData, nil
+}
+
+// Watch subscribes to changes of a level file, see Invalidations
+func (c *Client) Watch(path string) error {
+	_, err := c.call(Request{Op: OpWatch, Path: path})
+	return err
+}
+
+// call sends a request and waits for its response
+func (c *Client) call(req Request) (Response, error) {
+	ch := make(chan Response, 1)
+
+	c.mu.Lock()
+	if c.err != nil {
+		c.mu.Unlock()
+		return Response{}, c.err
+	}
+	c.nextID++
+	req.ID = c.nextID
+	c.pending[req.ID] = ch
+	c.mu.Unlock()
+
+	c.encMu.Lock()
+	err := c.enc.Encode(req)
+	c.encMu.Unlock()
+	if err != nil {
+		c.mu.Lock()
+		delete(c.pending, req.ID)
+		c.mu.Unlock()
+		return Response{}, fmt.Errorf("sending request to level compiler: %w", err)
+	}
+
+	res, ok := <-ch
+	if !ok {
+		c.mu.Lock()
+		defer c.mu.Unlock()
+		return Response{}, c.err
+	}
+	if res.Error != "" {
+		return Response{}, errors.New(res.Error)
+	}
+	return res, nil
+}
+
+// readLoop dispatches responses to their callers and invalidations to the channel
+func (c *Client) readLoop() {
+	dec := json.NewDecoder(bufio.NewReader(c.conn))
+	for {
+		var res Response
+		if err := dec.Decode(&res); err != nil {
+			c.mu.Lock()
+			c.err = fmt.Errorf("level compiler connection lost: %w", err)
+			for id, ch := range c.pending {
+				close(ch)
+				delete(c.pending, id)
+			}
+			c.mu.Unlock()
+			close(c.invalidations)
+			return
+		}
+
+		if res.ID == 0 {
+			// Drop invalidations nobody reads instead of stalling responses
+			select {
+			case c.invalidations <- res.Invalidated:
+			default:
+			}
+			continue
+		}
+
+		c.mu.Lock()
+		ch, ok := c.pending[res.ID]
+		delete(c.pending, res.ID)
+		c.mu.Unlock()
+		if ok {
+			ch <- res
+		}
+	}
+}
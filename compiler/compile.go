@@ -0,0 +1,183 @@
+// Package compiler converts YAML levels into their runtime protobuf form.
+// It can run in-process or as a long-running service that keeps parsed levels,
+// convex partitions and built trees in memory between builds and editor sessions.
+package compiler
+
+import (
+	"fmt"
+	"sort"
+
+	"github.com/bloodmagesoftware/venture/bsp"
+	"github.com/bloodmagesoftware/venture/level"
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// Report describes the collision of a compiled level
+type Report struct {
+	Budget  bsp.BudgetReport
+	Engine  bsp.EngineReport
+	Issues  []bsp.GeometryIssue // Problems in the collision outlines, reported but not fatal
+	Memory  []StageMemory       // Peak memory of each compile stage, of the compiling process
+	Sectors int                 // Number of sectors the empty space was clustered into, 0 without Options.Sectors
+}
+
+// Options are the settings a level is compiled with
+type Options struct {
+	Budget       bsp.Budget
+	ConvexShapes bool // Export the merged convex decomposition for external physics engines
+	Chunked      bool // Lay the level out in spatial chunks, so edits only change the bytes of the chunks they touch; no baked line of sight or flow fields
+	Sectors      bool // Cluster the empty space into sectors, point queries return the sector of a point
+}
+
+// CompileLevel converts a YAML level to protobuf format
+// The collision BSP tree is fitted into the budget, returning an error if it cannot fit
+// A BVH over the same pieces is built as well, and the faster of both is shipped
+// partitions may be nil; passing a shared cache skips partitioning unchanged outlines
+// The report holds the peak memory of every stage, so heavy levels can be found
+func CompileLevel(yamlLevel *level.Level, options Options, partitions *bsp.PartitionCache) (*pb.LevelData, Report, error) {
+	budget := options.Budget
+	var report Report
+	if yamlLevel == nil {
+		return nil, report, fmt.Errorf("nil level provided")
+	}
+	memory := StartMemorySampler("validate")
+	finish := func() Report {
+		report.Memory = memory.Stop()
+		return report
+	}
+
+	// Convert collision polygons to BSP tree
+	var bspPolygons []bsp.Polygon
+	for _, collision := range yamlLevel.Collisions {
+		vertices := make([]bsp.Point, len(collision.Outline))
+		for i, v := range collision.Outline {
+			vertices[i] = bsp.Point{X: v.X, Y: v.Y}
+		}
+		bspPolygons = append(bspPolygons, bsp.Polygon{
+			Vertices: vertices,
+			IsSolid:  true,
+		})
+	}
+
+	// Build BSP tree, with object collision prefabs as shared instanced subtrees
+	builder := bsp.NewBSPBuilder(bspPolygons)
+	builder.Prefabs, builder.Instances = yamlLevel.CollisionInstances()
+	builder.Partitions = partitions
+	if options.Chunked {
+		builder.ChunkSize = bsp.LayoutChunkSize
+	}
+
+	// Validate all outlines in one sweep, so bad geometry is reported instead of silently dropped
+	issues, err := builder.Validate()
+	if err != nil {
+		return nil, finish(), fmt.Errorf("validating collision geometry: %w", err)
+	}
+	report.Issues = issues
+
+	memory.Stage("bsp")
+	bspLevelData, budgetReport, err := builder.BuildWithinBudget(budget)
+	report.Budget = budgetReport
+	if err != nil {
+		return nil, finish(), fmt.Errorf("fitting collision into BSP budget: %w", err)
+	}
+
+	// Convert ground tiles
+	memory.Stage("tiles and objects")
+	groundTiles := make([]*pb.Tile, len(yamlLevel.Ground))
+	for i, tile := range yamlLevel.Ground {
+		groundTiles[i] = &pb.Tile{
+			Position: &pb.Vec2I{
+				X: tile.Position.X,
+				Y: tile.Position.Y,
+			},
+			Texture: tile.Texture,
+		}
+	}
+	if options.Chunked {
+		// Chunk by chunk, so painting a tile only inserts bytes in its own chunk
+		sortTilesByChunk(groundTiles, level.ObjectChunkSize)
+	}
+
+	// Pre-sort objects into render batches with a culling index
+	objectBatches, objectChunks := yamlLevel.ObjectBatches(level.ObjectChunkSize)
+
+	// Create level data with BSP nodes, ground tiles and object batches
+	levelData := &pb.LevelData{
+		Nodes:           bspLevelData.Nodes,
+		RootIndex:       bspLevelData.RootIndex,
+		Ground:          groundTiles,
+		ObjectBatches:   objectBatches,
+		ObjectChunks:    objectChunks,
+		ObjectChunkSize: level.ObjectChunkSize,
+	}
+
+	// Ship the BVH next to the BSP tree if it answers queries with fewer operations
+	// A simplified BSP tree has different solids than the exact BVH, so it stays,
+	// and so does a chunked one, as the BVH layout changes throughout on every edit,
+	// and one with sectors, as the BVH has no leaves to carry them
+	if !budgetReport.Simplified && !options.Chunked && !options.Sectors {
+		memory.Stage("bvh")
+		report.Engine = bsp.SelectEngine(levelData, builder.BuildBVH(), budget)
+	} else {
+		report.Engine = bsp.EngineReport{Engine: bsp.EngineBSP}
+	}
+
+	if options.ConvexShapes {
+		memory.Stage("convex shapes")
+		levelData.ConvexShapes = builder.ExportConvexShapes()
+	}
+
+	// Line of sight and flow fields are baked over the whole level, so a single wall edit changes
+	// visibility and distances far outside its chunk. Chunked levels leave them out, the game
+	// answers these queries at runtime instead.
+	if !options.Chunked {
+		// Bake line of sight with the shipped engine, so baked answers match runtime traces
+		memory.Stage("line of sight")
+		levelData.LineOfSight = bsp.BakeLineOfSight(levelData, yamlLevel.LineOfSightInput())
+
+		// Bake crowd flow fields toward spawns, portals and flow target markers the same way
+		memory.Stage("flow fields")
+		levelData.FlowFields = bsp.BakeFlowFields(levelData, yamlLevel.FlowFieldInput())
+	}
+
+	// Sectors go last, the lookup deepens the tree for empty points and the bakes do not need it
+	if options.Sectors {
+		memory.Stage("sectors")
+		boundsMin, boundsMax := yamlLevel.SectorBounds()
+		report.Sectors = len(bsp.BuildSectors(levelData, boundsMin, boundsMax))
+	}
+
+	return levelData, finish(), nil
+}
+
+// sortTilesByChunk sorts tiles by chunk, then row and column within the chunk
+func sortTilesByChunk(tiles []*pb.Tile, chunkSize int32) {
+	chunk := func(v int32) int32 {
+		if v < 0 {
+			return (v+1)/chunkSize - 1
+		}
+		return v / chunkSize
+	}
+	sort.SliceStable(tiles, func(i, j int) bool {
+		a, b := tiles[i].Position, tiles[j].Position
+		switch {
+		case chunk(a.Y) != chunk(b.Y):
+			return chunk(a.Y) < chunk(b.Y)
+		case chunk(a.X) != chunk(b.X):
+			return chunk(a.X) < chunk(b.X)
+		case a.Y != b.Y:
+			return a.Y < b.Y
+		default:
+			return a.X < b.X
+		}
+	})
+}
+
+// BuildCollision builds the collision BSP tree of loose polygons and prefab instances, without a budget
+func BuildCollision(polygons []bsp.Polygon, prefabs map[string][]bsp.Polygon, instances []bsp.Instance, partitions *bsp.PartitionCache) *pb.LevelData {
+	builder := bsp.NewBSPBuilder(polygons)
+	builder.Prefabs = prefabs
+	builder.Instances = instances
+	builder.Partitions = partitions
+	return builder.Build()
+}
@@ -0,0 +1,268 @@
+package compiler
+
+import (
+	"context"
+	"encoding/json"
+	"fmt"
+	"net"
+	"path/filepath"
+	"testing"
+	"time"
+
+	"github.com/bloodmagesoftware/venture/bsp"
+	"github.com/bloodmagesoftware/venture/level"
+	"google.golang.org/protobuf/proto"
+)
+
+// startServer runs a server on a socket in a temp directory until the test ends
+func startServer(t *testing.T) *Client {
+	t.Helper()
+	client, err := Dial(serveSocket(t))
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	t.Cleanup(func() { client.Close() })
+	return client
+}
+
+// serveSocket runs a server until the test ends and returns its socket
+func serveSocket(t *testing.T) string {
+	t.Helper()
+	socketPath := filepath.Join(t.TempDir(), "compiler.sock")
+	listener, err := Listen(socketPath)
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+
+	server := NewServer()
+	server.PollInterval = 10 * time.Millisecond
+	ctx, cancel := context.WithCancel(context.Background())
+	done := make(chan error, 1)
+	go func() { done <- server.Serve(ctx, listener) }()
+	t.Cleanup(func() {
+		cancel()
+		if err := <-done; err != nil {
+			t.Errorf("Unexpected serve error: %v", err)
+		}
+	})
+	return socketPath
+}
+
+func TestHandshake(t *testing.T) {
+	socketPath := serveSocket(t)
+	conn, err := net.Dial("unix", socketPath)
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	defer conn.Close()
+	enc, dec := json.NewEncoder(conn), json.NewDecoder(conn)
+	roundTrip := func(req Request) Response {
+		t.Helper()
+		if err := enc.Encode(req); err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+		var res Response
+		if err := dec.Decode(&res); err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+		return res
+	}
+
+	// A client from another build is turned away, and so are requests without a hello
+	if res := roundTrip(Request{ID: 1, Op: OpHello, Version: ProtocolVersion + 1, Binary: BinaryID()}); res.Error == "" {
+		t.Error("Expected an error for another protocol version")
+	}
+	if res := roundTrip(Request{ID: 2, Op: OpHello, Version: ProtocolVersion, Binary: "older"}); res.Error == "" {
+		t.Error("Expected an error for another binary")
+	}
+	if res := roundTrip(Request{ID: 3, Op: OpCollision}); res.Error == "" {
+		t.Error("Expected an error for a request before the hello")
+	}
+	if res := roundTrip(Request{ID: 4, Op: OpHello, Version: ProtocolVersion, Binary: BinaryID()}); res.Error != "" {
+		t.Errorf("Unexpected error: %s", res.Error)
+	}
+	if res := roundTrip(Request{ID: 5, Op: OpCollision}); res.Error != "" {
+		t.Errorf("Unexpected error after the hello: %s", res.Error)
+	}
+}
+
+func TestCompileLevelCached(t *testing.T) {
+	client := startServer(t)
+
+	path := filepath.Join(t.TempDir(), "test.yaml")
+	lvl := level.GenerateLevel(8, 4, []string{"grass.qoi"}, 1)
+	if err := lvl.Save(path); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if err := client.Watch(path); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+
+	first, err := client.CompileLevel(path, Options{})
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if first.Cached || len(first.Data) == 0 {
+		t.Fatalf("Expected a fresh compile, got cached=%v with %d bytes", first.Cached, len(first.Data))
+	}
+	if stages := first.Report.Memory; len(stages) == 0 || stages[0].Stage != "validate" || stages[len(stages)-1].Stage != "flow fields" {
+		t.Errorf("Expected the memory of every compile stage, got %+v", stages)
+	}
+
+	second, err := client.CompileLevel(path, Options{})
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if !second.Cached || string(second.Data) != string(first.Data) {
+		t.Error("Expected the second compile to be a cache hit with the same data")
+	}
+
+	// Other budgets are compiled separately
+	if res, err := client.CompileLevel(path, Options{Budget: bsp.Budget{MaxNodes: 100000}}); err != nil || res.Cached {
+		t.Errorf("Expected a fresh compile for a new budget, got cached=%v, err=%v", res.Cached, err)
+	}
+	if res, err := client.CompileLevel(path, Options{Sectors: true}); err != nil || res.Cached || res.Report.Sectors == 0 {
+		t.Errorf("Expected a fresh compile with sectors, got cached=%v, %d sectors, err=%v", res.Cached, res.Report.Sectors, err)
+	}
+
+	// Changing the file invalidates it
+	lvl.Collisions = lvl.Collisions[:1]
+	if err := lvl.Save(path); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	select {
+	case changed := <-client.Invalidations():
+		if changed != path {
+			t.Errorf("Expected invalidation of %s, got %s", path, changed)
+		}
+	case <-time.After(5 * time.Second):
+		t.Fatal("Expected an invalidation")
+	}
+
+	third, err := client.CompileLevel(path, Options{})
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if third.Cached {
+		t.Error("Expected the changed level to be compiled again")
+	}
+}
+
+func TestBuildCollisionCached(t *testing.T) {
+	client := startServer(t)
+
+	square := bsp.Polygon{
+		Vertices: []bsp.Point{{X: 0, Y: 0}, {X: 1, Y: 0}, {X: 1, Y: 1}, {X: 0, Y: 1}},
+		IsSolid:  true,
+	}
+	levelData, err := client.BuildCollision([]bsp.Polygon{square}, nil, nil)
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if !bsp.PointInBSP(levelData.Nodes, levelData.RootIndex, bsp.Point{X: 0.5, Y: 0.5}) {
+		t.Error("Expected the center of the square to be solid")
+	}
+	if bsp.PointInBSP(levelData.Nodes, levelData.RootIndex, bsp.Point{X: 2, Y: 2}) {
+		t.Error("Expected a point outside the square to be empty")
+	}
+
+	if _, err := client.CompileLevel(filepath.Join(t.TempDir(), "missing.yaml"), Options{}); err == nil {
+		t.Error("Expected an error for a missing level")
+	}
+}
+
+func TestServerLevelsBounded(t *testing.T) {
+	server := NewServer()
+	dir := t.TempDir()
+	lvl := level.GenerateLevel(4, 2, []string{"grass.qoi"}, 1)
+	paths := make([]string, maxUnwatchedLevels+2)
+	for i := range paths {
+		paths[i] = filepath.Join(dir, fmt.Sprintf("level%d.yaml", i))
+		if err := lvl.Save(paths[i]); err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+	}
+
+	// A watched level stays while its watcher is connected, even if it was never compiled
+	c := &serverConn{}
+	if err := server.watch(c, paths[0]); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	for _, path := range paths[1:] {
+		if _, err := server.compile(path, Options{}); err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+	}
+	if len(server.levels) != maxUnwatchedLevels+1 {
+		t.Errorf("Expected the watched level and %d unwatched ones, got %d levels", maxUnwatchedLevels, len(server.levels))
+	}
+	if _, ok := server.levels[paths[0]]; !ok {
+		t.Error("Expected the watched level to stay")
+	}
+	if _, ok := server.levels[paths[1]]; ok {
+		t.Error("Expected the least recently compiled level to be dropped")
+	}
+
+	// The last watcher disconnecting drops the level that was only kept for it
+	server.mu.Lock()
+	delete(server.watchers, c)
+	server.pruneLevels()
+	server.mu.Unlock()
+	if _, ok := server.levels[paths[0]]; ok {
+		t.Error("Expected the level to be dropped with its last watcher")
+	}
+	if len(server.levels) != maxUnwatchedLevels {
+		t.Errorf("Expected %d compiled levels to stay warm, got %d", maxUnwatchedLevels, len(server.levels))
+	}
+}
+
+// changedBytes returns the number of bytes between the first and the last difference of two files
+func changedBytes(before, after []byte) int {
+	prefix := 0
+	for prefix < len(before) && prefix < len(after) && before[prefix] == after[prefix] {
+		prefix++
+	}
+	suffix := 0
+	for suffix < len(before)-prefix && suffix < len(after)-prefix && before[len(before)-1-suffix] == after[len(after)-1-suffix] {
+		suffix++
+	}
+	return max(len(before), len(after)) - prefix - suffix
+}
+
+func TestCompileLevelChunkedEdit(t *testing.T) {
+	lvl := level.GenerateLevel(64, 80, []string{"grass.qoi", "dirt.qoi"}, 3)
+	lvl.Spawns["west"] = level.Spawn{Position: level.Vec2{X: -28, Y: 0}}
+	lvl.Spawns["east"] = level.Spawn{Position: level.Vec2{X: 28, Y: 0}}
+
+	compile := func(options Options) []byte {
+		t.Helper()
+		levelData, _, err := CompileLevel(lvl, options, nil)
+		if err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+		if options.Chunked && (levelData.LineOfSight != nil || levelData.FlowFields != nil) {
+			t.Error("Expected no baked line of sight or flow fields in a chunked level")
+		}
+		data, err := proto.MarshalOptions{Deterministic: true}.Marshal(levelData)
+		if err != nil {
+			t.Fatalf("Unexpected error: %v", err)
+		}
+		return data
+	}
+	chunked, plain := Options{Chunked: true}, Options{}
+	chunkedBefore, plainBefore := compile(chunked), compile(plain)
+
+	// Move one wall by a grid step
+	for i := range lvl.Collisions[0].Outline {
+		lvl.Collisions[0].Outline[i].X += 0.125
+	}
+	chunkedChanged := changedBytes(chunkedBefore, compile(chunked))
+	plainChanged := changedBytes(plainBefore, compile(plain))
+
+	if chunkedChanged == 0 || chunkedChanged > len(chunkedBefore)/8 {
+		t.Errorf("Expected the edit to change a few bytes of the chunked level, changed %d of %d", chunkedChanged, len(chunkedBefore))
+	}
+	if chunkedChanged >= plainChanged {
+		t.Errorf("Expected the chunked level to change less than the plain one, changed %d and %d bytes", chunkedChanged, plainChanged)
+	}
+}
@@ -0,0 +1,227 @@
+package compiler
+
+import (
+	"context"
+	"runtime"
+	"runtime/metrics"
+	"sync"
+	"time"
+)
+
+// memorySampleInterval is how often a running sampler reads the memory of the process
+const memorySampleInterval = 10 * time.Millisecond
+
+// StageMemory is the peak memory of the process while one stage of a build ran
+type StageMemory struct {
+	Stage  string
+	GoHeap uint64 // Peak size of the Go heap objects
+	Native uint64 // Peak resident memory outside the Go runtime (CGAL partitioning, C allocations), 0 if unknown
+}
+
+// Total returns the Go heap and native memory together
+func (m StageMemory) Total() uint64 {
+	return m.GoHeap + m.Native
+}
+
+// PeakStage returns the stage with the highest total memory
+func PeakStage(stages []StageMemory) StageMemory {
+	var peak StageMemory
+	for _, stage := range stages {
+		if stage.Total() >= peak.Total() {
+			peak = stage
+		}
+	}
+	return peak
+}
+
+// MemorySampler records the peak memory of consecutive stages
+// The process is sampled in the background and at every stage boundary, so short stages are
+// measured at least twice. Memory is process-wide: concurrent work shows up in every stage it overlaps
+type MemorySampler struct {
+	mu     sync.Mutex
+	stages []StageMemory
+
+	stop     chan struct{}
+	done     chan struct{}
+	stopOnce sync.Once
+}
+
+// StartMemorySampler starts sampling into a first stage
+func StartMemorySampler(stage string) *MemorySampler {
+	s := &MemorySampler{
+		stop: make(chan struct{}),
+		done: make(chan struct{}),
+	}
+	s.Stage(stage)
+	go func() {
+		defer close(s.done)
+		ticker := time.NewTicker(memorySampleInterval)
+		defer ticker.Stop()
+		for {
+			select {
+			case <-s.stop:
+				return
+			case <-ticker.C:
+				s.sample()
+			}
+		}
+	}()
+	return s
+}
+
+// Stage ends the current stage and starts the next one
+func (s *MemorySampler) Stage(name string) {
+	s.sample()
+	s.mu.Lock()
+	s.stages = append(s.stages, StageMemory{Stage: name})
+	s.mu.Unlock()
+	s.sample()
+}
+
+// Stop ends the last stage and returns all stages in order, it may be called more than once
+func (s *MemorySampler) Stop() []StageMemory {
+	s.stopOnce.Do(func() {
+		close(s.stop)
+		<-s.done
+		s.sample()
+	})
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	return s.stages
+}
+
+// sample raises the peaks of the current stage to the memory in use now
+func (s *MemorySampler) sample() {
+	goHeap, native := SampleMemory()
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if len(s.stages) == 0 {
+		return
+	}
+	current := &s.stages[len(s.stages)-1]
+	current.GoHeap = max(current.GoHeap, goHeap)
+	current.Native = max(current.Native, native)
+}
+
+// memoryMetrics are the runtime metrics SampleMemory reads
+var memoryMetrics = []string{
+	"/memory/classes/heap/objects:bytes",
+	"/memory/classes/total:bytes",
+	"/memory/classes/heap/released:bytes",
+}
+
+// SampleMemory returns the size of the Go heap objects and the resident memory of the process
+// outside the Go runtime
+// Native memory is the resident set minus what the Go runtime holds, 0 where the resident set
+// cannot be read cheaply (see residentMemory)
+func SampleMemory() (goHeap, native uint64) {
+	samples := make([]metrics.Sample, len(memoryMetrics))
+	for i, name := range memoryMetrics {
+		samples[i].Name = name
+	}
+	metrics.Read(samples)
+	value := func(i int) uint64 {
+		if samples[i].Value.Kind() != metrics.KindUint64 {
+			return 0
+		}
+		return samples[i].Value.Uint64()
+	}
+	goHeap = value(0)
+	goRuntime := value(1) - min(value(2), value(1))
+
+	if rss, ok := residentMemory(); ok && rss > goRuntime {
+		native = rss - goRuntime
+	}
+	return goHeap, native
+}
+
+// MemoryBudget throttles concurrent compilations so the process stays below a memory limit
+// A nil budget admits everything
+type MemoryBudget struct {
+	limit uint64
+
+	mu       sync.Mutex
+	cond     *sync.Cond
+	running  int
+	measured bool   // A compilation finished, so estimate is known
+	estimate uint64 // Largest memory growth of a single compilation so far
+}
+
+// NewMemoryBudget creates a budget for the given limit in bytes, nil for 0 (no limit)
+func NewMemoryBudget(limit uint64) *MemoryBudget {
+	if limit == 0 {
+		return nil
+	}
+	b := &MemoryBudget{limit: limit}
+	b.cond = sync.NewCond(&b.mu)
+	return b
+}
+
+// Acquire blocks until another compilation fits the budget and returns the function that
+// releases it, with the stages the compilation measured (nil if it failed)
+// Returns the context's error if it is done first, e.g. because the caller stopped admitting levels
+// A compilation is admitted if the memory in use plus the growth of the admitted one and of
+// every running one, each estimated by the largest growth seen, stays within the limit
+// Until the first compilation finished, they run one at a time. A compilation is always
+// admitted when none is running, so a budget throttles the build but never fails it
+func (b *MemoryBudget) Acquire(ctx context.Context) (release func(stages []StageMemory), err error) {
+	if b == nil {
+		return func([]StageMemory) {}, nil
+	}
+
+	// Waiting on the condition cannot select on the context, so its end wakes all waiters
+	stopWaking := context.AfterFunc(ctx, func() {
+		b.mu.Lock()
+		defer b.mu.Unlock()
+		b.cond.Broadcast()
+	})
+	defer stopWaking()
+
+	b.mu.Lock()
+	collected := false
+	for !b.fits() {
+		if err := ctx.Err(); err != nil {
+			b.mu.Unlock()
+			return nil, err
+		}
+		if !collected {
+			// Garbage of finished compilations still counts as heap until it is collected
+			collected = true
+			b.mu.Unlock()
+			runtime.GC()
+			b.mu.Lock()
+			continue
+		}
+		b.cond.Wait()
+		collected = false
+	}
+	b.running++
+	goHeap, native := SampleMemory()
+	start := goHeap + native
+	b.mu.Unlock()
+
+	return func(stages []StageMemory) {
+		b.mu.Lock()
+		defer b.mu.Unlock()
+		b.running--
+		if len(stages) > 0 {
+			b.measured = true
+		}
+		if peak := PeakStage(stages).Total(); peak > start {
+			b.estimate = max(b.estimate, peak-start)
+		}
+		b.cond.Broadcast()
+	}, nil
+}
+
+// fits returns true if another compilation can start now, b.mu must be held
+func (b *MemoryBudget) fits() bool {
+	if b.running == 0 {
+		return true
+	}
+	if !b.measured {
+		return false
+	}
+	goHeap, native := SampleMemory()
+	return goHeap+native+uint64(b.running+1)*b.estimate <= b.limit
+}
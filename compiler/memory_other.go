@@ -0,0 +1,9 @@
+//go:build !linux
+
+package compiler
+
+// residentMemory is only read on Linux, where build runners get OOM-killed
+// Elsewhere the current resident set needs platform APIs, so native memory reads as 0
+func residentMemory() (uint64, bool) {
+	return 0, false
+}
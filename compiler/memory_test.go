@@ -0,0 +1,112 @@
+package compiler
+
+import (
+	"context"
+	"errors"
+	"testing"
+	"time"
+)
+
+var memorySink []byte
+
+func TestMemorySampler(t *testing.T) {
+	sampler := StartMemorySampler("small")
+	sampler.Stage("large")
+	memorySink = make([]byte, 64<<20)
+	for i := range memorySink {
+		memorySink[i] = byte(i)
+	}
+	sampler.Stage("after")
+	stages := sampler.Stop()
+	memorySink = nil
+
+	if len(stages) != 3 || stages[0].Stage != "small" || stages[1].Stage != "large" || stages[2].Stage != "after" {
+		t.Fatalf("Expected three stages in order, got %+v", stages)
+	}
+	if stages[1].GoHeap < 64<<20 {
+		t.Errorf("Expected the large stage to see the 64 MiB allocation, got %d bytes", stages[1].GoHeap)
+	}
+	if peak := PeakStage(stages); peak.Stage == "small" {
+		t.Errorf("Expected the peak after the allocation, got %+v", peak)
+	}
+}
+
+func TestMemoryBudget(t *testing.T) {
+	ctx := context.Background()
+	if release, err := NewMemoryBudget(0).Acquire(ctx); release == nil || err != nil {
+		t.Fatal("Expected a no limit budget to admit compilations")
+	}
+
+	goHeap, native := SampleMemory()
+	budget := NewMemoryBudget(goHeap + native + 1<<40)
+	release := acquire(t, budget, ctx)
+
+	// The first compilation is measured alone
+	admitted := make(chan func([]StageMemory))
+	go func() { admitted <- acquire(t, budget, ctx) }()
+	select {
+	case <-admitted:
+		t.Fatal("Expected the second compilation to wait for the first one")
+	case <-time.After(50 * time.Millisecond):
+	}
+	release([]StageMemory{{Stage: "bsp", GoHeap: goHeap + 1<<20}})
+	second := <-admitted
+
+	// With a small estimate, the next one fits right away
+	third := make(chan func([]StageMemory))
+	go func() { third <- acquire(t, budget, ctx) }()
+	select {
+	case release := <-third:
+		release(nil)
+	case <-time.After(5 * time.Second):
+		t.Fatal("Expected the third compilation to fit the budget")
+	}
+	second(nil)
+
+	// A budget below the memory in use still runs one compilation at a time
+	tight := NewMemoryBudget(1)
+	acquire(t, tight, ctx)(nil)
+	acquire(t, tight, ctx)(nil)
+}
+
+func TestMemoryBudgetCancel(t *testing.T) {
+	// A compilation that never finishes (a timed out level) keeps its share of the budget
+	budget := NewMemoryBudget(1)
+	acquire(t, budget, context.Background())
+
+	ctx, cancel := context.WithCancel(context.Background())
+	done := make(chan error)
+	go func() {
+		release, err := budget.Acquire(ctx)
+		if release != nil {
+			release(nil)
+		}
+		done <- err
+	}()
+	select {
+	case <-done:
+		t.Fatal("Expected the second compilation to wait for the first one")
+	case <-time.After(50 * time.Millisecond):
+	}
+
+	// Once the caller stops admitting, the waiting compilation gives up
+	cancel()
+	select {
+	case err := <-done:
+		if !errors.Is(err, context.Canceled) {
+			t.Errorf("Expected context.Canceled, got %v", err)
+		}
+	case <-time.After(5 * time.Second):
+		t.Fatal("Expected cancelling to wake the waiting compilation")
+	}
+}
+
+// acquire acquires a share of the budget and fails the test on errors
+func acquire(t *testing.T, budget *MemoryBudget, ctx context.Context) func([]StageMemory) {
+	release, err := budget.Acquire(ctx)
+	if err != nil {
+		t.Errorf("Unexpected error: %v", err)
+		return func([]StageMemory) {}
+	}
+	return release
+}
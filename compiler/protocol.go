@@ -0,0 +1,98 @@
+package compiler
+
+import (
+	"crypto/sha256"
+	"errors"
+	"fmt"
+	"io"
+	"os"
+	"path/filepath"
+	"sync"
+
+	"github.com/bloodmagesoftware/venture/bsp"
+)
+
+// ProtocolVersion is raised whenever requests, responses or the meaning of their fields change
+const ProtocolVersion = 1
+
+// ErrVersionMismatch is returned by Dial if the service speaks another protocol version or runs another venture binary
+var ErrVersionMismatch = errors.New("level compiler service runs a different venture version, restart it")
+
+// Requests and responses are exchanged as JSON, one message per line
+// Every connection starts with a hello, the service answers other requests only after it
+const (
+	// OpHello checks that client and service speak the same protocol and run the same binary
+	OpHello = "hello"
+	// OpCompile compiles a level file into marshaled pb.LevelData
+	OpCompile = "compile"
+	// OpCollision builds the collision tree of polygons sent along with the request
+	OpCollision = "collision"
+	// OpWatch subscribes the connection to invalidations of a level file
+	OpWatch = "watch"
+)
+
+// Request is sent by a client
+type Request struct {
+	ID uint64 `json:"id"`
+	Op string `json:"op"`
+
+	// Versions of the client (hello)
+	Version int    `json:"version,omitempty"`
+	Binary  string `json:"binary,omitempty"`
+
+	// Level file (compile, watch)
+	Path         string     `json:"path,omitempty"`
+	Budget       bsp.Budget `json:"budget"`
+	ConvexShapes bool       `json:"convex_shapes,omitempty"`
+	Chunked      bool       `json:"chunked,omitempty"`
+	Sectors      bool       `json:"sectors,omitempty"`
+
+	// Collision geometry (collision)
+	Polygons  []bsp.Polygon            `json:"polygons,omitempty"`
+	Prefabs   map[string][]bsp.Polygon `json:"prefabs,omitempty"`
+	Instances []bsp.Instance           `json:"instances,omitempty"`
+}
+
+// Response answers the request with the same ID
+// Responses with ID 0 are invalidations pushed to watching connections
+type Response struct {
+	ID     uint64 `json:"id"`
+	Data   []byte `json:"data,omitempty"` // Marshaled pb.LevelData
+	Report Report `json:"report"`
+	Cached bool   `json:"cached,omitempty"` // true if the result came from memory
+	Error  string `json:"error,omitempty"`
+
+	// Invalidated is the level file that changed on disk
+	Invalidated string `json:"invalidated,omitempty"`
+}
+
+// BinaryID identifies the running venture binary by the hash of its executable, so a service
+// started from an older build is not mistaken for the current one even at the same protocol version
+// Empty if the executable cannot be read
+var BinaryID = sync.OnceValue(func() string {
+	path, err := os.Executable()
+	if err != nil {
+		return ""
+	}
+	f, err := os.Open(path)
+	if err != nil {
+		return ""
+	}
+	defer f.Close()
+	h := sha256.New()
+	if _, err := io.Copy(h, f); err != nil {
+		return ""
+	}
+	return fmt.Sprintf("%x", h.Sum(nil))
+})
+
+// SocketPath returns the socket of the compiler service of a project
+// The socket lives in the temp directory, because socket paths are limited to about 100 bytes
+func SocketPath(projectRoot string) string {
+	abs, err := filepath.Abs(projectRoot)
+	if err != nil {
+		abs = projectRoot
+	}
+	sum := sha256.Sum256([]byte(abs))
+	return filepath.Join(os.TempDir(), fmt.Sprintf("venture-compiler-%x.sock", sum[:8]))
+}
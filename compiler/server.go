@@ -0,0 +1,420 @@
+package compiler
+
+import (
+	"bufio"
+	"context"
+	"crypto/sha256"
+	"encoding/json"
+	"fmt"
+	"log"
+	"net"
+	"os"
+	"path/filepath"
+	"sort"
+	"sync"
+	"time"
+
+	"github.com/bloodmagesoftware/venture/bsp"
+	"github.com/bloodmagesoftware/venture/level"
+	"google.golang.org/protobuf/proto"
+)
+
+const (
+	// DefaultPollInterval is how often level files are checked for changes
+	DefaultPollInterval = time.Second
+	// maxCollisionEntries bounds the cache of editor collision builds, which change with every edit
+	maxCollisionEntries = 64
+	// maxUnwatchedLevels bounds the compiled levels kept warm that no connection watches,
+	// watched levels stay until their last watcher disconnects
+	maxUnwatchedLevels = 16
+)
+
+// Server keeps levels warm between compile requests
+type Server struct {
+	PollInterval time.Duration
+
+	partitions *bsp.PartitionCache // shared by all builds
+
+	mu             sync.Mutex
+	levels         map[string]*levelEntry          // absolute level path -> entry
+	levelUses      uint64                          // counts compile requests, for finding the least recently used level
+	collisions     map[[sha256.Size]byte][]byte    // collision request hash -> marshaled tree
+	collisionOrder [][sha256.Size]byte             // insertion order, oldest first
+	watchers       map[*serverConn]map[string]bool // connection -> watched level paths
+}
+
+// levelEntry is a parsed level file and its compiled forms
+type levelEntry struct {
+	modTime  time.Time
+	size     int64
+	level    *level.Level
+	compiled map[Options]compiledLevel
+	lastUse  uint64 // Server.levelUses at the last compile request for this level
+}
+
+// compiledLevel is a level compiled with one set of options
+type compiledLevel struct {
+	data   []byte
+	report Report
+}
+
+// serverConn is a client connection
+// Responses and pushed invalidations share the encoder
+type serverConn struct {
+	mu  sync.Mutex
+	enc *json.Encoder
+
+	greeted bool // The client sent a matching hello
+}
+
+func (c *serverConn) send(res Response) error {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	return c.enc.Encode(res)
+}
+
+// NewServer creates a server with empty caches
+func NewServer() *Server {
+	return &Server{
+		PollInterval: DefaultPollInterval,
+		partitions:   bsp.NewPartitionCache(),
+		levels:       make(map[string]*levelEntry),
+		collisions:   make(map[[sha256.Size]byte][]byte),
+		watchers:     make(map[*serverConn]map[string]bool),
+	}
+}
+
+// Listen creates the Unix socket of the service
+// A socket left behind by a service that is no longer running is replaced
+func Listen(socketPath string) (net.Listener, error) {
+	if conn, err := net.Dial("unix", socketPath); err == nil {
+		conn.Close()
+		return nil, fmt.Errorf("level compiler already running at %s", socketPath)
+	}
+	_ = os.Remove(socketPath)
+
+	listener, err := net.Listen("unix", socketPath)
+	if err != nil {
+		return nil, fmt.Errorf("listening on %s: %w", socketPath, err)
+	}
+	return listener, nil
+}
+
+// Serve handles connections until the context is canceled
+func (s *Server) Serve(ctx context.Context, listener net.Listener) error {
+	go func() {
+		<-ctx.Done()
+		listener.Close()
+	}()
+	go s.pollLevels(ctx)
+
+	for {
+		conn, err := listener.Accept()
+		if err != nil {
+			if ctx.Err() != nil {
+				return nil
+			}
+			return fmt.Errorf("accepting connection: %w", err)
+		}
+		go s.handleConn(conn)
+	}
+}
+
+// handleConn answers the requests of one client, one at a time
+func (s *Server) handleConn(conn net.Conn) {
+	defer conn.Close()
+
+	c := &serverConn{enc: json.NewEncoder(conn)}
+	defer func() {
+		s.mu.Lock()
+		delete(s.watchers, c)
+		s.pruneLevels()
+		s.mu.Unlock()
+	}()
+
+	dec := json.NewDecoder(bufio.NewReader(conn))
+	for {
+		var req Request
+		if err := dec.Decode(&req); err != nil {
+			return
+		}
+
+		res := s.handle(c, req)
+		res.ID = req.ID
+		if err := c.send(res); err != nil {
+			return
+		}
+	}
+}
+
+// handle answers a single request
+func (s *Server) handle(c *serverConn, req Request) Response {
+	var res Response
+	var err error
+	switch {
+	case req.Op == OpHello:
+		err = s.hello(c, req)
+	case !c.greeted:
+		err = fmt.Errorf("expected a hello with protocol version %d first", ProtocolVersion)
+	default:
+		res, err = s.handleOp(c, req)
+	}
+	if err != nil {
+		return Response{Error: err.Error()}
+	}
+	return res
+}
+
+// hello checks the versions of a client
+func (s *Server) hello(c *serverConn, req Request) error {
+	if req.Version != ProtocolVersion {
+		return fmt.Errorf("service speaks protocol version %d, client %d", ProtocolVersion, req.Version)
+	}
+	if req.Binary != BinaryID() {
+		return fmt.Errorf("service runs another venture binary")
+	}
+	c.greeted = true
+	return nil
+}
+
+// handleOp answers a request after the hello
+func (s *Server) handleOp(c *serverConn, req Request) (Response, error) {
+	var res Response
+	var err error
+	switch req.Op {
+	case OpCompile:
+		res, err = s.compile(req.Path, Options{Budget: req.Budget, ConvexShapes: req.ConvexShapes, Chunked: req.Chunked, Sectors: req.Sectors})
+	case OpCollision:
+		res, err = s.collision(req)
+	case OpWatch:
+		err = s.watch(c, req.Path)
+	default:
+		err = fmt.Errorf("unknown operation %q", req.Op)
+	}
+	return res, err
+}
+
+// compile returns the compiled level file, compiling it only if it is not cached
+func (s *Server) compile(path string, options Options) (Response, error) {
+	path, err := filepath.Abs(path)
+	if err != nil {
+		return Response{}, fmt.Errorf("resolving level path: %w", err)
+	}
+	info, err := os.Stat(path)
+	if err != nil {
+		return Response{}, fmt.Errorf("reading level %s: %w", path, err)
+	}
+
+	s.mu.Lock()
+	s.levelUses++
+	entry, ok := s.levels[path]
+	if ok {
+		entry.lastUse = s.levelUses
+	}
+	if ok && (entry.level == nil || !entry.modTime.Equal(info.ModTime()) || entry.size != info.Size()) {
+		// Not parsed yet (only watched) or changed since
+		ok = false
+	}
+	if ok {
+		if compiled, hit := entry.compiled[options]; hit {
+			s.mu.Unlock()
+			return Response{Data: compiled.data, Report: compiled.report, Cached: true}, nil
+		}
+	}
+	s.mu.Unlock()
+
+	var lvl *level.Level
+	if ok {
+		lvl = entry.level
+	} else {
+		lvl = level.New()
+		if err := lvl.Load(path); err != nil {
+			return Response{}, fmt.Errorf("loading level %s: %w", path, err)
+		}
+		entry = &levelEntry{
+			modTime:  info.ModTime(),
+			size:     info.Size(),
+			level:    lvl,
+			compiled: make(map[Options]compiledLevel),
+		}
+	}
+
+	levelData, report, err := CompileLevel(lvl, options, s.partitions)
+	if err != nil {
+		return Response{}, err
+	}
+	data, err := proto.Marshal(levelData)
+	if err != nil {
+		return Response{}, fmt.Errorf("marshaling level %s: %w", path, err)
+	}
+
+	s.mu.Lock()
+	s.levelUses++
+	entry.compiled[options] = compiledLevel{data: data, report: report}
+	entry.lastUse = s.levelUses
+	s.levels[path] = entry
+	s.pruneLevels()
+	s.mu.Unlock()
+
+	return Response{Data: data, Report: report}, nil
+}
+
+// collision returns the collision tree of the request geometry, building it only if it is not cached
+func (s *Server) collision(req Request) (Response, error) {
+	key, err := json.Marshal(struct {
+		Polygons  []bsp.Polygon
+		Prefabs   map[string][]bsp.Polygon
+		Instances []bsp.Instance
+	}{req.Polygons, req.Prefabs, req.Instances})
+	if err != nil {
+		return Response{}, fmt.Errorf("hashing collision geometry: %w", err)
+	}
+	hash := sha256.Sum256(key)
+
+	s.mu.Lock()
+	data, ok := s.collisions[hash]
+	s.mu.Unlock()
+	if ok {
+		return Response{Data: data, Cached: true}, nil
+	}
+
+	levelData := BuildCollision(req.Polygons, req.Prefabs, req.Instances, s.partitions)
+	data, err = proto.Marshal(levelData)
+	if err != nil {
+		return Response{}, fmt.Errorf("marshaling collision: %w", err)
+	}
+
+	s.mu.Lock()
+	if _, ok := s.collisions[hash]; !ok {
+		if len(s.collisionOrder) >= maxCollisionEntries {
+			delete(s.collisions, s.collisionOrder[0])
+			s.collisionOrder = s.collisionOrder[1:]
+		}
+		s.collisions[hash] = data
+		s.collisionOrder = append(s.collisionOrder, hash)
+	}
+	s.mu.Unlock()
+
+	return Response{Data: data}, nil
+}
+
+// watch subscribes a connection to changes of a level file
+func (s *Server) watch(c *serverConn, path string) error {
+	path, err := filepath.Abs(path)
+	if err != nil {
+		return fmt.Errorf("resolving level path: %w", err)
+	}
+
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if s.watchers[c] == nil {
+		s.watchers[c] = make(map[string]bool)
+	}
+	s.watchers[c][path] = true
+
+	// Watched files have to be polled even if they were never compiled
+	if _, ok := s.levels[path]; !ok {
+		entry := &levelEntry{compiled: make(map[Options]compiledLevel)}
+		if info, err := os.Stat(path); err == nil {
+			entry.modTime = info.ModTime()
+			entry.size = info.Size()
+		}
+		s.levels[path] = entry
+	}
+	return nil
+}
+
+// pruneLevels forgets the levels no connection watches, except the most recently compiled ones
+// The caller holds s.mu
+func (s *Server) pruneLevels() {
+	watched := make(map[string]bool)
+	for _, paths := range s.watchers {
+		for path := range paths {
+			watched[path] = true
+		}
+	}
+
+	var unwatched []string
+	for path, entry := range s.levels {
+		if watched[path] {
+			continue
+		}
+		if len(entry.compiled) == 0 {
+			// Only kept for its watchers, which are gone
+			delete(s.levels, path)
+			continue
+		}
+		unwatched = append(unwatched, path)
+	}
+	if len(unwatched) <= maxUnwatchedLevels {
+		return
+	}
+
+	sort.Slice(unwatched, func(i, j int) bool {
+		return s.levels[unwatched[i]].lastUse < s.levels[unwatched[j]].lastUse
+	})
+	for _, path := range unwatched[:len(unwatched)-maxUnwatchedLevels] {
+		delete(s.levels, path)
+	}
+}
+
+// pollLevels drops cached levels whose files changed and notifies the watching connections
+func (s *Server) pollLevels(ctx context.Context) {
+	ticker := time.NewTicker(s.PollInterval)
+	defer ticker.Stop()
+
+	for {
+		select {
+		case <-ctx.Done():
+			return
+		case <-ticker.C:
+		}
+
+		s.mu.Lock()
+		paths := make([]string, 0, len(s.levels))
+		for path := range s.levels {
+			paths = append(paths, path)
+		}
+		s.mu.Unlock()
+
+		for _, path := range paths {
+			// A deleted file has a zero modification time
+			var modTime time.Time
+			var size int64
+			if info, err := os.Stat(path); err == nil {
+				modTime, size = info.ModTime(), info.Size()
+			}
+
+			s.mu.Lock()
+			entry, ok := s.levels[path]
+			if !ok || entry.modTime.Equal(modTime) && entry.size == size {
+				s.mu.Unlock()
+				continue
+			}
+
+			var notify []*serverConn
+			for c, watched := range s.watchers {
+				if watched[path] {
+					notify = append(notify, c)
+				}
+			}
+			if len(notify) == 0 {
+				// Nobody watches the file, the next compile loads it again
+				delete(s.levels, path)
+			} else {
+				// Keep watching the file, but forget everything derived from it
+				s.levels[path] = &levelEntry{
+					modTime:  modTime,
+					size:     size,
+					compiled: make(map[Options]compiledLevel),
+				}
+			}
+			s.mu.Unlock()
+
+			log.Printf("level changed: %s", path)
+			for _, c := range notify {
+				_ = c.send(Response{Invalidated: path})
+			}
+		}
+	}
+}
@@ -0,0 +1,108 @@
+package level
+
+import (
+	"cmp"
+	"math"
+	"slices"
+
+	pb "github.com/bloodmagesoftware/venture/proto/level"
+)
+
+// ObjectChunkSize is the edge length of an object culling chunk in world units
+const ObjectChunkSize = 16
+
+// ObjectBatches sorts the objects into instancing batches (by layer, then texture)
+// and builds a chunk index over them, so the runtime neither sorts nor batches per frame.
+// Objects belong to the chunk that contains their center.
+func (l *Level) ObjectBatches(chunkSize float32) ([]*pb.ObjectBatch, []*pb.ObjectChunk) {
+	type entry struct {
+		obj   *Object
+		chunk Vec2i
+		order int
+	}
+
+	entries := make([]entry, len(l.Objects))
+	for i := range l.Objects {
+		obj := &l.Objects[i]
+		entries[i] = entry{
+			obj: obj,
+			chunk: Vec2i{
+				X: int32(math.Floor(float64(obj.Position.X / chunkSize))),
+				Y: int32(math.Floor(float64(obj.Position.Y / chunkSize))),
+			},
+			order: i,
+		}
+	}
+
+	// Batch key first, then chunk, then level order to keep the result deterministic
+	slices.SortFunc(entries, func(a, b entry) int {
+		return cmp.Or(
+			cmp.Compare(a.obj.Layer, b.obj.Layer),
+			cmp.Compare(a.obj.Texture, b.obj.Texture),
+			cmp.Compare(a.chunk.Y, b.chunk.Y),
+			cmp.Compare(a.chunk.X, b.chunk.X),
+			cmp.Compare(a.order, b.order),
+		)
+	})
+
+	batches := make([]*pb.ObjectBatch, 0)
+	chunks := make([]*pb.ObjectChunk, 0)
+	chunkIndex := make(map[Vec2i]int)
+
+	var batch *pb.ObjectBatch
+	var run *pb.ObjectRange
+	for i, e := range entries {
+		obj := e.obj
+
+		if batch == nil || obj.Layer != batch.Layer || obj.Texture != batch.Texture {
+			batch = &pb.ObjectBatch{
+				Layer:   obj.Layer,
+				Texture: obj.Texture,
+			}
+			batches = append(batches, batch)
+			run = nil
+		}
+
+		instance := int32(len(batch.Rotations))
+		batch.Positions = append(batch.Positions, obj.Position.X, obj.Position.Y)
+		batch.Rotations = append(batch.Rotations, float32(obj.Rotation))
+		batch.Sizes = append(batch.Sizes, obj.Size.X, obj.Size.Y)
+
+		ci, ok := chunkIndex[e.chunk]
+		if !ok {
+			ci = len(chunks)
+			chunkIndex[e.chunk] = ci
+			chunks = append(chunks, &pb.ObjectChunk{
+				Position: &pb.Vec2I{X: e.chunk.X, Y: e.chunk.Y},
+				MinX:     float32(math.Inf(1)),
+				MinY:     float32(math.Inf(1)),
+				MaxX:     float32(math.Inf(-1)),
+				MaxY:     float32(math.Inf(-1)),
+			})
+		}
+		chunk := chunks[ci]
+
+		// A new range starts whenever the batch or the chunk changes
+		if run == nil || entries[i-1].chunk != e.chunk {
+			run = &pb.ObjectRange{
+				BatchIndex:    int32(len(batches) - 1),
+				FirstInstance: instance,
+			}
+			chunk.Ranges = append(chunk.Ranges, run)
+		}
+		run.InstanceCount++
+
+		// Bounding box of the rotated object
+		rad := obj.Rotation * math.Pi / 180
+		cos := math.Abs(math.Cos(rad))
+		sin := math.Abs(math.Sin(rad))
+		halfW := float32(float64(obj.Size.X)*cos+float64(obj.Size.Y)*sin) / 2
+		halfH := float32(float64(obj.Size.X)*sin+float64(obj.Size.Y)*cos) / 2
+		chunk.MinX = min(chunk.MinX, obj.Position.X-halfW)
+		chunk.MinY = min(chunk.MinY, obj.Position.Y-halfH)
+		chunk.MaxX = max(chunk.MaxX, obj.Position.X+halfW)
+		chunk.MaxY = max(chunk.MaxY, obj.Position.Y+halfH)
+	}
+
+	return batches, chunks
+}
@@ -0,0 +1,72 @@
+package level
+
+import (
+	"testing"
+)
+
+func TestObjectBatches(t *testing.T) {
+	level := &Level{
+		Objects: []Object{
+			{Position: Vec2{X: 1, Y: 1}, Size: Vec2{X: 1, Y: 1}, Texture: "tree.png"},
+			{Position: Vec2{X: 2, Y: 2}, Size: Vec2{X: 2, Y: 1}, Texture: "rock.png", Rotation: 90},
+			{Position: Vec2{X: 20, Y: 1}, Size: Vec2{X: 1, Y: 1}, Texture: "tree.png"},
+			{Position: Vec2{X: 3, Y: 3}, Size: Vec2{X: 1, Y: 1}, Texture: "tree.png"},
+			{Position: Vec2{X: 0, Y: 0}, Size: Vec2{X: 4, Y: 4}, Texture: "roof.png", Layer: 1},
+		},
+	}
+
+	batches, chunks := level.ObjectBatches(16)
+
+	// Layer 0 (rock, tree), then layer 1 (roof)
+	if len(batches) != 3 {
+		t.Fatalf("Expected 3 batches, got %d", len(batches))
+	}
+	want := []struct {
+		layer   int32
+		texture string
+		count   int
+	}{
+		{0, "rock.png", 1},
+		{0, "tree.png", 3},
+		{1, "roof.png", 1},
+	}
+	for i, w := range want {
+		b := batches[i]
+		if b.Layer != w.layer || b.Texture != w.texture {
+			t.Errorf("Batch %d: expected %d/%s, got %d/%s", i, w.layer, w.texture, b.Layer, b.Texture)
+		}
+		if len(b.Rotations) != w.count || len(b.Positions) != 2*w.count || len(b.Sizes) != 2*w.count {
+			t.Errorf("Batch %d: expected %d packed instances, got %d rotations, %d positions, %d sizes",
+				i, w.count, len(b.Rotations), len(b.Positions), len(b.Sizes))
+		}
+	}
+
+	// Trees in chunk (0, 0) come first and keep their level order
+	trees := batches[1]
+	if trees.Positions[0] != 1 || trees.Positions[2] != 3 || trees.Positions[4] != 20 {
+		t.Errorf("Unexpected tree instance order: %v", trees.Positions)
+	}
+
+	if len(chunks) != 2 {
+		t.Fatalf("Expected 2 chunks, got %d", len(chunks))
+	}
+
+	total := 0
+	for _, chunk := range chunks {
+		for _, r := range chunk.Ranges {
+			total += int(r.InstanceCount)
+		}
+	}
+	if total != len(level.Objects) {
+		t.Errorf("Chunk ranges cover %d instances, expected %d", total, len(level.Objects))
+	}
+
+	// The rotated rock (2x1 turned by 90 degrees) reaches y = 3, the roof reaches -2
+	c := chunks[0]
+	if c.Position.X != 0 || c.Position.Y != 0 {
+		t.Fatalf("Expected chunk (0, 0) first, got (%d, %d)", c.Position.X, c.Position.Y)
+	}
+	if c.MinX != -2 || c.MinY != -2 || c.MaxX != 3.5 || c.MaxY != 3.5 {
+		t.Errorf("Unexpected chunk bounds: (%f, %f) - (%f, %f)", c.MinX, c.MinY, c.MaxX, c.MaxY)
+	}
+}
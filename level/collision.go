@@ -0,0 +1,50 @@
+package level
+
+import (
+	"github.com/bloodmagesoftware/venture/bsp"
+)
+
+// CollisionInstances converts the collision prefabs used by objects into BSP prefabs and placements.
+// Every prefab is converted once, no matter how many objects use it.
+func (l *Level) CollisionInstances() (map[string][]bsp.Polygon, []bsp.Instance) {
+	prefabs := make(map[string][]bsp.Polygon)
+	instances := make([]bsp.Instance, 0)
+
+	for _, obj := range l.Objects {
+		name := obj.PrefabName()
+		prefab, ok := l.Prefabs[name]
+		if !ok {
+			continue
+		}
+
+		if _, converted := prefabs[name]; !converted {
+			polygons := make([]bsp.Polygon, 0, len(prefab.Collisions))
+			for _, collision := range prefab.Collisions {
+				if len(collision.Outline) < 3 {
+					continue
+				}
+				vertices := make([]bsp.Point, len(collision.Outline))
+				for i, v := range collision.Outline {
+					vertices[i] = bsp.Point{X: v.X, Y: v.Y}
+				}
+				polygons = append(polygons, bsp.Polygon{
+					Vertices: vertices,
+					IsSolid:  true,
+				})
+			}
+			prefabs[name] = polygons
+		}
+
+		// Object space spans the object's size, centered on its position
+		instances = append(instances, bsp.Instance{
+			Prefab: name,
+			Transform: bsp.NewTransform2D(
+				bsp.Point{X: obj.Position.X, Y: obj.Position.Y},
+				obj.Rotation,
+				bsp.Vector2{X: obj.Size.X, Y: obj.Size.Y},
+			),
+		})
+	}
+
+	return prefabs, instances
+}
@@ -5,8 +5,10 @@ package level
 import (
 	"image"
 	"log"
+	"time"
 
 	"gioui.org/layout"
+	"gioui.org/op"
 	"gioui.org/widget"
 	"gioui.org/widget/material"
 	"github.com/bloodmagesoftware/venture/bsp"
@@ -28,12 +30,18 @@ type collisionTestResult struct {
 	LineHitY    float32 // line trace hit Y coordinate
 }
 
+// CollisionCompiler builds collision BSP trees outside of the editor, e.g. in the warm level compiler service
+type CollisionCompiler interface {
+	BuildCollision(polygons []bsp.Polygon, prefabs map[string][]bsp.Polygon, instances []bsp.Instance) (*pb.LevelData, error)
+}
+
 // Editor is the main level editor component that manages the UI state and interactions
 type Editor struct {
 	theme         *material.Theme
 	levelFilePath string
 	assetsDir     string
 	level         *Level
+	ground        *GroundIndex // grid-keyed index over level.Ground
 
 	// UI state
 	assetFiles      []string
@@ -50,6 +58,7 @@ type Editor struct {
 	saveButton      widget.Clickable       // button to save the level
 	saveIcon        *widget.Icon           // icon for the save button
 	dirty           bool                   // true when there are unsaved changes
+	fileState       levelFileState         // level file as last loaded or saved, to tell other programs' changes apart
 
 	// Close confirmation dialog
 	showCloseDialog    bool             // true when showing the close confirmation dialog
@@ -71,6 +80,10 @@ type Editor struct {
 	// Keyboard state for canvas interaction
 	isDeleting bool // true when 'x' key is held down
 	isMoving   bool // true when 'm' key is held down
+	isFilling  bool // true when 'f' key is held down
+
+	// Ground tool state
+	brushRadius int32 // ground brush radius in cells (0 = single cell)
 
 	// Point moving state
 	movingPointPolygonIndex int // index of the polygon being edited (-1 = none)
@@ -92,6 +105,21 @@ type Editor struct {
 	collisionTestPoints   []collisionTestResult // history of test results
 	collisionTestBSP      *pb.LevelData         // cached BSP tree with flat structure
 	collisionTestBSPDirty bool                   // true when BSP needs rebuild
+	collisionCompiler     CollisionCompiler     // builds the BSP tree if set, falls back to building locally
+	partitions            *bsp.PartitionCache   // convex partitions of unchanged outlines for local builds
+
+	// Collision drawing caches
+	collisionDrawCache []*collisionDrawCache // recorded ops per collision polygon
+	collisionHandle    op.CallOp             // recorded vertex handle, shared by all polygons
+	collisionHandleOps *op.Ops               // backing storage of collisionHandle
+
+	// Live geometry validation
+	geometryIssues      []bsp.GeometryIssue // problems in the current collision outlines
+	geometryIssuesDirty bool                // true when the outlines changed since the last validation
+
+	// Session recording and replay
+	recorder       *SessionRecorder         // records input while set (nil = not recording)
+	sectionTimings map[string]time.Duration // per-section durations while replaying a session
 }
 
 // NewEditor creates a new level editor instance
@@ -102,11 +130,16 @@ func NewEditor(theme *material.Theme, levelFilePath, assetsDir string, level *Le
 		log.Printf("Failed to load save icon: %v", err)
 	}
 
+	ground := NewGroundIndex(level)
+	warnHiddenTiles(levelFilePath, ground)
+
 	return &Editor{
 		theme:           theme,
 		levelFilePath:   levelFilePath,
+		fileState:       statLevelFile(levelFilePath),
 		assetsDir:       assetsDir,
 		level:           level,
+		ground:          ground,
 		assetFiles:      []string{},
 		folderStructure: make(map[string][]string),
 		folders:         []string{},
@@ -151,6 +184,7 @@ func NewEditor(theme *material.Theme, levelFilePath, assetsDir string, level *Le
 		// Collision Test tool defaults
 		collisionTestPoints:   []collisionTestResult{},
 		collisionTestBSPDirty: true, // BSP needs to be built initially
+		geometryIssuesDirty:   true,
 	}
 }
 
@@ -170,6 +204,7 @@ func (e *Editor) Save() error {
 	if err := e.level.Save(e.levelFilePath); err != nil {
 		return err
 	}
+	e.fileState = statLevelFile(e.levelFilePath)
 	e.dirty = false
 	return nil
 }
@@ -228,17 +263,41 @@ func (e *Editor) buildCollisionBSP() {
 		}
 	}
 
-	// Build the BSP tree
+	// Build the BSP tree, including the collision prefabs of placed objects
+	prefabs, instances := e.level.CollisionInstances()
+	e.collisionTestBSPDirty = false
+
+	if e.collisionCompiler != nil {
+		levelData, err := e.collisionCompiler.BuildCollision(bspPolygons, prefabs, instances)
+		if err == nil {
+			e.collisionTestBSP = levelData
+			log.Printf("Built BSP tree from %d collision polygons and %d prefab instances in the level compiler", len(bspPolygons), len(instances))
+			return
+		}
+		log.Printf("warning: level compiler failed, building locally: %v", err)
+	}
+
+	if e.partitions == nil {
+		e.partitions = bsp.NewPartitionCache()
+	}
 	builder := bsp.NewBSPBuilder(bspPolygons)
+	builder.Prefabs, builder.Instances = prefabs, instances
+	builder.Partitions = e.partitions
 	e.collisionTestBSP = builder.Build()
-	e.collisionTestBSPDirty = false
 
-	log.Printf("Built BSP tree from %d collision polygons", len(bspPolygons))
+	log.Printf("Built BSP tree from %d collision polygons and %d prefab instances", len(bspPolygons), len(instances))
+}
+
+// SetCollisionCompiler makes the editor build its collision BSP tree with the given compiler
+func (e *Editor) SetCollisionCompiler(c CollisionCompiler) {
+	e.collisionCompiler = c
+	e.markCollisionBSPDirty()
 }
 
 // markCollisionBSPDirty marks the BSP tree as needing rebuild
 func (e *Editor) markCollisionBSPDirty() {
 	e.collisionTestBSPDirty = true
+	e.geometryIssuesDirty = true
 }
 
 // lineTraceBSP performs a line trace through the BSP tree
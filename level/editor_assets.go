@@ -196,6 +196,13 @@ func (e *Editor) layoutFolderList(gtx layout.Context) layout.Dimensions {
 	)
 }
 
+// selectTexture selects the texture used for painting
+func (e *Editor) selectTexture(relPath string) {
+	e.recordEvent(SessionEvent{Kind: "texture", Texture: relPath})
+
+	e.selectedTexture = relPath
+}
+
 // layoutAssetTile renders a single asset tile with thumbnail and filename
 func (e *Editor) layoutAssetTile(gtx layout.Context, index int, relPath, fileName string) layout.Dimensions {
 	// Load the image (from cache or disk)
@@ -203,7 +210,7 @@ func (e *Editor) layoutAssetTile(gtx layout.Context, index int, relPath, fileNam
 
 	// Handle click events to select texture
 	if e.assetButtons[index].Clicked(gtx) {
-		e.selectedTexture = relPath
+		e.selectTexture(relPath)
 	}
 
 	// Check if this texture is currently selected
@@ -32,12 +32,18 @@ func (e *Editor) layoutCanvas(gtx layout.Context) layout.Dimensions {
 			e.handleCanvasInput(gtx)
 
 			// Draw the ground editor grid
+			done := e.timeSection("ground")
 			e.drawGroundGrid(gtx)
+			done()
 			// Draw collision polygons
+			done = e.timeSection("collision")
 			e.drawCollisionPolygons(gtx)
+			done()
 			// Draw collision test results (if collision test tool is active)
 			if e.currentTool == "collision_test" {
+				done = e.timeSection("collision_test")
 				e.drawCollisionTestResults(gtx)
+				done()
 			}
 			return layout.Dimensions{Size: gtx.Constraints.Max}
 		},
@@ -76,132 +82,136 @@ func (e *Editor) handleCanvasInput(gtx layout.Context) {
 				continue
 			}
 
-			switch ev.Kind {
-			case pointer.Press:
-				// Start panning on right mouse button press
-				if ev.Buttons == pointer.ButtonSecondary {
-					e.isPanning = true
-					e.lastMouseX = ev.Position.X
-					e.lastMouseY = ev.Position.Y
+			e.handleCanvasPointer(gtx, ev)
+		}
+	}
+}
+
+// handleCanvasPointer applies a single pointer event on the canvas to the editor state
+func (e *Editor) handleCanvasPointer(gtx layout.Context, ev pointer.Event) {
+	e.recordCanvasPointer(gtx, ev)
+
+	switch ev.Kind {
+	case pointer.Press:
+		// Start panning on right mouse button press
+		if ev.Buttons == pointer.ButtonSecondary {
+			e.isPanning = true
+			e.lastMouseX = ev.Position.X
+			e.lastMouseY = ev.Position.Y
+		}
+		// Place or delete tile on left mouse button press
+		if ev.Buttons == pointer.ButtonPrimary {
+			if e.currentTool == "ground" {
+				if e.isDeleting {
+					e.deleteTileAtPosition(gtx, ev.Position.X, ev.Position.Y)
+				} else {
+					e.placeTileAtPosition(gtx, ev.Position.X, ev.Position.Y)
 				}
-				// Place or delete tile on left mouse button press
-				if ev.Buttons == pointer.ButtonPrimary {
-					if e.currentTool == "ground" {
-						if e.isDeleting {
-							e.deleteTileAtPosition(gtx, ev.Position.X, ev.Position.Y)
-						} else {
-							e.placeTileAtPosition(gtx, ev.Position.X, ev.Position.Y)
-						}
-					} else if e.currentTool == "collision" {
-						// If deleting mode is active
-						if e.isDeleting {
-							// If no polygon is selected, delete the entire polygon we clicked inside
-							if e.selectedPolygonIndex < 0 {
-								e.deletePolygonAtPosition(gtx, ev.Position.X, ev.Position.Y)
-							} else {
-								// Otherwise delete the nearest point in the selected polygon
-								e.deleteCollisionPoint(gtx, ev.Position.X, ev.Position.Y)
-							}
-						} else if e.isMoving {
-							// If moving mode is active, find the nearest point
-							e.startMovingPoint(gtx, ev.Position.X, ev.Position.Y)
-						} else if e.selectedPolygonIndex < 0 {
-							// If no polygon is selected, try to select one by clicking inside it
-							e.selectPolygonAtPosition(gtx, ev.Position.X, ev.Position.Y)
-						} else {
-							// Otherwise add a point to the selected polygon
-							e.addCollisionPoint(gtx, ev.Position.X, ev.Position.Y)
-						}
-					} else if e.currentTool == "collision_test" {
-						// Collision test tool: test point collision
-						e.handleCollisionTest(gtx, ev.Position.X, ev.Position.Y)
+			} else if e.currentTool == "collision" {
+				// If deleting mode is active
+				if e.isDeleting {
+					// If no polygon is selected, delete the entire polygon we clicked inside
+					if e.selectedPolygonIndex < 0 {
+						e.deletePolygonAtPosition(gtx, ev.Position.X, ev.Position.Y)
+					} else {
+						// Otherwise delete the nearest point in the selected polygon
+						e.deleteCollisionPoint(gtx, ev.Position.X, ev.Position.Y)
 					}
+				} else if e.isMoving {
+					// If moving mode is active, find the nearest point
+					e.startMovingPoint(gtx, ev.Position.X, ev.Position.Y)
+				} else if e.selectedPolygonIndex < 0 {
+					// If no polygon is selected, try to select one by clicking inside it
+					e.selectPolygonAtPosition(gtx, ev.Position.X, ev.Position.Y)
+				} else {
+					// Otherwise add a point to the selected polygon
+					e.addCollisionPoint(gtx, ev.Position.X, ev.Position.Y)
 				}
+			} else if e.currentTool == "collision_test" {
+				// Collision test tool: test point collision
+				e.handleCollisionTest(gtx, ev.Position.X, ev.Position.Y)
+			}
+		}
 
-			case pointer.Release:
-				// Stop panning on right mouse button release
-				if ev.Buttons&pointer.ButtonSecondary == 0 {
-					e.isPanning = false
-				}
-				// Stop moving point on left mouse button release
-				if ev.Buttons&pointer.ButtonPrimary == 0 {
-					e.movingPointPolygonIndex = -1
-					e.movingPointIndex = -1
-				}
+	case pointer.Release:
+		// Stop panning on right mouse button release
+		if ev.Buttons&pointer.ButtonSecondary == 0 {
+			e.isPanning = false
+		}
+		// Stop moving point on left mouse button release
+		if ev.Buttons&pointer.ButtonPrimary == 0 {
+			e.movingPointPolygonIndex = -1
+			e.movingPointIndex = -1
+		}
 
-			case pointer.Drag:
-				// Pan the canvas if right mouse button is held
-				if e.isPanning {
-					deltaX := ev.Position.X - e.lastMouseX
-					deltaY := ev.Position.Y - e.lastMouseY
-					e.viewOffsetX += deltaX
-					e.viewOffsetY += deltaY
-					e.lastMouseX = ev.Position.X
-					e.lastMouseY = ev.Position.Y
+	case pointer.Drag:
+		// Pan the canvas if right mouse button is held
+		if e.isPanning {
+			deltaX := ev.Position.X - e.lastMouseX
+			deltaY := ev.Position.Y - e.lastMouseY
+			e.viewOffsetX += deltaX
+			e.viewOffsetY += deltaY
+			e.lastMouseX = ev.Position.X
+			e.lastMouseY = ev.Position.Y
+		}
+		// Place or delete tile while dragging with left mouse button
+		if ev.Buttons == pointer.ButtonPrimary {
+			if e.currentTool == "ground" {
+				if e.isDeleting {
+					e.deleteTileAtPosition(gtx, ev.Position.X, ev.Position.Y)
+				} else {
+					e.placeTileAtPosition(gtx, ev.Position.X, ev.Position.Y)
 				}
-				// Place or delete tile while dragging with left mouse button
-				if ev.Buttons == pointer.ButtonPrimary {
-					if e.currentTool == "ground" {
-						if e.isDeleting {
-							e.deleteTileAtPosition(gtx, ev.Position.X, ev.Position.Y)
-						} else {
-							e.placeTileAtPosition(gtx, ev.Position.X, ev.Position.Y)
-						}
-					} else if e.currentTool == "collision" {
-						// If moving a point, update its position
-						if e.isMoving && e.movingPointPolygonIndex >= 0 && e.movingPointIndex >= 0 {
-							e.movePoint(gtx, ev.Position.X, ev.Position.Y)
-						}
-					}
-					// Note: We don't add collision points on drag, only on click
+			} else if e.currentTool == "collision" {
+				// If moving a point, update its position
+				if e.isMoving && e.movingPointPolygonIndex >= 0 && e.movingPointIndex >= 0 {
+					e.movePoint(gtx, ev.Position.X, ev.Position.Y)
 				}
+			}
+			// Note: We don't add collision points on drag, only on click
+		}
 
-			case pointer.Scroll:
-				// Zoom in/out with mouse wheel
-				// Scroll.Y is positive when scrolling up (zoom in), negative when scrolling down (zoom out)
-				zoomFactor := float32(1.0 + ev.Scroll.Y*0.1)
-				newZoom := e.zoom * zoomFactor
-
-				// Clamp zoom to reasonable limits
-				const minZoom = 0.1
-				const maxZoom = 10.0
-				if newZoom < minZoom {
-					newZoom = minZoom
-				}
-				if newZoom > maxZoom {
-					newZoom = maxZoom
-				}
+	case pointer.Scroll:
+		// Zoom in/out with mouse wheel
+		// Scroll.Y is positive when scrolling up (zoom in), negative when scrolling down (zoom out)
+		zoomFactor := float32(1.0 + ev.Scroll.Y*0.1)
+		newZoom := e.zoom * zoomFactor
+
+		// Clamp zoom to reasonable limits
+		const minZoom = 0.1
+		const maxZoom = 10.0
+		if newZoom < minZoom {
+			newZoom = minZoom
+		}
+		if newZoom > maxZoom {
+			newZoom = maxZoom
+		}
 
-				// Zoom towards mouse position
-				// Calculate the world position under the mouse before zoom
-				canvasWidth := float32(gtx.Constraints.Max.X)
-				canvasHeight := float32(gtx.Constraints.Max.Y)
-				centerX := canvasWidth / 2.0
-				centerY := canvasHeight / 2.0
+		// Zoom towards mouse position
+		// Calculate the world position under the mouse before zoom
+		canvasWidth := float32(gtx.Constraints.Max.X)
+		canvasHeight := float32(gtx.Constraints.Max.Y)
+		centerX := canvasWidth / 2.0
+		centerY := canvasHeight / 2.0
 
-				// Mouse position relative to center
-				mouseRelX := ev.Position.X - centerX
-				mouseRelY := ev.Position.Y - centerY
+		// Mouse position relative to center
+		mouseRelX := ev.Position.X - centerX
+		mouseRelY := ev.Position.Y - centerY
 
-				// Adjust offset to keep the same world point under the mouse
-				zoomRatio := newZoom / e.zoom
-				e.viewOffsetX = (e.viewOffsetX-mouseRelX)*zoomRatio + mouseRelX
-				e.viewOffsetY = (e.viewOffsetY-mouseRelY)*zoomRatio + mouseRelY
+		// Adjust offset to keep the same world point under the mouse
+		zoomRatio := newZoom / e.zoom
+		e.viewOffsetX = (e.viewOffsetX-mouseRelX)*zoomRatio + mouseRelX
+		e.viewOffsetY = (e.viewOffsetY-mouseRelY)*zoomRatio + mouseRelY
 
-				e.zoom = newZoom
-			}
-		}
+		e.zoom = newZoom
 	}
 }
 
-// placeTileAtPosition places the selected texture at the grid position under the mouse
-func (e *Editor) placeTileAtPosition(gtx layout.Context, mouseX, mouseY float32) {
-	// Only place if we have a texture selected
-	if e.selectedTexture == "" {
-		return
-	}
+// maxBrushRadius is the largest ground brush radius in cells
+const maxBrushRadius = 16
 
-	// Convert screen coordinates to grid coordinates
+// gridCellAtPosition converts screen coordinates to the grid cell under the mouse
+func (e *Editor) gridCellAtPosition(gtx layout.Context, mouseX, mouseY float32) Vec2i {
 	canvasWidth := float32(gtx.Constraints.Max.X)
 	canvasHeight := float32(gtx.Constraints.Max.Y)
 	centerX := canvasWidth / 2.0
@@ -213,63 +223,38 @@ func (e *Editor) placeTileAtPosition(gtx layout.Context, mouseX, mouseY float32)
 	worldX := mouseX - centerX - e.viewOffsetX
 	worldY := mouseY - centerY - e.viewOffsetY
 
-	gridX := int32(math.Floor(float64(worldX / cellSize)))
-	gridY := int32(math.Floor(float64(worldY / cellSize)))
-
-	// Check if a tile already exists at this position
-	tileIndex := -1
-	for i, tile := range e.level.Ground {
-		if tile.Position.X == gridX && tile.Position.Y == gridY {
-			tileIndex = i
-			break
-		}
+	return Vec2i{
+		X: int32(math.Floor(float64(worldX / cellSize))),
+		Y: int32(math.Floor(float64(worldY / cellSize))),
 	}
+}
 
-	// Update or add the tile
-	newTile := Tile{
-		Position: Vec2i{X: gridX, Y: gridY},
-		Texture:  e.selectedTexture,
+// placeTileAtPosition places the selected texture at the grid position under the mouse
+// Uses the current brush size, or flood fills while 'f' is held
+func (e *Editor) placeTileAtPosition(gtx layout.Context, mouseX, mouseY float32) {
+	// Only place if we have a texture selected
+	if e.selectedTexture == "" {
+		return
 	}
 
-	if tileIndex >= 0 {
-		// Update existing tile (only if different)
-		if e.level.Ground[tileIndex].Texture != newTile.Texture {
-			e.level.Ground[tileIndex] = newTile
-			e.dirty = true // Mark as dirty when tile changes
-		}
+	cell := e.gridCellAtPosition(gtx, mouseX, mouseY)
+
+	var changed bool
+	if e.isFilling {
+		changed = e.ground.FloodFill(cell, e.selectedTexture)
 	} else {
-		// Add new tile
-		e.level.Ground = append(e.level.Ground, newTile)
-		e.dirty = true // Mark as dirty when tile is added
+		changed = e.ground.SetBrush(cell, e.brushRadius, e.selectedTexture)
+	}
+	if changed {
+		e.dirty = true // Mark as dirty when tiles change
 	}
 }
 
-// deleteTileAtPosition removes the tile at the grid position under the mouse
+// deleteTileAtPosition removes the tiles under the brush at the grid position under the mouse
 func (e *Editor) deleteTileAtPosition(gtx layout.Context, mouseX, mouseY float32) {
-	// Convert screen coordinates to grid coordinates
-	canvasWidth := float32(gtx.Constraints.Max.X)
-	canvasHeight := float32(gtx.Constraints.Max.Y)
-	centerX := canvasWidth / 2.0
-	centerY := canvasHeight / 2.0
-
-	cellSize := e.gridCellSize * e.zoom
-
-	// Calculate grid position
-	worldX := mouseX - centerX - e.viewOffsetX
-	worldY := mouseY - centerY - e.viewOffsetY
-
-	gridX := int32(math.Floor(float64(worldX / cellSize)))
-	gridY := int32(math.Floor(float64(worldY / cellSize)))
-
-	// Find and remove the tile at this position
-	for i, tile := range e.level.Ground {
-		if tile.Position.X == gridX && tile.Position.Y == gridY {
-			// Remove tile by replacing it with the last element and truncating
-			e.level.Ground[i] = e.level.Ground[len(e.level.Ground)-1]
-			e.level.Ground = e.level.Ground[:len(e.level.Ground)-1]
-			e.dirty = true // Mark as dirty when tile is deleted
-			return
-		}
+	cell := e.gridCellAtPosition(gtx, mouseX, mouseY)
+	if e.ground.DeleteBrush(cell, e.brushRadius) {
+		e.dirty = true // Mark as dirty when tiles are deleted
 	}
 }
 
@@ -375,6 +360,7 @@ func (e *Editor) addCollisionPoint(gtx layout.Context, mouseX, mouseY float32) {
 	e.level.Collisions[e.selectedPolygonIndex].Outline = append(e.level.Collisions[e.selectedPolygonIndex].Outline, point)
 	e.dirty = true
 	e.markCollisionBSPDirty() // Mark BSP as needing rebuild
+	e.invalidateCollisionDrawCache(e.selectedPolygonIndex)
 }
 
 // snapToGrid snaps a coordinate to the nearest grid point
@@ -453,6 +439,7 @@ func (e *Editor) movePoint(gtx layout.Context, mouseX, mouseY float32) {
 	e.level.Collisions[e.movingPointPolygonIndex].Outline[e.movingPointIndex] = Vec2{X: worldX, Y: worldY}
 	e.dirty = true
 	e.markCollisionBSPDirty() // Mark BSP as needing rebuild
+	e.invalidateCollisionDrawCache(e.movingPointPolygonIndex)
 }
 
 // deleteCollisionPoint finds and deletes the nearest collision point to the mouse in the selected polygon
@@ -507,11 +494,13 @@ func (e *Editor) deleteCollisionPoint(gtx layout.Context, mouseX, mouseY float32
 
 		e.dirty = true
 		e.markCollisionBSPDirty() // Mark BSP as needing rebuild
+		// The selection is cleared if the whole polygon was removed, which drops the whole cache
+		e.invalidateCollisionDrawCache(e.selectedPolygonIndex)
 		log.Printf("Deleted collision point at polygon %d, point %d", e.selectedPolygonIndex, foundPointIndex)
 	}
 }
 
-// drawCollisionPolygons draws all collision polygons and their points
+// drawCollisionPolygons draws all visible collision polygons and their points
 func (e *Editor) drawCollisionPolygons(gtx layout.Context) {
 	canvasWidth := float32(gtx.Constraints.Max.X)
 	canvasHeight := float32(gtx.Constraints.Max.Y)
@@ -523,83 +512,11 @@ func (e *Editor) drawCollisionPolygons(gtx layout.Context) {
 	centerX := canvasWidth / 2.0
 	centerY := canvasHeight / 2.0
 
-	// Draw all collision polygons
-	for _, polygon := range e.level.Collisions {
-		e.drawCollisionPolygon(gtx, polygon, centerX, centerY)
-	}
-}
-
-// drawCollisionPolygon draws a single collision polygon and its points
-func (e *Editor) drawCollisionPolygon(gtx layout.Context, polygon Polygon, centerX, centerY float32) {
-	cellSize := e.gridCellSize * e.zoom
+	// Draw all collision polygons from their cached ops
+	e.drawCollisionPolygonsCached(gtx, centerX, centerY)
 
-	// Fill the polygon if we have at least 3 points
-	if len(polygon.Outline) >= 3 {
-		var path clip.Path
-		path.Begin(gtx.Ops)
-
-		// Move to the first point
-		p0 := polygon.Outline[0]
-		screenX := centerX + e.viewOffsetX + p0.X*cellSize
-		screenY := centerY + e.viewOffsetY + p0.Y*cellSize
-		path.MoveTo(f32.Point{X: screenX, Y: screenY})
-
-		// Draw lines to all other points
-		for i := 1; i < len(polygon.Outline); i++ {
-			p := polygon.Outline[i]
-			screenX := centerX + e.viewOffsetX + p.X*cellSize
-			screenY := centerY + e.viewOffsetY + p.Y*cellSize
-			path.LineTo(f32.Point{X: screenX, Y: screenY})
-		}
-
-		// Close the path back to the first point
-		path.Close()
-
-		// Fill the polygon with semi-transparent cyan
-		spec := path.End()
-		stack := clip.Outline{Path: spec}.Op().Push(gtx.Ops)
-		paint.ColorOp{Color: color.NRGBA{R: 100, G: 200, B: 255, A: 60}}.Add(gtx.Ops)
-		paint.PaintOp{}.Add(gtx.Ops)
-		stack.Pop() // Pop immediately so subsequent drawing isn't clipped
-	}
-
-	// Draw lines between consecutive points
-	if len(polygon.Outline) > 1 {
-		for i := 0; i < len(polygon.Outline)-1; i++ {
-			p1 := polygon.Outline[i]
-			p2 := polygon.Outline[i+1]
-
-			// Convert world coordinates to screen coordinates (1 unit = 1 tile)
-			screenX1 := centerX + e.viewOffsetX + p1.X*cellSize
-			screenY1 := centerY + e.viewOffsetY + p1.Y*cellSize
-			screenX2 := centerX + e.viewOffsetX + p2.X*cellSize
-			screenY2 := centerY + e.viewOffsetY + p2.Y*cellSize
-
-			// Draw a line between the two points
-			e.drawLine(gtx, screenX1, screenY1, screenX2, screenY2, 2.0, color.NRGBA{R: 100, G: 200, B: 255, A: 200})
-		}
-
-		// Draw a line from the last point back to the first point to close the polygon
-		pFirst := polygon.Outline[0]
-		pLast := polygon.Outline[len(polygon.Outline)-1]
-
-		screenX1 := centerX + e.viewOffsetX + pLast.X*cellSize
-		screenY1 := centerY + e.viewOffsetY + pLast.Y*cellSize
-		screenX2 := centerX + e.viewOffsetX + pFirst.X*cellSize
-		screenY2 := centerY + e.viewOffsetY + pFirst.Y*cellSize
-
-		e.drawLine(gtx, screenX1, screenY1, screenX2, screenY2, 2.0, color.NRGBA{R: 100, G: 200, B: 255, A: 200})
-	}
-
-	// Draw all points as circles (on top of lines)
-	for _, point := range polygon.Outline {
-		// Convert world coordinates to screen coordinates (1 unit = 1 tile)
-		screenX := centerX + e.viewOffsetX + point.X*cellSize
-		screenY := centerY + e.viewOffsetY + point.Y*cellSize
-
-		// Draw a circle at this point
-		e.drawCircle(gtx, screenX, screenY, 6.0, color.NRGBA{R: 100, G: 200, B: 255, A: 255})
-	}
+	// Mark problems in the outlines on top of them
+	e.drawGeometryIssues(gtx, centerX, centerY)
 }
 
 // drawCircle draws a filled circle at the given position
@@ -719,6 +636,7 @@ func (e *Editor) deletePolygonAtPosition(gtx layout.Context, mouseX, mouseY floa
 			e.level.Collisions = append(e.level.Collisions[:i], e.level.Collisions[i+1:]...)
 			e.dirty = true
 			e.markCollisionBSPDirty() // Mark BSP as needing rebuild
+			e.invalidateCollisionDrawCache(-1)
 			log.Printf("Deleted entire polygon %d", i)
 			return
 		}
@@ -0,0 +1,192 @@
+//go:build !cli
+
+package level
+
+import (
+	"image/color"
+	"math"
+
+	"gioui.org/f32"
+	"gioui.org/layout"
+	"gioui.org/op"
+	"gioui.org/op/clip"
+	"gioui.org/op/paint"
+)
+
+const (
+	// collisionEdgeWidth is the width of collision polygon edges in screen pixels
+	collisionEdgeWidth = 2.0
+	// collisionHandleRadius is the radius of vertex handles in screen pixels
+	collisionHandleRadius = 6.0
+	// collisionHandleMinCellSize is the grid cell size (in screen pixels) below which
+	// vertex handles are hidden, because they would cover the outlines
+	collisionHandleMinCellSize = 16.0
+)
+
+// collisionDrawCache holds the recorded drawing ops of one collision polygon.
+// The ops are recorded relative to the world origin at a fixed cell size, so panning
+// only moves them and only zooming or editing the polygon records them again.
+type collisionDrawCache struct {
+	valid    bool      // false if the polygon changed since the bounds were computed
+	recorded bool      // true if call holds the ops for the current outline
+	cellSize float32   // cell size the ops were recorded for
+	min, max Vec2      // world-space bounds of the outline
+	ops      op.Ops    // backing storage of call
+	call     op.CallOp // outline fill, edges and handles
+}
+
+// invalidateCollisionDrawCache drops the cached ops of the polygon at index
+// Pass -1 when polygons were added or removed, which drops the whole cache
+func (e *Editor) invalidateCollisionDrawCache(index int) {
+	if index < 0 || index >= len(e.collisionDrawCache) {
+		e.collisionDrawCache = nil
+		return
+	}
+	e.collisionDrawCache[index].valid = false
+}
+
+// drawCollisionPolygonsCached draws the on-screen collision polygons from their cached ops
+func (e *Editor) drawCollisionPolygonsCached(gtx layout.Context, centerX, centerY float32) {
+	cellSize := e.gridCellSize * e.zoom
+	canvasWidth := float32(gtx.Constraints.Max.X)
+	canvasHeight := float32(gtx.Constraints.Max.Y)
+
+	if len(e.collisionDrawCache) != len(e.level.Collisions) {
+		e.collisionDrawCache = make([]*collisionDrawCache, len(e.level.Collisions))
+		for i := range e.collisionDrawCache {
+			e.collisionDrawCache[i] = &collisionDrawCache{}
+		}
+	}
+
+	// Screen position of the world origin
+	originX := centerX + e.viewOffsetX
+	originY := centerY + e.viewOffsetY
+	defer op.Affine(f32.Affine2D{}.Offset(f32.Point{X: originX, Y: originY})).Push(gtx.Ops).Pop()
+
+	// Handles and edges reach beyond the outline bounds
+	const margin = collisionHandleRadius + collisionEdgeWidth
+
+	for i, polygon := range e.level.Collisions {
+		if len(polygon.Outline) == 0 {
+			continue
+		}
+
+		cache := e.collisionDrawCache[i]
+		if !cache.valid {
+			cache.min, cache.max = outlineBounds(polygon.Outline)
+			cache.valid = true
+			cache.recorded = false
+		}
+
+		// Skip polygons that are entirely off-screen
+		if originX+cache.max.X*cellSize+margin < 0 || originX+cache.min.X*cellSize-margin > canvasWidth ||
+			originY+cache.max.Y*cellSize+margin < 0 || originY+cache.min.Y*cellSize-margin > canvasHeight {
+			continue
+		}
+
+		if !cache.recorded || cache.cellSize != cellSize {
+			e.recordCollisionPolygon(cache, polygon, cellSize)
+		}
+		cache.call.Add(gtx.Ops)
+	}
+}
+
+// recordCollisionPolygon records the ops of a collision polygon into its cache
+func (e *Editor) recordCollisionPolygon(cache *collisionDrawCache, polygon Polygon, cellSize float32) {
+	ops := &cache.ops
+	ops.Reset()
+	macro := op.Record(ops)
+
+	points := make([]f32.Point, len(polygon.Outline))
+	for i, p := range polygon.Outline {
+		points[i] = f32.Point{X: p.X * cellSize, Y: p.Y * cellSize}
+	}
+
+	// Fill the polygon with semi-transparent cyan if we have at least 3 points
+	if len(points) >= 3 {
+		var path clip.Path
+		path.Begin(ops)
+		path.MoveTo(points[0])
+		for _, p := range points[1:] {
+			path.LineTo(p)
+		}
+		path.Close()
+		stack := clip.Outline{Path: path.End()}.Op().Push(ops)
+		paint.ColorOp{Color: color.NRGBA{R: 100, G: 200, B: 255, A: 60}}.Add(ops)
+		paint.PaintOp{}.Add(ops)
+		stack.Pop()
+	}
+
+	// Stroke all edges, including the closing edge, as a single path
+	if len(points) > 1 {
+		var path clip.Path
+		path.Begin(ops)
+		path.MoveTo(points[0])
+		for _, p := range points[1:] {
+			path.LineTo(p)
+		}
+		path.Close()
+		stack := clip.Stroke{Path: path.End(), Width: collisionEdgeWidth}.Op().Push(ops)
+		paint.ColorOp{Color: color.NRGBA{R: 100, G: 200, B: 255, A: 200}}.Add(ops)
+		paint.PaintOp{}.Add(ops)
+		stack.Pop()
+	}
+
+	// Draw all points as instances of the shared handle (on top of lines)
+	if cellSize >= collisionHandleMinCellSize {
+		handle := e.collisionHandleOp()
+		for _, p := range points {
+			stack := op.Affine(f32.Affine2D{}.Offset(p)).Push(ops)
+			handle.Add(ops)
+			stack.Pop()
+		}
+	}
+
+	cache.call = macro.Stop()
+	cache.cellSize = cellSize
+	cache.recorded = true
+}
+
+// collisionHandleOp returns the recorded vertex handle, centered on the origin
+// It is recorded once and shared by every polygon
+func (e *Editor) collisionHandleOp() op.CallOp {
+	if e.collisionHandleOps != nil {
+		return e.collisionHandle
+	}
+
+	e.collisionHandleOps = new(op.Ops)
+	ops := e.collisionHandleOps
+	macro := op.Record(ops)
+
+	const segments = 32
+	var path clip.Path
+	path.Begin(ops)
+	path.MoveTo(f32.Point{X: collisionHandleRadius, Y: 0})
+	for i := 1; i <= segments; i++ {
+		angle := float64(i) * 2.0 * math.Pi / segments
+		path.LineTo(f32.Point{
+			X: collisionHandleRadius * float32(math.Cos(angle)),
+			Y: collisionHandleRadius * float32(math.Sin(angle)),
+		})
+	}
+	path.Close()
+	stack := clip.Outline{Path: path.End()}.Op().Push(ops)
+	paint.ColorOp{Color: color.NRGBA{R: 100, G: 200, B: 255, A: 255}}.Add(ops)
+	paint.PaintOp{}.Add(ops)
+	stack.Pop()
+
+	e.collisionHandle = macro.Stop()
+	return e.collisionHandle
+}
+
+// outlineBounds returns the bounding box of an outline
+func outlineBounds(outline Outline) (Vec2, Vec2) {
+	boundsMin, boundsMax := outline[0], outline[0]
+	for _, p := range outline[1:] {
+		boundsMin.X = min(boundsMin.X, p.X)
+		boundsMin.Y = min(boundsMin.Y, p.Y)
+		boundsMax.X = max(boundsMax.X, p.X)
+		boundsMax.Y = max(boundsMax.Y, p.Y)
+	}
+	return boundsMin, boundsMax
+}
@@ -0,0 +1,81 @@
+//go:build !cli
+
+package level
+
+import (
+	"image/color"
+	"log"
+
+	"gioui.org/layout"
+	"github.com/bloodmagesoftware/venture/bsp"
+)
+
+// geometryIssueRadius is the radius of geometry issue markers in screen pixels
+const geometryIssueRadius = 8.0
+
+// validateGeometry checks the collision outlines for self-intersections, crossings, slivers and
+// duplicate vertices if they changed since the last check
+// The check is one box intersection pass over all edges, cheap enough to run on every edit
+func (e *Editor) validateGeometry() {
+	if !e.geometryIssuesDirty {
+		return
+	}
+	e.geometryIssuesDirty = false
+
+	// Keep one polygon per collision, so issue indices match the collision list
+	polygons := make([]bsp.Polygon, len(e.level.Collisions))
+	for i, collision := range e.level.Collisions {
+		vertices := make([]bsp.Point, len(collision.Outline))
+		for j, pt := range collision.Outline {
+			vertices[j] = bsp.Point{X: pt.X, Y: pt.Y}
+		}
+		polygons[i] = bsp.Polygon{Vertices: vertices, IsSolid: true}
+	}
+
+	issues, err := bsp.ValidateGeometry(polygons, bsp.SliverTolerance)
+	if err != nil {
+		log.Printf("warning: validating collision geometry: %v", err)
+		return
+	}
+
+	// Outlines that are still being drawn are not reported
+	previous := e.geometryIssues
+	e.geometryIssues = nil
+	for _, issue := range issues {
+		if len(polygons[issue.Polygon].Vertices) >= 3 {
+			e.geometryIssues = append(e.geometryIssues, issue)
+		}
+	}
+
+	// Dragging a vertex revalidates every frame, only issues that are new are logged
+	for _, issue := range e.geometryIssues {
+		if !containsGeometryIssue(previous, issue) {
+			log.Printf("Collision geometry: %s", issue)
+		}
+	}
+}
+
+// containsGeometryIssue returns true if issues has an issue of the same kind on the same edges,
+// wherever it is located
+func containsGeometryIssue(issues []bsp.GeometryIssue, issue bsp.GeometryIssue) bool {
+	for _, other := range issues {
+		other.Location = issue.Location
+		if other == issue {
+			return true
+		}
+	}
+	return false
+}
+
+// drawGeometryIssues marks the location of every geometry issue in the collision outlines
+func (e *Editor) drawGeometryIssues(gtx layout.Context, centerX, centerY float32) {
+	e.validateGeometry()
+
+	cellSize := e.gridCellSize * e.zoom
+	colorIssue := color.NRGBA{R: 255, G: 160, B: 0, A: 200}
+	for _, issue := range e.geometryIssues {
+		screenX := issue.Location.X*cellSize + centerX + e.viewOffsetX
+		screenY := issue.Location.Y*cellSize + centerY + e.viewOffsetY
+		e.drawCircle(gtx, screenX, screenY, geometryIssueRadius, colorIssue)
+	}
+}
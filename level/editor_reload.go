@@ -0,0 +1,64 @@
+//go:build !cli
+
+package level
+
+import (
+	"fmt"
+	"log"
+	"os"
+	"time"
+)
+
+// levelFileState identifies a version of the level file on disk
+type levelFileState struct {
+	modTime time.Time
+	size    int64
+}
+
+// statLevelFile returns the state of a level file, the zero state if it does not exist
+func statLevelFile(path string) levelFileState {
+	info, err := os.Stat(path)
+	if err != nil {
+		return levelFileState{}
+	}
+	return levelFileState{modTime: info.ModTime(), size: info.Size()}
+}
+
+// ReloadFromDisk loads the level file again if another program changed it since the editor
+// loaded or saved it, e.g. a checkout or a script. The level compiler service pushes these changes.
+// Unsaved changes are never thrown away: the editor keeps its level and only logs the change.
+// Returns true if the level was reloaded
+func (e *Editor) ReloadFromDisk() (bool, error) {
+	state := statLevelFile(e.levelFilePath)
+	if state.modTime.Equal(e.fileState.modTime) && state.size == e.fileState.size {
+		return false, nil // Unchanged, or the editor's own save
+	}
+	e.fileState = state
+	if e.dirty {
+		log.Printf("warning: %s changed on disk, keeping the unsaved changes", e.levelFilePath)
+		return false, nil
+	}
+
+	lvl := New()
+	if err := lvl.Load(e.levelFilePath); err != nil {
+		return false, fmt.Errorf("reloading level %s: %w", e.levelFilePath, err)
+	}
+	e.level = lvl
+	e.ground = NewGroundIndex(lvl)
+	warnHiddenTiles(e.levelFilePath, e.ground)
+	e.selectedPolygonIndex = -1
+	e.movingPointPolygonIndex = -1
+	e.movingPointIndex = -1
+	e.invalidateCollisionDrawCache(-1)
+	e.markCollisionBSPDirty()
+	log.Printf("reloaded %s, it changed on disk", e.levelFilePath)
+	return true, nil
+}
+
+// warnHiddenTiles logs the ground tiles that were dropped because a later tile in the same cell covered them.
+// Saving the level writes the ground without them.
+func warnHiddenTiles(path string, ground *GroundIndex) {
+	if hidden := ground.Hidden(); hidden > 0 {
+		log.Printf("warning: %s has %d ground tiles hidden under others in the same cell, dropped them", path, hidden)
+	}
+}
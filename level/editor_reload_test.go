@@ -0,0 +1,54 @@
+//go:build !cli
+
+package level
+
+import (
+	"path/filepath"
+	"testing"
+)
+
+func TestReloadFromDisk(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "test.yaml")
+	square := Polygon{Outline: []Vec2{{X: 0, Y: 0}, {X: 1, Y: 0}, {X: 1, Y: 1}, {X: 0, Y: 1}}}
+	lvl := New()
+	lvl.Collisions = append(lvl.Collisions, square)
+	if err := lvl.Save(path); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+
+	editor := &Editor{levelFilePath: path, level: lvl, fileState: statLevelFile(path)}
+	if reloaded, err := editor.ReloadFromDisk(); err != nil || reloaded {
+		t.Fatalf("Expected no reload of an unchanged file, got %v, %v", reloaded, err)
+	}
+
+	// Another program adds a polygon
+	other := New()
+	other.Collisions = append(other.Collisions, square, square)
+	if err := other.Save(path); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if reloaded, err := editor.ReloadFromDisk(); err != nil || !reloaded || len(editor.level.Collisions) != 2 {
+		t.Fatalf("Expected the changed file to be reloaded, got %v, %v with %d polygons", reloaded, err, len(editor.level.Collisions))
+	}
+	if !editor.collisionTestBSPDirty {
+		t.Error("Expected the collision tree to be rebuilt after a reload")
+	}
+
+	// Unsaved changes are kept
+	editor.dirty = true
+	other.Collisions = other.Collisions[:1]
+	if err := other.Save(path); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if reloaded, err := editor.ReloadFromDisk(); err != nil || reloaded || len(editor.level.Collisions) != 2 {
+		t.Errorf("Expected unsaved changes to be kept, got %v, %v with %d polygons", reloaded, err, len(editor.level.Collisions))
+	}
+
+	// The editor's own save is no change
+	if err := editor.Save(); err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if reloaded, err := editor.ReloadFromDisk(); err != nil || reloaded {
+		t.Errorf("Expected no reload after saving, got %v, %v", reloaded, err)
+	}
+}
@@ -0,0 +1,313 @@
+//go:build !cli
+
+package level
+
+import (
+	"bufio"
+	"encoding/json"
+	"fmt"
+	"image"
+	"io"
+	"os"
+	"sort"
+	"time"
+
+	"gioui.org/f32"
+	"gioui.org/io/key"
+	"gioui.org/io/pointer"
+	"gioui.org/layout"
+	"gioui.org/op"
+	"gioui.org/unit"
+)
+
+// SessionEvent is a single recorded editor input.
+// Sessions are stored as JSON Lines, one event per line.
+type SessionEvent struct {
+	// Frame is the number of the editor frame the event was handled in
+	Frame int    `json:"frame"`
+	Kind  string `json:"kind"` // "canvas", "pointer", "key", "tool", "texture", "select_polygon" or "new_polygon"
+
+	// Canvas size in pixels (kind "canvas"), recorded whenever it changes
+	Width  int `json:"width,omitempty"`
+	Height int `json:"height,omitempty"`
+
+	// Pointer event on the canvas (kind "pointer"), in canvas coordinates
+	Pointer string  `json:"pointer,omitempty"` // "press", "release", "drag" or "scroll"
+	X       float32 `json:"x,omitempty"`
+	Y       float32 `json:"y,omitempty"`
+	Buttons int     `json:"buttons,omitempty"`
+	ScrollY float32 `json:"scroll_y,omitempty"`
+
+	// Key press or release (kind "key")
+	Key     string `json:"key,omitempty"`
+	Pressed bool   `json:"pressed,omitempty"`
+
+	// Tool switch, texture and polygon selection
+	Tool    string `json:"tool,omitempty"`
+	Texture string `json:"texture,omitempty"`
+	Polygon int    `json:"polygon,omitempty"`
+}
+
+// SessionRecorder writes the input of an editor session to a file
+type SessionRecorder struct {
+	file   *os.File
+	writer *bufio.Writer
+	enc    *json.Encoder
+	frame  int
+	canvas image.Point
+	err    error
+}
+
+// NewSessionRecorder creates (or truncates) a session file
+func NewSessionRecorder(path string) (*SessionRecorder, error) {
+	file, err := os.Create(path)
+	if err != nil {
+		return nil, fmt.Errorf("creating session file: %w", err)
+	}
+	writer := bufio.NewWriter(file)
+	return &SessionRecorder{
+		file:   file,
+		writer: writer,
+		enc:    json.NewEncoder(writer),
+		frame:  -1,
+	}, nil
+}
+
+// Close flushes and closes the session file
+// Returns the first error that occurred while recording
+func (r *SessionRecorder) Close() error {
+	if err := r.writer.Flush(); err != nil && r.err == nil {
+		r.err = fmt.Errorf("writing session file: %w", err)
+	}
+	if err := r.file.Close(); err != nil && r.err == nil {
+		r.err = fmt.Errorf("closing session file: %w", err)
+	}
+	return r.err
+}
+
+// record writes an event in the current frame
+func (r *SessionRecorder) record(ev SessionEvent) {
+	if r.err != nil {
+		return
+	}
+	ev.Frame = max(r.frame, 0)
+	if err := r.enc.Encode(ev); err != nil {
+		r.err = fmt.Errorf("writing session file: %w", err)
+	}
+}
+
+// LoadSession reads a session file written by SessionRecorder
+func LoadSession(path string) ([]SessionEvent, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, fmt.Errorf("opening session file: %w", err)
+	}
+	defer file.Close()
+
+	var events []SessionEvent
+	dec := json.NewDecoder(file)
+	for {
+		var ev SessionEvent
+		if err := dec.Decode(&ev); err == io.EOF {
+			break
+		} else if err != nil {
+			return nil, fmt.Errorf("parsing session file: %w", err)
+		}
+		events = append(events, ev)
+	}
+	return events, nil
+}
+
+// RecordSession makes the editor record all input to the given recorder
+func (e *Editor) RecordSession(r *SessionRecorder) {
+	e.recorder = r
+}
+
+// recordFrame starts a new frame in the session recording
+func (e *Editor) recordFrame() {
+	if e.recorder != nil {
+		e.recorder.frame++
+	}
+}
+
+// recordEvent records an input event, if a session is being recorded
+func (e *Editor) recordEvent(ev SessionEvent) {
+	if e.recorder != nil {
+		e.recorder.record(ev)
+	}
+}
+
+// recordCanvasPointer records a pointer event on the canvas, preceded by the canvas size if it changed
+func (e *Editor) recordCanvasPointer(gtx layout.Context, ev pointer.Event) {
+	if e.recorder == nil {
+		return
+	}
+
+	if e.recorder.canvas != gtx.Constraints.Max {
+		e.recorder.canvas = gtx.Constraints.Max
+		e.recorder.record(SessionEvent{Kind: "canvas", Width: gtx.Constraints.Max.X, Height: gtx.Constraints.Max.Y})
+	}
+
+	var kind string
+	switch ev.Kind {
+	case pointer.Press:
+		kind = "press"
+	case pointer.Release:
+		kind = "release"
+	case pointer.Drag:
+		kind = "drag"
+	case pointer.Scroll:
+		kind = "scroll"
+	default:
+		return
+	}
+	e.recorder.record(SessionEvent{
+		Kind:    "pointer",
+		Pointer: kind,
+		X:       ev.Position.X,
+		Y:       ev.Position.Y,
+		Buttons: int(ev.Buttons),
+		ScrollY: ev.Scroll.Y,
+	})
+}
+
+// timeSection starts timing a named section of a replayed frame
+// Call the returned function at the end of the section
+// Does nothing outside of ReplaySession
+func (e *Editor) timeSection(name string) func() {
+	if e.sectionTimings == nil {
+		return func() {}
+	}
+	start := time.Now()
+	return func() {
+		e.sectionTimings[name] += time.Since(start)
+	}
+}
+
+// SessionTimings are the timings captured while replaying a session
+type SessionTimings struct {
+	Frames   []time.Duration          // Duration of every replayed frame
+	Sections map[string]time.Duration // Total duration per section over all frames
+}
+
+// Percentile returns the frame duration below which p percent (0-100) of the frames fall
+func (t SessionTimings) Percentile(p float64) time.Duration {
+	if len(t.Frames) == 0 {
+		return 0
+	}
+	sorted := append([]time.Duration(nil), t.Frames...)
+	sort.Slice(sorted, func(i, j int) bool { return sorted[i] < sorted[j] })
+	i := int(p / 100 * float64(len(sorted)-1))
+	return sorted[min(max(i, 0), len(sorted)-1)]
+}
+
+// Total returns the sum of all frame durations
+func (t SessionTimings) Total() time.Duration {
+	var total time.Duration
+	for _, d := range t.Frames {
+		total += d
+	}
+	return total
+}
+
+// defaultReplayCanvas is the canvas size used until a session records one
+var defaultReplayCanvas = image.Point{X: 1280, Y: 720}
+
+// ReplaySession replays recorded input against the editor without a window.
+// Every recorded frame applies its input and lays out the canvas into an op list,
+// which is timed as a whole ("input" and the drawing sections are timed separately).
+// Nothing is rendered, so the timings cover the CPU side of the editor only.
+func (e *Editor) ReplaySession(events []SessionEvent) SessionTimings {
+	timings := SessionTimings{Sections: make(map[string]time.Duration)}
+	e.sectionTimings = timings.Sections
+	defer func() { e.sectionTimings = nil }()
+
+	// Replayed input must not end up in a recording
+	recorder := e.recorder
+	e.recorder = nil
+	defer func() { e.recorder = recorder }()
+
+	var ops op.Ops
+	canvas := defaultReplayCanvas
+
+	lastFrame := -1
+	if len(events) > 0 {
+		lastFrame = events[len(events)-1].Frame
+	}
+
+	next := 0
+	for frame := 0; frame <= lastFrame; frame++ {
+		ops.Reset()
+		gtx := layout.Context{
+			Constraints: layout.Exact(canvas),
+			Metric:      unit.Metric{PxPerDp: 1, PxPerSp: 1},
+			Now:         time.Now(),
+			Ops:         &ops,
+		}
+
+		start := time.Now()
+
+		done := e.timeSection("input")
+		for ; next < len(events) && events[next].Frame <= frame; next++ {
+			if size, ok := e.replayEvent(gtx, events[next]); ok {
+				canvas = size
+				gtx.Constraints = layout.Exact(canvas)
+			}
+		}
+		done()
+
+		e.layoutCanvas(gtx)
+
+		timings.Frames = append(timings.Frames, time.Since(start))
+	}
+
+	return timings
+}
+
+// replayEvent applies a recorded event to the editor
+// Returns the new canvas size for canvas events
+func (e *Editor) replayEvent(gtx layout.Context, ev SessionEvent) (image.Point, bool) {
+	switch ev.Kind {
+	case "canvas":
+		return image.Point{X: ev.Width, Y: ev.Height}, true
+
+	case "pointer":
+		pe := pointer.Event{
+			Position: f32.Point{X: ev.X, Y: ev.Y},
+			Buttons:  pointer.Buttons(ev.Buttons),
+			Scroll:   f32.Point{Y: ev.ScrollY},
+		}
+		switch ev.Pointer {
+		case "press":
+			pe.Kind = pointer.Press
+		case "release":
+			pe.Kind = pointer.Release
+		case "drag":
+			pe.Kind = pointer.Drag
+		case "scroll":
+			pe.Kind = pointer.Scroll
+		default:
+			return image.Point{}, false
+		}
+		e.handleCanvasPointer(gtx, pe)
+
+	case "key":
+		e.handleKey(key.Name(ev.Key), ev.Pressed)
+
+	case "tool":
+		e.setTool(ev.Tool)
+
+	case "texture":
+		e.selectTexture(ev.Texture)
+
+	case "select_polygon":
+		if ev.Polygon >= 0 && ev.Polygon < len(e.level.Collisions) {
+			e.selectPolygon(ev.Polygon)
+		}
+
+	case "new_polygon":
+		e.newCollisionPolygon()
+	}
+
+	return image.Point{}, false
+}
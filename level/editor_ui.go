@@ -24,58 +24,25 @@ func (e *Editor) Layout(gtx layout.Context) layout.Dimensions {
 	// Register for global keyboard events
 	event.Op(gtx.Ops, e)
 
-	// Process keyboard events for deletion mode
-	for {
-		ev, ok := gtx.Event(key.Filter{Name: "X"})
-		if !ok {
-			break
-		}
-
-		switch ev := ev.(type) {
-		case key.Event:
-			switch ev.State {
-			case key.Press:
-				e.isDeleting = true
-			case key.Release:
-				e.isDeleting = false
-			}
-		}
-	}
+	// Start a new frame in the session recording (if any)
+	e.recordFrame()
 
-	// Process keyboard events for move mode
+	// Process keyboard events for delete/move/fill modes, brush size and Escape
 	for {
-		ev, ok := gtx.Event(key.Filter{Name: "M"})
-		if !ok {
-			break
-		}
-
-		switch ev := ev.(type) {
-		case key.Event:
-			switch ev.State {
-			case key.Press:
-				e.isMoving = true
-			case key.Release:
-				e.isMoving = false
-				// Stop moving any point when key is released
-				e.movingPointPolygonIndex = -1
-				e.movingPointIndex = -1
-			}
-		}
-	}
-
-	// Process keyboard events for Escape key (unselect polygon)
-	for {
-		ev, ok := gtx.Event(key.Filter{Name: key.NameEscape})
+		ev, ok := gtx.Event(
+			key.Filter{Name: "X"},
+			key.Filter{Name: "M"},
+			key.Filter{Name: "F"},
+			key.Filter{Name: "["},
+			key.Filter{Name: "]"},
+			key.Filter{Name: key.NameEscape},
+		)
 		if !ok {
 			break
 		}
 
-		switch ev := ev.(type) {
-		case key.Event:
-			if ev.State == key.Press {
-				// Unselect the currently selected polygon
-				e.selectedPolygonIndex = -1
-			}
+		if ev, ok := ev.(key.Event); ok {
+			e.handleKey(ev.Name, ev.State == key.Press)
 		}
 	}
 
@@ -245,13 +212,11 @@ func (e *Editor) layoutLeftBar(gtx layout.Context) layout.Dimensions {
 							// Handle button clicks
 							if clickable.Clicked(gtx) {
 								if index == 0 {
-									e.currentTool = "ground"
+									e.setTool("ground")
 								} else if index == 1 {
-									e.currentTool = "collision"
+									e.setTool("collision")
 								} else {
-									e.currentTool = "collision_test"
-									// Clear previous test results when switching to collision test tool
-									e.collisionTestPoints = []collisionTestResult{}
+									e.setTool("collision_test")
 								}
 							}
 
@@ -427,7 +392,7 @@ func (e *Editor) layoutRightBar(gtx layout.Context) layout.Dimensions {
 						return layout.UniformInset(unit.Dp(8)).Layout(gtx, func(gtx layout.Context) layout.Dimensions {
 							// Handle button clicks
 							if e.collisionButtons[index].Clicked(gtx) {
-								e.selectedPolygonIndex = index
+								e.selectPolygon(index)
 							}
 
 							polygonName := fmt.Sprintf("Polygon %d", index+1)
@@ -452,17 +417,7 @@ func (e *Editor) layoutRightBar(gtx layout.Context) layout.Dimensions {
 					return layout.UniformInset(unit.Dp(8)).Layout(gtx, func(gtx layout.Context) layout.Dimensions {
 						// Handle button click
 						if e.newPolygonButton.Clicked(gtx) {
-							// Create a new empty polygon
-							newPolygon := Polygon{
-								Outline: make([]Vec2, 0),
-							}
-							e.level.Collisions = append(e.level.Collisions, newPolygon)
-							// Select the newly created polygon
-							e.selectedPolygonIndex = len(e.level.Collisions) - 1
-							// Mark as dirty
-							e.dirty = true
-							e.markCollisionBSPDirty() // Mark BSP as needing rebuild
-							log.Printf("Created new polygon at index %d", e.selectedPolygonIndex)
+							e.newCollisionPolygon()
 						}
 
 						// Create button with blue background
@@ -477,3 +432,72 @@ func (e *Editor) layoutRightBar(gtx layout.Context) layout.Dimensions {
 		},
 	)
 }
+
+// handleKey applies a key press or release to the editor state
+func (e *Editor) handleKey(name key.Name, pressed bool) {
+	e.recordEvent(SessionEvent{Kind: "key", Key: string(name), Pressed: pressed})
+
+	switch name {
+	case "X":
+		e.isDeleting = pressed
+	case "M":
+		e.isMoving = pressed
+		if !pressed {
+			// Stop moving any point when key is released
+			e.movingPointPolygonIndex = -1
+			e.movingPointIndex = -1
+		}
+	case "F":
+		e.isFilling = pressed
+	case "[", "]":
+		if pressed {
+			if name == "[" && e.brushRadius > 0 {
+				e.brushRadius--
+			} else if name == "]" && e.brushRadius < maxBrushRadius {
+				e.brushRadius++
+			}
+			log.Printf("Ground brush size: %dx%d", 2*e.brushRadius+1, 2*e.brushRadius+1)
+		}
+	case key.NameEscape:
+		if pressed {
+			// Unselect the currently selected polygon
+			e.selectedPolygonIndex = -1
+		}
+	}
+}
+
+// setTool switches the active tool ("ground", "collision" or "collision_test")
+func (e *Editor) setTool(tool string) {
+	e.recordEvent(SessionEvent{Kind: "tool", Tool: tool})
+
+	e.currentTool = tool
+	if tool == "collision_test" {
+		// Clear previous test results when switching to collision test tool
+		e.collisionTestPoints = []collisionTestResult{}
+	}
+}
+
+// selectPolygon selects the collision polygon at index
+func (e *Editor) selectPolygon(index int) {
+	e.recordEvent(SessionEvent{Kind: "select_polygon", Polygon: index})
+
+	e.selectedPolygonIndex = index
+}
+
+// newCollisionPolygon creates an empty collision polygon and selects it
+func (e *Editor) newCollisionPolygon() {
+	e.recordEvent(SessionEvent{Kind: "new_polygon"})
+
+	// Create a new empty polygon
+	newPolygon := Polygon{
+		Outline: make([]Vec2, 0),
+	}
+	e.level.Collisions = append(e.level.Collisions, newPolygon)
+	// Select the newly created polygon
+	e.selectedPolygonIndex = len(e.level.Collisions) - 1
+	// Mark as dirty
+	e.dirty = true
+	e.markCollisionBSPDirty() // Mark BSP as needing rebuild
+	e.invalidateCollisionDrawCache(-1)
+	log.Printf("Created new polygon at index %d", e.selectedPolygonIndex)
+}
@@ -0,0 +1,39 @@
+package level
+
+import (
+	"strconv"
+
+	"github.com/bloodmagesoftware/venture/bsp"
+)
+
+// FlowFieldInput collects the targets for bsp.BakeFlowFields.
+// Targets are ordered spawns (by name), portals (by index), then flow target markers (by name).
+func (l *Level) FlowFieldInput() bsp.FlowInput {
+	var input bsp.FlowInput
+
+	for _, name := range sortedKeys(l.Spawns) {
+		input.Targets = append(input.Targets, bsp.LOSPoint{Kind: "spawn", Name: name, Position: toPoint(l.Spawns[name].Position)})
+	}
+	for i, portal := range l.Portals {
+		input.Targets = append(input.Targets, bsp.LOSPoint{Kind: "portal", Name: strconv.Itoa(i), Position: toPoint(portal.Position)})
+	}
+	for _, name := range sortedKeys(l.Markers) {
+		if l.Markers[name].FlowTarget {
+			input.Targets = append(input.Targets, bsp.LOSPoint{Kind: "marker", Name: name, Position: toPoint(l.Markers[name].Position)})
+		}
+	}
+
+	points := make([]bsp.Point, len(input.Targets))
+	for i, p := range input.Targets {
+		points[i] = p.Position
+	}
+	input.BoundsMin, input.BoundsMax = l.bounds(points)
+
+	return input
+}
+
+// SectorBounds returns the area the empty space is clustered into sectors in: the ground tiles
+// and the collision outlines
+func (l *Level) SectorBounds() (bsp.Point, bsp.Point) {
+	return l.bounds(nil)
+}
@@ -0,0 +1,31 @@
+package level
+
+import (
+	"testing"
+)
+
+func TestFlowFieldInput(t *testing.T) {
+	lvl := New()
+	lvl.Spawns["west"] = Spawn{Position: Vec2{X: -4, Y: 0}}
+	lvl.Portals = append(lvl.Portals, Portal{Position: Vec2{X: 0, Y: 6}, Level: "cave", Spawn: "entry"})
+	lvl.Markers = map[string]Marker{
+		"chest": {Position: Vec2{X: 0, Y: -3}},
+		"camp":  {Position: Vec2{X: 8, Y: -5}, FlowTarget: true},
+	}
+	lvl.Ground = append(lvl.Ground, Tile{Position: Vec2i{X: 9, Y: 9}})
+
+	input := lvl.FlowFieldInput()
+
+	expected := []string{"spawn:west", "portal:0", "marker:camp"}
+	if len(input.Targets) != len(expected) {
+		t.Fatalf("Expected %d targets, got %d", len(expected), len(input.Targets))
+	}
+	for i, p := range input.Targets {
+		if p.Kind+":"+p.Name != expected[i] {
+			t.Errorf("Target %d: expected %s, got %s:%s", i, expected[i], p.Kind, p.Name)
+		}
+	}
+	if input.BoundsMin.X != -4 || input.BoundsMin.Y != -5 || input.BoundsMax.X != 10 || input.BoundsMax.Y != 10 {
+		t.Errorf("Unexpected bounds %v - %v", input.BoundsMin, input.BoundsMax)
+	}
+}
@@ -0,0 +1,50 @@
+package level
+
+import (
+	"math"
+	"math/rand"
+)
+
+// GenerateLevel creates a synthetic level for benchmarks.
+// The ground is a square of tilesPerSide x tilesPerSide tiles with random textures,
+// the collisions are polygons randomly placed on it.
+// The same seed always generates the same level.
+func GenerateLevel(tilesPerSide, polygons int, textures []string, seed int64) *Level {
+	rng := rand.New(rand.NewSource(seed))
+	lvl := New()
+
+	half := int32(tilesPerSide / 2)
+	lvl.Ground = make([]Tile, 0, tilesPerSide*tilesPerSide)
+	for y := int32(0); y < int32(tilesPerSide); y++ {
+		for x := int32(0); x < int32(tilesPerSide); x++ {
+			tile := Tile{Position: Vec2i{X: x - half, Y: y - half}}
+			if len(textures) > 0 {
+				tile.Texture = textures[rng.Intn(len(textures))]
+			}
+			lvl.Ground = append(lvl.Ground, tile)
+		}
+	}
+
+	// Polygons are convex-ish blobs of 3 to 12 vertices, snapped to the editor grid
+	const snap = 0.125
+	lvl.Collisions = make([]Polygon, 0, polygons)
+	for range polygons {
+		cx := (rng.Float64() - 0.5) * float64(tilesPerSide)
+		cy := (rng.Float64() - 0.5) * float64(tilesPerSide)
+		radius := 0.5 + rng.Float64()*2
+		vertices := 3 + rng.Intn(10)
+
+		outline := make(Outline, 0, vertices)
+		for i := 0; i < vertices; i++ {
+			angle := 2 * math.Pi * float64(i) / float64(vertices)
+			r := radius * (0.75 + rng.Float64()*0.25)
+			outline = append(outline, Vec2{
+				X: float32(math.Round((cx+r*math.Cos(angle))/snap) * snap),
+				Y: float32(math.Round((cy+r*math.Sin(angle))/snap) * snap),
+			})
+		}
+		lvl.Collisions = append(lvl.Collisions, Polygon{Outline: outline})
+	}
+
+	return lvl
+}
@@ -0,0 +1,33 @@
+package level
+
+import (
+	"reflect"
+	"testing"
+)
+
+func TestGenerateLevel(t *testing.T) {
+	textures := []string{"grass.qoi", "rock.qoi"}
+	a := GenerateLevel(32, 20, textures, 1)
+	b := GenerateLevel(32, 20, textures, 1)
+
+	if len(a.Ground) != 32*32 {
+		t.Errorf("Expected %d tiles, got %d", 32*32, len(a.Ground))
+	}
+	if len(a.Collisions) != 20 {
+		t.Errorf("Expected 20 polygons, got %d", len(a.Collisions))
+	}
+	for i, polygon := range a.Collisions {
+		if len(polygon.Outline) < 3 {
+			t.Errorf("Polygon %d has only %d vertices", i, len(polygon.Outline))
+		}
+	}
+
+	// Every cell is covered exactly once
+	if index := NewGroundIndex(a); index.Hidden() != 0 {
+		t.Errorf("Expected unique tile positions, %d tiles share a cell", index.Hidden())
+	}
+
+	if !reflect.DeepEqual(a, b) {
+		t.Error("Expected the same seed to generate the same level")
+	}
+}
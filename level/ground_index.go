@@ -0,0 +1,176 @@
+package level
+
+// maxFloodFillCells limits a single flood fill, so filling open space cannot run away
+const maxFloodFillCells = 1 << 16
+
+// GroundIndex is a grid-keyed index over Level.Ground.
+// It maps every occupied grid cell to the position of its tile in the slice,
+// so looking up, painting and erasing a cell costs the same regardless of level size.
+// All changes to Level.Ground must go through the index to keep both in sync.
+type GroundIndex struct {
+	level  *Level
+	cells  map[Vec2i]int // grid cell -> index into level.Ground
+	hidden int           // tiles dropped while building because a later one covered them
+}
+
+// NewGroundIndex builds the index for the ground tiles of a level.
+// If a cell holds more than one tile, the last one wins, just like it is drawn on top.
+// The tiles it hides are removed from Level.Ground, Hidden reports how many.
+func NewGroundIndex(level *Level) *GroundIndex {
+	g := &GroundIndex{
+		level: level,
+		cells: make(map[Vec2i]int, len(level.Ground)),
+	}
+	// Compact in place, tiles are only ever written at or before the one being read
+	ground := level.Ground[:0]
+	for _, tile := range level.Ground {
+		if i, ok := g.cells[tile.Position]; ok {
+			ground[i] = tile
+			g.hidden++
+			continue
+		}
+		g.cells[tile.Position] = len(ground)
+		ground = append(ground, tile)
+	}
+	level.Ground = ground
+	return g
+}
+
+// Hidden returns the number of tiles NewGroundIndex removed because a later tile in the same cell covered them
+func (g *GroundIndex) Hidden() int {
+	return g.hidden
+}
+
+// At returns the tile at the given grid cell
+func (g *GroundIndex) At(pos Vec2i) (Tile, bool) {
+	i, ok := g.cells[pos]
+	if !ok {
+		return Tile{}, false
+	}
+	return g.level.Ground[i], true
+}
+
+// Set places a tile with the given texture at the grid cell.
+// Returns true if the level changed.
+func (g *GroundIndex) Set(pos Vec2i, texture string) bool {
+	if i, ok := g.cells[pos]; ok {
+		if g.level.Ground[i].Texture == texture {
+			return false
+		}
+		g.level.Ground[i].Texture = texture
+		return true
+	}
+
+	g.cells[pos] = len(g.level.Ground)
+	g.level.Ground = append(g.level.Ground, Tile{Position: pos, Texture: texture})
+	return true
+}
+
+// Delete removes the tile at the grid cell.
+// Returns true if the level changed.
+func (g *GroundIndex) Delete(pos Vec2i) bool {
+	i, ok := g.cells[pos]
+	if !ok {
+		return false
+	}
+
+	// Remove tile by replacing it with the last element and truncating
+	last := len(g.level.Ground) - 1
+	if i != last {
+		g.level.Ground[i] = g.level.Ground[last]
+		g.cells[g.level.Ground[i].Position] = i
+	}
+	g.level.Ground = g.level.Ground[:last]
+	delete(g.cells, pos)
+	return true
+}
+
+// SetBrush places tiles in the square of cells within radius of center (radius 0 is a single cell).
+// Returns true if the level changed.
+func (g *GroundIndex) SetBrush(center Vec2i, radius int32, texture string) bool {
+	changed := false
+	for y := center.Y - radius; y <= center.Y+radius; y++ {
+		for x := center.X - radius; x <= center.X+radius; x++ {
+			if g.Set(Vec2i{X: x, Y: y}, texture) {
+				changed = true
+			}
+		}
+	}
+	return changed
+}
+
+// DeleteBrush removes the tiles in the square of cells within radius of center.
+// Returns true if the level changed.
+func (g *GroundIndex) DeleteBrush(center Vec2i, radius int32) bool {
+	changed := false
+	for y := center.Y - radius; y <= center.Y+radius; y++ {
+		for x := center.X - radius; x <= center.X+radius; x++ {
+			if g.Delete(Vec2i{X: x, Y: y}) {
+				changed = true
+			}
+		}
+	}
+	return changed
+}
+
+// FloodFill replaces the 4-connected region of cells that look like start (same texture,
+// or all empty) with the given texture.
+// Filling empty space is bounded by the bounding box of the existing tiles.
+// Returns true if the level changed.
+func (g *GroundIndex) FloodFill(start Vec2i, texture string) bool {
+	startTile, startOccupied := g.At(start)
+	if startOccupied && startTile.Texture == texture {
+		return false
+	}
+
+	// Empty regions have no natural border, so stay within the existing ground
+	boundsMin, boundsMax := start, start
+	if !startOccupied {
+		if len(g.level.Ground) == 0 {
+			return g.Set(start, texture)
+		}
+		for _, tile := range g.level.Ground {
+			boundsMin.X = min(boundsMin.X, tile.Position.X)
+			boundsMin.Y = min(boundsMin.Y, tile.Position.Y)
+			boundsMax.X = max(boundsMax.X, tile.Position.X)
+			boundsMax.Y = max(boundsMax.Y, tile.Position.Y)
+		}
+	}
+
+	matches := func(pos Vec2i) bool {
+		if !startOccupied && (pos.X < boundsMin.X || pos.X > boundsMax.X || pos.Y < boundsMin.Y || pos.Y > boundsMax.Y) {
+			return false
+		}
+		tile, occupied := g.At(pos)
+		if occupied != startOccupied {
+			return false
+		}
+		return !occupied || tile.Texture == startTile.Texture
+	}
+
+	visited := map[Vec2i]struct{}{start: {}}
+	stack := []Vec2i{start}
+	changed := false
+	for len(stack) > 0 && len(visited) <= maxFloodFillCells {
+		pos := stack[len(stack)-1]
+		stack = stack[:len(stack)-1]
+
+		if g.Set(pos, texture) {
+			changed = true
+		}
+
+		for _, next := range [4]Vec2i{
+			{X: pos.X + 1, Y: pos.Y},
+			{X: pos.X - 1, Y: pos.Y},
+			{X: pos.X, Y: pos.Y + 1},
+			{X: pos.X, Y: pos.Y - 1},
+		} {
+			if _, seen := visited[next]; seen || !matches(next) {
+				continue
+			}
+			visited[next] = struct{}{}
+			stack = append(stack, next)
+		}
+	}
+	return changed
+}
@@ -0,0 +1,132 @@
+package level
+
+import (
+	"testing"
+)
+
+// checkGroundIndex verifies that the index and Level.Ground agree
+func checkGroundIndex(t *testing.T, g *GroundIndex) {
+	t.Helper()
+	if len(g.cells) != len(g.level.Ground) {
+		t.Fatalf("Index has %d cells, level has %d tiles", len(g.cells), len(g.level.Ground))
+	}
+	for i, tile := range g.level.Ground {
+		if g.cells[tile.Position] != i {
+			t.Fatalf("Cell %v points to %d, tile is at %d", tile.Position, g.cells[tile.Position], i)
+		}
+	}
+}
+
+func TestGroundIndex(t *testing.T) {
+	level := New()
+	g := NewGroundIndex(level)
+
+	if !g.SetBrush(Vec2i{X: 0, Y: 0}, 1, "dirt.qoi") {
+		t.Fatal("Expected the brush to change the level")
+	}
+	if len(level.Ground) != 9 {
+		t.Fatalf("Expected a 3x3 brush to place 9 tiles, got %d", len(level.Ground))
+	}
+	checkGroundIndex(t, g)
+
+	if g.Set(Vec2i{X: 1, Y: 1}, "dirt.qoi") {
+		t.Error("Painting the same texture should not change the level")
+	}
+	if !g.Set(Vec2i{X: 1, Y: 1}, "rock.qoi") {
+		t.Error("Painting a new texture should change the level")
+	}
+	if tile, ok := g.At(Vec2i{X: 1, Y: 1}); !ok || tile.Texture != "rock.qoi" {
+		t.Errorf("Expected rock at (1, 1), got %v %v", tile, ok)
+	}
+
+	// Swap-remove moves the last tile, the index has to follow it
+	if !g.Delete(Vec2i{X: -1, Y: -1}) {
+		t.Fatal("Expected the tile to be deleted")
+	}
+	if _, ok := g.At(Vec2i{X: -1, Y: -1}); ok {
+		t.Error("Deleted tile is still indexed")
+	}
+	checkGroundIndex(t, g)
+
+	if g.Delete(Vec2i{X: 5, Y: 5}) {
+		t.Error("Deleting an empty cell should not change the level")
+	}
+
+	g.DeleteBrush(Vec2i{X: 0, Y: 0}, 1)
+	if len(level.Ground) != 0 {
+		t.Errorf("Expected all tiles to be deleted, %d left", len(level.Ground))
+	}
+	checkGroundIndex(t, g)
+}
+
+func TestGroundIndexHiddenTiles(t *testing.T) {
+	level := New()
+	level.Ground = []Tile{
+		{Position: Vec2i{X: 0, Y: 0}, Texture: "dirt.qoi"},
+		{Position: Vec2i{X: 1, Y: 0}, Texture: "dirt.qoi"},
+		{Position: Vec2i{X: 0, Y: 0}, Texture: "rock.qoi"},
+		{Position: Vec2i{X: 0, Y: 0}, Texture: "grass.qoi"},
+	}
+	g := NewGroundIndex(level)
+
+	if g.Hidden() != 2 {
+		t.Errorf("Expected 2 hidden tiles, got %d", g.Hidden())
+	}
+	if len(level.Ground) != 2 {
+		t.Fatalf("Expected the hidden tiles to be removed, got %v", level.Ground)
+	}
+	checkGroundIndex(t, g)
+	if tile, ok := g.At(Vec2i{X: 0, Y: 0}); !ok || tile.Texture != "grass.qoi" {
+		t.Errorf("Expected the last tile to win, got %v %v", tile, ok)
+	}
+
+	// Nothing is left underneath once the visible tile is erased
+	g.Delete(Vec2i{X: 0, Y: 0})
+	if _, ok := g.At(Vec2i{X: 0, Y: 0}); ok {
+		t.Error("Expected the cell to be empty")
+	}
+	checkGroundIndex(t, g)
+}
+
+func TestGroundIndexFloodFill(t *testing.T) {
+	// A ring of rock around a dirt floor
+	level := New()
+	for y := int32(0); y < 5; y++ {
+		for x := int32(0); x < 5; x++ {
+			texture := "dirt.qoi"
+			if x == 0 || y == 0 || x == 4 || y == 4 {
+				texture = "rock.qoi"
+			}
+			level.Ground = append(level.Ground, Tile{Position: Vec2i{X: x, Y: y}, Texture: texture})
+		}
+	}
+	g := NewGroundIndex(level)
+
+	if !g.FloodFill(Vec2i{X: 2, Y: 2}, "grass.qoi") {
+		t.Fatal("Expected the fill to change the level")
+	}
+	grass := 0
+	for _, tile := range level.Ground {
+		if tile.Texture == "grass.qoi" {
+			grass++
+		}
+	}
+	if grass != 9 {
+		t.Errorf("Expected the 3x3 floor to be filled, got %d grass tiles", grass)
+	}
+	if tile, _ := g.At(Vec2i{X: 0, Y: 2}); tile.Texture != "rock.qoi" {
+		t.Error("Fill leaked into the ring")
+	}
+
+	// Filling empty space stays within the existing ground
+	level.Ground = append(level.Ground, Tile{Position: Vec2i{X: 7, Y: 7}, Texture: "rock.qoi"})
+	g = NewGroundIndex(level)
+	g.FloodFill(Vec2i{X: 6, Y: 0}, "water.qoi")
+	if _, ok := g.At(Vec2i{X: 8, Y: 0}); ok {
+		t.Error("Fill of empty space left the ground bounds")
+	}
+	if tile, ok := g.At(Vec2i{X: 7, Y: 0}); !ok || tile.Texture != "water.qoi" {
+		t.Error("Expected empty cells inside the ground bounds to be filled")
+	}
+	checkGroundIndex(t, g)
+}
@@ -0,0 +1,93 @@
+package level
+
+import (
+	"slices"
+	"strconv"
+
+	"github.com/bloodmagesoftware/venture/bsp"
+)
+
+// LineOfSightInput collects the points and obstacles for bsp.BakeLineOfSight.
+// Points are ordered spawns (by name), portals (by index), then markers (by name),
+// so the baked indices are stable as long as the level does not change.
+func (l *Level) LineOfSightInput() bsp.LOSInput {
+	var input bsp.LOSInput
+
+	for _, name := range sortedKeys(l.Spawns) {
+		input.Points = append(input.Points, bsp.LOSPoint{Kind: "spawn", Name: name, Position: toPoint(l.Spawns[name].Position)})
+	}
+	for i, portal := range l.Portals {
+		input.Points = append(input.Points, bsp.LOSPoint{Kind: "portal", Name: strconv.Itoa(i), Position: toPoint(portal.Position)})
+	}
+	for _, name := range sortedKeys(l.Markers) {
+		input.Points = append(input.Points, bsp.LOSPoint{Kind: "marker", Name: name, Position: toPoint(l.Markers[name].Position)})
+	}
+
+	// One vertex per solid outline is enough: an outline that is not entirely
+	// inside an area crosses its boundary, which the bake finds by tracing
+	for _, collision := range l.Collisions {
+		if len(collision.Outline) >= 3 {
+			input.SolidVertices = append(input.SolidVertices, toPoint(collision.Outline[0]))
+		}
+	}
+	prefabs, instances := l.CollisionInstances()
+	for _, inst := range instances {
+		for _, poly := range prefabs[inst.Prefab] {
+			input.SolidVertices = append(input.SolidVertices, inst.Transform.Apply(poly.Vertices[0]))
+		}
+	}
+
+	points := make([]bsp.Point, len(input.Points))
+	for i, p := range input.Points {
+		points[i] = p.Position
+	}
+	input.BoundsMin, input.BoundsMax = l.bounds(points)
+
+	return input
+}
+
+// bounds returns the area covered by the ground (tiles span one unit from their position),
+// the collision outlines and the given points
+func (l *Level) bounds(points []bsp.Point) (bsp.Point, bsp.Point) {
+	var boundsMin, boundsMax bsp.Point
+	first := true
+	extend := func(p bsp.Point) {
+		if first {
+			boundsMin, boundsMax = p, p
+			first = false
+			return
+		}
+		boundsMin.X = min(boundsMin.X, p.X)
+		boundsMin.Y = min(boundsMin.Y, p.Y)
+		boundsMax.X = max(boundsMax.X, p.X)
+		boundsMax.Y = max(boundsMax.Y, p.Y)
+	}
+	for _, tile := range l.Ground {
+		extend(bsp.Point{X: float32(tile.Position.X), Y: float32(tile.Position.Y)})
+		extend(bsp.Point{X: float32(tile.Position.X + 1), Y: float32(tile.Position.Y + 1)})
+	}
+	for _, collision := range l.Collisions {
+		for _, v := range collision.Outline {
+			extend(toPoint(v))
+		}
+	}
+	for _, p := range points {
+		extend(p)
+	}
+	return boundsMin, boundsMax
+}
+
+// toPoint converts a level position to a BSP point
+func toPoint(v Vec2) bsp.Point {
+	return bsp.Point{X: v.X, Y: v.Y}
+}
+
+// sortedKeys returns the keys of a map in ascending order
+func sortedKeys[V any](m map[string]V) []string {
+	keys := make([]string, 0, len(m))
+	for key := range m {
+		keys = append(keys, key)
+	}
+	slices.Sort(keys)
+	return keys
+}
@@ -0,0 +1,34 @@
+package level
+
+import (
+	"testing"
+)
+
+func TestLineOfSightInput(t *testing.T) {
+	lvl := New()
+	lvl.Spawns["west"] = Spawn{Position: Vec2{X: -4, Y: 0}}
+	lvl.Spawns["east"] = Spawn{Position: Vec2{X: 4, Y: 0}}
+	lvl.Portals = append(lvl.Portals, Portal{Position: Vec2{X: 0, Y: 6}, Level: "cave", Spawn: "entry"})
+	lvl.Markers = map[string]Marker{"chest": {Position: Vec2{X: 0, Y: -3}}}
+	lvl.Collisions = append(lvl.Collisions, Polygon{Outline: Outline{{X: -1, Y: -1}, {X: 1, Y: -1}, {X: 1, Y: 1}, {X: -1, Y: 1}}})
+	lvl.Ground = append(lvl.Ground, Tile{Position: Vec2i{X: 9, Y: 9}})
+
+	input := lvl.LineOfSightInput()
+
+	expected := []string{"spawn:east", "spawn:west", "portal:0", "marker:chest"}
+	if len(input.Points) != len(expected) {
+		t.Fatalf("Expected %d points, got %d", len(expected), len(input.Points))
+	}
+	for i, p := range input.Points {
+		if p.Kind+":"+p.Name != expected[i] {
+			t.Errorf("Point %d: expected %s, got %s:%s", i, expected[i], p.Kind, p.Name)
+		}
+	}
+
+	if len(input.SolidVertices) != 1 {
+		t.Errorf("Expected one vertex per solid outline, got %d", len(input.SolidVertices))
+	}
+	if input.BoundsMin.X != -4 || input.BoundsMin.Y != -3 || input.BoundsMax.X != 10 || input.BoundsMax.Y != 10 {
+		t.Errorf("Unexpected bounds %v - %v", input.BoundsMin, input.BoundsMax)
+	}
+}
@@ -3,6 +3,7 @@ package level
 import (
 	"os"
 	"path/filepath"
+	"sort"
 
 	"gopkg.in/yaml.v3"
 )
@@ -23,12 +24,25 @@ type (
 		// Portals is a list of possible teleportation trigger points.
 		// When a player walks near them, they will be teleported to the specified level and spawn point.
 		Portals []Portal `yaml:"portals"`
+		// Markers are named points for gameplay scripts and AI (map key is the marker name).
+		// Line of sight between all spawns, portals and markers is baked into the level.
+		// Crowd flow fields are baked toward all spawns, portals and markers flagged as flow targets.
+		Markers map[string]Marker `yaml:"markers,omitempty"`
+		// Prefabs are reusable collision outlines for objects (map key is the prefab name).
+		// A prefab keyed by a texture path applies to every object using that texture.
+		Prefabs map[string]Prefab `yaml:"prefabs,omitempty"`
 	}
 
 	Spawn struct {
 		Position Vec2 `yaml:"position"`
 	}
 
+	Marker struct {
+		Position Vec2 `yaml:"position"`
+		// FlowTarget bakes a flow field toward the marker, like for every spawn and portal.
+		FlowTarget bool `yaml:"flow_target,omitempty"`
+	}
+
 	Portal struct {
 		// Position is the center of the portal.
 		// This is the position in the level where the player is currently standing in.
@@ -46,6 +60,12 @@ type (
 
 	Outline []Vec2
 
+	Prefab struct {
+		// Collisions are outlines in object space, where (-0.5, -0.5) to (0.5, 0.5) covers the object's size.
+		// They move, rotate and scale with every object that uses the prefab.
+		Collisions []Polygon `yaml:"collisions"`
+	}
+
 	Object struct {
 		// Position is the center of the object.
 		Position Vec2 `yaml:"position"`
@@ -55,6 +75,12 @@ type (
 		// By default, 256px is 1 world unit.
 		Size    Vec2   `yaml:"size"`
 		Texture string `yaml:"texture"`
+		// Layer is the draw layer of the object. Higher layers are drawn on top.
+		// Within a layer, objects are batched by texture.
+		Layer int32 `yaml:"layer,omitempty"`
+		// Prefab is the name of the collision prefab of this object.
+		// If empty, the prefab keyed by the texture path is used (if any).
+		Prefab string `yaml:"prefab,omitempty"`
 	}
 
 	Vec2 struct {
@@ -82,6 +108,35 @@ func New() *Level {
 	}
 }
 
+// PrefabName returns the name of the collision prefab used by the object
+func (o Object) PrefabName() string {
+	if o.Prefab != "" {
+		return o.Prefab
+	}
+	return o.Texture
+}
+
+// TextureReferences returns the textures the level draws (ground tiles and objects),
+// sorted and without duplicates, as paths relative to the assets directory
+func (l *Level) TextureReferences() []string {
+	seen := make(map[string]bool)
+	var textures []string
+	add := func(texture string) {
+		if texture != "" && !seen[texture] {
+			seen[texture] = true
+			textures = append(textures, texture)
+		}
+	}
+	for _, tile := range l.Ground {
+		add(tile.Texture)
+	}
+	for _, obj := range l.Objects {
+		add(obj.Texture)
+	}
+	sort.Strings(textures)
+	return textures
+}
+
 func (l *Level) Save(path string) error {
 	_ = os.MkdirAll(filepath.Dir(path), 0755)
 
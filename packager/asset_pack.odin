@@ -0,0 +1,135 @@
+// Reader for the asset packs written by venture build --pack-assets
+// Generated by venture, do not edit
+package asset_pack
+
+import "core:bytes"
+import "core:compress/zlib"
+import "core:encoding/endian"
+import "core:os"
+
+MAGIC :: "VPAK"
+VERSION :: 1
+HEADER_SIZE :: 32
+INDEX_ENTRY_SIZE :: 40
+FLAG_COMPRESSED :: 1
+
+Entry :: struct {
+	hash:        u64,
+	offset:      i64, // Offset of the stored bytes from the start of the pack
+	size:        i64, // Size once decompressed
+	stored_size: i64, // Size of the bytes in the pack
+	name_offset: u32,
+	name_len:    u16,
+	flags:       u16,
+}
+
+Pack :: struct {
+	fd:      os.Handle,
+	entries: []Entry, // Sorted by hash
+	names:   []u8,
+	index:   []u8,
+}
+
+// Same FNV-1a hash the packer keys the index with
+path_hash :: proc(path: string) -> u64 {
+	h: u64 = 0xcbf29ce484222325
+	for i in 0 ..< len(path) {
+		h ~= u64(path[i])
+		h *= 0x100000001b3
+	}
+	return h
+}
+
+// Opens a pack and reads its header and index, the only reads besides the entries themselves
+open :: proc(path: string, allocator := context.allocator) -> (pack: Pack, ok: bool) {
+	fd, err := os.open(path)
+	if err != nil {
+		return {}, false
+	}
+	defer if !ok {
+		os.close(fd)
+	}
+
+	header: [HEADER_SIZE]u8
+	if n, read_err := os.read_at(fd, header[:], 0); read_err != nil || n != HEADER_SIZE {
+		return {}, false
+	}
+	if string(header[:4]) != MAGIC || endian.unchecked_get_u32le(header[4:]) != VERSION {
+		return {}, false
+	}
+	count := int(endian.unchecked_get_u32le(header[8:]))
+	index_offset := i64(endian.unchecked_get_u64le(header[16:]))
+	names_size := int(endian.unchecked_get_u64le(header[24:]))
+
+	index := make([]u8, count * INDEX_ENTRY_SIZE + names_size, allocator)
+	if n, read_err := os.read_at(fd, index, index_offset); read_err != nil || n != len(index) {
+		delete(index, allocator)
+		return {}, false
+	}
+	entries := make([]Entry, count, allocator)
+	for &entry, i in entries {
+		record := index[i * INDEX_ENTRY_SIZE:]
+		entry = Entry {
+			hash        = endian.unchecked_get_u64le(record[0:]),
+			offset      = i64(endian.unchecked_get_u64le(record[8:])),
+			size        = i64(endian.unchecked_get_u64le(record[16:])),
+			stored_size = i64(endian.unchecked_get_u64le(record[24:])),
+			name_offset = endian.unchecked_get_u32le(record[32:]),
+			name_len    = endian.unchecked_get_u16le(record[36:]),
+			flags       = endian.unchecked_get_u16le(record[38:]),
+		}
+	}
+	return Pack{fd = fd, entries = entries, names = index[count * INDEX_ENTRY_SIZE:], index = index}, true
+}
+
+close :: proc(pack: ^Pack, allocator := context.allocator) {
+	os.close(pack.fd)
+	delete(pack.entries, allocator)
+	delete(pack.index, allocator)
+	pack^ = {}
+}
+
+// Finds an entry by its slash-separated path relative to the assets directory, with a binary search over the hashes
+// Uncompressed entries can be used in place from a memory-mapped pack at entry.offset
+lookup :: proc(pack: ^Pack, path: string) -> (Entry, bool) {
+	hash := path_hash(path)
+	lo, hi := 0, len(pack.entries)
+	for lo < hi {
+		mid := lo + (hi - lo) / 2
+		if pack.entries[mid].hash < hash {
+			lo = mid + 1
+		} else {
+			hi = mid
+		}
+	}
+	for i := lo; i < len(pack.entries) && pack.entries[i].hash == hash; i += 1 {
+		entry := pack.entries[i]
+		name := pack.names[entry.name_offset:][:entry.name_len]
+		if string(name) == path {
+			return entry, true
+		}
+	}
+	return {}, false
+}
+
+// Reads and decompresses an entry, the caller owns the returned bytes
+read_file :: proc(pack: ^Pack, path: string, allocator := context.allocator) -> (data: []u8, ok: bool) {
+	entry := lookup(pack, path) or_return
+	stored := make([]u8, int(entry.stored_size), allocator)
+	if n, err := os.read_at(pack.fd, stored, entry.offset); err != nil || i64(n) != entry.stored_size {
+		delete(stored, allocator)
+		return nil, false
+	}
+	if entry.flags & FLAG_COMPRESSED == 0 {
+		return stored, true
+	}
+	defer delete(stored, allocator)
+
+	buf: bytes.Buffer
+	bytes.buffer_init_allocator(&buf, 0, int(entry.size), allocator)
+	if err := zlib.inflate(stored, &buf, raw = true, expected_output_size = int(entry.size)); err != nil {
+		bytes.buffer_destroy(&buf)
+		return nil, false
+	}
+	return bytes.buffer_to_bytes(&buf), true
+}
@@ -0,0 +1,112 @@
+// Reader for the compressed levels written by venture build (.pbz files and levels/levels.dict)
+// Generated by venture, do not edit
+package level_reader
+
+import "core:bytes"
+import "core:compress/zlib"
+import "core:encoding/endian"
+import "core:os"
+import "core:thread"
+
+DICTIONARY_PATH :: "levels/levels.dict"
+HEADER_SIZE :: 8
+MAX_DICTIONARY_SIZE :: 32 * 1024
+
+// Same 32-bit FNV-1a hash the build identifies the dictionary with
+dictionary_id :: proc(dict: []u8) -> u32 {
+	h: u32 = 0x811c9dc5
+	for b in dict {
+		h ~= u32(b)
+		h *= 0x01000193
+	}
+	return h
+}
+
+// Decompresses a level, the caller owns the returned bytes
+// Levels are raw DEFLATE with the dictionary as preset history. The inflater has no preset
+// dictionaries, so the dictionary goes in front of the level as a stored block and is cut off again
+decode :: proc(compressed: []u8, dict: []u8, allocator := context.allocator) -> (level: []u8, ok: bool) {
+	if len(compressed) < HEADER_SIZE || len(dict) > MAX_DICTIONARY_SIZE {
+		return nil, false
+	}
+	if endian.unchecked_get_u32le(compressed[0:]) != dictionary_id(dict) {
+		return nil, false
+	}
+	size := int(endian.unchecked_get_u32le(compressed[4:]))
+	stream := compressed[HEADER_SIZE:]
+
+	// Stored block header: BFINAL = 0 and BTYPE = 00 padded to a byte, LEN, NLEN
+	input := make([]u8, 5 + len(dict) + len(stream), allocator)
+	defer delete(input, allocator)
+	endian.unchecked_put_u16le(input[1:], u16(len(dict)))
+	endian.unchecked_put_u16le(input[3:], ~u16(len(dict)))
+	copy(input[5:], dict)
+	copy(input[5 + len(dict):], stream)
+
+	buf: bytes.Buffer
+	bytes.buffer_init_allocator(&buf, 0, len(dict) + size, allocator)
+	if err := zlib.inflate(input, &buf, raw = true, expected_output_size = len(dict) + size); err != nil {
+		bytes.buffer_destroy(&buf)
+		return nil, false
+	}
+	out := bytes.buffer_to_bytes(&buf)
+	if len(out) != len(dict) + size {
+		bytes.buffer_destroy(&buf)
+		return nil, false
+	}
+	copy(out, out[len(dict):])
+	return out[:size], true
+}
+
+// Reads and decompresses a level file, the caller owns the returned bytes
+load :: proc(path: string, dict: []u8, allocator := context.allocator) -> (level: []u8, ok: bool) {
+	compressed := os.read_entire_file(path, allocator) or_return
+	defer delete(compressed, allocator)
+	return decode(compressed, dict, allocator)
+}
+
+Job :: struct {
+	compressed: []u8,
+	dict:       []u8,
+	level:      []u8,
+	ok:         bool,
+}
+
+decode_job :: proc(task: thread.Task) {
+	job := (^Job)(task.data)
+	job.level, job.ok = decode(job.compressed, job.dict, task.allocator)
+}
+
+// Decompresses several levels at once on a pool of worker threads, the caller owns the returned levels
+// The allocator is used from the worker threads, so it has to be thread-safe (the default heap allocator is)
+decode_all :: proc(compressed: [][]u8, dict: []u8, allocator := context.allocator) -> (levels: [][]u8, ok: bool) {
+	jobs := make([]Job, len(compressed), allocator)
+	defer delete(jobs, allocator)
+
+	pool: thread.Pool
+	thread.pool_init(&pool, allocator, max(1, min(os.processor_core_count(), len(compressed))))
+	defer thread.pool_destroy(&pool)
+	for &job, i in jobs {
+		job = Job{compressed = compressed[i], dict = dict}
+		thread.pool_add_task(&pool, allocator, decode_job, &job, i)
+	}
+	thread.pool_start(&pool)
+	thread.pool_finish(&pool)
+
+	levels = make([][]u8, len(jobs), allocator)
+	ok = true
+	for job, i in jobs {
+		levels[i] = job.level
+		if !job.ok {
+			ok = false
+		}
+	}
+	if !ok {
+		for level in levels {
+			delete(level, allocator)
+		}
+		delete(levels, allocator)
+		return nil, false
+	}
+	return levels, true
+}
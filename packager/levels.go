@@ -0,0 +1,258 @@
+package packager
+
+import (
+	"bytes"
+	"compress/flate"
+	"container/heap"
+	_ "embed"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"hash/fnv"
+	"io"
+	"io/fs"
+	"iter"
+	"math"
+	"os"
+	"strings"
+)
+
+const (
+	// LevelDictionaryPath is where the shared level dictionary is shipped (relative to the assets directory)
+	LevelDictionaryPath = "levels/levels.dict"
+	// LevelDictionaryFile is where the trained level dictionary is kept in the project (relative to the root).
+	// It is trained once and checked in, so editing a level does not change the bytes of every other level
+	LevelDictionaryFile = "levels.dict"
+	// CompressedLevelExt replaces the .pb extension of compressed levels
+	CompressedLevelExt = ".pbz"
+
+	// Compressed level header (little endian): dictionary id u32, level size u32, followed by raw DEFLATE
+	levelHeaderSize = 8
+
+	// DEFLATE can only reference the last 32 KiB, so a larger dictionary is never used
+	levelDictionaryMaxSize = 32 * 1024
+	// Length of the byte sequences that are counted across levels
+	levelDictionaryGramSize = 8
+	// Length of the chunks of level data the dictionary is assembled from
+	levelDictionarySegmentSize = 64
+)
+
+// LevelReaderOdin is the source of the Odin package level_reader, which decompresses levels in the game
+//
+//go:embed level_reader.odin
+var LevelReaderOdin []byte
+
+// CompressLevels compresses every level with the given dictionary.
+// It yields the dictionary first (at LevelDictionaryPath), followed by the compressed levels
+// with their .pb extension replaced by .pbz. Levels are compressed one by one as they arrive.
+func CompressLevels(levels iter.Seq2[string, []byte], dict []byte) iter.Seq2[string, []byte] {
+	return func(yield func(string, []byte) bool) {
+		if !yield(LevelDictionaryPath, dict) {
+			return
+		}
+
+		var count, rawSize, compressedSize int
+		for relPath, protoBytes := range levels {
+			compressed, err := CompressLevel(protoBytes, dict)
+			if err != nil {
+				fmt.Printf("ERROR: compressing level %s: %v\n", relPath, err)
+				return // Stop iteration, build will fail
+			}
+			count++
+			rawSize += len(protoBytes)
+			compressedSize += len(compressed)
+
+			if !yield(strings.TrimSuffix(relPath, ".pb")+CompressedLevelExt, compressed) {
+				return // Consumer requested stop
+			}
+		}
+
+		if count > 0 {
+			fmt.Printf("  Compressed %d level(s): %d -> %d bytes (+%d bytes dictionary)\n",
+				count, rawSize, compressedSize, len(dict))
+		}
+	}
+}
+
+// LevelDictionaryID identifies a dictionary in the header of the levels compressed with it
+// (32-bit FNV-1a of the dictionary bytes)
+func LevelDictionaryID(dict []byte) uint32 {
+	h := fnv.New32a()
+	h.Write(dict)
+	return h.Sum32()
+}
+
+// CompressLevel compresses a serialized level as raw DEFLATE with the given preset dictionary,
+// behind a header with the dictionary id and the size of the level
+func CompressLevel(protoBytes, dict []byte) ([]byte, error) {
+	if uint64(len(protoBytes)) > math.MaxUint32 {
+		return nil, fmt.Errorf("level is %d bytes, compressed levels are limited to 4 GiB", len(protoBytes))
+	}
+	var buf bytes.Buffer
+	var header [levelHeaderSize]byte
+	binary.LittleEndian.PutUint32(header[0:], LevelDictionaryID(dict))
+	binary.LittleEndian.PutUint32(header[4:], uint32(len(protoBytes)))
+	buf.Write(header[:])
+
+	w, err := flate.NewWriterDict(&buf, flate.BestCompression, dict)
+	if err != nil {
+		return nil, fmt.Errorf("creating compressor: %w", err)
+	}
+	if _, err := w.Write(protoBytes); err != nil {
+		return nil, fmt.Errorf("compressing: %w", err)
+	}
+	if err := w.Close(); err != nil {
+		return nil, fmt.Errorf("flushing compressor: %w", err)
+	}
+	return buf.Bytes(), nil
+}
+
+// NewLevelReader returns a streaming reader that decompresses a level written by CompressLevel.
+// The same dictionary that was used for compression must be passed, a different one is an error.
+func NewLevelReader(r io.Reader, dict []byte) (io.ReadCloser, error) {
+	var header [levelHeaderSize]byte
+	if _, err := io.ReadFull(r, header[:]); err != nil {
+		return nil, fmt.Errorf("reading level header: %w", err)
+	}
+	if id := binary.LittleEndian.Uint32(header[0:]); id != LevelDictionaryID(dict) {
+		return nil, fmt.Errorf("level was compressed with dictionary %08x, got %08x", id, LevelDictionaryID(dict))
+	}
+	return flate.NewReaderDict(r, dict), nil
+}
+
+// ReadLevelDictionary reads the project's level dictionary, found is false if there is none yet
+// An empty file counts as none, it was trained from too few levels and is trained again
+func ReadLevelDictionary(path string) (dict []byte, found bool, err error) {
+	dict, err = os.ReadFile(path)
+	if errors.Is(err, fs.ErrNotExist) {
+		return nil, false, nil
+	}
+	if err != nil {
+		return nil, false, fmt.Errorf("reading level dictionary: %w", err)
+	}
+	if len(dict) == 0 {
+		return nil, false, nil
+	}
+	return dict, true, nil
+}
+
+// WriteLevelDictionary trains a dictionary from the levels and writes it to path, so it can be checked in.
+// Training is the only step that needs all levels at once. An empty dictionary is not written.
+func WriteLevelDictionary(path string, levels iter.Seq2[string, []byte]) ([]byte, error) {
+	var samples [][]byte
+	for _, protoBytes := range levels {
+		samples = append(samples, protoBytes)
+	}
+	dict := TrainLevelDictionary(samples)
+	if len(dict) == 0 {
+		// Nothing to share yet (a single level), the next build trains again instead of keeping this
+		if err := os.Remove(path); err != nil && !errors.Is(err, fs.ErrNotExist) {
+			return nil, fmt.Errorf("removing level dictionary: %w", err)
+		}
+		return dict, nil
+	}
+	if err := os.WriteFile(path, dict, 0644); err != nil {
+		return nil, fmt.Errorf("writing level dictionary: %w", err)
+	}
+	return dict, nil
+}
+
+// TrainLevelDictionary builds a preset dictionary from byte sequences that several levels share
+// (texture paths, similar node runs, tile layouts).
+// Returns an empty dictionary if there is nothing to share.
+//
+// Every level is cut into fixed-size segments. A segment scores by how many of its
+// byte sequences also occur in other levels. Segments are picked greedily by score; picking
+// one clears the score of its sequences, so the dictionary does not repeat itself.
+// The best segments are placed at the end of the dictionary, closest to the data,
+// where DEFLATE encodes back-references most cheaply.
+func TrainLevelDictionary(samples [][]byte) []byte {
+	if len(samples) < 2 {
+		return []byte{}
+	}
+
+	// Count in how many levels every sequence occurs
+	frequency := make(map[uint64]int)
+	for _, sample := range samples {
+		seen := make(map[uint64]struct{})
+		for i := 0; i+levelDictionaryGramSize <= len(sample); i++ {
+			gram := binary.LittleEndian.Uint64(sample[i:])
+			if _, ok := seen[gram]; ok {
+				continue
+			}
+			seen[gram] = struct{}{}
+			frequency[gram]++
+		}
+	}
+
+	var candidates dictionarySegments
+	for _, sample := range samples {
+		for start := 0; start+levelDictionarySegmentSize <= len(sample); start += levelDictionarySegmentSize {
+			segment := sample[start : start+levelDictionarySegmentSize]
+			if score := segmentScore(segment, frequency); score > 0 {
+				candidates = append(candidates, dictionarySegment{data: segment, score: score})
+			}
+		}
+	}
+	heap.Init(&candidates)
+
+	var picked [][]byte
+	size := 0
+	for candidates.Len() > 0 && size+levelDictionarySegmentSize <= levelDictionaryMaxSize {
+		best := heap.Pop(&candidates).(dictionarySegment)
+
+		// Scores only drop as segments are picked, so re-score lazily
+		score := segmentScore(best.data, frequency)
+		if score <= 0 {
+			continue
+		}
+		if candidates.Len() > 0 && score < candidates[0].score {
+			best.score = score
+			heap.Push(&candidates, best)
+			continue
+		}
+
+		picked = append(picked, best.data)
+		size += len(best.data)
+		for i := 0; i+levelDictionaryGramSize <= len(best.data); i++ {
+			delete(frequency, binary.LittleEndian.Uint64(best.data[i:]))
+		}
+	}
+
+	dict := make([]byte, 0, size)
+	for i := len(picked) - 1; i >= 0; i-- {
+		dict = append(dict, picked[i]...)
+	}
+	return dict
+}
+
+// segmentScore sums, over all sequences of a segment, the number of other levels that share it
+func segmentScore(segment []byte, frequency map[uint64]int) int {
+	score := 0
+	for i := 0; i+levelDictionaryGramSize <= len(segment); i++ {
+		if n := frequency[binary.LittleEndian.Uint64(segment[i:])]; n > 1 {
+			score += n - 1
+		}
+	}
+	return score
+}
+
+type dictionarySegment struct {
+	data  []byte
+	score int
+}
+
+// dictionarySegments is a max-heap of segments by score
+type dictionarySegments []dictionarySegment
+
+func (s dictionarySegments) Len() int           { return len(s) }
+func (s dictionarySegments) Less(i, j int) bool { return s[i].score > s[j].score }
+func (s dictionarySegments) Swap(i, j int)      { s[i], s[j] = s[j], s[i] }
+func (s *dictionarySegments) Push(x any)        { *s = append(*s, x.(dictionarySegment)) }
+func (s *dictionarySegments) Pop() any {
+	old := *s
+	n := len(old)
+	x := old[n-1]
+	*s = old[:n-1]
+	return x
+}
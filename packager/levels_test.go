@@ -0,0 +1,162 @@
+package packager
+
+import (
+	"bytes"
+	"compress/flate"
+	"fmt"
+	"io"
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+// testLevel builds a level-like blob with shared texture paths and a level-specific part
+func testLevel(seed int) []byte {
+	var buf bytes.Buffer
+	for i := 0; i < 200; i++ {
+		fmt.Fprintf(&buf, "assets/Dirt_%02d-256x256.qoi", i%5)
+		buf.Write([]byte{byte(i), byte(i >> 8), byte(seed)})
+	}
+	for i := 0; i < 500; i++ {
+		buf.WriteByte(byte(i*seed + i*i))
+	}
+	return buf.Bytes()
+}
+
+func TestLevelCompressionRoundTrip(t *testing.T) {
+	var samples [][]byte
+	for seed := 1; seed <= 8; seed++ {
+		samples = append(samples, testLevel(seed))
+	}
+
+	dict := TrainLevelDictionary(samples)
+	if len(dict) == 0 {
+		t.Fatal("Expected a dictionary from levels that share content")
+	}
+	if len(dict) > levelDictionaryMaxSize {
+		t.Errorf("Dictionary is %d bytes, max is %d", len(dict), levelDictionaryMaxSize)
+	}
+
+	withDict, withoutDict := 0, 0
+	for i, sample := range samples {
+		compressed, err := CompressLevel(sample, dict)
+		if err != nil {
+			t.Fatalf("Compressing level %d: %v", i, err)
+		}
+		plain, err := CompressLevel(sample, nil)
+		if err != nil {
+			t.Fatalf("Compressing level %d without dictionary: %v", i, err)
+		}
+		withDict += len(compressed)
+		withoutDict += len(plain)
+
+		r, err := NewLevelReader(bytes.NewReader(compressed), dict)
+		if err != nil {
+			t.Fatalf("Opening level %d: %v", i, err)
+		}
+		decompressed, err := io.ReadAll(r)
+		r.Close()
+		if err != nil {
+			t.Fatalf("Decompressing level %d: %v", i, err)
+		}
+		if !bytes.Equal(decompressed, sample) {
+			t.Errorf("Level %d does not survive the round trip", i)
+		}
+	}
+
+	if withDict >= withoutDict {
+		t.Errorf("Dictionary did not help: %d bytes with, %d bytes without", withDict, withoutDict)
+	}
+
+	t.Run("Wrong dictionary", func(t *testing.T) {
+		compressed, err := CompressLevel(samples[0], dict)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if _, err := NewLevelReader(bytes.NewReader(compressed), dict[1:]); err == nil {
+			t.Error("Expected an error for a different dictionary")
+		}
+	})
+
+	t.Run("Dictionary as stored block", func(t *testing.T) {
+		// level_reader.odin puts the dictionary in front of the stream as a stored block,
+		// which has to decompress like the preset dictionary
+		compressed, err := CompressLevel(samples[3], dict)
+		if err != nil {
+			t.Fatal(err)
+		}
+		input := []byte{0, byte(len(dict)), byte(len(dict) >> 8), ^byte(len(dict)), ^byte(len(dict) >> 8)}
+		input = append(input, dict...)
+		input = append(input, compressed[levelHeaderSize:]...)
+		decompressed, err := io.ReadAll(flate.NewReader(bytes.NewReader(input)))
+		if err != nil {
+			t.Fatalf("Decompressing: %v", err)
+		}
+		if !bytes.Equal(decompressed[len(dict):], samples[3]) {
+			t.Error("Level does not survive the round trip with the dictionary as stored block")
+		}
+	})
+}
+
+func TestCompressLevels(t *testing.T) {
+	levels := func(yield func(string, []byte) bool) {
+		for seed := 1; seed <= 3; seed++ {
+			if !yield(fmt.Sprintf("levels/level%d.pb", seed), testLevel(seed)) {
+				return
+			}
+		}
+	}
+
+	var paths []string
+	for relPath := range CompressLevels(levels, TrainLevelDictionary(nil)) {
+		paths = append(paths, relPath)
+	}
+
+	want := []string{LevelDictionaryPath, "levels/level1.pbz", "levels/level2.pbz", "levels/level3.pbz"}
+	if fmt.Sprint(paths) != fmt.Sprint(want) {
+		t.Errorf("Expected %v, got %v", want, paths)
+	}
+}
+
+func TestWriteLevelDictionary(t *testing.T) {
+	path := filepath.Join(t.TempDir(), LevelDictionaryFile)
+	levels := func(count int) func(yield func(string, []byte) bool) {
+		return func(yield func(string, []byte) bool) {
+			for seed := 1; seed <= count; seed++ {
+				if !yield(fmt.Sprintf("levels/level%d.pb", seed), testLevel(seed)) {
+					return
+				}
+			}
+		}
+	}
+
+	// A project that starts with one level has nothing to share yet
+	dict, err := WriteLevelDictionary(path, levels(1))
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	if len(dict) != 0 {
+		t.Errorf("Expected an empty dictionary for one level, got %d bytes", len(dict))
+	}
+	if _, found, err := ReadLevelDictionary(path); err != nil || found {
+		t.Errorf("Expected no dictionary to be kept, found=%v err=%v", found, err)
+	}
+
+	// Once there are more levels, the next build trains a real one
+	dict, err = WriteLevelDictionary(path, levels(3))
+	if err != nil {
+		t.Fatalf("Unexpected error: %v", err)
+	}
+	read, found, err := ReadLevelDictionary(path)
+	if err != nil || !found || len(dict) == 0 || !bytes.Equal(read, dict) {
+		t.Errorf("Expected the trained %d byte dictionary to be read back, got %d bytes, found=%v err=%v", len(dict), len(read), found, err)
+	}
+
+	// An empty file from an earlier build counts as missing
+	if err := os.WriteFile(path, nil, 0644); err != nil {
+		t.Fatal(err)
+	}
+	if _, found, err := ReadLevelDictionary(path); err != nil || found {
+		t.Errorf("Expected an empty dictionary file to count as missing, found=%v err=%v", found, err)
+	}
+}
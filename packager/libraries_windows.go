@@ -10,8 +10,12 @@ import (
 	"os"
 	"path/filepath"
 	"strings"
+	"sync"
 )
 
+// dllCacheMu serializes access to the DLL cache, variants are packaged concurrently
+var dllCacheMu sync.Mutex
+
 // DLLInfo contains information about a DLL to download.
 type DLLInfo struct {
 	Name        string // e.g., "SDL3"
@@ -159,18 +163,24 @@ func extractDLLFromZip(archiveData []byte, dllFileName, targetDir string) error
 			}
 			defer rc.Close()
 
-			// Create the target file
-			targetPath := filepath.Join(targetDir, dllFileName)
-			targetFile, err := os.Create(targetPath)
+			// Extract to a temporary file and rename it, so an interrupted download never looks cached
+			targetFile, err := os.CreateTemp(targetDir, dllFileName+".*.tmp")
 			if err != nil {
 				return fmt.Errorf("creating target file: %w", err)
 			}
-			defer targetFile.Close()
+			defer os.Remove(targetFile.Name())
 
 			// Copy the DLL
-			if _, err := io.Copy(targetFile, rc); err != nil {
+			_, err = io.Copy(targetFile, rc)
+			if closeErr := targetFile.Close(); err == nil {
+				err = closeErr
+			}
+			if err != nil {
 				return fmt.Errorf("extracting %s: %w", dllFileName, err)
 			}
+			if err := os.Rename(targetFile.Name(), filepath.Join(targetDir, dllFileName)); err != nil {
+				return fmt.Errorf("moving %s into the cache: %w", dllFileName, err)
+			}
 
 			break
 		}
@@ -184,12 +194,15 @@ func extractDLLFromZip(archiveData []byte, dllFileName, targetDir string) error
 }
 
 // EnsureDLLsDownloaded ensures all required DLLs are downloaded and cached.
-// Returns a map of DLL file names to their cached paths.
+// Returns a map of DLL file names to their cached paths. Concurrent calls wait for each other.
 func EnsureDLLsDownloaded(dlls []DLLInfo) (map[string]string, error) {
 	if len(dlls) == 0 {
 		return make(map[string]string), nil
 	}
 
+	dllCacheMu.Lock()
+	defer dllCacheMu.Unlock()
+
 	fmt.Println("Checking Windows DLL dependencies...")
 
 	cacheDir, err := getCacheDir()
@@ -238,3 +251,12 @@ func CopyDLLsToPackage(dllPaths map[string]string, packageDir string) error {
 
 	return nil
 }
+
+// fetchPlatformLibraries downloads the SDL DLLs into the cache.
+func fetchPlatformLibraries(versions LibraryVersions) error {
+	dlls := GetSDLDLLs(versions.SDL, versions.SDLTTF, versions.SDLImage)
+	if _, err := EnsureDLLsDownloaded(dlls); err != nil {
+		return fmt.Errorf("downloading DLLs: %w", err)
+	}
+	return nil
+}
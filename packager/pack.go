@@ -0,0 +1,382 @@
+package packager
+
+import (
+	"bytes"
+	"compress/flate"
+	_ "embed"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"hash/fnv"
+	"io"
+	"io/fs"
+	"iter"
+	"os"
+	"path/filepath"
+	"sort"
+	"strings"
+)
+
+// Pack file layout (little endian):
+//
+//	header  magic "VPAK", version u32, entry count u32, alignment u32, index offset u64, names size u64
+//	data    entries, each starting at a multiple of the alignment
+//	index   entry count records sorted by path hash, then path:
+//	        hash u64, offset u64, size u64, stored size u64, name offset u32, name length u16, flags u16
+//	names   all paths back to back
+//
+// The header and the index are all a reader needs to resolve a path, with a binary search over the hashes.
+// Stored entries can be used in place from a memory-mapped pack, compressed ones are raw DEFLATE.
+const (
+	// AssetPackName is the file name of the asset pack next to the binary
+	AssetPackName = "assets.pak"
+	// PackAlignment is the alignment of every entry, so stored entries are cache line aligned in a mapped pack
+	PackAlignment = 64
+
+	packMagic          = "VPAK"
+	packVersion        = 1
+	packHeaderSize     = 32
+	packIndexEntrySize = 40
+	// Compressed entries must save at least an eighth, otherwise they stay stored for mmap
+	packMinSavings = 8
+)
+
+// PackFlagCompressed marks an entry that is stored as raw DEFLATE
+const PackFlagCompressed uint16 = 1 << 0
+
+// PackReaderOdin is the source of the Odin package asset_pack, which reads asset packs in the game
+//
+//go:embed asset_pack.odin
+var PackReaderOdin []byte
+
+// precompressedExts are formats that do not shrink any further, so they are stored without trying
+var precompressedExts = map[string]bool{
+	CompressedLevelExt: true,
+	".png":             true,
+	".jpg":             true,
+	".jpeg":            true,
+	".ogg":             true,
+	".mp3":             true,
+	".zip":             true,
+}
+
+// PackEntry describes where an entry lives in a pack
+type PackEntry struct {
+	Path       string
+	Offset     int64 // Offset of the stored bytes from the start of the pack
+	Size       int64 // Size of the entry once decompressed
+	StoredSize int64 // Size of the bytes in the pack
+	Flags      uint16
+}
+
+// Compressed returns true if the entry is stored as raw DEFLATE
+func (e PackEntry) Compressed() bool {
+	return e.Flags&PackFlagCompressed != 0
+}
+
+// PackStats summarizes a written pack
+type PackStats struct {
+	Entries    int
+	Compressed int
+	Size       int64 // Size of all entries once decompressed
+	StoredSize int64 // Size of the pack file
+}
+
+// PackPathHash is the 64-bit FNV-1a hash of a slash-separated path, the key of the pack index
+func PackPathHash(path string) uint64 {
+	h := fnv.New64a()
+	h.Write([]byte(path))
+	return h.Sum64()
+}
+
+// WritePack writes every file into a pack, compressing the entries that shrink enough.
+// Files are streamed into the pack one by one, only the index is kept in memory;
+// the header is written last, which is why the pack needs to be seekable.
+// Paths are slash-separated and relative to the assets directory, duplicates are an error.
+func WritePack(w io.WriteSeeker, files iter.Seq2[string, []byte]) (PackStats, error) {
+	var stats PackStats
+	if _, err := w.Write(make([]byte, packHeaderSize)); err != nil {
+		return stats, fmt.Errorf("writing pack header: %w", err)
+	}
+	offset := int64(packHeaderSize)
+
+	pad := func(alignment int64) error {
+		if rem := offset % alignment; rem != 0 {
+			if _, err := w.Write(make([]byte, alignment-rem)); err != nil {
+				return err
+			}
+			offset += alignment - rem
+		}
+		return nil
+	}
+
+	var entries []PackEntry
+	seen := make(map[string]bool)
+	for relPath, data := range files {
+		relPath = filepath.ToSlash(relPath)
+		if seen[relPath] {
+			return stats, fmt.Errorf("duplicate pack entry %s", relPath)
+		}
+		seen[relPath] = true
+		if len(relPath) > 0xFFFF {
+			return stats, fmt.Errorf("pack entry path too long: %s", relPath[:64])
+		}
+
+		stored, flags, err := packEntryData(relPath, data)
+		if err != nil {
+			return stats, fmt.Errorf("compressing %s: %w", relPath, err)
+		}
+		if err := pad(PackAlignment); err != nil {
+			return stats, fmt.Errorf("writing pack: %w", err)
+		}
+		if _, err := w.Write(stored); err != nil {
+			return stats, fmt.Errorf("writing %s: %w", relPath, err)
+		}
+		entries = append(entries, PackEntry{
+			Path:       relPath,
+			Offset:     offset,
+			Size:       int64(len(data)),
+			StoredSize: int64(len(stored)),
+			Flags:      flags,
+		})
+		offset += int64(len(stored))
+
+		stats.Entries++
+		stats.Size += int64(len(data))
+		if flags&PackFlagCompressed != 0 {
+			stats.Compressed++
+		}
+	}
+
+	// Index sorted by hash, ties broken by path so colliding paths are next to each other
+	sort.Slice(entries, func(i, j int) bool {
+		hi, hj := PackPathHash(entries[i].Path), PackPathHash(entries[j].Path)
+		if hi != hj {
+			return hi < hj
+		}
+		return entries[i].Path < entries[j].Path
+	})
+
+	if err := pad(8); err != nil {
+		return stats, fmt.Errorf("writing pack: %w", err)
+	}
+	indexOffset := offset
+	var index, names bytes.Buffer
+	record := make([]byte, packIndexEntrySize)
+	for _, entry := range entries {
+		binary.LittleEndian.PutUint64(record[0:], PackPathHash(entry.Path))
+		binary.LittleEndian.PutUint64(record[8:], uint64(entry.Offset))
+		binary.LittleEndian.PutUint64(record[16:], uint64(entry.Size))
+		binary.LittleEndian.PutUint64(record[24:], uint64(entry.StoredSize))
+		binary.LittleEndian.PutUint32(record[32:], uint32(names.Len()))
+		binary.LittleEndian.PutUint16(record[36:], uint16(len(entry.Path)))
+		binary.LittleEndian.PutUint16(record[38:], entry.Flags)
+		index.Write(record)
+		names.WriteString(entry.Path)
+	}
+	if int64(names.Len()) > 0xFFFFFFFF {
+		return stats, fmt.Errorf("pack paths exceed 4 GiB")
+	}
+	if _, err := w.Write(index.Bytes()); err != nil {
+		return stats, fmt.Errorf("writing pack index: %w", err)
+	}
+	if _, err := w.Write(names.Bytes()); err != nil {
+		return stats, fmt.Errorf("writing pack paths: %w", err)
+	}
+	stats.StoredSize = offset + int64(index.Len()+names.Len())
+
+	header := make([]byte, packHeaderSize)
+	copy(header, packMagic)
+	binary.LittleEndian.PutUint32(header[4:], packVersion)
+	binary.LittleEndian.PutUint32(header[8:], uint32(len(entries)))
+	binary.LittleEndian.PutUint32(header[12:], PackAlignment)
+	binary.LittleEndian.PutUint64(header[16:], uint64(indexOffset))
+	binary.LittleEndian.PutUint64(header[24:], uint64(names.Len()))
+	if _, err := w.Seek(0, io.SeekStart); err != nil {
+		return stats, fmt.Errorf("seeking to pack header: %w", err)
+	}
+	if _, err := w.Write(header); err != nil {
+		return stats, fmt.Errorf("writing pack header: %w", err)
+	}
+	if _, err := w.Seek(stats.StoredSize, io.SeekStart); err != nil {
+		return stats, fmt.Errorf("seeking to pack end: %w", err)
+	}
+	return stats, nil
+}
+
+// packEntryData returns the bytes to store for an entry and its flags
+func packEntryData(relPath string, data []byte) ([]byte, uint16, error) {
+	if len(data) == 0 || precompressedExts[strings.ToLower(filepath.Ext(relPath))] {
+		return data, 0, nil
+	}
+	var buf bytes.Buffer
+	w, err := flate.NewWriter(&buf, flate.BestCompression)
+	if err != nil {
+		return nil, 0, err
+	}
+	if _, err := w.Write(data); err != nil {
+		return nil, 0, err
+	}
+	if err := w.Close(); err != nil {
+		return nil, 0, err
+	}
+	if buf.Len() > len(data)-len(data)/packMinSavings {
+		return data, 0, nil
+	}
+	return buf.Bytes(), PackFlagCompressed, nil
+}
+
+// Pack reads entries from a pack written by WritePack
+type Pack struct {
+	r       io.ReaderAt
+	hashes  []uint64
+	entries []PackEntry
+}
+
+// OpenPack reads the header and the index of a pack
+func OpenPack(r io.ReaderAt) (*Pack, error) {
+	header := make([]byte, packHeaderSize)
+	if _, err := r.ReadAt(header, 0); err != nil {
+		return nil, fmt.Errorf("reading pack header: %w", err)
+	}
+	if string(header[:4]) != packMagic {
+		return nil, fmt.Errorf("not an asset pack")
+	}
+	if version := binary.LittleEndian.Uint32(header[4:]); version != packVersion {
+		return nil, fmt.Errorf("unsupported asset pack version %d", version)
+	}
+	count := int64(binary.LittleEndian.Uint32(header[8:]))
+	indexOffset := int64(binary.LittleEndian.Uint64(header[16:]))
+	namesSize := int64(binary.LittleEndian.Uint64(header[24:]))
+
+	// Index and paths are read together
+	index := make([]byte, count*packIndexEntrySize+namesSize)
+	if _, err := r.ReadAt(index, indexOffset); err != nil {
+		return nil, fmt.Errorf("reading pack index: %w", err)
+	}
+	names := index[count*packIndexEntrySize:]
+
+	p := &Pack{r: r, hashes: make([]uint64, count), entries: make([]PackEntry, count)}
+	for i := range p.entries {
+		record := index[int64(i)*packIndexEntrySize:]
+		nameOffset := int64(binary.LittleEndian.Uint32(record[32:]))
+		nameLen := int64(binary.LittleEndian.Uint16(record[36:]))
+		if nameOffset+nameLen > namesSize {
+			return nil, fmt.Errorf("pack entry %d has a path outside of the index", i)
+		}
+		p.hashes[i] = binary.LittleEndian.Uint64(record[0:])
+		p.entries[i] = PackEntry{
+			Path:       string(names[nameOffset : nameOffset+nameLen]),
+			Offset:     int64(binary.LittleEndian.Uint64(record[8:])),
+			Size:       int64(binary.LittleEndian.Uint64(record[16:])),
+			StoredSize: int64(binary.LittleEndian.Uint64(record[24:])),
+			Flags:      binary.LittleEndian.Uint16(record[38:]),
+		}
+	}
+	return p, nil
+}
+
+// Entries returns all entries in index order
+func (p *Pack) Entries() []PackEntry {
+	return p.entries
+}
+
+// Lookup finds an entry by its slash-separated path with a binary search over the path hashes
+func (p *Pack) Lookup(relPath string) (PackEntry, bool) {
+	hash := PackPathHash(relPath)
+	for i := sort.Search(len(p.hashes), func(i int) bool { return p.hashes[i] >= hash }); i < len(p.hashes) && p.hashes[i] == hash; i++ {
+		if p.entries[i].Path == relPath {
+			return p.entries[i], true
+		}
+	}
+	return PackEntry{}, false
+}
+
+// ReadFile returns the decompressed contents of an entry
+// Returns an error wrapping fs.ErrNotExist if the pack has no such entry
+func (p *Pack) ReadFile(relPath string) ([]byte, error) {
+	entry, ok := p.Lookup(relPath)
+	if !ok {
+		return nil, fmt.Errorf("%s: %w", relPath, fs.ErrNotExist)
+	}
+	stored := make([]byte, entry.StoredSize)
+	if _, err := p.r.ReadAt(stored, entry.Offset); err != nil {
+		return nil, fmt.Errorf("reading %s: %w", relPath, err)
+	}
+	if !entry.Compressed() {
+		return stored, nil
+	}
+	r := flate.NewReader(bytes.NewReader(stored))
+	defer r.Close()
+	data := make([]byte, entry.Size)
+	if _, err := io.ReadFull(r, data); err != nil {
+		return nil, fmt.Errorf("decompressing %s: %w", relPath, err)
+	}
+	return data, nil
+}
+
+// writeAssetPack packs the compiled levels and the shipped assets (without the YAML level sources) into one file at packPath
+// Levels come first and replace asset files with the same path, like they overwrite them in a loose assets directory
+func writeAssetPack(config PackageConfig, packPath string) error {
+	f, err := os.Create(packPath)
+	if err != nil {
+		return fmt.Errorf("creating asset pack: %w", err)
+	}
+	defer f.Close()
+
+	var walkErr error
+	files := func(yield func(string, []byte) bool) {
+		packed := make(map[string]bool)
+		if config.LevelIterator != nil {
+			for relPath, data := range config.LevelIterator {
+				packed[filepath.ToSlash(relPath)] = true
+				if !yield(relPath, data) {
+					return
+				}
+			}
+		}
+
+		walkErr = filepath.Walk(config.AssetsDir, func(path string, info os.FileInfo, err error) error {
+			if err != nil {
+				return err
+			}
+			if info.IsDir() || info.Name() == ".DS_Store" || strings.HasPrefix(info.Name(), "._") {
+				return nil
+			}
+			relPath, err := filepath.Rel(config.AssetsDir, path)
+			if err != nil {
+				return err
+			}
+			if strings.HasPrefix(relPath, "levels"+string(filepath.Separator)) && strings.HasSuffix(path, ".yaml") {
+				return nil
+			}
+			if packed[filepath.ToSlash(relPath)] || !config.Assets.Ships(relPath) {
+				return nil
+			}
+			data, err := os.ReadFile(path)
+			if err != nil {
+				return err
+			}
+			if !yield(relPath, data) {
+				return filepath.SkipAll
+			}
+			return nil
+		})
+		if errors.Is(walkErr, fs.ErrNotExist) {
+			walkErr = nil // No assets directory, levels only
+		}
+	}
+	stats, err := WritePack(f, files)
+	if err != nil {
+		return err
+	}
+	if walkErr != nil {
+		return fmt.Errorf("reading assets: %w", walkErr)
+	}
+	if err := f.Close(); err != nil {
+		return fmt.Errorf("closing asset pack: %w", err)
+	}
+	fmt.Printf("  Packed %d asset(s) into %s: %d -> %d bytes (%d compressed)\n",
+		stats.Entries, AssetPackName, stats.Size, stats.StoredSize, stats.Compressed)
+	return nil
+}
@@ -0,0 +1,120 @@
+package packager
+
+import (
+	"bytes"
+	"errors"
+	"io/fs"
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+// testPackFiles are compressible text, incompressible bytes, a compressed level and an empty file
+func testPackFiles() map[string][]byte {
+	noise := make([]byte, 3000)
+	state := uint32(7)
+	for i := range noise {
+		state = state*1664525 + 1013904223
+		noise[i] = byte(state >> 24)
+	}
+	return map[string][]byte{
+		"shaders/sprite.glsl":   bytes.Repeat([]byte("uniform sampler2D tex;\n"), 100),
+		"textures/noise.qoi":    noise,
+		"levels/level1.pbz":     testLevel(1),
+		"levels/levels.dict":    {},
+		"fonts/ui/readme.txt":   []byte("short"),
+		"textures/dirt_256.qoi": bytes.Repeat([]byte{1, 2, 3, 4}, 1000),
+	}
+}
+
+func TestPackRoundTrip(t *testing.T) {
+	files := testPackFiles()
+	packPath := filepath.Join(t.TempDir(), AssetPackName)
+	f, err := os.Create(packPath)
+	if err != nil {
+		t.Fatal(err)
+	}
+	stats, err := WritePack(f, func(yield func(string, []byte) bool) {
+		for relPath, data := range files {
+			if !yield(relPath, data) {
+				return
+			}
+		}
+	})
+	f.Close()
+	if err != nil {
+		t.Fatalf("Writing pack: %v", err)
+	}
+	if stats.Entries != len(files) {
+		t.Errorf("Expected %d entries, got %d", len(files), stats.Entries)
+	}
+
+	f, err = os.Open(packPath)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer f.Close()
+	info, _ := f.Stat()
+	if info.Size() != stats.StoredSize {
+		t.Errorf("Pack file is %d bytes, stats say %d", info.Size(), stats.StoredSize)
+	}
+
+	pack, err := OpenPack(f)
+	if err != nil {
+		t.Fatalf("Opening pack: %v", err)
+	}
+	for relPath, data := range files {
+		entry, ok := pack.Lookup(relPath)
+		if !ok {
+			t.Errorf("%s is missing from the index", relPath)
+			continue
+		}
+		if entry.Offset%PackAlignment != 0 {
+			t.Errorf("%s starts at %d, not aligned to %d", relPath, entry.Offset, PackAlignment)
+		}
+		got, err := pack.ReadFile(relPath)
+		if err != nil {
+			t.Errorf("Reading %s: %v", relPath, err)
+		} else if !bytes.Equal(got, data) {
+			t.Errorf("%s does not survive the round trip", relPath)
+		}
+	}
+
+	// Text is compressed, noise and compressed levels are stored for mmap
+	for relPath, compressed := range map[string]bool{
+		"shaders/sprite.glsl": true,
+		"textures/noise.qoi":  false,
+		"levels/level1.pbz":   false,
+	} {
+		if entry, _ := pack.Lookup(relPath); entry.Compressed() != compressed {
+			t.Errorf("%s: expected compressed=%v", relPath, compressed)
+		}
+	}
+
+	// The index is sorted, so lookups can binary search it
+	for i := 1; i < len(pack.hashes); i++ {
+		if pack.hashes[i-1] > pack.hashes[i] {
+			t.Fatalf("Index is not sorted at entry %d", i)
+		}
+	}
+
+	if _, err := pack.ReadFile("textures/missing.qoi"); !errors.Is(err, fs.ErrNotExist) {
+		t.Errorf("Expected fs.ErrNotExist for a missing entry, got %v", err)
+	}
+}
+
+func TestPackRejectsDuplicates(t *testing.T) {
+	f, err := os.Create(filepath.Join(t.TempDir(), AssetPackName))
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer f.Close()
+	_, err = WritePack(f, func(yield func(string, []byte) bool) {
+		if yield("textures/a.qoi", nil) {
+			yield("textures/a.qoi", nil)
+		}
+	})
+	if err == nil {
+		t.Error("Expected an error for the same path twice")
+	}
+}
@@ -27,8 +27,17 @@ type PackageConfig struct {
 	Libraries       []string                  // Paths to dynamic libraries to include (e.g., Steam)
 	LibraryVersions LibraryVersions           // Versions of SDL libraries to download
 	Target          string                    // Target platform (e.g., "darwin_arm64")
+	Variant         string                    // Platform and configuration appended to the package name, if several are built
 	OutputDir       string                    // Directory to output the package
-	LevelIterator   iter.Seq2[string, []byte] // Iterator yielding (relativePath, protoBytes) for levels
+	LevelIterator   iter.Seq2[string, []byte] // Iterator yielding (relativePath, bytes) for level files
+	PackAssets      bool                      // Ship assets and levels as one assets.pak instead of loose files
+	Assets          *AssetSelection           // Textures to ship, nil ships all of them
+}
+
+// FetchLibraries downloads the libraries the packages bundle into the user cache.
+// Call it once before packaging several variants concurrently, so they don't all download them at once.
+func FetchLibraries(versions LibraryVersions) error {
+	return fetchPlatformLibraries(versions)
 }
 
 // Package creates a distribution package with the binary, assets, and libraries.
@@ -44,6 +53,12 @@ func Package(config PackageConfig) (string, error) {
 		return "", fmt.Errorf("creating output directory: %w", err)
 	}
 
+	if config.Assets != nil {
+		if err := reportUnreferencedAssets(config); err != nil {
+			return "", err
+		}
+	}
+
 	// Platform-specific packaging is implemented in:
 	// - packager_darwin.go (macOS)
 	// - packager_linux.go (Linux)
@@ -52,6 +67,15 @@ func Package(config PackageConfig) (string, error) {
 	return packagePlatform(config)
 }
 
+// distributionName returns the name of the package directory and zip, like game-linux_amd64-steam-release
+func distributionName(config PackageConfig) string {
+	name := fmt.Sprintf("%s-%s", config.BinaryName, config.Target)
+	if config.Variant != "" {
+		name += "-" + config.Variant
+	}
+	return name
+}
+
 // copyFile copies a file from src to dst
 func copyFile(src, dst string) error {
 	sourceFile, err := os.Open(src)
@@ -106,8 +130,9 @@ func copyDir(src, dst string) error {
 	})
 }
 
-// copyDirExcludingLevels recursively copies a directory, excluding YAML level files
-func copyDirExcludingLevels(src, dst string) error {
+// copyDirExcludingLevels recursively copies a directory, excluding YAML level files and
+// the textures the selection does not ship
+func copyDirExcludingLevels(src, dst string, selection *AssetSelection) error {
 	return filepath.Walk(src, func(path string, info os.FileInfo, err error) error {
 		if err != nil {
 			return err
@@ -131,6 +156,9 @@ func copyDirExcludingLevels(src, dst string) error {
 		if relPath == filepath.Join("levels", info.Name()) && strings.HasSuffix(info.Name(), ".yaml") {
 			return nil
 		}
+		if !info.IsDir() && !selection.Ships(relPath) {
+			return nil
+		}
 
 		targetPath := filepath.Join(dst, relPath)
 
@@ -205,6 +233,11 @@ func createZipArchive(sourceDir, zipPath, baseName string) error {
 		header.Name = zipPath
 		header.Method = zip.Deflate
 
+		// Compressed levels and asset packs would only grow when deflated again
+		if strings.HasSuffix(info.Name(), CompressedLevelExt) || info.Name() == AssetPackName {
+			header.Method = zip.Store
+		}
+
 		// Preserve executable permissions
 		if info.Mode()&0111 != 0 {
 			header.SetMode(0755)
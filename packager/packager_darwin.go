@@ -18,7 +18,7 @@ func packagePlatform(config PackageConfig) (string, error) {
 	}
 
 	// Create temporary directory for packaging (outside of build dir)
-	packageName := fmt.Sprintf("%s-%s", config.BinaryName, config.Target)
+	packageName := distributionName(config)
 	tempDir, err := os.MkdirTemp("", packageName+"-*")
 	if err != nil {
 		return "", fmt.Errorf("creating temporary directory: %w", err)
@@ -45,17 +45,24 @@ func packagePlatform(config PackageConfig) (string, error) {
 	}
 	fmt.Printf("  Copied binary to %s\n", targetBinary)
 
+	// Pack assets and levels into one file next to the binary, if requested
+	if config.PackAssets {
+		if err := writeAssetPack(config, filepath.Join(packageDir, AssetPackName)); err != nil {
+			return "", fmt.Errorf("packing assets: %w", err)
+		}
+	}
+
 	// Copy assets to package directory (excluding YAML level files)
-	if _, err := os.Stat(config.AssetsDir); err == nil {
+	if _, err := os.Stat(config.AssetsDir); err == nil && !config.PackAssets {
 		assetsTarget := filepath.Join(packageDir, "assets")
-		if err := copyDirExcludingLevels(config.AssetsDir, assetsTarget); err != nil {
+		if err := copyDirExcludingLevels(config.AssetsDir, assetsTarget, config.Assets); err != nil {
 			return "", fmt.Errorf("copying assets: %w", err)
 		}
 		fmt.Printf("  Copied assets (excluding YAML level files)\n")
 	}
 
 	// Write protobuf level files from iterator
-	if config.LevelIterator != nil {
+	if config.LevelIterator != nil && !config.PackAssets {
 		assetsTarget := filepath.Join(packageDir, "assets")
 		levelCount := 0
 		for relPath, protoBytes := range config.LevelIterator {
@@ -125,3 +132,8 @@ func packagePlatform(config PackageConfig) (string, error) {
 	fmt.Printf("\n✅ macOS package created: %s\n", zipPath)
 	return zipPath, nil
 }
+
+// fetchPlatformLibraries has nothing to fetch, dylibbundler bundles the libraries installed on the system.
+func fetchPlatformLibraries(versions LibraryVersions) error {
+	return nil
+}
@@ -48,16 +48,16 @@ func packagePlatform(config PackageConfig) (string, error) {
 	fmt.Printf("  Copied binary to %s\n", targetBinary)
 
 	// Copy assets (excluding YAML level files)
-	if _, err := os.Stat(config.AssetsDir); err == nil {
+	if _, err := os.Stat(config.AssetsDir); err == nil && !config.PackAssets {
 		assetsTarget := filepath.Join(usrShareDir, "assets")
-		if err := copyDirExcludingLevels(config.AssetsDir, assetsTarget); err != nil {
+		if err := copyDirExcludingLevels(config.AssetsDir, assetsTarget, config.Assets); err != nil {
 			return "", fmt.Errorf("copying assets: %w", err)
 		}
 		fmt.Printf("  Copied assets (excluding YAML level files)\n")
 	}
 
 	// Write protobuf level files to AppDir from iterator
-	if config.LevelIterator != nil {
+	if config.LevelIterator != nil && !config.PackAssets {
 		assetsTarget := filepath.Join(usrShareDir, "assets")
 		levelCount := 0
 		for relPath, protoBytes := range config.LevelIterator {
@@ -135,7 +135,7 @@ Terminal=false
 	}
 
 	// Now create the final distribution structure
-	distDirName := fmt.Sprintf("%s-%s", config.BinaryName, config.Target)
+	distDirName := distributionName(config)
 	distDir := filepath.Join(tempDir, distDirName)
 
 	// Create dist directory structure
@@ -192,17 +192,24 @@ Terminal=false
 	}
 	fmt.Printf("  Copied %d libraries to lib/\n", len(libEntries))
 
+	// Pack assets and levels into one file next to the binary, if requested
+	if config.PackAssets {
+		if err := writeAssetPack(config, filepath.Join(distDir, AssetPackName)); err != nil {
+			return "", fmt.Errorf("packing assets: %w", err)
+		}
+	}
+
 	// Copy assets to dist root (excluding YAML level files)
-	if _, err := os.Stat(config.AssetsDir); err == nil {
+	if _, err := os.Stat(config.AssetsDir); err == nil && !config.PackAssets {
 		assetsTarget := filepath.Join(distDir, "assets")
-		if err := copyDirExcludingLevels(config.AssetsDir, assetsTarget); err != nil {
+		if err := copyDirExcludingLevels(config.AssetsDir, assetsTarget, config.Assets); err != nil {
 			return "", fmt.Errorf("copying assets to dist: %w", err)
 		}
 		fmt.Printf("  Copied assets to distribution directory (excluding YAML level files)\n")
 	}
 
 	// Copy protobuf level files from AppDir to dist (they were already written there)
-	if config.LevelIterator != nil {
+	if config.LevelIterator != nil && !config.PackAssets {
 		appDirAssets := filepath.Join(usrShareDir, "assets", "levels")
 		distAssets := filepath.Join(distDir, "assets", "levels")
 
@@ -233,3 +240,8 @@ Terminal=false
 	fmt.Printf("\n✅ Linux package created: %s\n", zipPath)
 	return zipPath, nil
 }
+
+// fetchPlatformLibraries has nothing to fetch, linuxdeploy bundles the libraries installed on the system.
+func fetchPlatformLibraries(versions LibraryVersions) error {
+	return nil
+}
@@ -23,7 +23,7 @@ func packagePlatform(config PackageConfig) (string, error) {
 	}
 
 	// Create temporary directory for packaging (outside of build dir)
-	packageName := fmt.Sprintf("%s-%s", config.BinaryName, config.Target)
+	packageName := distributionName(config)
 	tempDir, err := os.MkdirTemp("", packageName+"-*")
 	if err != nil {
 		return "", fmt.Errorf("creating temporary directory: %w", err)
@@ -44,17 +44,24 @@ func packagePlatform(config PackageConfig) (string, error) {
 	}
 	fmt.Printf("  Copied binary: %s\n", filepath.Base(targetBinary))
 
+	// Pack assets and levels into one file next to the binary, if requested
+	if config.PackAssets {
+		if err := writeAssetPack(config, filepath.Join(packageDir, AssetPackName)); err != nil {
+			return "", fmt.Errorf("packing assets: %w", err)
+		}
+	}
+
 	// Copy assets to package directory (excluding YAML level files)
-	if _, err := os.Stat(config.AssetsDir); err == nil {
+	if _, err := os.Stat(config.AssetsDir); err == nil && !config.PackAssets {
 		assetsTarget := filepath.Join(packageDir, "assets")
-		if err := copyDirExcludingLevels(config.AssetsDir, assetsTarget); err != nil {
+		if err := copyDirExcludingLevels(config.AssetsDir, assetsTarget, config.Assets); err != nil {
 			return "", fmt.Errorf("copying assets: %w", err)
 		}
 		fmt.Printf("  Copied assets (excluding YAML level files)\n")
 	}
 
 	// Write protobuf level files from iterator
-	if config.LevelIterator != nil {
+	if config.LevelIterator != nil && !config.PackAssets {
 		assetsTarget := filepath.Join(packageDir, "assets")
 		levelCount := 0
 		for relPath, protoBytes := range config.LevelIterator {
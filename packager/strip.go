@@ -0,0 +1,114 @@
+package packager
+
+import (
+	"fmt"
+	"os"
+	"path"
+	"path/filepath"
+	"sort"
+	"strings"
+)
+
+// textureExts are the assets that are only shipped if something references them
+// Everything else (fonts, sounds, shaders, level data) is loaded by code and always shipped
+var textureExts = map[string]bool{
+	".qoi":  true,
+	".png":  true,
+	".jpg":  true,
+	".jpeg": true,
+}
+
+// AssetSelection decides which textures a build ships: those referenced by levels and those on the keep-list
+type AssetSelection struct {
+	referenced map[string]bool
+	keep       []string
+}
+
+// NewAssetSelection creates a selection from the referenced texture paths and keep-list patterns.
+// Paths are relative to the assets directory. A pattern (path.Match syntax, slash-separated) keeps
+// every asset it matches, and everything below a directory it matches.
+func NewAssetSelection(referenced []string, keep []string) (*AssetSelection, error) {
+	s := &AssetSelection{referenced: make(map[string]bool, len(referenced))}
+	for _, relPath := range referenced {
+		s.referenced[path.Clean(filepath.ToSlash(relPath))] = true
+	}
+	for _, pattern := range keep {
+		pattern = path.Clean(filepath.ToSlash(pattern))
+		if _, err := path.Match(pattern, ""); err != nil {
+			return nil, fmt.Errorf("invalid keep pattern %q: %w", pattern, err)
+		}
+		s.keep = append(s.keep, pattern)
+	}
+	return s, nil
+}
+
+// Ships returns true if the asset at relPath is shipped
+// A nil selection ships everything
+func (s *AssetSelection) Ships(relPath string) bool {
+	if s == nil {
+		return true
+	}
+	relPath = filepath.ToSlash(relPath)
+	if !textureExts[strings.ToLower(path.Ext(relPath))] || s.referenced[relPath] {
+		return true
+	}
+	for p := relPath; p != "." && p != "/"; p = path.Dir(p) {
+		for _, pattern := range s.keep {
+			if ok, _ := path.Match(pattern, p); ok {
+				return true
+			}
+		}
+	}
+	return false
+}
+
+// UnreferencedAsset is a texture a build leaves out
+type UnreferencedAsset struct {
+	Path string // Slash-separated, relative to the assets directory
+	Size int64
+}
+
+// UnreferencedAssets lists the files in assetsDir that the selection does not ship, sorted by path
+func UnreferencedAssets(assetsDir string, selection *AssetSelection) ([]UnreferencedAsset, error) {
+	var unreferenced []UnreferencedAsset
+	err := filepath.Walk(assetsDir, func(filePath string, info os.FileInfo, err error) error {
+		if err != nil {
+			return err
+		}
+		if info.IsDir() {
+			return nil
+		}
+		relPath, err := filepath.Rel(assetsDir, filePath)
+		if err != nil {
+			return err
+		}
+		if !selection.Ships(relPath) {
+			unreferenced = append(unreferenced, UnreferencedAsset{Path: filepath.ToSlash(relPath), Size: info.Size()})
+		}
+		return nil
+	})
+	if err != nil && !os.IsNotExist(err) {
+		return nil, fmt.Errorf("listing assets: %w", err)
+	}
+	sort.Slice(unreferenced, func(i, j int) bool { return unreferenced[i].Path < unreferenced[j].Path })
+	return unreferenced, nil
+}
+
+// reportUnreferencedAssets prints the textures left out of the package and how much that saves
+func reportUnreferencedAssets(config PackageConfig) error {
+	unreferenced, err := UnreferencedAssets(config.AssetsDir, config.Assets)
+	if err != nil {
+		return err
+	}
+	if len(unreferenced) == 0 {
+		fmt.Println("  All textures are referenced")
+		return nil
+	}
+	var total int64
+	for _, asset := range unreferenced {
+		fmt.Printf("  Not shipping unreferenced %s (%d bytes)\n", asset.Path, asset.Size)
+		total += asset.Size
+	}
+	fmt.Printf("  Left out %d unreferenced texture(s), %d bytes\n", len(unreferenced), total)
+	return nil
+}
@@ -0,0 +1,79 @@
+package packager
+
+import (
+	"fmt"
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+func TestAssetSelection(t *testing.T) {
+	assetsDir := t.TempDir()
+	files := map[string]int{
+		"tiles/grass.qoi":     10,
+		"tiles/unused.qoi":    20,
+		"objects/crate.png":   30,
+		"objects/old.png":     40,
+		"ui/button.qoi":       50,
+		"ui/icons/heart.qoi":  60,
+		"fonts/main.ttf":      70,
+		"sounds/step.ogg":     80,
+		"levels/level1.yaml":  90,
+		"splash.qoi":          100,
+		"splash_old.qoi":      110,
+		"levels/preview.jpeg": 120,
+	}
+	for relPath, size := range files {
+		full := filepath.Join(assetsDir, filepath.FromSlash(relPath))
+		if err := os.MkdirAll(filepath.Dir(full), 0755); err != nil {
+			t.Fatal(err)
+		}
+		if err := os.WriteFile(full, make([]byte, size), 0644); err != nil {
+			t.Fatal(err)
+		}
+	}
+
+	selection, err := NewAssetSelection(
+		[]string{"tiles/grass.qoi", filepath.Join("objects", "crate.png")},
+		[]string{"ui", "splash.*"},
+	)
+	if err != nil {
+		t.Fatalf("Creating selection: %v", err)
+	}
+
+	unreferenced, err := UnreferencedAssets(assetsDir, selection)
+	if err != nil {
+		t.Fatalf("Listing unreferenced assets: %v", err)
+	}
+	want := []UnreferencedAsset{
+		{Path: "levels/preview.jpeg", Size: 120},
+		{Path: "objects/old.png", Size: 40},
+		{Path: "splash_old.qoi", Size: 110},
+		{Path: "tiles/unused.qoi", Size: 20},
+	}
+	if fmt.Sprint(unreferenced) != fmt.Sprint(want) {
+		t.Errorf("Expected %v, got %v", want, unreferenced)
+	}
+
+	// Only the selection's own textures are stripped, other assets always ship
+	dst := t.TempDir()
+	if err := copyDirExcludingLevels(assetsDir, dst, selection); err != nil {
+		t.Fatalf("Copying assets: %v", err)
+	}
+	for relPath := range files {
+		_, err := os.Stat(filepath.Join(dst, filepath.FromSlash(relPath)))
+		shipped := err == nil
+		expected := selection.Ships(relPath) && filepath.Ext(relPath) != ".yaml"
+		if shipped != expected {
+			t.Errorf("%s: shipped=%v, expected %v", relPath, shipped, expected)
+		}
+	}
+
+	var everything *AssetSelection
+	if !everything.Ships("tiles/unused.qoi") {
+		t.Error("Expected a nil selection to ship everything")
+	}
+	if _, err := NewAssetSelection(nil, []string{"ui/["}); err == nil {
+		t.Error("Expected an error for an invalid keep pattern")
+	}
+}
@@ -0,0 +1,186 @@
+package patch
+
+import (
+	"encoding/binary"
+	"fmt"
+)
+
+const (
+	// deltaBlockSize is the length of the source blocks that matches are found from
+	// Smaller blocks find shorter matches, larger blocks keep the index small
+	deltaBlockSize = 32
+	// deltaMaxCandidates bounds the source blocks compared per hash, for data with many equal blocks
+	deltaMaxCandidates = 8
+	// deltaHashPrime is the base of the rolling hash
+	deltaHashPrime = 16777619
+)
+
+// Delta encodes target as copies from source and inserted bytes
+// Matches are found like rsync does, with a rolling hash over every block of source, so data that
+// moved keeps being copied. A delta is a sequence of operations, each starting with a uvarint:
+//   - length<<1 | 1: copy length bytes from source, at a varint offset from the end of the previous copy
+//   - length<<1: insert the next length bytes
+func Delta(source, target []byte) []byte {
+	index := make(map[uint32][]int32)
+	for start := 0; start+deltaBlockSize <= len(source); start += deltaBlockSize {
+		h := blockHash(source[start : start+deltaBlockSize])
+		if len(index[h]) < deltaMaxCandidates {
+			index[h] = append(index[h], int32(start))
+		}
+	}
+
+	// Multiplier of the byte that leaves the window
+	outFactor := uint32(1)
+	for i := 1; i < deltaBlockSize; i++ {
+		outFactor *= deltaHashPrime
+	}
+
+	var delta []byte
+	literal := 0   // Start of the bytes that have not been encoded yet
+	sourceEnd := 0 // End of the previous copy in source
+	emitInsert := func(data []byte) {
+		if len(data) > 0 {
+			delta = binary.AppendUvarint(delta, uint64(len(data))<<1)
+			delta = append(delta, data...)
+		}
+	}
+
+	i := 0
+	var h uint32
+	if len(target) >= deltaBlockSize {
+		h = blockHash(target[:deltaBlockSize])
+	}
+	for i+deltaBlockSize <= len(target) {
+		bestStart, bestBefore, bestLength := -1, 0, 0
+		for _, candidate := range index[h] {
+			start := int(candidate)
+			length := 0
+			for start+length < len(source) && i+length < len(target) && source[start+length] == target[i+length] {
+				length++
+			}
+			if length < deltaBlockSize {
+				continue
+			}
+			// Matches also grow backwards, into the bytes that would be inserted otherwise
+			before := 0
+			for before < start && before < i-literal && source[start-before-1] == target[i-before-1] {
+				before++
+			}
+			if before+length > bestBefore+bestLength {
+				bestStart, bestBefore, bestLength = start, before, length
+			}
+		}
+
+		if bestStart < 0 {
+			if i+deltaBlockSize < len(target) {
+				h = (h-uint32(target[i])*outFactor)*deltaHashPrime + uint32(target[i+deltaBlockSize])
+			}
+			i++
+			continue
+		}
+
+		emitInsert(target[literal : i-bestBefore])
+		copyStart := bestStart - bestBefore
+		delta = binary.AppendUvarint(delta, uint64(bestBefore+bestLength)<<1|1)
+		delta = binary.AppendVarint(delta, int64(copyStart-sourceEnd))
+		sourceEnd = copyStart + bestBefore + bestLength
+
+		i += bestLength
+		literal = i
+		if i+deltaBlockSize <= len(target) {
+			h = blockHash(target[i : i+deltaBlockSize])
+		}
+	}
+	emitInsert(target[literal:])
+	return delta
+}
+
+// blockHash is the rolling hash of a whole block
+func blockHash(block []byte) uint32 {
+	var h uint32
+	for _, b := range block {
+		h = h*deltaHashPrime + uint32(b)
+	}
+	return h
+}
+
+// deltaOp is a decoded delta operation
+type deltaOp struct {
+	copy   bool
+	offset int    // Source offset of a copy
+	length int    // Number of bytes copied or inserted
+	data   []byte // Inserted bytes
+}
+
+// decodeDelta decodes the operations of a delta and checks them against the source size
+func decodeDelta(delta []byte, sourceSize int) ([]deltaOp, error) {
+	var ops []deltaOp
+	sourceEnd := 0
+	for len(delta) > 0 {
+		header, n := binary.Uvarint(delta)
+		if n <= 0 {
+			return nil, fmt.Errorf("invalid delta operation")
+		}
+		delta = delta[n:]
+		length := int(header >> 1)
+		if length < 0 || uint64(length) != header>>1 {
+			return nil, fmt.Errorf("invalid delta length")
+		}
+
+		if header&1 == 0 {
+			if length > len(delta) {
+				return nil, fmt.Errorf("delta insert of %d bytes is truncated", length)
+			}
+			ops = append(ops, deltaOp{length: length, data: delta[:length]})
+			delta = delta[length:]
+			continue
+		}
+
+		offset, n := binary.Varint(delta)
+		if n <= 0 {
+			return nil, fmt.Errorf("invalid delta copy offset")
+		}
+		delta = delta[n:]
+		start := int64(sourceEnd) + offset
+		if start < 0 || start+int64(length) > int64(sourceSize) {
+			return nil, fmt.Errorf("delta copies %d bytes at %d from a source of %d bytes", length, start, sourceSize)
+		}
+		sourceEnd = int(start) + length
+		ops = append(ops, deltaOp{copy: true, offset: int(start), length: length})
+	}
+	return ops, nil
+}
+
+// ApplyDelta rebuilds the target of a delta from its source
+func ApplyDelta(source, delta []byte) ([]byte, error) {
+	ops, err := decodeDelta(delta, len(source))
+	if err != nil {
+		return nil, err
+	}
+	size := 0
+	for _, op := range ops {
+		size += op.length
+	}
+	target := make([]byte, 0, size)
+	for _, op := range ops {
+		if op.copy {
+			target = append(target, source[op.offset:op.offset+op.length]...)
+		} else {
+			target = append(target, op.data...)
+		}
+	}
+	return target, nil
+}
+
+// inPlace returns true if every copy keeps its bytes where they are, so the delta can be applied
+// by writing only the inserted bytes into the source
+func inPlace(ops []deltaOp) bool {
+	position := 0
+	for _, op := range ops {
+		if op.copy && op.offset != position {
+			return false
+		}
+		position += op.length
+	}
+	return true
+}
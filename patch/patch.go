@@ -0,0 +1,573 @@
+// Package patch creates and applies binary patches between two builds of a game.
+// Files that changed are shipped as deltas, compressed levels as deltas of their decompressed
+// data, so the size of a patch follows the size of the edit instead of the size of the build.
+package patch
+
+import (
+	"archive/zip"
+	"bufio"
+	"bytes"
+	"compress/flate"
+	"crypto/sha256"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
+	"io/fs"
+	"os"
+	"path"
+	"path/filepath"
+	"sort"
+	"strings"
+
+	"github.com/bloodmagesoftware/venture/packager"
+)
+
+const (
+	patchMagic   = "VPCH"
+	patchVersion = 1
+)
+
+// Kinds of patch entries
+const (
+	entryEnd        = 0
+	entryAdd        = 1 // New file, the contents follow
+	entryRemove     = 2 // Removed file
+	entryDelta      = 3 // Changed file, a delta against the old contents follows
+	entryLevelDelta = 4 // Changed compressed level, a delta against the old decompressed level follows
+)
+
+// Stats describes a patch
+type Stats struct {
+	Added     int
+	Removed   int
+	Changed   int
+	Unchanged int
+	InPlace   int   // Changed files that are patched by writing only the changed bytes
+	DeltaSize int64 // Bytes of deltas and new files, before the patch is compressed
+}
+
+// entry is one file of a patch
+type entry struct {
+	kind       byte
+	path       string // Slash-separated, relative to the build root
+	mode       fs.FileMode
+	data       []byte // File contents (add) or delta (delta, level delta)
+	sourceHash [sha256.Size]byte
+	targetHash [sha256.Size]byte
+	dictPath   string // Level dictionary of a level delta
+}
+
+// buildFile is a file of a build, read on demand
+type buildFile struct {
+	mode fs.FileMode
+	read func() ([]byte, error)
+}
+
+// Create writes a patch that turns the old build into the new one
+// Builds are package zips or directories. A zip whose entries share one top-level directory
+// is read from inside that directory, the way it is installed.
+func Create(oldBuild, newBuild string, w io.Writer) (Stats, error) {
+	var stats Stats
+	oldFiles, closeOld, err := openBuild(oldBuild)
+	if err != nil {
+		return stats, err
+	}
+	defer closeOld()
+	newFiles, closeNew, err := openBuild(newBuild)
+	if err != nil {
+		return stats, err
+	}
+	defer closeNew()
+
+	bw := bufio.NewWriter(w)
+	if _, err := bw.WriteString(patchMagic); err != nil {
+		return stats, fmt.Errorf("writing patch header: %w", err)
+	}
+	if err := binary.Write(bw, binary.LittleEndian, uint32(patchVersion)); err != nil {
+		return stats, fmt.Errorf("writing patch header: %w", err)
+	}
+	fw, err := flate.NewWriter(bw, flate.BestCompression)
+	if err != nil {
+		return stats, fmt.Errorf("creating compressor: %w", err)
+	}
+
+	for _, relPath := range sortedPaths(newFiles) {
+		newFile := newFiles[relPath]
+		target, err := newFile.read()
+		if err != nil {
+			return stats, fmt.Errorf("reading new %s: %w", relPath, err)
+		}
+
+		oldFile, existed := oldFiles[relPath]
+		if !existed {
+			stats.Added++
+			stats.DeltaSize += int64(len(target))
+			if err := writeEntry(fw, entry{kind: entryAdd, path: relPath, mode: newFile.mode, data: target}); err != nil {
+				return stats, err
+			}
+			continue
+		}
+		source, err := oldFile.read()
+		if err != nil {
+			return stats, fmt.Errorf("reading old %s: %w", relPath, err)
+		}
+		if bytes.Equal(source, target) && oldFile.mode == newFile.mode {
+			stats.Unchanged++
+			continue
+		}
+
+		e, err := levelDelta(relPath, source, target, oldFiles, newFiles)
+		if err != nil {
+			return stats, err
+		}
+		if e == nil {
+			e = &entry{kind: entryDelta, path: relPath, data: Delta(source, target)}
+			e.sourceHash, e.targetHash = sha256.Sum256(source), sha256.Sum256(target)
+			if ops, err := decodeDelta(e.data, len(source)); err == nil && inPlace(ops) {
+				stats.InPlace++
+			}
+		}
+		e.mode = newFile.mode
+		stats.Changed++
+		stats.DeltaSize += int64(len(e.data))
+		if err := writeEntry(fw, *e); err != nil {
+			return stats, err
+		}
+	}
+
+	for _, relPath := range sortedPaths(oldFiles) {
+		if _, ok := newFiles[relPath]; !ok {
+			stats.Removed++
+			if err := writeEntry(fw, entry{kind: entryRemove, path: relPath}); err != nil {
+				return stats, err
+			}
+		}
+	}
+
+	if err := writeEntry(fw, entry{kind: entryEnd}); err != nil {
+		return stats, err
+	}
+	if err := fw.Close(); err != nil {
+		return stats, fmt.Errorf("compressing patch: %w", err)
+	}
+	if err := bw.Flush(); err != nil {
+		return stats, fmt.Errorf("writing patch: %w", err)
+	}
+	return stats, nil
+}
+
+// levelDelta returns a delta of the decompressed data of a compressed level
+// A small edit changes the compressed bytes from the edit to the end of the level, and a retrained
+// dictionary changes them throughout, so levels are diffed decompressed. Returns nil if relPath is no level.
+func levelDelta(relPath string, source, target []byte, oldFiles, newFiles map[string]buildFile) (*entry, error) {
+	if path.Ext(relPath) != packager.CompressedLevelExt {
+		return nil, nil
+	}
+	dictPath, ok := levelDictionary(relPath, oldFiles)
+	if _, inNew := newFiles[dictPath]; !ok || !inNew {
+		return nil, nil
+	}
+
+	oldLevel, err := decompressLevel(source, oldFiles[dictPath])
+	if err != nil {
+		return nil, fmt.Errorf("decompressing old %s: %w", relPath, err)
+	}
+	newLevel, err := decompressLevel(target, newFiles[dictPath])
+	if err != nil {
+		return nil, fmt.Errorf("decompressing new %s: %w", relPath, err)
+	}
+	e := &entry{kind: entryLevelDelta, path: relPath, data: Delta(oldLevel, newLevel), dictPath: dictPath}
+	e.sourceHash, e.targetHash = sha256.Sum256(oldLevel), sha256.Sum256(newLevel)
+	return e, nil
+}
+
+// levelDictionary finds the dictionary a compressed level was compressed with
+// Levels live below the levels directory of the assets, next to the dictionary
+func levelDictionary(relPath string, files map[string]buildFile) (string, bool) {
+	parts := strings.Split(relPath, "/")
+	for i := len(parts) - 2; i >= 0; i-- {
+		if parts[i] != "levels" {
+			continue
+		}
+		dictPath := path.Join(append(parts[:i:i], packager.LevelDictionaryPath)...)
+		if _, ok := files[dictPath]; ok {
+			return dictPath, true
+		}
+	}
+	return "", false
+}
+
+// decompressLevel decompresses a level with the dictionary file
+func decompressLevel(compressed []byte, dictFile buildFile) ([]byte, error) {
+	dict, err := dictFile.read()
+	if err != nil {
+		return nil, err
+	}
+	r, err := packager.NewLevelReader(bytes.NewReader(compressed), dict)
+	if err != nil {
+		return nil, err
+	}
+	defer r.Close()
+	return io.ReadAll(r)
+}
+
+// Apply patches the build installed in dir
+// Every file is checked against the build the patch was made for before anything is written,
+// so a patch for a different build fails without changing dir. Files whose unchanged bytes stay
+// where they are are patched in place, writing only the changed bytes. Other files are rewritten.
+func Apply(dir string, r io.Reader) (Stats, error) {
+	var stats Stats
+	entries, err := readPatch(r)
+	if err != nil {
+		return stats, err
+	}
+
+	type write struct {
+		entry  entry
+		data   []byte    // New contents
+		ops    []deltaOp // Operations of a file patched in place
+		remove bool
+	}
+	writes := make([]write, 0, len(entries))
+	results := make(map[string][]byte) // New contents of files that change, for level dictionaries
+	readCurrent := func(relPath string) ([]byte, error) {
+		return os.ReadFile(filepath.Join(dir, filepath.FromSlash(relPath)))
+	}
+
+	// Levels last, they are recompressed with the new dictionary
+	sort.SliceStable(entries, func(i, j int) bool {
+		return entries[i].kind != entryLevelDelta && entries[j].kind == entryLevelDelta
+	})
+	for _, e := range entries {
+		switch e.kind {
+		case entryAdd:
+			stats.Added++
+			writes = append(writes, write{entry: e, data: e.data})
+			results[e.path] = e.data
+		case entryRemove:
+			stats.Removed++
+			writes = append(writes, write{entry: e, remove: true})
+		case entryDelta:
+			source, err := readCurrent(e.path)
+			if err != nil {
+				return stats, fmt.Errorf("reading %s: %w", e.path, err)
+			}
+			if sha256.Sum256(source) != e.sourceHash {
+				return stats, fmt.Errorf("%s differs from the build the patch was made for", e.path)
+			}
+			ops, err := decodeDelta(e.data, len(source))
+			if err != nil {
+				return stats, fmt.Errorf("patching %s: %w", e.path, err)
+			}
+			target, _ := ApplyDelta(source, e.data)
+			if sha256.Sum256(target) != e.targetHash {
+				return stats, fmt.Errorf("patching %s: result does not match the new build", e.path)
+			}
+			stats.Changed++
+			results[e.path] = target
+			if inPlace(ops) {
+				stats.InPlace++
+				writes = append(writes, write{entry: e, ops: ops})
+			} else {
+				writes = append(writes, write{entry: e, data: target})
+			}
+		case entryLevelDelta:
+			compressed, err := readCurrent(e.path)
+			if err != nil {
+				return stats, fmt.Errorf("reading %s: %w", e.path, err)
+			}
+			oldDict, err := readCurrent(e.dictPath)
+			if err != nil {
+				return stats, fmt.Errorf("reading %s: %w", e.dictPath, err)
+			}
+			source, err := decompressLevel(compressed, buildFile{read: func() ([]byte, error) { return oldDict, nil }})
+			if err != nil {
+				return stats, fmt.Errorf("decompressing %s: %w", e.path, err)
+			}
+			if sha256.Sum256(source) != e.sourceHash {
+				return stats, fmt.Errorf("%s differs from the build the patch was made for", e.path)
+			}
+			target, err := ApplyDelta(source, e.data)
+			if err != nil {
+				return stats, fmt.Errorf("patching %s: %w", e.path, err)
+			}
+			if sha256.Sum256(target) != e.targetHash {
+				return stats, fmt.Errorf("patching %s: result does not match the new build", e.path)
+			}
+			newDict, changed := results[e.dictPath]
+			if !changed {
+				newDict = oldDict
+			}
+			recompressed, err := packager.CompressLevel(target, newDict)
+			if err != nil {
+				return stats, fmt.Errorf("compressing %s: %w", e.path, err)
+			}
+			stats.Changed++
+			writes = append(writes, write{entry: e, data: recompressed})
+		}
+	}
+
+	for _, w := range writes {
+		fullPath := filepath.Join(dir, filepath.FromSlash(w.entry.path))
+		switch {
+		case w.remove:
+			if err := os.Remove(fullPath); err != nil && !errors.Is(err, fs.ErrNotExist) {
+				return stats, fmt.Errorf("removing %s: %w", w.entry.path, err)
+			}
+		case w.ops != nil:
+			if err := patchInPlace(fullPath, w.ops, w.entry.mode); err != nil {
+				return stats, fmt.Errorf("patching %s: %w", w.entry.path, err)
+			}
+		default:
+			if err := replaceFile(fullPath, w.data, w.entry.mode); err != nil {
+				return stats, fmt.Errorf("writing %s: %w", w.entry.path, err)
+			}
+		}
+	}
+	return stats, nil
+}
+
+// patchInPlace writes the inserted bytes of in-place operations into a file
+func patchInPlace(fullPath string, ops []deltaOp, mode fs.FileMode) error {
+	f, err := os.OpenFile(fullPath, os.O_RDWR, 0)
+	if err != nil {
+		return err
+	}
+	position := int64(0)
+	for _, op := range ops {
+		if !op.copy {
+			if _, err := f.WriteAt(op.data, position); err != nil {
+				f.Close()
+				return err
+			}
+		}
+		position += int64(op.length)
+	}
+	if err := f.Truncate(position); err != nil {
+		f.Close()
+		return err
+	}
+	if err := f.Chmod(mode); err != nil {
+		f.Close()
+		return err
+	}
+	return f.Close()
+}
+
+// replaceFile writes a file next to its destination and renames it into place,
+// so a failed write does not leave a half-written file behind
+func replaceFile(fullPath string, data []byte, mode fs.FileMode) error {
+	if err := os.MkdirAll(filepath.Dir(fullPath), 0755); err != nil {
+		return err
+	}
+	tmp, err := os.CreateTemp(filepath.Dir(fullPath), "."+filepath.Base(fullPath)+".patch*")
+	if err != nil {
+		return err
+	}
+	defer os.Remove(tmp.Name())
+	if _, err := tmp.Write(data); err != nil {
+		tmp.Close()
+		return err
+	}
+	if err := tmp.Chmod(mode); err != nil {
+		tmp.Close()
+		return err
+	}
+	if err := tmp.Close(); err != nil {
+		return err
+	}
+	return os.Rename(tmp.Name(), fullPath)
+}
+
+// openBuild lists the files of a build directory or package zip
+func openBuild(buildPath string) (map[string]buildFile, func(), error) {
+	info, err := os.Stat(buildPath)
+	if err != nil {
+		return nil, nil, fmt.Errorf("opening build: %w", err)
+	}
+
+	files := make(map[string]buildFile)
+	if info.IsDir() {
+		err := filepath.WalkDir(buildPath, func(filePath string, d fs.DirEntry, err error) error {
+			if err != nil || d.IsDir() {
+				return err
+			}
+			relPath, err := filepath.Rel(buildPath, filePath)
+			if err != nil {
+				return err
+			}
+			fileInfo, err := d.Info()
+			if err != nil {
+				return err
+			}
+			files[filepath.ToSlash(relPath)] = buildFile{
+				mode: fileInfo.Mode().Perm(),
+				read: func() ([]byte, error) { return os.ReadFile(filePath) },
+			}
+			return nil
+		})
+		if err != nil {
+			return nil, nil, fmt.Errorf("listing build %s: %w", buildPath, err)
+		}
+		return files, func() {}, nil
+	}
+
+	archive, err := zip.OpenReader(buildPath)
+	if err != nil {
+		return nil, nil, fmt.Errorf("opening build %s: %w", buildPath, err)
+	}
+	prefix := zipRoot(archive.File)
+	for _, f := range archive.File {
+		if strings.HasSuffix(f.Name, "/") {
+			continue
+		}
+		f := f
+		files[strings.TrimPrefix(f.Name, prefix)] = buildFile{
+			mode: f.Mode().Perm(),
+			read: func() ([]byte, error) {
+				r, err := f.Open()
+				if err != nil {
+					return nil, err
+				}
+				defer r.Close()
+				return io.ReadAll(r)
+			},
+		}
+	}
+	return files, func() { archive.Close() }, nil
+}
+
+// zipRoot returns the top-level directory (with a trailing slash) all files of a zip are in,
+// or "" if there is none
+func zipRoot(files []*zip.File) string {
+	root := ""
+	for _, f := range files {
+		dir, _, found := strings.Cut(f.Name, "/")
+		if !found || (root != "" && dir+"/" != root) {
+			return ""
+		}
+		root = dir + "/"
+	}
+	return root
+}
+
+// sortedPaths returns the paths of a build in order
+func sortedPaths(files map[string]buildFile) []string {
+	paths := make([]string, 0, len(files))
+	for relPath := range files {
+		paths = append(paths, relPath)
+	}
+	sort.Strings(paths)
+	return paths
+}
+
+// writeEntry writes one entry of a patch
+func writeEntry(w io.Writer, e entry) error {
+	buf := []byte{e.kind}
+	if e.kind != entryEnd {
+		buf = appendBytes(buf, []byte(e.path))
+		buf = binary.AppendUvarint(buf, uint64(e.mode))
+	}
+	switch e.kind {
+	case entryAdd:
+		buf = appendBytes(buf, e.data)
+	case entryDelta, entryLevelDelta:
+		buf = append(buf, e.sourceHash[:]...)
+		buf = append(buf, e.targetHash[:]...)
+		if e.kind == entryLevelDelta {
+			buf = appendBytes(buf, []byte(e.dictPath))
+		}
+		buf = appendBytes(buf, e.data)
+	}
+	if _, err := w.Write(buf); err != nil {
+		return fmt.Errorf("writing patch entry %s: %w", e.path, err)
+	}
+	return nil
+}
+
+// appendBytes appends a length-prefixed byte string
+func appendBytes(buf, data []byte) []byte {
+	buf = binary.AppendUvarint(buf, uint64(len(data)))
+	return append(buf, data...)
+}
+
+// readPatch reads and checks all entries of a patch
+func readPatch(r io.Reader) ([]entry, error) {
+	header := make([]byte, len(patchMagic)+4)
+	if _, err := io.ReadFull(r, header); err != nil {
+		return nil, fmt.Errorf("reading patch header: %w", err)
+	}
+	if string(header[:len(patchMagic)]) != patchMagic {
+		return nil, fmt.Errorf("not a patch")
+	}
+	if version := binary.LittleEndian.Uint32(header[len(patchMagic):]); version != patchVersion {
+		return nil, fmt.Errorf("unsupported patch version %d", version)
+	}
+
+	br := bufio.NewReader(flate.NewReader(r))
+	readBytes := func() ([]byte, error) {
+		n, err := binary.ReadUvarint(br)
+		if err != nil {
+			return nil, err
+		}
+		data, err := io.ReadAll(io.LimitReader(br, int64(n)))
+		if err == nil && uint64(len(data)) != n {
+			err = io.ErrUnexpectedEOF
+		}
+		return data, err
+	}
+
+	var entries []entry
+	for {
+		kind, err := br.ReadByte()
+		if err != nil {
+			return nil, fmt.Errorf("reading patch: %w", err)
+		}
+		if kind == entryEnd {
+			return entries, nil
+		}
+		if kind > entryLevelDelta {
+			return nil, fmt.Errorf("reading patch: unknown entry kind %d", kind)
+		}
+
+		e := entry{kind: kind}
+		name, err := readBytes()
+		if err != nil {
+			return nil, fmt.Errorf("reading patch: %w", err)
+		}
+		e.path = string(name)
+		if !filepath.IsLocal(filepath.FromSlash(e.path)) {
+			return nil, fmt.Errorf("reading patch: invalid path %q", e.path)
+		}
+		mode, err := binary.ReadUvarint(br)
+		if err != nil {
+			return nil, fmt.Errorf("reading patch: %w", err)
+		}
+		e.mode = fs.FileMode(mode).Perm()
+
+		switch kind {
+		case entryAdd:
+			e.data, err = readBytes()
+		case entryDelta, entryLevelDelta:
+			if _, err = io.ReadFull(br, e.sourceHash[:]); err == nil {
+				_, err = io.ReadFull(br, e.targetHash[:])
+			}
+			if err == nil && kind == entryLevelDelta {
+				var dictPath []byte
+				dictPath, err = readBytes()
+				e.dictPath = string(dictPath)
+				if err == nil && !filepath.IsLocal(filepath.FromSlash(e.dictPath)) {
+					err = fmt.Errorf("invalid dictionary path %q", e.dictPath)
+				}
+			}
+			if err == nil {
+				e.data, err = readBytes()
+			}
+		}
+		if err != nil {
+			return nil, fmt.Errorf("reading patch entry %s: %w", e.path, err)
+		}
+		entries = append(entries, e)
+	}
+}
@@ -0,0 +1,213 @@
+package patch
+
+import (
+	"bytes"
+	"math/rand"
+	"os"
+	"path/filepath"
+	"testing"
+
+	"github.com/bloodmagesoftware/venture/packager"
+)
+
+func randomBytes(rng *rand.Rand, n int) []byte {
+	data := make([]byte, n)
+	rng.Read(data)
+	return data
+}
+
+func TestDelta(t *testing.T) {
+	rng := rand.New(rand.NewSource(1))
+	source := randomBytes(rng, 64*1024)
+
+	t.Run("Edits and moved data", func(t *testing.T) {
+		var target []byte
+		target = append(target, source[:10000]...)
+		target = append(target, randomBytes(rng, 100)...) // Replaced
+		target = append(target, source[10100:30000]...)
+		target = append(target, randomBytes(rng, 10)...) // Inserted
+		target = append(target, source[50000:]...)       // Moved up
+		target = append(target, source[30000:50000]...)
+
+		delta := Delta(source, target)
+		got, err := ApplyDelta(source, delta)
+		if err != nil {
+			t.Fatalf("Applying delta: %v", err)
+		}
+		if !bytes.Equal(got, target) {
+			t.Fatal("Applied delta does not reproduce the target")
+		}
+		if len(delta) > 512 {
+			t.Errorf("Expected a small delta, got %d bytes", len(delta))
+		}
+		ops, _ := decodeDelta(delta, len(source))
+		if inPlace(ops) {
+			t.Error("Expected moved data to need a rewrite")
+		}
+	})
+
+	t.Run("Same layout patches in place", func(t *testing.T) {
+		target := append([]byte(nil), source...)
+		copy(target[20000:], randomBytes(rng, 64))
+		target = append(target, 1, 2, 3)
+
+		delta := Delta(source, target)
+		ops, err := decodeDelta(delta, len(source))
+		if err != nil {
+			t.Fatalf("Decoding delta: %v", err)
+		}
+		if !inPlace(ops) {
+			t.Error("Expected an in-place delta")
+		}
+		if len(delta) > 128 {
+			t.Errorf("Expected a small delta, got %d bytes", len(delta))
+		}
+	})
+
+	t.Run("Invalid deltas", func(t *testing.T) {
+		for _, delta := range [][]byte{{0x81}, {0x08, 1, 2}, {0x03, 0x02}} {
+			if _, err := ApplyDelta(source[:1], delta); err == nil {
+				t.Errorf("Expected an error for delta %v", delta)
+			}
+		}
+	})
+}
+
+func writeFiles(t *testing.T, dir string, files map[string][]byte) {
+	t.Helper()
+	for relPath, data := range files {
+		full := filepath.Join(dir, filepath.FromSlash(relPath))
+		if err := os.MkdirAll(filepath.Dir(full), 0755); err != nil {
+			t.Fatal(err)
+		}
+		if err := os.WriteFile(full, data, 0644); err != nil {
+			t.Fatal(err)
+		}
+	}
+}
+
+func TestCreateApply(t *testing.T) {
+	rng := rand.New(rand.NewSource(2))
+	compress := func(level, dict []byte) []byte {
+		compressed, err := packager.CompressLevel(level, dict)
+		if err != nil {
+			t.Fatal(err)
+		}
+		return compressed
+	}
+
+	binary := randomBytes(rng, 20000)
+	newBinary := append([]byte(nil), binary...)
+	copy(newBinary[5000:], "patched")
+	level := randomBytes(rng, 30000)
+	newLevel := append(append(append([]byte(nil), level[:12000]...), "edit"...), level[12000:]...)
+	dict, newDict := randomBytes(rng, 1024), randomBytes(rng, 1024)
+
+	oldDir, newDir, installDir := t.TempDir(), t.TempDir(), t.TempDir()
+	oldFiles := map[string][]byte{
+		"game":                      binary,
+		"assets/levels/levels.dict": dict,
+		"assets/levels/town.pbz":    compress(level, dict),
+		"assets/old.txt":            []byte("removed"),
+		"assets/same.txt":           []byte("unchanged"),
+	}
+	writeFiles(t, oldDir, oldFiles)
+	writeFiles(t, installDir, oldFiles)
+	writeFiles(t, newDir, map[string][]byte{
+		"game":                      newBinary,
+		"assets/levels/levels.dict": newDict,
+		"assets/levels/town.pbz":    compress(newLevel, newDict),
+		"assets/new.txt":            []byte("added"),
+		"assets/same.txt":           []byte("unchanged"),
+	})
+
+	var patch bytes.Buffer
+	stats, err := Create(oldDir, newDir, &patch)
+	if err != nil {
+		t.Fatalf("Creating patch: %v", err)
+	}
+	if stats.Added != 1 || stats.Removed != 1 || stats.Changed != 3 || stats.Unchanged != 1 {
+		t.Errorf("Unexpected patch stats %+v", stats)
+	}
+	// The dictionary changes completely, the level and binary only by a few bytes
+	if stats.DeltaSize > 1024+256 {
+		t.Errorf("Expected small deltas, got %d bytes", stats.DeltaSize)
+	}
+
+	patchBytes := patch.Bytes()
+	if _, err := Apply(installDir, bytes.NewReader(patchBytes)); err != nil {
+		t.Fatalf("Applying patch: %v", err)
+	}
+	for _, relPath := range []string{"game", "assets/levels/levels.dict", "assets/levels/town.pbz", "assets/new.txt", "assets/same.txt"} {
+		want, _ := os.ReadFile(filepath.Join(newDir, relPath))
+		got, err := os.ReadFile(filepath.Join(installDir, relPath))
+		if err != nil || !bytes.Equal(got, want) {
+			t.Errorf("%s does not match the new build (%v)", relPath, err)
+		}
+	}
+	if _, err := os.Stat(filepath.Join(installDir, "assets", "old.txt")); !os.IsNotExist(err) {
+		t.Error("Expected the removed file to be gone")
+	}
+
+	// The patch no longer applies to the patched build, and leaves it alone
+	if _, err := Apply(installDir, bytes.NewReader(patchBytes)); err == nil {
+		t.Error("Expected an error applying the patch twice")
+	}
+	if got, _ := os.ReadFile(filepath.Join(installDir, "game")); !bytes.Equal(got, newBinary) {
+		t.Error("Expected a failed patch to leave the build unchanged")
+	}
+}
+
+func TestApplyStableDictionary(t *testing.T) {
+	rng := rand.New(rand.NewSource(3))
+	dict := randomBytes(rng, 1024)
+	compress := func(level []byte) []byte {
+		compressed, err := packager.CompressLevel(level, dict)
+		if err != nil {
+			t.Fatal(err)
+		}
+		return compressed
+	}
+
+	town, cave := randomBytes(rng, 30000), randomBytes(rng, 30000)
+	newTown := append([]byte(nil), town...)
+	copy(newTown[12000:], "edit")
+
+	oldDir, newDir, installDir := t.TempDir(), t.TempDir(), t.TempDir()
+	oldFiles := map[string][]byte{
+		"assets/levels/levels.dict": dict,
+		"assets/levels/town.pbz":    compress(town),
+		"assets/levels/cave.pbz":    compress(cave),
+	}
+	writeFiles(t, oldDir, oldFiles)
+	writeFiles(t, installDir, oldFiles)
+	writeFiles(t, newDir, map[string][]byte{
+		"assets/levels/levels.dict": dict,
+		"assets/levels/town.pbz":    compress(newTown),
+		"assets/levels/cave.pbz":    compress(cave),
+	})
+
+	// With the checked-in dictionary only the edited level is in the patch and recompressed
+	var patch bytes.Buffer
+	stats, err := Create(oldDir, newDir, &patch)
+	if err != nil {
+		t.Fatalf("Creating patch: %v", err)
+	}
+	if stats.Changed != 1 || stats.Unchanged != 2 {
+		t.Errorf("Expected only the edited level to change, got %+v", stats)
+	}
+	stats, err = Apply(installDir, &patch)
+	if err != nil {
+		t.Fatalf("Applying patch: %v", err)
+	}
+	if stats.Changed != 1 {
+		t.Errorf("Expected one level to be recompressed, got %+v", stats)
+	}
+	for _, relPath := range []string{"assets/levels/town.pbz", "assets/levels/cave.pbz"} {
+		want, _ := os.ReadFile(filepath.Join(newDir, relPath))
+		got, err := os.ReadFile(filepath.Join(installDir, relPath))
+		if err != nil || !bytes.Equal(got, want) {
+			t.Errorf("%s does not match the new build (%v)", relPath, err)
+		}
+	}
+}
@@ -19,12 +19,24 @@ type Libraries struct {
 	SDLImage string `yaml:"sdl_image,omitempty"` // SDL3_image version (e.g., "3.2.4")
 }
 
+// BSPBudget limits the size of the collision BSP tree of every level.
+// Levels that exceed it are simplified; the build fails if that is not enough.
+// Zero means no limit.
+type BSPBudget struct {
+	MaxNodes int `yaml:"max_nodes,omitempty"` // Maximum number of BSP nodes per level
+	MaxDepth int `yaml:"max_depth,omitempty"` // Maximum number of nodes visited by a single query
+}
+
 // Config represents the project configuration from venture.yaml.
 type Config struct {
-	Name       string    `yaml:"name"`
-	BinaryName string    `yaml:"binary_name"`
-	SteamAppID string    `yaml:"steam_app_id,omitempty"`
-	Libraries  Libraries `yaml:"libraries,omitempty"`
+	Name       string               `yaml:"name"`
+	BinaryName string               `yaml:"binary_name"`
+	SteamAppID string               `yaml:"steam_app_id,omitempty"`
+	Libraries  Libraries            `yaml:"libraries,omitempty"`
+	BSPBudgets map[string]BSPBudget `yaml:"bsp_budgets,omitempty"` // Per platform (e.g., "steam", "fallback")
+	// KeepAssets are textures that ship even if no level references them, like UI textures loaded by code
+	// (path.Match patterns relative to assets/, a matched directory keeps everything in it)
+	KeepAssets []string `yaml:"keep_assets,omitempty"`
 }
 
 // FindProjectRoot walks up from the current working directory looking for venture.yaml.
@@ -21,6 +21,8 @@ const (
 	_ = protoimpl.EnforceVersion(protoimpl.MaxVersion - 20)
 )
 
+// Collision is answered by the BSP tree (nodes, root_index), or by collision_bvh
+// if the build counted fewer operations per query for it. The BSP tree always ships.
 type LevelData struct {
 	state protoimpl.MessageState `protogen:"open.v1"`
 	// Store ALL nodes here in a flat list
@@ -28,7 +30,23 @@ type LevelData struct {
 	// Index of the root node in the list above (-1 for empty tree)
 	RootIndex int32 `protobuf:"varint,2,opt,name=root_index,json=rootIndex,proto3" json:"root_index,omitempty"`
 	// Ground tiles for visual rendering
-	Ground        []*Tile `protobuf:"bytes,3,rep,name=ground,proto3" json:"ground,omitempty"`
+	Ground []*Tile `protobuf:"bytes,3,rep,name=ground,proto3" json:"ground,omitempty"`
+	// Objects, pre-sorted into instancing batches in draw order
+	ObjectBatches []*ObjectBatch `protobuf:"bytes,4,rep,name=object_batches,json=objectBatches,proto3" json:"object_batches,omitempty"`
+	// Culling index over the batched objects
+	ObjectChunks []*ObjectChunk `protobuf:"bytes,5,rep,name=object_chunks,json=objectChunks,proto3" json:"object_chunks,omitempty"`
+	// Edge length of an object chunk in world units
+	ObjectChunkSize float32 `protobuf:"fixed32,6,opt,name=object_chunk_size,json=objectChunkSize,proto3" json:"object_chunk_size,omitempty"`
+	// Baked line of sight between spawns, portals and markers (not baked into chunked levels)
+	LineOfSight *LineOfSight `protobuf:"bytes,7,opt,name=line_of_sight,json=lineOfSight,proto3" json:"line_of_sight,omitempty"`
+	// Bounding volume hierarchy over the convex solid pieces (answers queries instead of the BSP tree if set)
+	CollisionBvh *CollisionBVH `protobuf:"bytes,8,opt,name=collision_bvh,json=collisionBvh,proto3" json:"collision_bvh,omitempty"`
+	// Baked flow fields toward spawns, portals and flow target markers (not baked into chunked levels)
+	FlowFields *FlowFields `protobuf:"bytes,9,opt,name=flow_fields,json=flowFields,proto3" json:"flow_fields,omitempty"`
+	// Merged convex decomposition of the solid geometry for external physics engines (optional)
+	ConvexShapes *ConvexShapes `protobuf:"bytes,10,opt,name=convex_shapes,json=convexShapes,proto3" json:"convex_shapes,omitempty"`
+	// Rooms of the empty space, sector_id of an empty leaf is an index into this plus one (optional)
+	Sectors       []*Sector `protobuf:"bytes,11,rep,name=sectors,proto3" json:"sectors,omitempty"`
 	unknownFields protoimpl.UnknownFields
 	sizeCache     protoimpl.SizeCache
 }
@@ -84,14 +102,73 @@ func (x *LevelData) GetGround() []*Tile {
 	return nil
 }
 
+func (x *LevelData) GetObjectBatches() []*ObjectBatch {
+	if x != nil {
+		return x.ObjectBatches
+	}
+	return nil
+}
+
+func (x *LevelData) GetObjectChunks() []*ObjectChunk {
+	if x != nil {
+		return x.ObjectChunks
+	}
+	return nil
+}
+
+func (x *LevelData) GetObjectChunkSize() float32 {
+	if x != nil {
+		return x.ObjectChunkSize
+	}
+	return 0
+}
+
+func (x *LevelData) GetLineOfSight() *LineOfSight {
+	if x != nil {
+		return x.LineOfSight
+	}
+	return nil
+}
+
+func (x *LevelData) GetCollisionBvh() *CollisionBVH {
+	if x != nil {
+		return x.CollisionBvh
+	}
+	return nil
+}
+
+func (x *LevelData) GetFlowFields() *FlowFields {
+	if x != nil {
+		return x.FlowFields
+	}
+	return nil
+}
+
+func (x *LevelData) GetConvexShapes() *ConvexShapes {
+	if x != nil {
+		return x.ConvexShapes
+	}
+	return nil
+}
+
+func (x *LevelData) GetSectors() []*Sector {
+	if x != nil {
+		return x.Sectors
+	}
+	return nil
+}
+
 type BSPNode struct {
 	state protoimpl.MessageState `protogen:"open.v1"`
-	// A node is strictly one of these two things.
+	// A node is strictly one of these things.
 	//
 	// Types that are valid to be assigned to Type:
 	//
 	//	*BSPNode_Split
 	//	*BSPNode_Leaf
+	//	*BSPNode_Instance
+	//	*BSPNode_Circle
+	//	*BSPNode_AxisSplit
 	Type          isBSPNode_Type `protobuf_oneof:"type"`
 	unknownFields protoimpl.UnknownFields
 	sizeCache     protoimpl.SizeCache
@@ -152,6 +229,33 @@ func (x *BSPNode) GetLeaf() *Leaf {
 	return nil
 }
 
+func (x *BSPNode) GetInstance() *Instance {
+	if x != nil {
+		if x, ok := x.Type.(*BSPNode_Instance); ok {
+			return x.Instance
+		}
+	}
+	return nil
+}
+
+func (x *BSPNode) GetCircle() *Circle {
+	if x != nil {
+		if x, ok := x.Type.(*BSPNode_Circle); ok {
+			return x.Circle
+		}
+	}
+	return nil
+}
+
+func (x *BSPNode) GetAxisSplit() *AxisSplit {
+	if x != nil {
+		if x, ok := x.Type.(*BSPNode_AxisSplit); ok {
+			return x.AxisSplit
+		}
+	}
+	return nil
+}
+
 type isBSPNode_Type interface {
 	isBSPNode_Type()
 }
@@ -164,10 +268,28 @@ type BSPNode_Leaf struct {
 	Leaf *Leaf `protobuf:"bytes,2,opt,name=leaf,proto3,oneof"`
 }
 
+type BSPNode_Instance struct {
+	Instance *Instance `protobuf:"bytes,3,opt,name=instance,proto3,oneof"`
+}
+
+type BSPNode_Circle struct {
+	Circle *Circle `protobuf:"bytes,4,opt,name=circle,proto3,oneof"`
+}
+
+type BSPNode_AxisSplit struct {
+	AxisSplit *AxisSplit `protobuf:"bytes,5,opt,name=axis_split,json=axisSplit,proto3,oneof"`
+}
+
 func (*BSPNode_Split) isBSPNode_Type() {}
 
 func (*BSPNode_Leaf) isBSPNode_Type() {}
 
+func (*BSPNode_Instance) isBSPNode_Type() {}
+
+func (*BSPNode_Circle) isBSPNode_Type() {}
+
+func (*BSPNode_AxisSplit) isBSPNode_Type() {}
+
 type Split struct {
 	state protoimpl.MessageState `protogen:"open.v1"`
 	// The Plane (Line in 2D): Normal * Point = Distance
@@ -246,30 +368,36 @@ func (x *Split) GetBackIndex() int32 {
 	return 0
 }
 
-type Leaf struct {
-	state protoimpl.MessageState `protogen:"open.v1"`
-	// The actual content index (e.g., sector ID, polygons)
-	SectorId       int32   `protobuf:"varint,1,opt,name=sector_id,json=sectorId,proto3" json:"sector_id,omitempty"`
-	PolygonIndices []int32 `protobuf:"varint,2,rep,packed,name=polygon_indices,json=polygonIndices,proto3" json:"polygon_indices,omitempty"`
-	IsSolid        bool    `protobuf:"varint,3,opt,name=is_solid,json=isSolid,proto3" json:"is_solid,omitempty"`
-	unknownFields  protoimpl.UnknownFields
-	sizeCache      protoimpl.SizeCache
+// A Split whose plane is a vertical (axis 0, x = threshold) or horizontal
+// (axis 1, y = threshold) line. Most walls are axis-aligned, and testing one
+// coordinate against a threshold is cheaper than a full plane equation.
+type AxisSplit struct {
+	state     protoimpl.MessageState `protogen:"open.v1"`
+	Axis      uint32                 `protobuf:"varint,1,opt,name=axis,proto3" json:"axis,omitempty"`
+	Threshold float32                `protobuf:"fixed32,2,opt,name=threshold,proto3" json:"threshold,omitempty"`
+	// The front side is coordinate > threshold, or coordinate < threshold if set.
+	// Points exactly on the line are on the back side, as for Split.
+	FrontBelow    bool  `protobuf:"varint,3,opt,name=front_below,json=frontBelow,proto3" json:"front_below,omitempty"`
+	FrontIndex    int32 `protobuf:"varint,4,opt,name=front_index,json=frontIndex,proto3" json:"front_index,omitempty"`
+	BackIndex     int32 `protobuf:"varint,5,opt,name=back_index,json=backIndex,proto3" json:"back_index,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
 }
 
-func (x *Leaf) Reset() {
-	*x = Leaf{}
+func (x *AxisSplit) Reset() {
+	*x = AxisSplit{}
 	mi := &file_level_proto_msgTypes[3]
 	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
 	ms.StoreMessageInfo(mi)
 }
 
-func (x *Leaf) String() string {
+func (x *AxisSplit) String() string {
 	return protoimpl.X.MessageStringOf(x)
 }
 
-func (*Leaf) ProtoMessage() {}
+func (*AxisSplit) ProtoMessage() {}
 
-func (x *Leaf) ProtoReflect() protoreflect.Message {
+func (x *AxisSplit) ProtoReflect() protoreflect.Message {
 	mi := &file_level_proto_msgTypes[3]
 	if x != nil {
 		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
@@ -281,54 +409,81 @@ func (x *Leaf) ProtoReflect() protoreflect.Message {
 	return mi.MessageOf(x)
 }
 
-// Deprecated: Use Leaf.ProtoReflect.Descriptor instead.
-func (*Leaf) Descriptor() ([]byte, []int) {
+// Deprecated: Use AxisSplit.ProtoReflect.Descriptor instead.
+func (*AxisSplit) Descriptor() ([]byte, []int) {
 	return file_level_proto_rawDescGZIP(), []int{3}
 }
 
-func (x *Leaf) GetSectorId() int32 {
+func (x *AxisSplit) GetAxis() uint32 {
 	if x != nil {
-		return x.SectorId
+		return x.Axis
 	}
 	return 0
 }
 
-func (x *Leaf) GetPolygonIndices() []int32 {
+func (x *AxisSplit) GetThreshold() float32 {
 	if x != nil {
-		return x.PolygonIndices
+		return x.Threshold
 	}
-	return nil
+	return 0
 }
 
-func (x *Leaf) GetIsSolid() bool {
+func (x *AxisSplit) GetFrontBelow() bool {
 	if x != nil {
-		return x.IsSolid
+		return x.FrontBelow
 	}
 	return false
 }
 
-type Vec2I struct {
-	state         protoimpl.MessageState `protogen:"open.v1"`
-	X             int32                  `protobuf:"varint,1,opt,name=x,proto3" json:"x,omitempty"`
-	Y             int32                  `protobuf:"varint,2,opt,name=y,proto3" json:"y,omitempty"`
+func (x *AxisSplit) GetFrontIndex() int32 {
+	if x != nil {
+		return x.FrontIndex
+	}
+	return 0
+}
+
+func (x *AxisSplit) GetBackIndex() int32 {
+	if x != nil {
+		return x.BackIndex
+	}
+	return 0
+}
+
+// Places a shared, local-space subtree (a prefab) into the world.
+// Queries transform the point or segment into local space and descend into
+// 'subtree_index'. If the point is not solid there, the query continues at
+// 'next_index' in world space.
+type Instance struct {
+	state protoimpl.MessageState `protogen:"open.v1"`
+	// Index of the prefab subtree root in the 'nodes' array
+	SubtreeIndex int32 `protobuf:"varint,1,opt,name=subtree_index,json=subtreeIndex,proto3" json:"subtree_index,omitempty"`
+	// World-to-local affine transform: local = M * world + T
+	M00 float32 `protobuf:"fixed32,2,opt,name=m00,proto3" json:"m00,omitempty"`
+	M01 float32 `protobuf:"fixed32,3,opt,name=m01,proto3" json:"m01,omitempty"`
+	M10 float32 `protobuf:"fixed32,4,opt,name=m10,proto3" json:"m10,omitempty"`
+	M11 float32 `protobuf:"fixed32,5,opt,name=m11,proto3" json:"m11,omitempty"`
+	Tx  float32 `protobuf:"fixed32,6,opt,name=tx,proto3" json:"tx,omitempty"`
+	Ty  float32 `protobuf:"fixed32,7,opt,name=ty,proto3" json:"ty,omitempty"`
+	// Where to continue when the instance is empty at the query point
+	NextIndex     int32 `protobuf:"varint,8,opt,name=next_index,json=nextIndex,proto3" json:"next_index,omitempty"`
 	unknownFields protoimpl.UnknownFields
 	sizeCache     protoimpl.SizeCache
 }
 
-func (x *Vec2I) Reset() {
-	*x = Vec2I{}
+func (x *Instance) Reset() {
+	*x = Instance{}
 	mi := &file_level_proto_msgTypes[4]
 	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
 	ms.StoreMessageInfo(mi)
 }
 
-func (x *Vec2I) String() string {
+func (x *Instance) String() string {
 	return protoimpl.X.MessageStringOf(x)
 }
 
-func (*Vec2I) ProtoMessage() {}
+func (*Instance) ProtoMessage() {}
 
-func (x *Vec2I) ProtoReflect() protoreflect.Message {
+func (x *Instance) ProtoReflect() protoreflect.Message {
 	mi := &file_level_proto_msgTypes[4]
 	if x != nil {
 		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
@@ -340,47 +495,95 @@ func (x *Vec2I) ProtoReflect() protoreflect.Message {
 	return mi.MessageOf(x)
 }
 
-// Deprecated: Use Vec2I.ProtoReflect.Descriptor instead.
-func (*Vec2I) Descriptor() ([]byte, []int) {
+// Deprecated: Use Instance.ProtoReflect.Descriptor instead.
+func (*Instance) Descriptor() ([]byte, []int) {
 	return file_level_proto_rawDescGZIP(), []int{4}
 }
 
-func (x *Vec2I) GetX() int32 {
+func (x *Instance) GetSubtreeIndex() int32 {
 	if x != nil {
-		return x.X
+		return x.SubtreeIndex
 	}
 	return 0
 }
 
-func (x *Vec2I) GetY() int32 {
+func (x *Instance) GetM00() float32 {
 	if x != nil {
-		return x.Y
+		return x.M00
 	}
 	return 0
 }
 
-type Tile struct {
-	state         protoimpl.MessageState `protogen:"open.v1"`
-	Position      *Vec2I                 `protobuf:"bytes,1,opt,name=position,proto3" json:"position,omitempty"`
-	Texture       string                 `protobuf:"bytes,2,opt,name=texture,proto3" json:"texture,omitempty"`
+func (x *Instance) GetM01() float32 {
+	if x != nil {
+		return x.M01
+	}
+	return 0
+}
+
+func (x *Instance) GetM10() float32 {
+	if x != nil {
+		return x.M10
+	}
+	return 0
+}
+
+func (x *Instance) GetM11() float32 {
+	if x != nil {
+		return x.M11
+	}
+	return 0
+}
+
+func (x *Instance) GetTx() float32 {
+	if x != nil {
+		return x.Tx
+	}
+	return 0
+}
+
+func (x *Instance) GetTy() float32 {
+	if x != nil {
+		return x.Ty
+	}
+	return 0
+}
+
+func (x *Instance) GetNextIndex() int32 {
+	if x != nil {
+		return x.NextIndex
+	}
+	return 0
+}
+
+// A solid disc, resolved analytically instead of approximated by split planes.
+// Points inside or on the circle are solid. Everywhere else, the query
+// continues at 'outside_index'.
+type Circle struct {
+	state   protoimpl.MessageState `protogen:"open.v1"`
+	CenterX float32                `protobuf:"fixed32,1,opt,name=center_x,json=centerX,proto3" json:"center_x,omitempty"`
+	CenterY float32                `protobuf:"fixed32,2,opt,name=center_y,json=centerY,proto3" json:"center_y,omitempty"`
+	Radius  float32                `protobuf:"fixed32,3,opt,name=radius,proto3" json:"radius,omitempty"`
+	// Where to continue when the query point is outside the circle
+	OutsideIndex  int32 `protobuf:"varint,4,opt,name=outside_index,json=outsideIndex,proto3" json:"outside_index,omitempty"`
 	unknownFields protoimpl.UnknownFields
 	sizeCache     protoimpl.SizeCache
 }
 
-func (x *Tile) Reset() {
-	*x = Tile{}
+func (x *Circle) Reset() {
+	*x = Circle{}
 	mi := &file_level_proto_msgTypes[5]
 	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
 	ms.StoreMessageInfo(mi)
 }
 
-func (x *Tile) String() string {
+func (x *Circle) String() string {
 	return protoimpl.X.MessageStringOf(x)
 }
 
-func (*Tile) ProtoMessage() {}
+func (*Circle) ProtoMessage() {}
 
-func (x *Tile) ProtoReflect() protoreflect.Message {
+func (x *Circle) ProtoReflect() protoreflect.Message {
 	mi := &file_level_proto_msgTypes[5]
 	if x != nil {
 		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
@@ -392,57 +595,1374 @@ func (x *Tile) ProtoReflect() protoreflect.Message {
 	return mi.MessageOf(x)
 }
 
-// Deprecated: Use Tile.ProtoReflect.Descriptor instead.
-func (*Tile) Descriptor() ([]byte, []int) {
+// Deprecated: Use Circle.ProtoReflect.Descriptor instead.
+func (*Circle) Descriptor() ([]byte, []int) {
 	return file_level_proto_rawDescGZIP(), []int{5}
 }
 
-func (x *Tile) GetPosition() *Vec2I {
+func (x *Circle) GetCenterX() float32 {
 	if x != nil {
-		return x.Position
+		return x.CenterX
+	}
+	return 0
+}
+
+func (x *Circle) GetCenterY() float32 {
+	if x != nil {
+		return x.CenterY
+	}
+	return 0
+}
+
+func (x *Circle) GetRadius() float32 {
+	if x != nil {
+		return x.Radius
+	}
+	return 0
+}
+
+func (x *Circle) GetOutsideIndex() int32 {
+	if x != nil {
+		return x.OutsideIndex
+	}
+	return 0
+}
+
+// A bounding volume hierarchy over convex solid pieces.
+// Node 0 is the root. Nodes are stored depth-first, so the first child of an
+// inner node directly follows it.
+type CollisionBVH struct {
+	state  protoimpl.MessageState `protogen:"open.v1"`
+	Nodes  []*BVHNode             `protobuf:"bytes,1,rep,name=nodes,proto3" json:"nodes,omitempty"`
+	Pieces []*ConvexPiece         `protobuf:"bytes,2,rep,name=pieces,proto3" json:"pieces,omitempty"`
+	// Outline vertices of all polygon pieces: x0, y0, x1, y1, ...
+	Vertices      []float32 `protobuf:"fixed32,3,rep,packed,name=vertices,proto3" json:"vertices,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *CollisionBVH) Reset() {
+	*x = CollisionBVH{}
+	mi := &file_level_proto_msgTypes[6]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *CollisionBVH) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*CollisionBVH) ProtoMessage() {}
+
+func (x *CollisionBVH) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[6]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use CollisionBVH.ProtoReflect.Descriptor instead.
+func (*CollisionBVH) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{6}
+}
+
+func (x *CollisionBVH) GetNodes() []*BVHNode {
+	if x != nil {
+		return x.Nodes
 	}
 	return nil
 }
 
-func (x *Tile) GetTexture() string {
+func (x *CollisionBVH) GetPieces() []*ConvexPiece {
 	if x != nil {
-		return x.Texture
+		return x.Pieces
 	}
-	return ""
+	return nil
 }
 
-var File_level_proto protoreflect.FileDescriptor
+func (x *CollisionBVH) GetVertices() []float32 {
+	if x != nil {
+		return x.Vertices
+	}
+	return nil
+}
 
-const file_level_proto_rawDesc = "" +
-	"\n" +
-	"\vlevel.proto\x12\aventure\"y\n" +
-	"\tLevelData\x12&\n" +
-	"\x05nodes\x18\x01 \x03(\v2\x10.venture.BSPNodeR\x05nodes\x12\x1d\n" +
-	"\n" +
-	"root_index\x18\x02 \x01(\x05R\trootIndex\x12%\n" +
-	"\x06ground\x18\x03 \x03(\v2\r.venture.TileR\x06ground\"^\n" +
-	"\aBSPNode\x12&\n" +
-	"\x05split\x18\x01 \x01(\v2\x0e.venture.SplitH\x00R\x05split\x12#\n" +
-	"\x04leaf\x18\x02 \x01(\v2\r.venture.LeafH\x00R\x04leafB\x06\n" +
-	"\x04type\"\x99\x01\n" +
-	"\x05Split\x12\x19\n" +
-	"\bnormal_x\x18\x01 \x01(\x02R\anormalX\x12\x19\n" +
-	"\bnormal_y\x18\x02 \x01(\x02R\anormalY\x12\x1a\n" +
-	"\bdistance\x18\x03 \x01(\x02R\bdistance\x12\x1f\n" +
-	"\vfront_index\x18\x04 \x01(\x05R\n" +
-	"frontIndex\x12\x1d\n" +
-	"\n" +
-	"back_index\x18\x05 \x01(\x05R\tbackIndex\"g\n" +
-	"\x04Leaf\x12\x1b\n" +
-	"\tsector_id\x18\x01 \x01(\x05R\bsectorId\x12'\n" +
-	"\x0fpolygon_indices\x18\x02 \x03(\x05R\x0epolygonIndices\x12\x19\n" +
-	"\bis_solid\x18\x03 \x01(\bR\aisSolid\"#\n" +
-	"\x05Vec2i\x12\f\n" +
-	"\x01x\x18\x01 \x01(\x05R\x01x\x12\f\n" +
-	"\x01y\x18\x02 \x01(\x05R\x01y\"L\n" +
-	"\x04Tile\x12*\n" +
-	"\bposition\x18\x01 \x01(\v2\x0e.venture.Vec2iR\bposition\x12\x18\n" +
-	"\atexture\x18\x02 \x01(\tR\atextureB2Z0github.com/bloodmagesoftware/venture/proto/levelb\x06proto3"
+type BVHNode struct {
+	state protoimpl.MessageState `protogen:"open.v1"`
+	MinX  float32                `protobuf:"fixed32,1,opt,name=min_x,json=minX,proto3" json:"min_x,omitempty"`
+	MinY  float32                `protobuf:"fixed32,2,opt,name=min_y,json=minY,proto3" json:"min_y,omitempty"`
+	MaxX  float32                `protobuf:"fixed32,3,opt,name=max_x,json=maxX,proto3" json:"max_x,omitempty"`
+	MaxY  float32                `protobuf:"fixed32,4,opt,name=max_y,json=maxY,proto3" json:"max_y,omitempty"`
+	// Inner nodes: index of the second child
+	RightIndex int32 `protobuf:"varint,5,opt,name=right_index,json=rightIndex,proto3" json:"right_index,omitempty"`
+	// Leaves (piece_count > 0): pieces [first_piece, first_piece + piece_count)
+	FirstPiece    int32 `protobuf:"varint,6,opt,name=first_piece,json=firstPiece,proto3" json:"first_piece,omitempty"`
+	PieceCount    int32 `protobuf:"varint,7,opt,name=piece_count,json=pieceCount,proto3" json:"piece_count,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *BVHNode) Reset() {
+	*x = BVHNode{}
+	mi := &file_level_proto_msgTypes[7]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *BVHNode) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*BVHNode) ProtoMessage() {}
+
+func (x *BVHNode) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[7]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use BVHNode.ProtoReflect.Descriptor instead.
+func (*BVHNode) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{7}
+}
+
+func (x *BVHNode) GetMinX() float32 {
+	if x != nil {
+		return x.MinX
+	}
+	return 0
+}
+
+func (x *BVHNode) GetMinY() float32 {
+	if x != nil {
+		return x.MinY
+	}
+	return 0
+}
+
+func (x *BVHNode) GetMaxX() float32 {
+	if x != nil {
+		return x.MaxX
+	}
+	return 0
+}
+
+func (x *BVHNode) GetMaxY() float32 {
+	if x != nil {
+		return x.MaxY
+	}
+	return 0
+}
+
+func (x *BVHNode) GetRightIndex() int32 {
+	if x != nil {
+		return x.RightIndex
+	}
+	return 0
+}
+
+func (x *BVHNode) GetFirstPiece() int32 {
+	if x != nil {
+		return x.FirstPiece
+	}
+	return 0
+}
+
+func (x *BVHNode) GetPieceCount() int32 {
+	if x != nil {
+		return x.PieceCount
+	}
+	return 0
+}
+
+// A convex solid in world space, either a polygon or a (transformed) disc
+type ConvexPiece struct {
+	state protoimpl.MessageState `protogen:"open.v1"`
+	// Polygon: CCW outline in vertices [first_vertex, first_vertex + vertex_count)
+	FirstVertex int32 `protobuf:"varint,1,opt,name=first_vertex,json=firstVertex,proto3" json:"first_vertex,omitempty"`
+	VertexCount int32 `protobuf:"varint,2,opt,name=vertex_count,json=vertexCount,proto3" json:"vertex_count,omitempty"`
+	// Disc (vertex_count 0): solid circle in local space, local = M * world + T
+	CenterX       float32 `protobuf:"fixed32,3,opt,name=center_x,json=centerX,proto3" json:"center_x,omitempty"`
+	CenterY       float32 `protobuf:"fixed32,4,opt,name=center_y,json=centerY,proto3" json:"center_y,omitempty"`
+	Radius        float32 `protobuf:"fixed32,5,opt,name=radius,proto3" json:"radius,omitempty"`
+	M00           float32 `protobuf:"fixed32,6,opt,name=m00,proto3" json:"m00,omitempty"`
+	M01           float32 `protobuf:"fixed32,7,opt,name=m01,proto3" json:"m01,omitempty"`
+	M10           float32 `protobuf:"fixed32,8,opt,name=m10,proto3" json:"m10,omitempty"`
+	M11           float32 `protobuf:"fixed32,9,opt,name=m11,proto3" json:"m11,omitempty"`
+	Tx            float32 `protobuf:"fixed32,10,opt,name=tx,proto3" json:"tx,omitempty"`
+	Ty            float32 `protobuf:"fixed32,11,opt,name=ty,proto3" json:"ty,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *ConvexPiece) Reset() {
+	*x = ConvexPiece{}
+	mi := &file_level_proto_msgTypes[8]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *ConvexPiece) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*ConvexPiece) ProtoMessage() {}
+
+func (x *ConvexPiece) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[8]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use ConvexPiece.ProtoReflect.Descriptor instead.
+func (*ConvexPiece) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{8}
+}
+
+func (x *ConvexPiece) GetFirstVertex() int32 {
+	if x != nil {
+		return x.FirstVertex
+	}
+	return 0
+}
+
+func (x *ConvexPiece) GetVertexCount() int32 {
+	if x != nil {
+		return x.VertexCount
+	}
+	return 0
+}
+
+func (x *ConvexPiece) GetCenterX() float32 {
+	if x != nil {
+		return x.CenterX
+	}
+	return 0
+}
+
+func (x *ConvexPiece) GetCenterY() float32 {
+	if x != nil {
+		return x.CenterY
+	}
+	return 0
+}
+
+func (x *ConvexPiece) GetRadius() float32 {
+	if x != nil {
+		return x.Radius
+	}
+	return 0
+}
+
+func (x *ConvexPiece) GetM00() float32 {
+	if x != nil {
+		return x.M00
+	}
+	return 0
+}
+
+func (x *ConvexPiece) GetM01() float32 {
+	if x != nil {
+		return x.M01
+	}
+	return 0
+}
+
+func (x *ConvexPiece) GetM10() float32 {
+	if x != nil {
+		return x.M10
+	}
+	return 0
+}
+
+func (x *ConvexPiece) GetM11() float32 {
+	if x != nil {
+		return x.M11
+	}
+	return 0
+}
+
+func (x *ConvexPiece) GetTx() float32 {
+	if x != nil {
+		return x.Tx
+	}
+	return 0
+}
+
+func (x *ConvexPiece) GetTy() float32 {
+	if x != nil {
+		return x.Ty
+	}
+	return 0
+}
+
+type Leaf struct {
+	state protoimpl.MessageState `protogen:"open.v1"`
+	// The actual content index (e.g., sector ID, polygons)
+	// sector_id is the index into LevelData.sectors plus one, 0 for no sector
+	SectorId       int32   `protobuf:"varint,1,opt,name=sector_id,json=sectorId,proto3" json:"sector_id,omitempty"`
+	PolygonIndices []int32 `protobuf:"varint,2,rep,packed,name=polygon_indices,json=polygonIndices,proto3" json:"polygon_indices,omitempty"`
+	IsSolid        bool    `protobuf:"varint,3,opt,name=is_solid,json=isSolid,proto3" json:"is_solid,omitempty"`
+	unknownFields  protoimpl.UnknownFields
+	sizeCache      protoimpl.SizeCache
+}
+
+func (x *Leaf) Reset() {
+	*x = Leaf{}
+	mi := &file_level_proto_msgTypes[9]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *Leaf) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*Leaf) ProtoMessage() {}
+
+func (x *Leaf) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[9]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use Leaf.ProtoReflect.Descriptor instead.
+func (*Leaf) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{9}
+}
+
+func (x *Leaf) GetSectorId() int32 {
+	if x != nil {
+		return x.SectorId
+	}
+	return 0
+}
+
+func (x *Leaf) GetPolygonIndices() []int32 {
+	if x != nil {
+		return x.PolygonIndices
+	}
+	return nil
+}
+
+func (x *Leaf) GetIsSolid() bool {
+	if x != nil {
+		return x.IsSolid
+	}
+	return false
+}
+
+// A room of the empty space, sectors are separated by narrow passages
+type Sector struct {
+	state protoimpl.MessageState `protogen:"open.v1"`
+	// Bounds in world units
+	MinX float32 `protobuf:"fixed32,1,opt,name=min_x,json=minX,proto3" json:"min_x,omitempty"`
+	MinY float32 `protobuf:"fixed32,2,opt,name=min_y,json=minY,proto3" json:"min_y,omitempty"`
+	MaxX float32 `protobuf:"fixed32,3,opt,name=max_x,json=maxX,proto3" json:"max_x,omitempty"`
+	MaxY float32 `protobuf:"fixed32,4,opt,name=max_y,json=maxY,proto3" json:"max_y,omitempty"`
+	// sector_id of every sector that can be walked to directly
+	Neighbors     []int32 `protobuf:"varint,5,rep,packed,name=neighbors,proto3" json:"neighbors,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *Sector) Reset() {
+	*x = Sector{}
+	mi := &file_level_proto_msgTypes[10]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *Sector) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*Sector) ProtoMessage() {}
+
+func (x *Sector) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[10]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use Sector.ProtoReflect.Descriptor instead.
+func (*Sector) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{10}
+}
+
+func (x *Sector) GetMinX() float32 {
+	if x != nil {
+		return x.MinX
+	}
+	return 0
+}
+
+func (x *Sector) GetMinY() float32 {
+	if x != nil {
+		return x.MinY
+	}
+	return 0
+}
+
+func (x *Sector) GetMaxX() float32 {
+	if x != nil {
+		return x.MaxX
+	}
+	return 0
+}
+
+func (x *Sector) GetMaxY() float32 {
+	if x != nil {
+		return x.MaxY
+	}
+	return 0
+}
+
+func (x *Sector) GetNeighbors() []int32 {
+	if x != nil {
+		return x.Neighbors
+	}
+	return nil
+}
+
+type Vec2I struct {
+	state         protoimpl.MessageState `protogen:"open.v1"`
+	X             int32                  `protobuf:"varint,1,opt,name=x,proto3" json:"x,omitempty"`
+	Y             int32                  `protobuf:"varint,2,opt,name=y,proto3" json:"y,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *Vec2I) Reset() {
+	*x = Vec2I{}
+	mi := &file_level_proto_msgTypes[11]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *Vec2I) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*Vec2I) ProtoMessage() {}
+
+func (x *Vec2I) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[11]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use Vec2I.ProtoReflect.Descriptor instead.
+func (*Vec2I) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{11}
+}
+
+func (x *Vec2I) GetX() int32 {
+	if x != nil {
+		return x.X
+	}
+	return 0
+}
+
+func (x *Vec2I) GetY() int32 {
+	if x != nil {
+		return x.Y
+	}
+	return 0
+}
+
+type Tile struct {
+	state         protoimpl.MessageState `protogen:"open.v1"`
+	Position      *Vec2I                 `protobuf:"bytes,1,opt,name=position,proto3" json:"position,omitempty"`
+	Texture       string                 `protobuf:"bytes,2,opt,name=texture,proto3" json:"texture,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *Tile) Reset() {
+	*x = Tile{}
+	mi := &file_level_proto_msgTypes[12]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *Tile) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*Tile) ProtoMessage() {}
+
+func (x *Tile) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[12]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use Tile.ProtoReflect.Descriptor instead.
+func (*Tile) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{12}
+}
+
+func (x *Tile) GetPosition() *Vec2I {
+	if x != nil {
+		return x.Position
+	}
+	return nil
+}
+
+func (x *Tile) GetTexture() string {
+	if x != nil {
+		return x.Texture
+	}
+	return ""
+}
+
+// All objects of one layer that share a texture, drawable with one instanced call.
+// Batches are ordered by layer, then texture. Instances keep their level order
+// within a chunk and are grouped by chunk, so every chunk is a contiguous range.
+// Per-instance data is packed into flat arrays.
+type ObjectBatch struct {
+	state   protoimpl.MessageState `protogen:"open.v1"`
+	Layer   int32                  `protobuf:"varint,1,opt,name=layer,proto3" json:"layer,omitempty"`
+	Texture string                 `protobuf:"bytes,2,opt,name=texture,proto3" json:"texture,omitempty"`
+	// Center of every instance: x0, y0, x1, y1, ...
+	Positions []float32 `protobuf:"fixed32,3,rep,packed,name=positions,proto3" json:"positions,omitempty"`
+	// Rotation of every instance in degrees
+	Rotations []float32 `protobuf:"fixed32,4,rep,packed,name=rotations,proto3" json:"rotations,omitempty"`
+	// Size of every instance in world units: x0, y0, x1, y1, ...
+	Sizes         []float32 `protobuf:"fixed32,5,rep,packed,name=sizes,proto3" json:"sizes,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *ObjectBatch) Reset() {
+	*x = ObjectBatch{}
+	mi := &file_level_proto_msgTypes[13]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *ObjectBatch) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*ObjectBatch) ProtoMessage() {}
+
+func (x *ObjectBatch) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[13]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use ObjectBatch.ProtoReflect.Descriptor instead.
+func (*ObjectBatch) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{13}
+}
+
+func (x *ObjectBatch) GetLayer() int32 {
+	if x != nil {
+		return x.Layer
+	}
+	return 0
+}
+
+func (x *ObjectBatch) GetTexture() string {
+	if x != nil {
+		return x.Texture
+	}
+	return ""
+}
+
+func (x *ObjectBatch) GetPositions() []float32 {
+	if x != nil {
+		return x.Positions
+	}
+	return nil
+}
+
+func (x *ObjectBatch) GetRotations() []float32 {
+	if x != nil {
+		return x.Rotations
+	}
+	return nil
+}
+
+func (x *ObjectBatch) GetSizes() []float32 {
+	if x != nil {
+		return x.Sizes
+	}
+	return nil
+}
+
+// The objects whose centers lie in one chunk of the level grid.
+// The bounds enclose every object of the chunk, including rotation, so a chunk
+// can be culled as a whole against the view rectangle.
+type ObjectChunk struct {
+	state         protoimpl.MessageState `protogen:"open.v1"`
+	Position      *Vec2I                 `protobuf:"bytes,1,opt,name=position,proto3" json:"position,omitempty"`
+	MinX          float32                `protobuf:"fixed32,2,opt,name=min_x,json=minX,proto3" json:"min_x,omitempty"`
+	MinY          float32                `protobuf:"fixed32,3,opt,name=min_y,json=minY,proto3" json:"min_y,omitempty"`
+	MaxX          float32                `protobuf:"fixed32,4,opt,name=max_x,json=maxX,proto3" json:"max_x,omitempty"`
+	MaxY          float32                `protobuf:"fixed32,5,opt,name=max_y,json=maxY,proto3" json:"max_y,omitempty"`
+	Ranges        []*ObjectRange         `protobuf:"bytes,6,rep,name=ranges,proto3" json:"ranges,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *ObjectChunk) Reset() {
+	*x = ObjectChunk{}
+	mi := &file_level_proto_msgTypes[14]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *ObjectChunk) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*ObjectChunk) ProtoMessage() {}
+
+func (x *ObjectChunk) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[14]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use ObjectChunk.ProtoReflect.Descriptor instead.
+func (*ObjectChunk) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{14}
+}
+
+func (x *ObjectChunk) GetPosition() *Vec2I {
+	if x != nil {
+		return x.Position
+	}
+	return nil
+}
+
+func (x *ObjectChunk) GetMinX() float32 {
+	if x != nil {
+		return x.MinX
+	}
+	return 0
+}
+
+func (x *ObjectChunk) GetMinY() float32 {
+	if x != nil {
+		return x.MinY
+	}
+	return 0
+}
+
+func (x *ObjectChunk) GetMaxX() float32 {
+	if x != nil {
+		return x.MaxX
+	}
+	return 0
+}
+
+func (x *ObjectChunk) GetMaxY() float32 {
+	if x != nil {
+		return x.MaxY
+	}
+	return 0
+}
+
+func (x *ObjectChunk) GetRanges() []*ObjectRange {
+	if x != nil {
+		return x.Ranges
+	}
+	return nil
+}
+
+// A contiguous run of instances inside one batch
+type ObjectRange struct {
+	state         protoimpl.MessageState `protogen:"open.v1"`
+	BatchIndex    int32                  `protobuf:"varint,1,opt,name=batch_index,json=batchIndex,proto3" json:"batch_index,omitempty"`
+	FirstInstance int32                  `protobuf:"varint,2,opt,name=first_instance,json=firstInstance,proto3" json:"first_instance,omitempty"`
+	InstanceCount int32                  `protobuf:"varint,3,opt,name=instance_count,json=instanceCount,proto3" json:"instance_count,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *ObjectRange) Reset() {
+	*x = ObjectRange{}
+	mi := &file_level_proto_msgTypes[15]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *ObjectRange) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*ObjectRange) ProtoMessage() {}
+
+func (x *ObjectRange) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[15]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use ObjectRange.ProtoReflect.Descriptor instead.
+func (*ObjectRange) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{15}
+}
+
+func (x *ObjectRange) GetBatchIndex() int32 {
+	if x != nil {
+		return x.BatchIndex
+	}
+	return 0
+}
+
+func (x *ObjectRange) GetFirstInstance() int32 {
+	if x != nil {
+		return x.FirstInstance
+	}
+	return 0
+}
+
+func (x *ObjectRange) GetInstanceCount() int32 {
+	if x != nil {
+		return x.InstanceCount
+	}
+	return 0
+}
+
+// Line of sight between the level's spawns, portals and markers, baked at build time.
+// Bit sets are packed into 64-bit words, least significant bit first.
+type LineOfSight struct {
+	state  protoimpl.MessageState `protogen:"open.v1"`
+	Points []*LOSPoint            `protobuf:"bytes,1,rep,name=points,proto3" json:"points,omitempty"`
+	// Symmetric matrix of the points: bit (i * len(points) + j) is set if i sees j
+	Matrix []uint64 `protobuf:"fixed64,2,rep,packed,name=matrix,proto3" json:"matrix,omitempty"`
+	// Uniform grid over the level. Every cell stores the points that are visible
+	// from everywhere inside the cell, in words_per_cell words per cell (row-major).
+	// A clear bit means "not known", not "hidden".
+	CellSize      float32  `protobuf:"fixed32,3,opt,name=cell_size,json=cellSize,proto3" json:"cell_size,omitempty"`
+	MinX          float32  `protobuf:"fixed32,4,opt,name=min_x,json=minX,proto3" json:"min_x,omitempty"`
+	MinY          float32  `protobuf:"fixed32,5,opt,name=min_y,json=minY,proto3" json:"min_y,omitempty"`
+	Width         int32    `protobuf:"varint,6,opt,name=width,proto3" json:"width,omitempty"`
+	Height        int32    `protobuf:"varint,7,opt,name=height,proto3" json:"height,omitempty"`
+	WordsPerCell  int32    `protobuf:"varint,8,opt,name=words_per_cell,json=wordsPerCell,proto3" json:"words_per_cell,omitempty"`
+	CellMasks     []uint64 `protobuf:"fixed64,9,rep,packed,name=cell_masks,json=cellMasks,proto3" json:"cell_masks,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *LineOfSight) Reset() {
+	*x = LineOfSight{}
+	mi := &file_level_proto_msgTypes[16]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *LineOfSight) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*LineOfSight) ProtoMessage() {}
+
+func (x *LineOfSight) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[16]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use LineOfSight.ProtoReflect.Descriptor instead.
+func (*LineOfSight) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{16}
+}
+
+func (x *LineOfSight) GetPoints() []*LOSPoint {
+	if x != nil {
+		return x.Points
+	}
+	return nil
+}
+
+func (x *LineOfSight) GetMatrix() []uint64 {
+	if x != nil {
+		return x.Matrix
+	}
+	return nil
+}
+
+func (x *LineOfSight) GetCellSize() float32 {
+	if x != nil {
+		return x.CellSize
+	}
+	return 0
+}
+
+func (x *LineOfSight) GetMinX() float32 {
+	if x != nil {
+		return x.MinX
+	}
+	return 0
+}
+
+func (x *LineOfSight) GetMinY() float32 {
+	if x != nil {
+		return x.MinY
+	}
+	return 0
+}
+
+func (x *LineOfSight) GetWidth() int32 {
+	if x != nil {
+		return x.Width
+	}
+	return 0
+}
+
+func (x *LineOfSight) GetHeight() int32 {
+	if x != nil {
+		return x.Height
+	}
+	return 0
+}
+
+func (x *LineOfSight) GetWordsPerCell() int32 {
+	if x != nil {
+		return x.WordsPerCell
+	}
+	return 0
+}
+
+func (x *LineOfSight) GetCellMasks() []uint64 {
+	if x != nil {
+		return x.CellMasks
+	}
+	return nil
+}
+
+type LOSPoint struct {
+	state protoimpl.MessageState `protogen:"open.v1"`
+	// "spawn", "portal" or "marker"
+	Kind string `protobuf:"bytes,1,opt,name=kind,proto3" json:"kind,omitempty"`
+	// Spawn or marker name, portal index
+	Name          string  `protobuf:"bytes,2,opt,name=name,proto3" json:"name,omitempty"`
+	X             float32 `protobuf:"fixed32,3,opt,name=x,proto3" json:"x,omitempty"`
+	Y             float32 `protobuf:"fixed32,4,opt,name=y,proto3" json:"y,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *LOSPoint) Reset() {
+	*x = LOSPoint{}
+	mi := &file_level_proto_msgTypes[17]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *LOSPoint) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*LOSPoint) ProtoMessage() {}
+
+func (x *LOSPoint) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[17]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use LOSPoint.ProtoReflect.Descriptor instead.
+func (*LOSPoint) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{17}
+}
+
+func (x *LOSPoint) GetKind() string {
+	if x != nil {
+		return x.Kind
+	}
+	return ""
+}
+
+func (x *LOSPoint) GetName() string {
+	if x != nil {
+		return x.Name
+	}
+	return ""
+}
+
+func (x *LOSPoint) GetX() float32 {
+	if x != nil {
+		return x.X
+	}
+	return 0
+}
+
+func (x *LOSPoint) GetY() float32 {
+	if x != nil {
+		return x.Y
+	}
+	return 0
+}
+
+// Flow fields on one uniform grid over the level (row-major cells), baked at build time.
+// Agents heading to a common target look up the cell they stand in instead of path finding.
+type FlowFields struct {
+	state         protoimpl.MessageState `protogen:"open.v1"`
+	CellSize      float32                `protobuf:"fixed32,1,opt,name=cell_size,json=cellSize,proto3" json:"cell_size,omitempty"`
+	MinX          float32                `protobuf:"fixed32,2,opt,name=min_x,json=minX,proto3" json:"min_x,omitempty"`
+	MinY          float32                `protobuf:"fixed32,3,opt,name=min_y,json=minY,proto3" json:"min_y,omitempty"`
+	Width         int32                  `protobuf:"varint,4,opt,name=width,proto3" json:"width,omitempty"`
+	Height        int32                  `protobuf:"varint,5,opt,name=height,proto3" json:"height,omitempty"`
+	Fields        []*FlowField           `protobuf:"bytes,6,rep,name=fields,proto3" json:"fields,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *FlowFields) Reset() {
+	*x = FlowFields{}
+	mi := &file_level_proto_msgTypes[18]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *FlowFields) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*FlowFields) ProtoMessage() {}
+
+func (x *FlowFields) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[18]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use FlowFields.ProtoReflect.Descriptor instead.
+func (*FlowFields) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{18}
+}
+
+func (x *FlowFields) GetCellSize() float32 {
+	if x != nil {
+		return x.CellSize
+	}
+	return 0
+}
+
+func (x *FlowFields) GetMinX() float32 {
+	if x != nil {
+		return x.MinX
+	}
+	return 0
+}
+
+func (x *FlowFields) GetMinY() float32 {
+	if x != nil {
+		return x.MinY
+	}
+	return 0
+}
+
+func (x *FlowFields) GetWidth() int32 {
+	if x != nil {
+		return x.Width
+	}
+	return 0
+}
+
+func (x *FlowFields) GetHeight() int32 {
+	if x != nil {
+		return x.Height
+	}
+	return 0
+}
+
+func (x *FlowFields) GetFields() []*FlowField {
+	if x != nil {
+		return x.Fields
+	}
+	return nil
+}
+
+type FlowField struct {
+	state protoimpl.MessageState `protogen:"open.v1"`
+	// "spawn", "portal" or "marker"
+	Kind string `protobuf:"bytes,1,opt,name=kind,proto3" json:"kind,omitempty"`
+	// Spawn or marker name, portal index
+	Name string  `protobuf:"bytes,2,opt,name=name,proto3" json:"name,omitempty"`
+	X    float32 `protobuf:"fixed32,3,opt,name=x,proto3" json:"x,omitempty"`
+	Y    float32 `protobuf:"fixed32,4,opt,name=y,proto3" json:"y,omitempty"`
+	// Walking distance from the cell center to the target in 1/16 world units, plus one.
+	// 0 means the target cannot be reached from the cell.
+	Distances []uint32 `protobuf:"varint,5,rep,packed,name=distances,proto3" json:"distances,omitempty"`
+	// Walking direction per cell, one byte per cell: 0 means none,
+	// k > 0 is the angle (k - 1) * 2pi / 255, counter-clockwise from +X
+	Directions    []byte `protobuf:"bytes,6,opt,name=directions,proto3" json:"directions,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *FlowField) Reset() {
+	*x = FlowField{}
+	mi := &file_level_proto_msgTypes[19]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *FlowField) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*FlowField) ProtoMessage() {}
+
+func (x *FlowField) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[19]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use FlowField.ProtoReflect.Descriptor instead.
+func (*FlowField) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{19}
+}
+
+func (x *FlowField) GetKind() string {
+	if x != nil {
+		return x.Kind
+	}
+	return ""
+}
+
+func (x *FlowField) GetName() string {
+	if x != nil {
+		return x.Name
+	}
+	return ""
+}
+
+func (x *FlowField) GetX() float32 {
+	if x != nil {
+		return x.X
+	}
+	return 0
+}
+
+func (x *FlowField) GetY() float32 {
+	if x != nil {
+		return x.Y
+	}
+	return 0
+}
+
+func (x *FlowField) GetDistances() []uint32 {
+	if x != nil {
+		return x.Distances
+	}
+	return nil
+}
+
+func (x *FlowField) GetDirections() []byte {
+	if x != nil {
+		return x.Directions
+	}
+	return nil
+}
+
+// Convex solid shapes in world space, merged across outlines into as few and large shapes as possible.
+// Together they cover exactly the solid space of the level; shapes may overlap.
+type ConvexShapes struct {
+	state protoimpl.MessageState `protogen:"open.v1"`
+	// x, y pairs of all shapes back to back, counter-clockwise per shape
+	Vertices []float32 `protobuf:"fixed32,1,rep,packed,name=vertices,proto3" json:"vertices,omitempty"`
+	// Shape i has the points offsets[i] to offsets[i + 1] (exclusive), so there is one more offset than shapes
+	Offsets       []uint32 `protobuf:"varint,2,rep,packed,name=offsets,proto3" json:"offsets,omitempty"`
+	unknownFields protoimpl.UnknownFields
+	sizeCache     protoimpl.SizeCache
+}
+
+func (x *ConvexShapes) Reset() {
+	*x = ConvexShapes{}
+	mi := &file_level_proto_msgTypes[20]
+	ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+	ms.StoreMessageInfo(mi)
+}
+
+func (x *ConvexShapes) String() string {
+	return protoimpl.X.MessageStringOf(x)
+}
+
+func (*ConvexShapes) ProtoMessage() {}
+
+func (x *ConvexShapes) ProtoReflect() protoreflect.Message {
+	mi := &file_level_proto_msgTypes[20]
+	if x != nil {
+		ms := protoimpl.X.MessageStateOf(protoimpl.Pointer(x))
+		if ms.LoadMessageInfo() == nil {
+			ms.StoreMessageInfo(mi)
+		}
+		return ms
+	}
+	return mi.MessageOf(x)
+}
+
+// Deprecated: Use ConvexShapes.ProtoReflect.Descriptor instead.
+func (*ConvexShapes) Descriptor() ([]byte, []int) {
+	return file_level_proto_rawDescGZIP(), []int{20}
+}
+
+func (x *ConvexShapes) GetVertices() []float32 {
+	if x != nil {
+		return x.Vertices
+	}
+	return nil
+}
+
+func (x *ConvexShapes) GetOffsets() []uint32 {
+	if x != nil {
+		return x.Offsets
+	}
+	return nil
+}
+
+var File_level_proto protoreflect.FileDescriptor
+
+const file_level_proto_rawDesc = "" +
+	"\n" +
+	"\vlevel.proto\x12\aventure\"\xb0\x04\n" +
+	"\tLevelData\x12&\n" +
+	"\x05nodes\x18\x01 \x03(\v2\x10.venture.BSPNodeR\x05nodes\x12\x1d\n" +
+	"\n" +
+	"root_index\x18\x02 \x01(\x05R\trootIndex\x12%\n" +
+	"\x06ground\x18\x03 \x03(\v2\r.venture.TileR\x06ground\x12;\n" +
+	"\x0eobject_batches\x18\x04 \x03(\v2\x14.venture.ObjectBatchR\robjectBatches\x129\n" +
+	"\robject_chunks\x18\x05 \x03(\v2\x14.venture.ObjectChunkR\fobjectChunks\x12*\n" +
+	"\x11object_chunk_size\x18\x06 \x01(\x02R\x0fobjectChunkSize\x128\n" +
+	"\rline_of_sight\x18\a \x01(\v2\x14.venture.LineOfSightR\vlineOfSight\x12:\n" +
+	"\rcollision_bvh\x18\b \x01(\v2\x15.venture.CollisionBVHR\fcollisionBvh\x124\n" +
+	"\vflow_fields\x18\t \x01(\v2\x13.venture.FlowFieldsR\n" +
+	"flowFields\x12:\n" +
+	"\rconvex_shapes\x18\n" +
+	" \x01(\v2\x15.venture.ConvexShapesR\fconvexShapes\x12)\n" +
+	"\asectors\x18\v \x03(\v2\x0f.venture.SectorR\asectors\"\xef\x01\n" +
+	"\aBSPNode\x12&\n" +
+	"\x05split\x18\x01 \x01(\v2\x0e.venture.SplitH\x00R\x05split\x12#\n" +
+	"\x04leaf\x18\x02 \x01(\v2\r.venture.LeafH\x00R\x04leaf\x12/\n" +
+	"\binstance\x18\x03 \x01(\v2\x11.venture.InstanceH\x00R\binstance\x12)\n" +
+	"\x06circle\x18\x04 \x01(\v2\x0f.venture.CircleH\x00R\x06circle\x123\n" +
+	"\n" +
+	"axis_split\x18\x05 \x01(\v2\x12.venture.AxisSplitH\x00R\taxisSplitB\x06\n" +
+	"\x04type\"\x99\x01\n" +
+	"\x05Split\x12\x19\n" +
+	"\bnormal_x\x18\x01 \x01(\x02R\anormalX\x12\x19\n" +
+	"\bnormal_y\x18\x02 \x01(\x02R\anormalY\x12\x1a\n" +
+	"\bdistance\x18\x03 \x01(\x02R\bdistance\x12\x1f\n" +
+	"\vfront_index\x18\x04 \x01(\x05R\n" +
+	"frontIndex\x12\x1d\n" +
+	"\n" +
+	"back_index\x18\x05 \x01(\x05R\tbackIndex\"\x9e\x01\n" +
+	"\tAxisSplit\x12\x12\n" +
+	"\x04axis\x18\x01 \x01(\rR\x04axis\x12\x1c\n" +
+	"\tthreshold\x18\x02 \x01(\x02R\tthreshold\x12\x1f\n" +
+	"\vfront_below\x18\x03 \x01(\bR\n" +
+	"frontBelow\x12\x1f\n" +
+	"\vfront_index\x18\x04 \x01(\x05R\n" +
+	"frontIndex\x12\x1d\n" +
+	"\n" +
+	"back_index\x18\x05 \x01(\x05R\tbackIndex\"\xb6\x01\n" +
+	"\bInstance\x12#\n" +
+	"\rsubtree_index\x18\x01 \x01(\x05R\fsubtreeIndex\x12\x10\n" +
+	"\x03m00\x18\x02 \x01(\x02R\x03m00\x12\x10\n" +
+	"\x03m01\x18\x03 \x01(\x02R\x03m01\x12\x10\n" +
+	"\x03m10\x18\x04 \x01(\x02R\x03m10\x12\x10\n" +
+	"\x03m11\x18\x05 \x01(\x02R\x03m11\x12\x0e\n" +
+	"\x02tx\x18\x06 \x01(\x02R\x02tx\x12\x0e\n" +
+	"\x02ty\x18\a \x01(\x02R\x02ty\x12\x1d\n" +
+	"\n" +
+	"next_index\x18\b \x01(\x05R\tnextIndex\"{\n" +
+	"\x06Circle\x12\x19\n" +
+	"\bcenter_x\x18\x01 \x01(\x02R\acenterX\x12\x19\n" +
+	"\bcenter_y\x18\x02 \x01(\x02R\acenterY\x12\x16\n" +
+	"\x06radius\x18\x03 \x01(\x02R\x06radius\x12#\n" +
+	"\routside_index\x18\x04 \x01(\x05R\foutsideIndex\"\x80\x01\n" +
+	"\fCollisionBVH\x12&\n" +
+	"\x05nodes\x18\x01 \x03(\v2\x10.venture.BVHNodeR\x05nodes\x12,\n" +
+	"\x06pieces\x18\x02 \x03(\v2\x14.venture.ConvexPieceR\x06pieces\x12\x1a\n" +
+	"\bvertices\x18\x03 \x03(\x02R\bvertices\"\xc0\x01\n" +
+	"\aBVHNode\x12\x13\n" +
+	"\x05min_x\x18\x01 \x01(\x02R\x04minX\x12\x13\n" +
+	"\x05min_y\x18\x02 \x01(\x02R\x04minY\x12\x13\n" +
+	"\x05max_x\x18\x03 \x01(\x02R\x04maxX\x12\x13\n" +
+	"\x05max_y\x18\x04 \x01(\x02R\x04maxY\x12\x1f\n" +
+	"\vright_index\x18\x05 \x01(\x05R\n" +
+	"rightIndex\x12\x1f\n" +
+	"\vfirst_piece\x18\x06 \x01(\x05R\n" +
+	"firstPiece\x12\x1f\n" +
+	"\vpiece_count\x18\a \x01(\x05R\n" +
+	"pieceCount\"\x89\x02\n" +
+	"\vConvexPiece\x12!\n" +
+	"\ffirst_vertex\x18\x01 \x01(\x05R\vfirstVertex\x12!\n" +
+	"\fvertex_count\x18\x02 \x01(\x05R\vvertexCount\x12\x19\n" +
+	"\bcenter_x\x18\x03 \x01(\x02R\acenterX\x12\x19\n" +
+	"\bcenter_y\x18\x04 \x01(\x02R\acenterY\x12\x16\n" +
+	"\x06radius\x18\x05 \x01(\x02R\x06radius\x12\x10\n" +
+	"\x03m00\x18\x06 \x01(\x02R\x03m00\x12\x10\n" +
+	"\x03m01\x18\a \x01(\x02R\x03m01\x12\x10\n" +
+	"\x03m10\x18\b \x01(\x02R\x03m10\x12\x10\n" +
+	"\x03m11\x18\t \x01(\x02R\x03m11\x12\x0e\n" +
+	"\x02tx\x18\n" +
+	" \x01(\x02R\x02tx\x12\x0e\n" +
+	"\x02ty\x18\v \x01(\x02R\x02ty\"g\n" +
+	"\x04Leaf\x12\x1b\n" +
+	"\tsector_id\x18\x01 \x01(\x05R\bsectorId\x12'\n" +
+	"\x0fpolygon_indices\x18\x02 \x03(\x05R\x0epolygonIndices\x12\x19\n" +
+	"\bis_solid\x18\x03 \x01(\bR\aisSolid\"z\n" +
+	"\x06Sector\x12\x13\n" +
+	"\x05min_x\x18\x01 \x01(\x02R\x04minX\x12\x13\n" +
+	"\x05min_y\x18\x02 \x01(\x02R\x04minY\x12\x13\n" +
+	"\x05max_x\x18\x03 \x01(\x02R\x04maxX\x12\x13\n" +
+	"\x05max_y\x18\x04 \x01(\x02R\x04maxY\x12\x1c\n" +
+	"\tneighbors\x18\x05 \x03(\x05R\tneighbors\"#\n" +
+	"\x05Vec2i\x12\f\n" +
+	"\x01x\x18\x01 \x01(\x05R\x01x\x12\f\n" +
+	"\x01y\x18\x02 \x01(\x05R\x01y\"L\n" +
+	"\x04Tile\x12*\n" +
+	"\bposition\x18\x01 \x01(\v2\x0e.venture.Vec2iR\bposition\x12\x18\n" +
+	"\atexture\x18\x02 \x01(\tR\atexture\"\x8f\x01\n" +
+	"\vObjectBatch\x12\x14\n" +
+	"\x05layer\x18\x01 \x01(\x05R\x05layer\x12\x18\n" +
+	"\atexture\x18\x02 \x01(\tR\atexture\x12\x1c\n" +
+	"\tpositions\x18\x03 \x03(\x02R\tpositions\x12\x1c\n" +
+	"\trotations\x18\x04 \x03(\x02R\trotations\x12\x14\n" +
+	"\x05sizes\x18\x05 \x03(\x02R\x05sizes\"\xbb\x01\n" +
+	"\vObjectChunk\x12*\n" +
+	"\bposition\x18\x01 \x01(\v2\x0e.venture.Vec2iR\bposition\x12\x13\n" +
+	"\x05min_x\x18\x02 \x01(\x02R\x04minX\x12\x13\n" +
+	"\x05min_y\x18\x03 \x01(\x02R\x04minY\x12\x13\n" +
+	"\x05max_x\x18\x04 \x01(\x02R\x04maxX\x12\x13\n" +
+	"\x05max_y\x18\x05 \x01(\x02R\x04maxY\x12,\n" +
+	"\x06ranges\x18\x06 \x03(\v2\x14.venture.ObjectRangeR\x06ranges\"|\n" +
+	"\vObjectRange\x12\x1f\n" +
+	"\vbatch_index\x18\x01 \x01(\x05R\n" +
+	"batchIndex\x12%\n" +
+	"\x0efirst_instance\x18\x02 \x01(\x05R\rfirstInstance\x12%\n" +
+	"\x0einstance_count\x18\x03 \x01(\x05R\rinstanceCount\"\x8a\x02\n" +
+	"\vLineOfSight\x12)\n" +
+	"\x06points\x18\x01 \x03(\v2\x11.venture.LOSPointR\x06points\x12\x16\n" +
+	"\x06matrix\x18\x02 \x03(\x06R\x06matrix\x12\x1b\n" +
+	"\tcell_size\x18\x03 \x01(\x02R\bcellSize\x12\x13\n" +
+	"\x05min_x\x18\x04 \x01(\x02R\x04minX\x12\x13\n" +
+	"\x05min_y\x18\x05 \x01(\x02R\x04minY\x12\x14\n" +
+	"\x05width\x18\x06 \x01(\x05R\x05width\x12\x16\n" +
+	"\x06height\x18\a \x01(\x05R\x06height\x12$\n" +
+	"\x0ewords_per_cell\x18\b \x01(\x05R\fwordsPerCell\x12\x1d\n" +
+	"\n" +
+	"cell_masks\x18\t \x03(\x06R\tcellMasks\"N\n" +
+	"\bLOSPoint\x12\x12\n" +
+	"\x04kind\x18\x01 \x01(\tR\x04kind\x12\x12\n" +
+	"\x04name\x18\x02 \x01(\tR\x04name\x12\f\n" +
+	"\x01x\x18\x03 \x01(\x02R\x01x\x12\f\n" +
+	"\x01y\x18\x04 \x01(\x02R\x01y\"\xad\x01\n" +
+	"\n" +
+	"FlowFields\x12\x1b\n" +
+	"\tcell_size\x18\x01 \x01(\x02R\bcellSize\x12\x13\n" +
+	"\x05min_x\x18\x02 \x01(\x02R\x04minX\x12\x13\n" +
+	"\x05min_y\x18\x03 \x01(\x02R\x04minY\x12\x14\n" +
+	"\x05width\x18\x04 \x01(\x05R\x05width\x12\x16\n" +
+	"\x06height\x18\x05 \x01(\x05R\x06height\x12*\n" +
+	"\x06fields\x18\x06 \x03(\v2\x12.venture.FlowFieldR\x06fields\"\x8d\x01\n" +
+	"\tFlowField\x12\x12\n" +
+	"\x04kind\x18\x01 \x01(\tR\x04kind\x12\x12\n" +
+	"\x04name\x18\x02 \x01(\tR\x04name\x12\f\n" +
+	"\x01x\x18\x03 \x01(\x02R\x01x\x12\f\n" +
+	"\x01y\x18\x04 \x01(\x02R\x01y\x12\x1c\n" +
+	"\tdistances\x18\x05 \x03(\rR\tdistances\x12\x1e\n" +
+	"\n" +
+	"directions\x18\x06 \x01(\fR\n" +
+	"directions\"D\n" +
+	"\fConvexShapes\x12\x1a\n" +
+	"\bvertices\x18\x01 \x03(\x02R\bvertices\x12\x18\n" +
+	"\aoffsets\x18\x02 \x03(\rR\aoffsetsB2Z0github.com/bloodmagesoftware/venture/proto/levelb\x06proto3"
 
 var (
 	file_level_proto_rawDescOnce sync.Once
@@ -456,26 +1976,57 @@ func file_level_proto_rawDescGZIP() []byte {
 	return file_level_proto_rawDescData
 }
 
-var file_level_proto_msgTypes = make([]protoimpl.MessageInfo, 6)
+var file_level_proto_msgTypes = make([]protoimpl.MessageInfo, 21)
 var file_level_proto_goTypes = []any{
-	(*LevelData)(nil), // 0: venture.LevelData
-	(*BSPNode)(nil),   // 1: venture.BSPNode
-	(*Split)(nil),     // 2: venture.Split
-	(*Leaf)(nil),      // 3: venture.Leaf
-	(*Vec2I)(nil),     // 4: venture.Vec2i
-	(*Tile)(nil),      // 5: venture.Tile
+	(*LevelData)(nil),    // 0: venture.LevelData
+	(*BSPNode)(nil),      // 1: venture.BSPNode
+	(*Split)(nil),        // 2: venture.Split
+	(*AxisSplit)(nil),    // 3: venture.AxisSplit
+	(*Instance)(nil),     // 4: venture.Instance
+	(*Circle)(nil),       // 5: venture.Circle
+	(*CollisionBVH)(nil), // 6: venture.CollisionBVH
+	(*BVHNode)(nil),      // 7: venture.BVHNode
+	(*ConvexPiece)(nil),  // 8: venture.ConvexPiece
+	(*Leaf)(nil),         // 9: venture.Leaf
+	(*Sector)(nil),       // 10: venture.Sector
+	(*Vec2I)(nil),        // 11: venture.Vec2i
+	(*Tile)(nil),         // 12: venture.Tile
+	(*ObjectBatch)(nil),  // 13: venture.ObjectBatch
+	(*ObjectChunk)(nil),  // 14: venture.ObjectChunk
+	(*ObjectRange)(nil),  // 15: venture.ObjectRange
+	(*LineOfSight)(nil),  // 16: venture.LineOfSight
+	(*LOSPoint)(nil),     // 17: venture.LOSPoint
+	(*FlowFields)(nil),   // 18: venture.FlowFields
+	(*FlowField)(nil),    // 19: venture.FlowField
+	(*ConvexShapes)(nil), // 20: venture.ConvexShapes
 }
 var file_level_proto_depIdxs = []int32{
-	1, // 0: venture.LevelData.nodes:type_name -> venture.BSPNode
-	5, // 1: venture.LevelData.ground:type_name -> venture.Tile
-	2, // 2: venture.BSPNode.split:type_name -> venture.Split
-	3, // 3: venture.BSPNode.leaf:type_name -> venture.Leaf
-	4, // 4: venture.Tile.position:type_name -> venture.Vec2i
-	5, // [5:5] is the sub-list for method output_type
-	5, // [5:5] is the sub-list for method input_type
-	5, // [5:5] is the sub-list for extension type_name
-	5, // [5:5] is the sub-list for extension extendee
-	0, // [0:5] is the sub-list for field type_name
+	1,  // 0: venture.LevelData.nodes:type_name -> venture.BSPNode
+	12, // 1: venture.LevelData.ground:type_name -> venture.Tile
+	13, // 2: venture.LevelData.object_batches:type_name -> venture.ObjectBatch
+	14, // 3: venture.LevelData.object_chunks:type_name -> venture.ObjectChunk
+	16, // 4: venture.LevelData.line_of_sight:type_name -> venture.LineOfSight
+	6,  // 5: venture.LevelData.collision_bvh:type_name -> venture.CollisionBVH
+	18, // 6: venture.LevelData.flow_fields:type_name -> venture.FlowFields
+	20, // 7: venture.LevelData.convex_shapes:type_name -> venture.ConvexShapes
+	10, // 8: venture.LevelData.sectors:type_name -> venture.Sector
+	2,  // 9: venture.BSPNode.split:type_name -> venture.Split
+	9,  // 10: venture.BSPNode.leaf:type_name -> venture.Leaf
+	4,  // 11: venture.BSPNode.instance:type_name -> venture.Instance
+	5,  // 12: venture.BSPNode.circle:type_name -> venture.Circle
+	3,  // 13: venture.BSPNode.axis_split:type_name -> venture.AxisSplit
+	7,  // 14: venture.CollisionBVH.nodes:type_name -> venture.BVHNode
+	8,  // 15: venture.CollisionBVH.pieces:type_name -> venture.ConvexPiece
+	11, // 16: venture.Tile.position:type_name -> venture.Vec2i
+	11, // 17: venture.ObjectChunk.position:type_name -> venture.Vec2i
+	15, // 18: venture.ObjectChunk.ranges:type_name -> venture.ObjectRange
+	17, // 19: venture.LineOfSight.points:type_name -> venture.LOSPoint
+	19, // 20: venture.FlowFields.fields:type_name -> venture.FlowField
+	21, // [21:21] is the sub-list for method output_type
+	21, // [21:21] is the sub-list for method input_type
+	21, // [21:21] is the sub-list for extension type_name
+	21, // [21:21] is the sub-list for extension extendee
+	0,  // [0:21] is the sub-list for field type_name
 }
 
 func init() { file_level_proto_init() }
@@ -486,6 +2037,9 @@ func file_level_proto_init() {
 	file_level_proto_msgTypes[1].OneofWrappers = []any{
 		(*BSPNode_Split)(nil),
 		(*BSPNode_Leaf)(nil),
+		(*BSPNode_Instance)(nil),
+		(*BSPNode_Circle)(nil),
+		(*BSPNode_AxisSplit)(nil),
 	}
 	type x struct{}
 	out := protoimpl.TypeBuilder{
@@ -493,7 +2047,7 @@ func file_level_proto_init() {
 			GoPackagePath: reflect.TypeOf(x{}).PkgPath(),
 			RawDescriptor: unsafe.Slice(unsafe.StringData(file_level_proto_rawDesc), len(file_level_proto_rawDesc)),
 			NumEnums:      0,
-			NumMessages:   6,
+			NumMessages:   21,
 			NumExtensions: 0,
 			NumServices:   0,
 		},